@@ -12,9 +12,11 @@
  * Platform implementations:
  * - macOS: AVFoundationEncoder
  * - Windows: MediaFoundationEncoder
+ * - Linux: LibavEncoder (when built with libavcodec/libavformat)
  *
- * This interface provides a common API for native video encoding
- * without requiring external dependencies like FFmpeg.
+ * This interface provides a common API for native video encoding.
+ * macOS and Windows use the system encoders; Linux has no system encoder
+ * API, so it uses the distribution's FFmpeg libraries.
  */
 class IVideoEncoder : public QObject
 {
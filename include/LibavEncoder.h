@@ -0,0 +1,53 @@
+#ifndef LIBAVENCODER_H
+#define LIBAVENCODER_H
+
+#include "IVideoEncoder.h"
+
+#if defined(Q_OS_LINUX) && defined(SNAPTRAY_HAVE_LIBAV)
+
+class LibavEncoderPrivate;
+
+/**
+ * @brief Linux software H.264 encoder
+ *
+ * Encodes with whichever H.264 encoder libavcodec provides (libx264,
+ * then openh264, then any other taking YUV420P) and muxes MP4 with
+ * libavformat, with 16-bit PCM audio encoded to AAC. Frames are
+ * timestamped in milliseconds, so variable frame timing is kept as
+ * captured. Odd frame sizes are padded to even by repeating the edge.
+ */
+class LibavEncoder : public IVideoEncoder
+{
+    Q_OBJECT
+
+public:
+    explicit LibavEncoder(QObject *parent = nullptr);
+    ~LibavEncoder() override;
+
+    bool isAvailable() const override;
+    QString encoderName() const override;
+
+    bool start(const QString &outputPath, const QSize &frameSize, int frameRate) override;
+    void writeFrame(const QImage &frame, qint64 timestampMs = -1) override;
+    void finish() override;
+    void abort() override;
+
+    bool isRunning() const override;
+    QString lastError() const override;
+    qint64 framesWritten() const override;
+    QString outputPath() const override;
+
+    void setQuality(int quality) override;
+
+    // Audio support
+    void setAudioFormat(int sampleRate, int channels, int bitsPerSample) override;
+    bool isAudioSupported() const override;
+    bool isAudioEnabled() const override;
+    void writeAudioSamples(const QByteArray &pcmData, qint64 timestampMs) override;
+
+private:
+    LibavEncoderPrivate *d;
+};
+
+#endif // Q_OS_LINUX && SNAPTRAY_HAVE_LIBAV
+#endif // LIBAVENCODER_H
@@ -25,6 +25,9 @@ class QmlSettingsWindow;
 class QmlHistoryWindow;
 class QmlDialog;
 class ScreenPickerViewModel;
+namespace CLI {
+class IPCServerSession;
+}
 }
 
 class MainApplication : public QObject
@@ -40,6 +43,7 @@ public:
 public slots:
     void activate();
     void handleCLICommand(const QByteArray& commandData);
+    void attachCLISession(SnapTray::CLI::IPCServerSession* session);
 
 private slots:
     void onRegionCapture();
@@ -64,6 +68,9 @@ private slots:
 private:
     friend class tst_MainApplicationTrayMenu;
 
+    void handleCLIRequest(SnapTray::CLI::IPCServerSession* session,
+                          quint32 requestId,
+                          const QByteArray& commandData);
     void startRegionCapture(bool showShortcutHintsOnEntry);
     bool canShutdownForUpdate() const;
     void prepareForUpdateShutdown();
@@ -18,6 +18,7 @@
 using SharedPixmap = std::shared_ptr<const QPixmap>;
 #include "WatermarkRenderer.h"
 #include "LoadingSpinnerRenderer.h"
+#include "pinwindow/LiveFrameGate.h"
 #include "pinwindow/ResizeHandler.h"
 #include "tools/ToolId.h"
 #include "annotation/AnnotationHostAdapter.h"
@@ -401,6 +402,7 @@ private:
     QAction* m_opacityInfoAction = nullptr;
     QAction* m_flipHorizontalInfoAction = nullptr;
     QAction* m_flipVerticalInfoAction = nullptr;
+    QAction* m_liveFramesInfoAction = nullptr;
 
     // Live capture context menu items
     QAction* m_startLiveAction = nullptr;
@@ -535,6 +537,7 @@ private:
     QTimer* m_liveIndicatorTimer = nullptr;
     int m_captureFrameRate = kLivePreviewFps;
     bool m_livePaused = false;
+    LiveFrameGate m_liveFrameGate;
 
     // Beautify
     void showBeautifyPanel();
@@ -568,6 +571,7 @@ private:
     static constexpr int kMosaicBlockSize = 12;
 
     void updateLiveFrame();
+    QString liveFrameStatsText() const;
 };
 
 #endif // PINWINDOW_H
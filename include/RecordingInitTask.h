@@ -102,6 +102,11 @@ public:
     Result &result() { return m_result; }
     const Result &result() const { return m_result; }
 
+    /**
+     * @brief Configuration the task was created with
+     */
+    const Config &config() const { return m_config; }
+
     /**
      * @brief Cancel the initialization if in progress
      */
@@ -8,6 +8,12 @@
 class QLocalServer;
 class QLockFile;
 
+namespace SnapTray {
+namespace CLI {
+class IPCServerSession;
+}
+}
+
 class SingleInstanceGuard : public QObject
 {
     Q_OBJECT
@@ -21,6 +27,9 @@ public:
 signals:
     void activateRequested();
     void commandReceived(const QByteArray& commandData);
+    // A client opened a framed, persistent connection. Connect to the
+    // session's commandReceived() and reply through it.
+    void sessionStarted(SnapTray::CLI::IPCServerSession* session);
 
 private slots:
     void onNewConnection();
@@ -31,6 +31,11 @@ public:
                                         const QImage &cachedWatermark,
                                         const Settings &settings);
 
+    // Same as applyToImageWithCache() but paints into target; returns false if nothing was drawn
+    static bool applyToImageInPlace(QImage &target,
+                                    const QImage &cachedWatermark,
+                                    const Settings &settings);
+
 private:
     static QRect calculateWatermarkRect(const QRect &targetRect, const QSize &size, Position position, int margin);
     static void renderImage(QPainter &painter, const QRect &targetRect, const Settings &settings);
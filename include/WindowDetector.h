@@ -11,9 +11,12 @@
 #include <QPointer>
 #include <QElapsedTimer>
 #include <algorithm>
+#include <memory>
 #include <vector>
 #include <optional>
 
+#include "WindowHitIndex.h"
+
 class QScreen;
 
 // Element type classification for detected UI elements
@@ -152,7 +155,18 @@ private:
         }
     }
 
+    // Call with m_cacheMutex held. Rebuilds the index if m_windowCache was
+    // replaced without going through m_hitIndex.build().
+    const WindowHitIndex& hitIndexLocked() const
+    {
+        if (!m_hitIndex.isBuiltFor(m_windowCache)) {
+            m_hitIndex.build(m_windowCache);
+        }
+        return m_hitIndex;
+    }
+
     std::vector<DetectedElement> m_windowCache;
+    mutable WindowHitIndex m_hitIndex;
     mutable QMutex m_cacheMutex;
     QPointer<QScreen> m_currentScreen;
     bool m_enabled;
@@ -172,6 +186,12 @@ private:
     mutable bool m_accessibilityPromptRequested{false};
 #endif
 
+#ifdef Q_OS_LINUX
+    // Keeps the X11 window list current from server events between refreshes.
+    class X11WindowTracker;
+    std::unique_ptr<X11WindowTracker> m_x11Tracker;
+#endif
+
     friend class tst_WindowDetectorQueryMode;
 };
 
@@ -0,0 +1,76 @@
+#ifndef WINDOWHITINDEX_H
+#define WINDOWHITINDEX_H
+
+#include <QPoint>
+#include <QRect>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct DetectedElement;
+
+// Uniform grid over a window cache snapshot for point lookups.
+//
+// Each cell lists the indices of the elements whose bounds overlap it, in
+// cache order, so the first candidate that contains a point is also the
+// topmost one. Lookups touch a single cell instead of the whole cache.
+//
+// Elements with windowLayer == 1 are child controls of the closest preceding
+// top-level element, matching the layout detectWindowAt() expects.
+class WindowHitIndex
+{
+public:
+    static constexpr uint32_t kNoTopLevel = UINT32_MAX;
+
+    class Candidates
+    {
+    public:
+        Candidates() = default;
+        Candidates(const uint32_t* first, const uint32_t* last) : m_first(first), m_last(last) {}
+
+        const uint32_t* begin() const { return m_first; }
+        const uint32_t* end() const { return m_last; }
+        bool empty() const { return m_first == m_last; }
+
+    private:
+        const uint32_t* m_first = nullptr;
+        const uint32_t* m_last = nullptr;
+    };
+
+    void build(const std::vector<DetectedElement>& elements);
+    void clear();
+
+    // True if build() was last called with this vector and it has not been
+    // resized since. Lets readers rebuild an index that a writer left stale.
+    bool isBuiltFor(const std::vector<DetectedElement>& elements) const;
+
+    // Elements that may contain point, in ascending index order. Callers
+    // still test the bounds: a cell is coarser than the elements in it.
+    Candidates candidatesAt(const QPoint& point) const;
+
+    // Index of the top-level element that owns the element at index, or
+    // kNoTopLevel for a child control with no preceding top-level element.
+    uint32_t topLevelIndexOf(size_t index) const;
+
+private:
+    static constexpr int kMinCellSize = 64;
+    static constexpr int kMaxCellsPerAxis = 128;
+
+    int cellColumn(int x) const;
+    int cellRow(int y) const;
+
+    const DetectedElement* m_source = nullptr;
+    size_t m_sourceSize = 0;
+    bool m_built = false;
+
+    QRect m_extent;
+    int m_cellSize = kMinCellSize;
+    int m_columns = 0;
+    int m_rows = 0;
+    std::vector<uint32_t> m_cellOffsets;  // m_columns * m_rows + 1 entries
+    std::vector<uint32_t> m_cellEntries;
+    std::vector<uint32_t> m_topLevelIndex;
+};
+
+#endif // WINDOWHITINDEX_H
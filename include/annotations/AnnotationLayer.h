@@ -6,6 +6,7 @@
 #include <QPoint>
 #include <QRect>
 #include <QPixmap>
+#include <QRegion>
 #include <functional>
 #include <cstdint>
 #include <map>
@@ -13,6 +14,7 @@
 #include <vector>
 
 #include "annotations/AnnotationItem.h"
+#include "annotations/AnnotationSpatialIndex.h"
 #include "annotations/ErasedItemsGroup.h"
 
 // Forward declarations
@@ -77,18 +79,23 @@ public:
     void setSelectedIndex(int index);
     int selectedIndex() const { return m_selectedIndex; }
     AnnotationItem* selectedItem();
-    void clearSelection() { m_selectedIndex = -1; }
+    void clearSelection();
     bool removeSelectedItem();
 
     // Cache management for rendering optimization
     void invalidateCache();
+    // Call after an item changed in place within a logical rect: only the
+    // cache tiles overlapping it are re-rasterized on next draw.
+    void invalidateCacheRect(const QRect& rect);
     void drawCached(QPainter &painter,
                     const QSize &canvasSize,
                     qreal devicePixelRatio = 1.0,
                     const QPoint& origin = QPoint()) const;
 
     // Dirty region optimization for dragging operations
-    // Instead of invalidating the entire cache during drag, mark only affected regions
+    // Instead of invalidating the entire cache during drag, mark only affected regions.
+    // Editors mark the selected item's bounds when a drag starts, so the full
+    // cache can be reused for drag rendering by repainting only those tiles.
     void markDirtyRect(const QRect& rect);
     void clearDirtyRect();
     bool hasDirtyRect() const { return m_hasDirtyRect; }
@@ -102,16 +109,41 @@ public:
                              const QPoint& origin = QPoint()) const;
 
     // Commit dirty region changes to cache after drag completes
-    void commitDirtyRegion(const QSize &canvasSize, qreal devicePixelRatio);
+    void commitDirtyRegion();
+
+    // Cache tile edge length in device pixels.
+    static constexpr int kCacheTileSize = 256;
 
 signals:
     void changed();
 
 private:
     static constexpr size_t kMaxHistorySize = 50;
+    // Logical padding around item bounds when mapping them to cache tiles.
+    // Covers antialiasing, arrowheads and text shadows drawn slightly outside
+    // boundingRect().
+    static constexpr int kCacheTilePadding = 8;
+    // Logical padding around item bounds in the spatial index. Covers the
+    // hit tolerance of containsPoint() beyond boundingRect().
+    static constexpr int kHitTestPadding = 16;
 
     void trimHistory();
     void renumberStepBadges();
+    void invalidateItemCache(const AnnotationItem* item);
+    void markCacheTilesDirty(const QRect& rect);
+    void dropExcludeIndexCaches();
+
+    // Spatial index over m_items for hover and eraser queries. Appends and
+    // pops are applied in place; anything that shifts indices or moves items
+    // marks it stale and it is rebuilt on the next query. The selected item
+    // may be edited in place, so queries test it directly and the index is
+    // refreshed once the selection changes.
+    const AnnotationSpatialIndex& spatialIndex() const;
+    void appendToSpatialIndex(const AnnotationItem* item);
+    void popFromSpatialIndex();
+    void invalidateSpatialIndex() { m_spatialIndexValid = false; }
+    template <typename T>
+    int hitTestTopmost(const QPoint& pos) const;
 
     std::vector<std::unique_ptr<AnnotationItem>> m_items;
     std::vector<std::unique_ptr<AnnotationItem>> m_redoStack;
@@ -147,10 +179,37 @@ private:
         }
     };
 
+    // Full-canvas raster of completed annotations, split into fixed-size
+    // device-pixel tiles. Only tiles marked dirty are re-rasterized.
+    struct CacheEntry {
+        QPixmap pixmap;
+        int columns = 0;
+        int rows = 0;
+        std::vector<std::uint8_t> dirtyTiles;
+        bool hasDirtyTiles = false;
+    };
+
+    const QPixmap& cachedPixmap(const CacheKey& key,
+                                const QSize& physicalSize,
+                                qreal devicePixelRatio,
+                                const QPoint& origin) const;
+    void rasterizeDirtyTiles(CacheEntry& entry,
+                             const CacheKey& key,
+                             qreal devicePixelRatio,
+                             const QPoint& origin) const;
+    static void markTilesDirty(CacheEntry& entry, const QRect& deviceRect);
+    static QRect cacheDeviceRect(const QRect& rect, const CacheKey& key);
+    static QRect itemDeviceRect(const AnnotationItem* item,
+                                const QPoint& origin,
+                                qreal devicePixelRatio);
+
     // Completed annotations caches for rendering optimization.
-    mutable std::map<CacheKey, QPixmap> m_annotationCaches;
+    mutable std::map<CacheKey, CacheEntry> m_annotationCaches;
     std::uint64_t m_revision = 0;
 
+    mutable AnnotationSpatialIndex m_spatialIndex;
+    mutable bool m_spatialIndexValid = false;
+
     // Dirty region tracking for drag optimization
     mutable QRect m_dirtyRect;
     mutable bool m_hasDirtyRect = false;
@@ -0,0 +1,45 @@
+#ifndef ANNOTATIONSPATIALINDEX_H
+#define ANNOTATIONSPATIALINDEX_H
+
+#include <QPoint>
+#include <QRect>
+#include <QtGlobal>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Uniform grid over annotation bounding rects.
+ *
+ * Items are identified by their stacking index in the owning layer. Indices
+ * must be appended in increasing order, so every cell list stays sorted
+ * bottom-to-top and the topmost candidate is always at the back.
+ */
+class AnnotationSpatialIndex
+{
+public:
+    static constexpr int kCellSize = 128;
+
+    void clear();
+    bool isEmpty() const { return m_rects.empty(); }
+    int size() const { return static_cast<int>(m_rects.size()); }
+
+    // Append the item at index size(). Empty rects are tracked but not indexed.
+    void append(const QRect& rect);
+    // Remove the most recently appended item.
+    void removeLast();
+
+    // Indices whose cell covers the point, sorted bottom-to-top.
+    // Returns nullptr when no item is indexed there.
+    const std::vector<int>* candidatesAt(const QPoint& point) const;
+    // Indices whose rect intersects the query rect, sorted bottom-to-top.
+    std::vector<int> query(const QRect& rect) const;
+
+private:
+    static qint64 cellKey(int column, int row);
+    static int cellCoordinate(int value);
+
+    std::unordered_map<qint64, std::vector<int>> m_cells;
+    std::vector<QRect> m_rects;
+};
+
+#endif // ANNOTATIONSPATIALINDEX_H
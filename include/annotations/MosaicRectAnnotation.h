@@ -46,10 +46,13 @@ private:
     mutable QPixmap m_renderedCache;
     mutable QRect m_cachedRect;
     mutable qreal m_cachedDpr = 0.0;
+    // Source pixels read by the effect kernels (shares the pixmap buffer on
+    // raster backends).
+    mutable QImage m_sourceImage;
 
+    const QImage& sourceImage() const;
     QImage applyPixelatedMosaic(qreal dpr) const;
     QImage applyGaussianBlur(qreal dpr) const;
-    QRgb calculateBlockAverageColor(const QImage& image, int x, int y, int blockW, int blockH) const;
 };
 
 #endif // MOSAICRECTANNOTATION_H
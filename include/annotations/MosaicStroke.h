@@ -46,18 +46,27 @@ private:
     BlurType m_blurType;
     qreal m_devicePixelRatio;
 
-    // Performance optimization: rendered result cache
-    mutable QPixmap m_renderedCache;
+    // Performance optimization: rendered result cache, extended incrementally
+    // as points are added. Covers m_cachedBounds in device pixels, which may
+    // be larger than boundingRect() so a growing stroke rarely reallocates.
+    mutable QImage m_renderedCache;
     mutable int m_cachedPointCount = 0;
     mutable QRect m_cachedBounds;
     mutable qreal m_cachedDpr = 0.0;
+    // Source pixels read by the effect kernels. On raster backends this
+    // shares the pixmap's buffer, so re-renders never copy or convert it.
+    mutable QImage m_sourceImage;
 
+    const QImage& sourceImage() const;
+    void invalidateRenderCache() const;
+    void growRenderCache(const QRect &bounds, qreal dpr) const;
+    // Renders points [firstPoint, end) and composites them into the cache
+    void renderPointsIntoCache(int firstPoint, qreal dpr) const;
+    QImage applyEffect(const QRect &rect) const;
     // Pixelated mosaic algorithm aligned to the source image grid
     QImage applyPixelatedMosaic(const QRect &strokeBounds) const;
     // Gaussian blur algorithm
     QImage applyGaussianBlur(const QRect &strokeBounds) const;
-    QRgb calculateBlockAverageColor(const QImage &image, int x, int y,
-                                     int blockW, int blockH) const;
 };
 
 #endif // MOSAICSTROKE_H
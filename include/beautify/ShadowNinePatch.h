@@ -0,0 +1,46 @@
+#ifndef SNAPTRAY_SHADOWNINEPATCH_H
+#define SNAPTRAY_SHADOWNINEPATCH_H
+
+#include <QColor>
+#include <QImage>
+#include <QRectF>
+
+class QPainter;
+
+// Gaussian drop shadows for rounded rectangles, drawn as a stretched
+// nine-patch.
+//
+// The shadow of a rounded rectangle only varies near its corners: past the
+// corner radius plus the blur reach, every row (or column) of an edge is the
+// same. So one small tile holding a blurred rounded rectangle is enough for
+// any size. Its corners are drawn as is and a one-pixel band through its
+// middle is stretched along the edges, which keeps drawing cost constant in
+// the size of the shadow.
+//
+// Tiles are rendered at the painter's device scale and cached process-wide,
+// keyed by corner radius, blur sigma, color and device scale, so repainting
+// with unchanged shadow settings never blurs again. The blur is a separable
+// Gaussian over a float plane; both passes run as column passes, using SSE2
+// on x86 and NEON on ARM, with a scalar fallback.
+
+namespace ShadowNinePatch {
+
+// Draws the shadow cast by a rounded rectangle: rect filled with color,
+// corners rounded by radius, blurred with a Gaussian of the given sigma.
+// Coordinates are in the painter's logical space. The shadow reaches about
+// 3 * sigma beyond rect.
+void draw(QPainter& painter, const QRectF& rect, qreal radius, qreal sigma, const QColor& color);
+
+// Blurs a Format_Alpha8 or Format_Grayscale8 image in place with a Gaussian
+// of the given sigma. Pixels outside the image count as zero. Other formats
+// and sigma below 0.5 leave the image unchanged.
+void blurAlpha(QImage& image, qreal sigma);
+
+// Number of tiles held by the cache, and an entry point for tests to start
+// from an empty cache.
+int cachedTileCount();
+void clearCache();
+
+} // namespace ShadowNinePatch
+
+#endif // SNAPTRAY_SHADOWNINEPATCH_H
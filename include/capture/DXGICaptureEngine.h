@@ -36,6 +36,8 @@ public:
     void stop() override;
     bool isRunning() const override;
     QImage captureFrame() override;
+    bool captureFrameInto(QImage &target) override;
+    bool writesInPlace() const override { return false; }
     QString engineName() const override;
 
     /**
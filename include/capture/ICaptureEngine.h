@@ -5,8 +5,11 @@
 #include <QRect>
 #include <QImage>
 #include <QList>
+#include <QRegion>
 #include <QString>
 
+#include <optional>
+
 class QScreen;
 
 /**
@@ -49,6 +52,7 @@ struct CaptureScreenInfo
  * - QtCaptureEngine: Cross-platform fallback using QScreen::grabWindow()
  * - SCKCaptureEngine: macOS ScreenCaptureKit (12.3+)
  * - DXGICaptureEngine: Windows Desktop Duplication API
+ * - X11CaptureEngine: X11 MIT-SHM, with XDamage when available
  */
 class ICaptureEngine : public QObject
 {
@@ -111,6 +115,34 @@ public:
      */
     virtual QImage captureFrame() = 0;
 
+    /**
+     * @brief Capture a frame into a caller-owned buffer
+     * @param target Reused between calls; reallocated only when the frame
+     *               size or format changes
+     * @return false if no frame is available (target is left untouched)
+     *
+     * The default copies the result of captureFrame() into target so the
+     * engine's own buffer is returned immediately. Engines whose captures
+     * are freshly allocated anyway may hand that allocation over instead.
+     */
+    virtual bool captureFrameInto(QImage &target);
+
+    /**
+     * @brief Whether captureFrameInto() writes into the target's pixels
+     *
+     * false for engines that hand over their own image, which replaces the
+     * target's buffer; callers then gain nothing from preallocating it.
+     */
+    virtual bool writesInPlace() const { return true; }
+
+    /**
+     * @brief Areas that changed in the most recent captured frame
+     * @return Changed areas in frame pixels (empty if the frame is identical
+     *         to the previous one), or std::nullopt if the engine does not
+     *         track changes and the whole frame must be treated as new
+     */
+    virtual std::optional<QRegion> lastDirtyRegion() const { return std::nullopt; }
+
     /**
      * @brief Get the name of this capture engine
      */
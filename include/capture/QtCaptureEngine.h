@@ -32,6 +32,8 @@ public:
     void stop() override;
     bool isRunning() const override;
     QImage captureFrame() override;
+    bool captureFrameInto(QImage &target) override;
+    bool writesInPlace() const override { return false; }
     QString engineName() const override { return QStringLiteral("Qt Screen Grab"); }
 
 private:
@@ -0,0 +1,55 @@
+#ifndef X11CAPTUREENGINE_H
+#define X11CAPTUREENGINE_H
+
+#include "ICaptureEngine.h"
+
+/**
+ * @brief Linux capture engine using the X11 MIT-SHM extension
+ *
+ * Grabs the capture region with XShmGetImage into a shared memory segment
+ * allocated once in start(), so a frame costs one server-side copy and one
+ * copy into the caller's buffer, with no per-frame allocation.
+ *
+ * When built with XDamage and the server supports it, the engine tracks
+ * damage on the root window: an unchanged region is not grabbed at all, and
+ * captureFrameInto() only rewrites the areas that changed since that buffer
+ * was last written, so callers rotating through a pool of buffers still get
+ * partial copies. The rewritten areas are reported through lastDirtyRegion().
+ *
+ * Falls back to XGetSubImage into a preallocated image when the segment
+ * cannot be attached (for example on a remote display).
+ *
+ * Like the other engines it captures whatever is on screen. Callers gate
+ * live pins and recording on PlatformCapabilities, since X11 cannot exclude
+ * SnapTray's own windows from the capture.
+ */
+class X11CaptureEngine : public ICaptureEngine
+{
+    Q_OBJECT
+
+public:
+    explicit X11CaptureEngine(QObject *parent = nullptr);
+    ~X11CaptureEngine() override;
+
+    bool setRegion(const QRect &region, QScreen *screen) override;
+    bool setRegion(const QRect &region, const CaptureScreenInfo &screenInfo) override;
+    bool start() override;
+    void stop() override;
+    bool isRunning() const override;
+    QImage captureFrame() override;
+    bool captureFrameInto(QImage &target) override;
+    std::optional<QRegion> lastDirtyRegion() const override;
+    QString engineName() const override;
+
+    /**
+     * @brief Check if a local X11 display with MIT-SHM and a 32-bit
+     *        TrueColor root visual is available
+     */
+    static bool isAvailable();
+
+private:
+    class Private;
+    Private *d;
+};
+
+#endif // X11CAPTUREENGINE_H
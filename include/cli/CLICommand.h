@@ -47,6 +47,28 @@ public:
      */
     virtual bool requiresGUI(const QCommandLineParser& /*parser*/) const { return false; }
 
+    /**
+     * @brief Whether a running main instance may execute this invocation
+     *
+     * Local commands that answer here are forwarded to the main instance
+     * when one is running, which executes them in-process and streams the
+     * result back; otherwise they run locally as usual.
+     * @param parser Parsed command line (allows checking options)
+     */
+    virtual bool canRunInMainInstance(const QCommandLineParser& /*parser*/) const { return false; }
+
+    /**
+     * @brief Output for an image the main instance captured for this invocation
+     *
+     * Called in the CLI process when the main instance hands the capture
+     * back through shared memory instead of as encoded bytes.
+     */
+    virtual CLIResult emitForwardedImage(const QCommandLineParser& /*parser*/,
+                                         const QImage& /*image*/) const
+    {
+        return CLIResult::error(CLIResult::Code::GeneralError, "Unexpected image from SnapTray");
+    }
+
     /**
      * @brief Whether to wait for response from main instance
      */
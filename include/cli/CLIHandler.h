@@ -18,6 +18,10 @@ namespace CLI {
  * Supports two execution modes:
  * 1. Local execution (full, screen, region - no GUI needed)
  * 2. IPC execution (gui, canvas, pin, config - sends to main instance)
+ *
+ * Local commands that allow it (captures to stdout) are forwarded to a
+ * running main instance, which captures in its warm process and streams
+ * the image back over the IPC connection.
  */
 class CLIHandler
 {
@@ -32,6 +36,15 @@ public:
      */
     CLIResult process(const QStringList& arguments);
 
+    /**
+     * @brief Execute a command line forwarded to the main instance
+     *
+     * Runs in-process; commands that do not allow it are rejected rather
+     * than forwarded again.
+     * @param arguments Command line arguments (including program name)
+     */
+    CLIResult processInMainInstance(const QStringList& arguments);
+
     /**
      * @brief Check if there are command line arguments
      */
@@ -48,6 +61,7 @@ public:
     static QString getVersionText();
 
 private:
+    CLIResult dispatch(const QStringList& arguments, bool inMainInstance);
     void registerCommands();
     CLICommand* findCommand(const QString& name) const;
 
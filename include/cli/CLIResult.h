@@ -2,8 +2,14 @@
 #define CLI_RESULT_H
 
 #include <QByteArray>
+#include <QImage>
 #include <QString>
 
+#include <functional>
+#include <utility>
+
+class QIODevice;
+
 namespace SnapTray {
 namespace CLI {
 
@@ -23,8 +29,15 @@ struct CLIResult
     Code code = Code::Success;
     QString message;
     QByteArray data; // For --raw output
+    // For --raw output written straight to stdout instead of via data.
+    // Returns false if writing failed part-way.
+    std::function<bool(QIODevice*)> writeData;
+    // The captured image behind writeData, so the main instance can hand
+    // it to a CLI client through shared memory instead of encoding it.
+    QImage image;
 
     bool isSuccess() const { return code == Code::Success; }
+    bool hasData() const { return !data.isEmpty() || writeData; }
 
     static CLIResult success(const QString& msg = QString())
     {
@@ -34,6 +47,11 @@ struct CLIResult
     static CLIResult error(Code code, const QString& msg) { return {code, msg, {}}; }
 
     static CLIResult withData(const QByteArray& data) { return {Code::Success, {}, data}; }
+
+    static CLIResult withDataWriter(std::function<bool(QIODevice*)> writer)
+    {
+        return {Code::Success, {}, {}, std::move(writer)};
+    }
 };
 
 } // namespace CLI
@@ -2,9 +2,13 @@
 #define CAPTURE_OUTPUT_HELPER_H
 
 #include "cli/CLIResult.h"
+#include "cli/RawImageWriter.h"
 
 #include <QString>
 
+#include <functional>
+
+class QCommandLineParser;
 class QPixmap;
 class QScreen;
 
@@ -17,6 +21,8 @@ struct CaptureOutputOptions
     QString outputFile;
     bool toClipboard = false;
     bool toRaw = false;
+    RawImageFormat rawFormat = RawImageFormat::Png;
+    bool rawHeader = false;
 };
 
 struct CaptureMetadata
@@ -25,12 +31,78 @@ struct CaptureMetadata
     QString captureType;
 };
 
+struct BurstOptions
+{
+    int count = 1;
+    int intervalMs = 0;
+};
+
+// Grabs one frame into *frame; returns the error to report on failure.
+using CaptureFrameFunction = std::function<CLIResult(QPixmap* frame)>;
+
 void applyOptionalDelay(int delayMs);
 CLIResult emitCaptureOutput(
     const QPixmap& screenshot,
     const CaptureOutputOptions& options,
     const CaptureMetadata& metadata = {});
 
+/**
+ * @brief Register --raw, --raw-format and --raw-header on a capture command
+ */
+void addRawOutputOptions(QCommandLineParser& parser);
+
+/**
+ * @brief Fill the raw output fields of options. --raw-format implies --raw.
+ * @return false with *error set on invalid input
+ */
+bool parseRawOutputOptions(const QCommandLineParser& parser,
+                           CaptureOutputOptions* options,
+                           CLIResult* error);
+
+/**
+ * @brief Whether a capture invocation can be served by the main instance
+ *
+ * True for an immediate single capture to stdout (--raw or --raw-format,
+ * no --delay, no burst): it needs no file paths or clipboard of the
+ * calling process and does not block the main instance.
+ */
+bool canCaptureInMainInstance(const QCommandLineParser& parser);
+
+/**
+ * @brief Raw output for an image the main instance captured and shared
+ *
+ * Encodes image to stdout in the --raw-format of this invocation.
+ */
+CLIResult emitForwardedCapture(const QCommandLineParser& parser, const QImage& image);
+
+/**
+ * @brief Register --count and --interval-ms on a capture command
+ */
+void addBurstOptions(QCommandLineParser& parser);
+
+/**
+ * @brief Read --count/--interval-ms. Bursts only save to files, so they are
+ * rejected together with --raw or --clipboard.
+ * @return false with *error set on invalid input
+ */
+bool parseBurstOptions(const QCommandLineParser& parser, BurstOptions* burst, CLIResult* error);
+
+/**
+ * @brief Capture burst.count frames, one every burst.intervalMs
+ *
+ * Frames are grabbed on the calling thread on a fixed schedule and encoded
+ * on a small worker pool, so a slow save does not push back the next grab.
+ * File names go through the filename template with {#} set to the frame
+ * number; with --output, "{#}" in the given name is replaced the same way
+ * and names without it get a "_<frame>" suffix. The result message lists
+ * per-frame capture and encode latency.
+ */
+CLIResult runCaptureBurst(
+    const BurstOptions& burst,
+    const CaptureFrameFunction& captureFrame,
+    const CaptureOutputOptions& options,
+    const CaptureMetadata& metadata = {});
+
 } // namespace CLI
 } // namespace SnapTray
 
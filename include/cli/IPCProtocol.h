@@ -5,6 +5,13 @@
 #include <QJsonObject>
 #include <QString>
 
+#include <deque>
+#include <map>
+#include <memory>
+
+class QIODevice;
+class QLocalSocket;
+
 namespace SnapTray {
 namespace CLI {
 
@@ -13,6 +20,17 @@ namespace CLI {
  */
 struct IPCMessage
 {
+    // Runs options["arguments"] (a CLI command line without the program
+    // name) inside the main instance and returns its output. With
+    // options["sharedMemory"], an image result comes back as a
+    // SharedImageDescriptor in IPCResponse::sharedImage.
+    static constexpr char kRunCommand[] = "run";
+    // Drops the shared image options["key"] of an earlier run response.
+    static constexpr char kReleaseCommand[] = "release";
+    // Streams the shared image options["key"] encoded as its run command
+    // asked, then drops it: for clients that cannot map the segment.
+    static constexpr char kStreamSharedCommand[] = "streamShared";
+
     QString command;
     QJsonObject options;
 
@@ -28,31 +46,164 @@ struct IPCResponse
     bool success = false;
     QString message;
     QString error;
+    int exitCode = 0;       // CLIResult::Code of a run request
+    bool hasData = false;   // Data frames follow this response
+    QJsonObject sharedImage;  // SharedImageDescriptor of a run request
     QByteArray data;
 
     QByteArray toJson() const;
     static IPCResponse fromJson(const QByteArray& data);
 };
 
+/**
+ * @brief One frame on the CLI <-> main instance socket
+ *
+ * Header (16 bytes, big-endian):
+ *   magic "STIP" (4) | version (1) | type (1) | flags (2) |
+ *   request id (4) | payload size (4)
+ *
+ * Command and Response payloads are compact JSON. A Response with the
+ * HasData flag is followed by Data frames carrying raw bytes for the same
+ * request id and one empty DataEnd frame. Request ids are chosen by the
+ * client, so several requests may be in flight on one connection.
+ */
+struct IPCFrame
+{
+    enum class Type : quint8 {
+        Command = 1,
+        Response = 2,
+        Data = 3,
+        DataEnd = 4,
+    };
+
+    enum Flag : quint16 {
+        HasData = 0x0001,   // Response: Data frames follow
+        Aborted = 0x0002,   // DataEnd: the sender failed part-way
+    };
+
+    static constexpr quint32 kMagic = 0x53544950;   // "STIP"
+    static constexpr quint8 kVersion = 2;           // 1 was bare length-prefixed JSON
+    static constexpr int kHeaderSize = 16;
+    static constexpr quint32 kMaxPayloadSize = 4 * 1024 * 1024;
+    static constexpr int kDataChunkSize = 256 * 1024;
+
+    Type type = Type::Command;
+    quint16 flags = 0;
+    quint32 requestId = 0;
+    QByteArray payload;
+
+    QByteArray encode() const;
+    static QByteArray encodeHeader(Type type, quint16 flags, quint32 requestId, quint32 payloadSize);
+
+    /**
+     * @brief Whether data (possibly only its first bytes) starts with the frame magic
+     */
+    static bool hasMagicPrefix(const QByteArray& data);
+};
+
+/**
+ * @brief Incremental IPCFrame parser over a byte stream
+ */
+class IPCFrameReader
+{
+public:
+    enum class Status {
+        Incomplete,
+        Ready,
+        Invalid,
+    };
+
+    void append(const QByteArray& data);
+
+    /**
+     * @brief Take the next complete frame
+     *
+     * Invalid (bad magic, unknown version or type, oversized payload) is
+     * final: the stream cannot be resynchronised.
+     */
+    Status next(IPCFrame* frame);
+
+private:
+    QByteArray m_buffer;
+    qsizetype m_offset = 0;
+};
+
+/**
+ * @brief Client end of a persistent connection to the main instance
+ *
+ * One connection carries any number of requests. post() only queues a
+ * request, so callers can pipeline several before reading; frames that
+ * arrive for other requests are kept until asked for.
+ */
+class IPCConnection
+{
+public:
+    IPCConnection();
+    ~IPCConnection();
+
+    bool connectToServer(const QString& serverName, int timeoutMs);
+    bool isConnected() const;
+    void close();
+
+    /**
+     * @brief Queue a command
+     * @return Its request id, or 0 if the connection is closed
+     */
+    quint32 post(const IPCMessage& message);
+
+    /**
+     * @brief Block until queued commands have been written
+     */
+    bool flush(int timeoutMs);
+
+    /**
+     * @brief Wait for the response to requestId
+     * @return false with errorString() set on timeout, disconnect or a bad frame
+     */
+    bool waitForResponse(quint32 requestId, IPCResponse* response, int timeoutMs);
+
+    /**
+     * @brief Copy the data of a HasData response into sink as it arrives
+     * @param timeoutMs Longest wait for any single frame
+     */
+    bool readData(quint32 requestId, QIODevice* sink, int timeoutMs);
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    bool readFrame(quint32 requestId, IPCFrame* frame, int timeoutMs);
+
+    std::unique_ptr<QLocalSocket> m_socket;
+    IPCFrameReader m_reader;
+    std::map<quint32, std::deque<IPCFrame>> m_pendingFrames;
+    quint32 m_nextRequestId = 1;
+    QString m_errorString;
+};
+
 /**
  * @brief IPC protocol handler for CLI communication
  */
 class IPCProtocol
 {
 public:
+    static constexpr int kConnectionTimeout = 1000;  // ms
+    static constexpr int kResponseTimeout = 30000;   // ms
+
     IPCProtocol();
     ~IPCProtocol();
 
     /**
      * @brief Check if main instance is running
+     *
+     * The probe connection is kept open and reused by sendCommand().
      */
-    bool isMainInstanceRunning() const;
+    bool isMainInstanceRunning();
 
     /**
      * @brief Send command to main instance
      * @param message Command message
      * @param waitResponse Whether to wait for response
-     * @return Response from main instance
+     * @return Response from main instance; streamed data is collected into data
      */
     IPCResponse sendCommand(const IPCMessage& message, bool waitResponse = false);
 
@@ -62,8 +213,9 @@ public:
     static QString getServerName();
 
 private:
-    static constexpr int kConnectionTimeout = 1000;  // ms
-    static constexpr int kResponseTimeout = 30000;   // ms
+    bool ensureConnected();
+
+    std::unique_ptr<IPCConnection> m_connection;
 };
 
 } // namespace CLI
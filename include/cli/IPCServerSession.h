@@ -0,0 +1,108 @@
+#ifndef IPC_SERVER_SESSION_H
+#define IPC_SERVER_SESSION_H
+
+#include "cli/CLIResult.h"
+#include "cli/IPCProtocol.h"
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+
+class QLocalSocket;
+class QSharedMemory;
+
+namespace SnapTray {
+namespace CLI {
+
+struct StreamState;
+
+/**
+ * @brief Main-instance end of a framed IPC connection
+ *
+ * Parses IPCFrame commands off one client socket for as long as the client
+ * keeps it open. Commands are dispatched one at a time in arrival order, so
+ * pipelined requests get their responses in order; a handler that spins the
+ * event loop does not start the next command early, and neither does one
+ * whose reply is still streaming.
+ *
+ * Images handed out through shared memory stay mapped until the client
+ * sends IPCMessage::kReleaseCommand or disconnects.
+ */
+class IPCServerSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param socket Connected client; the session takes ownership
+     * @param receivedData Bytes already read from socket
+     */
+    IPCServerSession(QLocalSocket* socket, const QByteArray& receivedData, QObject* parent = nullptr);
+    ~IPCServerSession() override;
+
+    /**
+     * @brief Dispatch commands already received; call once receivers are connected
+     */
+    void start();
+
+    /**
+     * @brief Send the response to requestId
+     * @param writeData If set, called on a pool thread with a device that
+     *        forwards everything written to it as Data frames after the
+     *        response. It must not touch objects owned by the GUI thread.
+     * @return false if the client went away; a failure in writeData is
+     *         reported to the client by an aborted DataEnd frame
+     */
+    bool sendResponse(quint32 requestId,
+                      const IPCResponse& response,
+                      const std::function<bool(QIODevice*)>& writeData = {});
+
+    /**
+     * @brief Send a CLI result, streaming its data if it has any
+     * @param preferSharedMemory Hand result.image over in a shared memory
+     *        segment instead, falling back to streaming if that fails. The
+     *        client can still ask for the stream of a published image with
+     *        IPCMessage::kStreamSharedCommand.
+     */
+    bool sendResult(quint32 requestId, const CLIResult& result, bool preferSharedMemory = false);
+
+signals:
+    void commandReceived(quint32 requestId, const QByteArray& commandData);
+
+private:
+    void readAvailable();
+    void dispatchFrames();
+    void finish();
+
+    void releaseSharedImage(const QString& key);
+    void streamSharedImage(quint32 requestId, const QString& key);
+
+    void writeStreamFrame(const QByteArray& frame);
+    void updateStreamBacklog();
+    void finishStream(bool ok);
+
+    QLocalSocket* m_socket = nullptr;
+    IPCFrameReader m_reader;
+    struct SharedImage
+    {
+        QString key;
+        std::unique_ptr<QSharedMemory> segment;
+        std::function<bool(QIODevice*)> writeData;   // Encodes the same image
+    };
+    std::deque<SharedImage> m_sharedImages;
+    std::shared_ptr<StreamState> m_stream;   // Set while a reply streams
+    quint32 m_streamRequestId = 0;
+    bool m_started = false;
+    bool m_dispatching = false;
+    bool m_finished = false;
+};
+
+} // namespace CLI
+} // namespace SnapTray
+
+#endif // IPC_SERVER_SESSION_H
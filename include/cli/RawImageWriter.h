@@ -0,0 +1,56 @@
+#ifndef RAW_IMAGE_WRITER_H
+#define RAW_IMAGE_WRITER_H
+
+#include <QString>
+
+#include <optional>
+
+class QImage;
+class QIODevice;
+
+namespace SnapTray {
+namespace CLI {
+
+/**
+ * @brief Encodings for --raw output on stdout
+ *
+ * Png is the default. Ppm (P6), Bmp (32-bit, bottom-up) and Rgba (bare
+ * RGBA8888 rows) need no compression and suit piping into image-diff tools
+ * or ffmpeg's rawvideo input. Qoi is a compact lossless format that is
+ * still much cheaper to encode than PNG.
+ */
+enum class RawImageFormat {
+    Png,
+    Ppm,
+    Bmp,
+    Qoi,
+    Rgba,
+};
+
+/**
+ * @brief Parse a --raw-format value (case-insensitive)
+ */
+std::optional<RawImageFormat> parseRawImageFormat(const QString& name);
+
+/**
+ * @brief Accepted --raw-format values, for help and error text
+ */
+QString rawImageFormatNames();
+
+/**
+ * @brief Write image to device in the given format
+ *
+ * Rows are converted and written one scanline (or a small batch) at a time,
+ * so the encoded image is never held in memory as a whole.
+ *
+ * @param withHeader For Rgba, first write one text line
+ *        "RGBA <width> <height> <stride>\n"; stride is in bytes. The other
+ *        formats carry their own headers and ignore it.
+ * @return false if the device rejected a write
+ */
+bool writeRawImage(const QImage& image, RawImageFormat format, bool withHeader, QIODevice* device);
+
+} // namespace CLI
+} // namespace SnapTray
+
+#endif // RAW_IMAGE_WRITER_H
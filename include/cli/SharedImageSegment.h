@@ -0,0 +1,77 @@
+#ifndef SHARED_IMAGE_SEGMENT_H
+#define SHARED_IMAGE_SEGMENT_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QJsonObject>
+#include <QString>
+
+#include <memory>
+
+class QSharedMemory;
+
+namespace SnapTray {
+namespace CLI {
+
+/**
+ * @brief Location and layout of an image in a shared memory segment
+ *
+ * Sent over IPC in place of the pixels. Row y starts at
+ * y * bytesPerLine from the start of the segment. The colour space travels
+ * as its ICC profile, so encoders on the client side can embed it.
+ */
+struct SharedImageDescriptor
+{
+    QString key;
+    int width = 0;
+    int height = 0;
+    qsizetype bytesPerLine = 0;
+    QImage::Format format = QImage::Format_Invalid;
+    qreal devicePixelRatio = 1.0;
+    QByteArray iccProfile;   // Empty when the image has no colour space
+
+    qsizetype byteCount() const { return bytesPerLine * height; }
+    bool isValid() const;
+
+    QJsonObject toJson() const;
+    static SharedImageDescriptor fromJson(const QJsonObject& json);
+};
+
+/**
+ * @brief Copy image into a new shared memory segment
+ * @param descriptor Filled in for the client on success
+ * @return The segment, readable by other processes while it lives; null on failure
+ */
+std::unique_ptr<QSharedMemory> publishSharedImage(const QImage& image,
+                                                  SharedImageDescriptor* descriptor);
+
+/**
+ * @brief Read-only mapping of a segment made by publishSharedImage()
+ */
+class SharedImageView
+{
+public:
+    SharedImageView();
+    ~SharedImageView();
+
+    bool attach(const SharedImageDescriptor& descriptor);
+
+    /**
+     * @brief The mapped pixels, wrapped without a copy
+     *
+     * Valid only while this view stays attached.
+     */
+    QImage image() const;
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    std::unique_ptr<QSharedMemory> m_segment;
+    SharedImageDescriptor m_descriptor;
+    QString m_errorString;
+};
+
+} // namespace CLI
+} // namespace SnapTray
+
+#endif // SHARED_IMAGE_SEGMENT_H
@@ -16,6 +16,9 @@ public:
     QString description() const override;
     void setupOptions(QCommandLineParser& parser) override;
     CLIResult execute(const QCommandLineParser& parser) override;
+    bool canRunInMainInstance(const QCommandLineParser& parser) const override;
+    CLIResult emitForwardedImage(const QCommandLineParser& parser,
+                                 const QImage& image) const override;
 };
 
 } // namespace CLI
@@ -0,0 +1,24 @@
+#ifndef TRIM_COMMAND_H
+#define TRIM_COMMAND_H
+
+#include "cli/CLICommand.h"
+
+namespace SnapTray {
+namespace CLI {
+
+/**
+ * @brief Trim an animated GIF or WebP without re-encoding
+ */
+class TrimCommand : public CLICommand
+{
+public:
+    QString name() const override;
+    QString description() const override;
+    void setupOptions(QCommandLineParser& parser) override;
+    CLIResult execute(const QCommandLineParser& parser) override;
+};
+
+} // namespace CLI
+} // namespace SnapTray
+
+#endif // TRIM_COMMAND_H
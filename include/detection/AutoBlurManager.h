@@ -50,6 +50,9 @@ public:
 
     /**
      * @brief Detect faces in the image.
+     *
+     * Faces found earlier in identical pixels with the same detector
+     * settings are returned from DetectionResultCache.
      * @param image Image to analyze
      * @return Detection result with regions
      */
@@ -80,7 +83,7 @@ public:
     /**
      * @brief Set options.
      */
-    void setOptions(const Options& options) { m_options = options; }
+    void setOptions(const Options& options);
 
     /**
      * @brief Convert blur intensity (1-100) to mosaic block size.
@@ -104,6 +107,11 @@ private:
     bool m_initialized = false;
     Options m_options;
 
+    /**
+     * @brief Hash of the face detector settings, part of the cache key.
+     */
+    quint64 detectionConfigHash() const;
+
     /**
      * @brief Apply Gaussian blur to a region.
      */
@@ -22,8 +22,14 @@ public:
      * @param blocks OCR text blocks with normalized geometry.
      * @param imageSize Source image size in pixels.
      * @return Pixel-space rectangles relative to the input image.
+     *
+     * Results are cached in DetectionResultCache under a hash of the blocks.
      */
     static QVector<QRect> detect(const QVector<OCRTextBlock>& blocks, const QSize& imageSize);
+
+private:
+    static QVector<QRect> detectUncached(const QVector<OCRTextBlock>& blocks,
+                                         const QSize& imageSize);
 };
 
 #endif // CREDENTIALDETECTOR_H
@@ -0,0 +1,146 @@
+#ifndef DETECTIONRESULTCACHE_H
+#define DETECTIONRESULTCACHE_H
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QtGlobal>
+
+#include <any>
+#include <array>
+
+/**
+ * @brief Process-wide cache of detection results keyed by image content.
+ *
+ * The same capture is often analysed several times: for toolbar hints, on
+ * export and again when it is reopened from history. Detectors look up a
+ * hash of the pixels plus a hash of their own configuration before doing
+ * any work, and store what they found afterwards.
+ *
+ * Entries are evicted least recently used first once their estimated size
+ * exceeds the memory cap. Results found under other detector settings never
+ * hit again, since the configuration hash is part of the key, and age out
+ * the same way. All methods are thread-safe.
+ */
+class DetectionResultCache
+{
+public:
+    enum class Kind {
+        Faces,
+        Barcode,
+        Credentials,
+        Count
+    };
+
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        int entries = 0;
+    };
+
+    static constexpr qint64 kDefaultMaxBytes = 4 * 1024 * 1024;
+
+    static DetectionResultCache& instance();
+
+    /**
+     * @brief Hash the visible pixels, size and format of an image.
+     *
+     * Content key of the cache; see ImageHash::hashPixels().
+     */
+    static quint64 hashImage(const QImage& image);
+
+    /**
+     * @brief Fold a value into a running configuration or content hash.
+     */
+    static quint64 combineHash(quint64 seed, quint64 value);
+
+    /**
+     * @brief Look up a previously stored result.
+     * @return true and fills result on a hit
+     */
+    template <typename T>
+    bool lookup(Kind kind, quint64 contentHash, quint64 configHash, T* result)
+    {
+        std::any value;
+        if (!lookupValue(kind, contentHash, configHash, &value)) {
+            return false;
+        }
+        const T* cached = std::any_cast<T>(&value);
+        if (!cached) {
+            return false;
+        }
+        *result = *cached;
+        return true;
+    }
+
+    /**
+     * @brief Store a result.
+     * @param costBytes Estimated memory held by the result
+     */
+    template <typename T>
+    void insert(Kind kind, quint64 contentHash, quint64 configHash, const T& result,
+                qint64 costBytes)
+    {
+        insertValue(kind, contentHash, configHash, std::any(result),
+                    costBytes + static_cast<qint64>(sizeof(T)));
+    }
+
+    /**
+     * @brief Drop every result of one kind.
+     */
+    void invalidate(Kind kind);
+
+    /**
+     * @brief Drop every result and reset the counters.
+     */
+    void clear();
+
+    /**
+     * @brief Hit and miss counts and live entries of one kind.
+     */
+    Stats stats(Kind kind) const;
+
+    /**
+     * @brief Estimated memory held by all cached results.
+     */
+    qint64 costBytes() const;
+
+    qint64 maxBytes() const;
+    void setMaxBytes(qint64 maxBytes);
+
+private:
+    struct Key {
+        Kind kind;
+        quint64 contentHash;
+        quint64 configHash;
+
+        bool operator==(const Key& other) const
+        {
+            return kind == other.kind && contentHash == other.contentHash
+                   && configHash == other.configHash;
+        }
+        friend size_t qHash(const Key& key, size_t seed = 0)
+        {
+            return qHashMulti(seed, static_cast<int>(key.kind), key.contentHash, key.configHash);
+        }
+    };
+
+    struct Counters {
+        quint64 hits = 0;
+        quint64 misses = 0;
+    };
+
+    DetectionResultCache();
+    DetectionResultCache(const DetectionResultCache&) = delete;
+    DetectionResultCache& operator=(const DetectionResultCache&) = delete;
+
+    bool lookupValue(Kind kind, quint64 contentHash, quint64 configHash, std::any* value);
+    void insertValue(Kind kind, quint64 contentHash, quint64 configHash, std::any value,
+                     qint64 costBytes);
+
+    mutable QMutex m_mutex;
+    QCache<Key, std::any> m_results;   // Cost in bytes
+    std::array<Counters, static_cast<size_t>(Kind::Count)> m_counters;
+};
+
+#endif // DETECTIONRESULTCACHE_H
@@ -2,13 +2,16 @@
 #define FACEDETECTOR_H
 
 #include <QImage>
+#include <QMutex>
 #include <QRect>
 #include <QVector>
 
 #include <memory>
+#include <vector>
 
 namespace cv {
 class CascadeClassifier;
+class FileStorage;
 }
 
 /**
@@ -16,6 +19,13 @@ class CascadeClassifier;
  *
  * Uses OpenCV's CascadeClassifier with the pre-trained
  * haarcascade_frontalface_default.xml model for offline face detection.
+ *
+ * Large captures are searched on a downscaled proxy sized so that a face of
+ * minFaceSize just fills the cascade window. The proxy is split into
+ * overlapping tiles that run on a private thread pool, with one extra pass
+ * over the whole proxy for faces too large for a tile. Detections are merged
+ * across tile seams and each one is then re-detected in a small window of
+ * the full-resolution image to recover exact bounds.
  */
 class FaceDetector
 {
@@ -28,6 +38,7 @@ public:
         int minNeighbors = 5;         ///< Higher values = fewer false positives
         int minFaceSize = 30;         ///< Minimum face size in pixels
         int maxFaceSize = 0;          ///< Maximum face size (0 = unlimited)
+        int tileSize = 640;           ///< Proxy tile edge for parallel search (0 = single pass)
     };
 
     FaceDetector();
@@ -48,7 +59,17 @@ public:
     Config config() const;
 
 private:
-    std::unique_ptr<cv::CascadeClassifier> m_classifier;
+    class ClassifierLease;
+
+    // CascadeClassifier keeps per-image scratch state, so every concurrent
+    // pass needs its own instance; idle ones are kept for the next call.
+    std::unique_ptr<cv::CascadeClassifier> acquireClassifier();
+    void releaseClassifier(std::unique_ptr<cv::CascadeClassifier> classifier);
+
+    std::unique_ptr<cv::FileStorage> m_cascade;
+    std::vector<std::unique_ptr<cv::CascadeClassifier>> m_idleClassifiers;
+    QMutex m_classifierMutex;
+    int m_windowSize = 0;
     bool m_initialized = false;
     Config m_config;
 };
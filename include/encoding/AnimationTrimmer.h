@@ -0,0 +1,77 @@
+#ifndef ANIMATIONTRIMMER_H
+#define ANIMATIONTRIMMER_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Lossless trim of animated GIF and WebP files at the container level
+ *
+ * Parses the GIF graphic control and image blocks, or the WebP ANMF chunks,
+ * and copies the frames shown inside [startMs, endMs) byte-for-byte. Only the
+ * delays of the first and last kept frames are rewritten, so the trimmed
+ * range plays with its original timing.
+ *
+ * A kept frame that only draws part of the canvas, or blends over it, needs
+ * the frames before it to look right. Such a frame is re-based: the animation
+ * is decoded up to it and the composited canvas is written as a full frame in
+ * its place. Re-basing continues until a frame leaves the canvas exactly as
+ * the original does, which for typical recordings is the first kept frame
+ * alone. Every later frame is copied untouched.
+ *
+ * No player or encoder is involved, so trimming is bound by file I/O and
+ * works headless on every platform.
+ */
+class AnimationTrimmer
+{
+public:
+    enum class Format {
+        Unknown,
+        Gif,
+        WebP
+    };
+
+    struct Result {
+        bool success = false;
+        QString errorMessage;
+        int framesWritten = 0;
+        int framesRebased = 0;  // Frames re-encoded from the decoded canvas
+        qint64 durationMs = 0;  // Playback length of the trimmed animation
+    };
+
+    /**
+     * @brief Identify an animation container from its leading bytes
+     */
+    static Format detectFormat(const QByteArray &header);
+
+    /**
+     * @brief Identify the container of a file from its leading bytes
+     */
+    static Format detectFileFormat(const QString &path);
+
+    /**
+     * @brief Trim an in-memory GIF or animated WebP
+     * @param input Complete file contents
+     * @param startMs Start of the kept range in milliseconds
+     * @param endMs End of the kept range in milliseconds (exclusive)
+     * @param output Receives the trimmed file, in the input's format
+     */
+    static Result trim(const QByteArray &input, qint64 startMs, qint64 endMs,
+                       QByteArray *output);
+
+    /**
+     * @brief Trim a GIF or animated WebP file
+     *
+     * The output is written atomically; on failure it is left untouched.
+     */
+    static Result trimFile(const QString &inputPath, const QString &outputPath,
+                           qint64 startMs, qint64 endMs);
+
+private:
+    static Result trimGif(const QByteArray &input, qint64 startMs, qint64 endMs,
+                          QByteArray *output);
+    static Result trimWebP(const QByteArray &input, qint64 startMs, qint64 endMs,
+                           QByteArray *output);
+};
+
+#endif // ANIMATIONTRIMMER_H
@@ -10,6 +10,7 @@
 #include <memory>
 
 #include "WatermarkRenderer.h"
+#include "encoding/FrameBufferPool.h"
 
 class IVideoEncoder;
 class NativeGifEncoder;
@@ -28,8 +29,13 @@ class QThread;
  * 2. Worker thread processes frames sequentially via processNextFrame()
  * 3. Results are emitted via signals back to UI thread
  *
+ * With configureFramePool(), the UI thread instead leases a pooled
+ * buffer, captures into it and submits it; the worker releases it after
+ * encoding. This path takes no lock and does not allocate per frame.
+ *
  * Thread safety:
  * - Frame queue is protected by mutex
+ * - Frame pool is lock-free with the UI thread as its only producer
  * - Encoders are owned and only accessed by the worker thread
  * - Audio samples pass through directly (encoder handles backpressure)
  */
@@ -97,6 +103,17 @@ public:
      */
     void setWatermarkSettings(const WatermarkRenderer::Settings& settings);
 
+    /**
+     * @brief Enable pooled frame submission
+     * @param frameSize Expected physical frame size
+     * @param capacity Number of buffers, 0 to size the pool from a memory budget
+     * @param preallocate Allocate the buffers up front; pass false when the
+     *                    capture engine replaces them (ICaptureEngine::writesInPlace())
+     *
+     * Buffers are allocated by start() and freed by stop() or destruction.
+     */
+    void configureFramePool(const QSize& frameSize, int capacity = 0, bool preallocate = true);
+
     // ========== Lifecycle ==========
 
     /**
@@ -126,6 +143,29 @@ public:
      */
     bool enqueueFrame(const FrameData& frame);
 
+    /**
+     * @brief Lease a pooled frame buffer (UI thread, non-blocking)
+     * @return Slot index, or -1 if not accepting frames or every buffer is
+     *         still queued for encoding (counted as a dropped frame)
+     */
+    int acquireFrameBuffer();
+
+    /**
+     * @brief Buffer of a leased slot, to be filled before submitFrameBuffer()
+     */
+    QImage& frameBuffer(int slot) { return m_framePool.image(slot); }
+
+    /**
+     * @brief Queue a filled buffer for encoding
+     * @return true if queued; otherwise the lease is returned to the pool
+     */
+    bool submitFrameBuffer(int slot, qint64 timestampMs);
+
+    /**
+     * @brief Return a leased buffer without encoding it (e.g. capture failed)
+     */
+    void cancelFrameBuffer(int slot);
+
     /**
      * @brief Write audio samples to encoder
      * @param data PCM audio data
@@ -142,6 +182,7 @@ public:
     bool isProcessing() const;
     bool isRunning() const { return m_running.load(); }
     qint64 framesWritten() const { return m_framesWritten.load(); }
+    FrameBufferPool::Stats framePoolStats() const { return m_framePool.stats(); }
 
 signals:
     /**
@@ -176,8 +217,14 @@ private:
     void scheduleProcessing();
     void processNextFrame();
     void doProcessFrame(const FrameData& frameData);
+    void encodeFrame(QImage& frame, qint64 timestampMs);
+    bool hasPendingWork() const;
+    void notifyQueueLow(int depth, int maxDepth);
     void handleProcessingFailure(const QString& context, const QString& details);
     void applyWatermark(QImage& frame);
+    void writeAnimationFrame(const QImage& frame, qint64 timestampMs);
+    void updatePreviousFrame(const QImage& frame, const QRect& changedRect);
+    void flushSkippedFrames();
     void finishEncoder();
 
     // Encoders (owned, accessed only by worker thread)
@@ -191,6 +238,14 @@ private:
     QQueue<FrameData> m_frameQueue;
     static constexpr int MAX_QUEUE_SIZE = 30;  // ~1 second at 30fps
 
+    // Pooled frames (lock-free, UI thread produces, worker thread consumes)
+    FrameBufferPool m_framePool;
+    QSize m_framePoolFrameSize;
+    int m_framePoolCapacity = 0;
+    bool m_framePoolPreallocate = true;
+    static constexpr qint64 FRAME_POOL_BUDGET_BYTES = 256LL * 1024 * 1024;
+    static constexpr int MIN_FRAME_POOL_SIZE = 4;
+
     // Audio queue (thread-safe, shared mutex with frame queue)
     QQueue<AudioData> m_audioQueue;
     static constexpr int MAX_AUDIO_QUEUE_SIZE = 100;  // ~1 second buffer
@@ -202,7 +257,13 @@ private:
     std::atomic<bool> m_finishRequested{false};
     std::atomic<qint64> m_framesWritten{0};
     std::atomic<bool> m_finishCalled{false};
-    bool m_wasNearFull = false;
+    std::atomic<bool> m_wasNearFull{false};
+
+    // GIF/WebP delta state: frames identical to the last written one are
+    // skipped and extend its display time instead. The worker owns this copy;
+    // sharing a pooled buffer would make the next capture into it detach.
+    QImage m_previousFrame;
+    qint64 m_lastSkippedTimestampMs = -1;  // -1 when no frame was skipped
 
     // Configuration
     WatermarkRenderer::Settings m_watermarkSettings;
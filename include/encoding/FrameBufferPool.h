@@ -0,0 +1,133 @@
+#ifndef FRAMEBUFFERPOOL_H
+#define FRAMEBUFFERPOOL_H
+
+#include <QImage>
+#include <QSize>
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief Fixed set of recording frame buffers passed between two threads
+ *
+ * The capture side leases a free buffer, fills it in place and publishes it
+ * with a timestamp. The encoding side takes published buffers in order and
+ * releases them once encoded. Slot indices travel through two
+ * single-producer/single-consumer rings, so neither side locks or allocates
+ * per frame and memory use is bounded by the pool capacity.
+ *
+ * Thread roles:
+ * - Producer: acquire(), image() on a leased slot, publish(), cancel()
+ * - Consumer: takeReady(), image() on a taken slot, release(), drain()
+ * - reset() only while neither side is active
+ *
+ * Buffers are plain QImages. If the consumer passes one to code that keeps a
+ * reference (an encoder holding the previous frame), the next capture into
+ * that slot detaches it, so sharing stays correct at the cost of one
+ * allocation.
+ */
+class FrameBufferPool
+{
+public:
+    struct Stats {
+        int capacity = 0;
+        int inFlight = 0;       // Leased by the producer or waiting for the consumer
+        int peakInFlight = 0;
+        qint64 published = 0;
+        qint64 dropped = 0;     // acquire() found every buffer in flight
+    };
+
+    FrameBufferPool() = default;
+    FrameBufferPool(const FrameBufferPool&) = delete;
+    FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+    /**
+     * @brief Reallocate the pool and reset all counters
+     * @param capacity Number of buffers, 0 releases all memory
+     * @param frameSize Expected frame size; buffers adapt if frames differ
+     */
+    void reset(int capacity, const QSize& frameSize,
+               QImage::Format format = QImage::Format_RGB32);
+
+    int capacity() const { return static_cast<int>(m_slots.size()); }
+
+    // ========== Producer ==========
+
+    /**
+     * @brief Lease a free buffer
+     * @return Slot index, or -1 when every buffer is in flight (counted as a drop)
+     */
+    int acquire();
+
+    /**
+     * @brief Hand a filled buffer to the consumer
+     */
+    void publish(int slot, qint64 timestampMs);
+
+    /**
+     * @brief Return a leased buffer without publishing it
+     */
+    void cancel(int slot);
+
+    // ========== Consumer ==========
+
+    /**
+     * @brief Take the oldest published buffer
+     * @return false when nothing is waiting
+     */
+    bool takeReady(int& slot, qint64& timestampMs);
+
+    /**
+     * @brief Return a taken buffer to the free list
+     */
+    void release(int slot);
+
+    /**
+     * @brief Release every published buffer without processing it
+     * @return Number of buffers discarded
+     */
+    int drain();
+
+    /**
+     * @brief Number of published buffers waiting for the consumer
+     */
+    int readyCount() const { return m_ready.size(); }
+
+    QImage& image(int slot) { return m_slots[static_cast<size_t>(slot)].image; }
+
+    Stats stats() const;
+
+private:
+    // Ring of slot indices with one pushing and one popping thread. Every
+    // slot is in at most one ring at a time, so a ring sized to the pool
+    // never overflows.
+    class IndexRing
+    {
+    public:
+        void reset(int capacity);
+        void push(int value);
+        bool pop(int& value);
+        int size() const;
+
+    private:
+        std::vector<int> m_items;
+        std::atomic<size_t> m_head{0};  // Next position to pop
+        std::atomic<size_t> m_tail{0};  // Next position to push
+    };
+
+    struct Slot {
+        QImage image;
+        qint64 timestampMs = 0;
+    };
+
+    std::vector<Slot> m_slots;
+    IndexRing m_free;    // Consumer -> producer
+    IndexRing m_ready;   // Producer -> consumer
+    int m_spareSlot = -1;  // Cancelled lease, reused by the next acquire() (producer only)
+
+    std::atomic<int> m_inFlight{0};
+    std::atomic<int> m_peakInFlight{0};
+    std::atomic<qint64> m_published{0};
+    std::atomic<qint64> m_dropped{0};
+};
+
+#endif // FRAMEBUFFERPOOL_H
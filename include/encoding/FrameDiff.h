@@ -0,0 +1,23 @@
+#ifndef SNAPTRAY_FRAMEDIFF_H
+#define SNAPTRAY_FRAMEDIFF_H
+
+#include <QImage>
+#include <QRect>
+
+// Change detection between consecutive recording frames.
+//
+// Rows are compared 16 bytes at a time (SSE2 on x86, NEON on ARM, scalar
+// fallback), and only the rows inside the changed band are scanned for the
+// left/right extent.
+
+namespace FrameDiff {
+
+// Returns the bounding rectangle of the pixels that differ between previous
+// and current, or a null rect when the frames are identical. Frames that
+// cannot be compared (null previous, different size or format, not 32 bits
+// per pixel) report current.rect().
+QRect changedRect(const QImage& previous, const QImage& current);
+
+} // namespace FrameDiff
+
+#endif // SNAPTRAY_FRAMEDIFF_H
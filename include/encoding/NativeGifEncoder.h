@@ -3,8 +3,14 @@
 
 #include <QObject>
 #include <QImage>
+#include <QRect>
 #include <QSize>
 #include <QString>
+#include <QThreadPool>
+
+#include <deque>
+#include <memory>
+#include <vector>
 
 /**
  * @brief Native GIF encoder using msf_gif library
@@ -14,6 +20,10 @@
  * - Per-frame variable delay (fixes audio/video sync issues)
  * - Automatic palette optimization
  * - Incremental encoding with good memory efficiency
+ * - Quantization and LZW compression run on a thread pool, several frames
+ *   in flight, while frames are appended to the output in submission order
+ * - Frames can be restricted to the rectangle that changed since the previous
+ *   one, which is all that gets quantized and stored
  */
 class NativeGifEncoder : public QObject
 {
@@ -36,11 +46,16 @@ public:
      * @brief Write a frame
      * @param frame Frame image (any format, will be converted to RGBA)
      * @param timestampMs Timestamp from recording start (milliseconds)
+     * @param changedRect Area that differs from the previously written frame,
+     *        or a null rect to store the whole frame
      *
      * Uses timestamp to calculate per-frame delay, fixing sync issues
-     * that occurred with FFmpeg's fixed frame rate approach.
+     * that occurred with FFmpeg's fixed frame rate approach. A frame is held
+     * until the next one arrives, so it is shown until that frame's
+     * timestamp; the last frame gets the base frame rate delay.
      */
-    void writeFrame(const QImage &frame, qint64 timestampMs = -1);
+    void writeFrame(const QImage &frame, qint64 timestampMs = -1,
+                    const QRect &changedRect = QRect());
 
     /**
      * @brief Finish encoding and write to file
@@ -65,14 +80,35 @@ public:
     void setMaxBitDepth(int depth);
     int maxBitDepth() const { return m_maxBitDepth; }
 
+    /**
+     * @brief Quantize every frame to the same fixed palette
+     * @param enabled Takes effect for frames written after the call
+     *
+     * Skips the per-frame palette search and lets all frames quantize in
+     * parallel. Because frames always share a palette, unchanged pixels are
+     * encoded as transparent. Limited to 128 colors, so best suited to UI
+     * recordings rather than video or photos.
+     */
+    void setSharedPalette(bool enabled);
+    bool sharedPalette() const { return m_sharedPalette; }
+
 signals:
     void finished(bool success, const QString &outputPath);
     void error(const QString &message);
     void progress(qint64 framesWritten);
 
 private:
+    struct FrameScratch;
+    struct FrameJob;
+
     void cleanup();
-    int calculateCentiseconds(qint64 timestampMs);
+    int calculateCentiseconds(qint64 nextTimestampMs);
+    void submitFrame(const QImage &frame, const QRect &rect, int centiSeconds);
+    std::shared_ptr<FrameScratch> acquireScratch();
+    // Appends finished frames in order, waiting until at most maxPending remain
+    void collectEncodedFrames(size_t maxPending);
+    void appendEncodedFrame(FrameJob &job);
+    void discardPendingFrames();
 
     void *m_gifState;  // Opaque pointer to MsfGifState
     QString m_outputPath;
@@ -82,10 +118,19 @@ private:
     qint64 m_framesWritten;
     int m_consecutiveFailures;  // Track consecutive frame encoding failures
     int m_maxConsecutiveFailures;  // Configurable threshold
-    qint64 m_lastTimestampMs;
+    qint64 m_lastTimestampMs;  // Timestamp of the held frame
+    QImage m_heldFrame;  // Submitted once the next timestamp gives its delay
+    QRect m_heldRect;
+    QRect m_appendedRect;  // Area of the last frame in the output list
     QString m_lastError;
     bool m_running;
     bool m_aborted;
+    bool m_sharedPalette;
+
+    QThreadPool m_pool;
+    std::vector<std::shared_ptr<FrameScratch>> m_scratchPool;
+    std::deque<std::shared_ptr<FrameJob>> m_pendingFrames;
+    std::shared_ptr<FrameJob> m_previousJob;  // Reference frame for the next job
 };
 
 #endif // NATIVEGIFENCODER_H
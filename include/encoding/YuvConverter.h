@@ -0,0 +1,32 @@
+#ifndef SNAPTRAY_YUVCONVERTER_H
+#define SNAPTRAY_YUVCONVERTER_H
+
+#include <QImage>
+
+// RGB to YUV conversion for video encoders that take planar input.
+//
+// Output is BT.709 limited range (the matrix players assume for HD content)
+// with 8-bit fixed-point coefficients. Rows are converted 8 pixels at a time
+// with SSE2 on x86 and NEON on ARM, with a scalar fallback that produces
+// identical results.
+
+namespace YuvConverter {
+
+struct I420Planes {
+    uchar* y = nullptr;
+    int yStride = 0;
+    uchar* u = nullptr;
+    int uStride = 0;
+    uchar* v = nullptr;
+    int vStride = 0;
+};
+
+// Converts a Format_RGB32 or Format_ARGB32 image to I420. Alpha is ignored.
+// The Y plane holds image.width() x image.height() samples, U and V hold one
+// sample per 2x2 block (rounded up), computed from the block's rounded
+// average color. Odd edges repeat the last row or column.
+void bgraToI420(const QImage& image, const I420Planes& planes);
+
+} // namespace YuvConverter
+
+#endif // SNAPTRAY_YUVCONVERTER_H
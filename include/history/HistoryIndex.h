@@ -0,0 +1,55 @@
+#pragma once
+
+#include "history/HistoryStore.h"
+
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+#include <optional>
+
+namespace SnapTray {
+
+// Append-only binary index of the history entries directory. Each record
+// holds everything HistoryEntry needs, so listing history reads one mapped
+// file instead of parsing every entry's manifest. Records are length-prefixed
+// and checksummed; a truncated or damaged file reads as missing and the
+// caller rebuilds it from the manifests.
+//
+// The header stores the entries directory's modification time as of the
+// last update. A mismatch means entries were added or removed without going
+// through the index, which also calls for a rebuild. The stamp has the
+// filesystem's timestamp granularity, so an outside change landing in the
+// same tick as an index update goes unnoticed until the next one.
+namespace HistoryIndex {
+
+struct Contents
+{
+    QList<HistoryEntry> entries;   // Live entries in record order
+    qint64 directoryStamp = 0;
+    int obsoleteRecords = 0;       // Removals and superseded additions
+};
+
+// Modification time of entriesRoot in ms, or 0 if it does not exist.
+qint64 directoryStamp(const QString& entriesRoot);
+
+// Stamp stored in the index header, or nullopt if the file is missing or
+// not an index.
+std::optional<qint64> readStamp(const QString& indexPath);
+
+// Maps and parses the whole index. Entry paths are resolved against
+// entriesRoot/<id>.
+std::optional<Contents> read(const QString& indexPath, const QString& entriesRoot);
+
+// Replaces the index with exactly these entries.
+bool write(const QString& indexPath, const QList<HistoryEntry>& entries, qint64 directoryStamp);
+
+// Appends one record and moves the header to the new stamp.
+bool appendEntry(const QString& indexPath, const HistoryEntry& entry, qint64 directoryStamp);
+bool appendRemoval(const QString& indexPath, const QString& id, qint64 directoryStamp);
+
+// Moves the header to a new stamp without adding a record.
+bool updateStamp(const QString& indexPath, qint64 directoryStamp);
+
+} // namespace HistoryIndex
+
+} // namespace SnapTray
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QImage>
+#include <QString>
+
+namespace SnapTray {
+
+// Lossless codec for the full-resolution canvas kept with each history
+// entry. The canvas is written on every capture and read only on replay, so
+// the format trades size for speed. Pixels are QOI-coded (run, index, delta
+// and literal ops) straight from the QImage's scanlines. Rows are split into
+// bands with independent coder state, so encoding and decoding both run on
+// several threads.
+//
+// File layout (little endian): "STSN" magic, version, pixel format, width,
+// height, device pixel ratio, ICC profile size, band height, band count,
+// then each band's byte size, the ICC profile and the band streams.
+//
+// read() also accepts anything QImageReader does, so entries written as PNG
+// before this format existed keep loading.
+namespace HistorySnapshotCodec {
+
+enum class Format {
+    Png,    // Portable, slow; for callers that hand the file elsewhere
+    Qoi,    // Banded QOI with the header above
+};
+
+// File name suffix, without the dot, for files written in format.
+QString fileSuffix(Format format);
+
+// Writes atomically: on failure the previous file, if any, is untouched.
+bool write(const QImage& image, const QString& filePath, Format format,
+           QString* errorMessage = nullptr);
+
+// Decodes a snapshot into a new image with its device pixel ratio and color
+// space restored. Falls back to QImageReader for other files.
+QImage read(const QString& filePath, QString* errorMessage = nullptr);
+
+// Codec-only entry points, for tests and in-memory use.
+QByteArray encodeQoi(const QImage& image);
+QImage decodeQoi(const uchar* data, qsizetype size, QString* errorMessage = nullptr);
+
+} // namespace HistorySnapshotCodec
+
+} // namespace SnapTray
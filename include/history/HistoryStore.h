@@ -1,5 +1,6 @@
 #pragma once
 
+#include "history/HistorySnapshotCodec.h"
 #include "region/MultiRegionManager.h"
 
 #include <QByteArray>
@@ -47,11 +48,17 @@ struct CaptureSessionWriteRequest
     int cornerRadius = 0;
     int maxEntries = 20;
     QDateTime createdAt = QDateTime::currentDateTime();
+    // Codec for canvasImage, which is only read back for replay.
+    HistorySnapshotCodec::Format canvasFormat = HistorySnapshotCodec::Format::Qoi;
 };
 
 class HistoryStore
 {
 public:
+    // Long edge, in pixels, of the thumbnail written next to each capture.
+    // Large enough to fill a history grid card on a 2x display.
+    static constexpr int kThumbnailMaxEdge = 640;
+
     static QString historyRootPath();
     static QString entriesRootPath();
     static QList<HistoryEntry> loadEntries();
@@ -59,8 +66,18 @@ public:
     static std::optional<HistoryEntry> writeCaptureSession(const CaptureSessionWriteRequest& request);
     static bool deleteEntry(const HistoryEntry& entry);
 
+    // Image to show for an entry in the history list: its thumbnail, or the
+    // full result for entries small enough (or old enough) not to have one.
+    // Empty if the id doesn't name an entry directory.
+    static QString thumbnailSourcePath(const QString& id);
+
+    // Discards the binary index so the next loadEntries() rescans every
+    // manifest. Needed after editing entry files outside HistoryStore.
+    static void invalidateIndex();
+
 private:
     static std::optional<HistoryEntry> loadEntryFromDirectory(const QString& entryDirectory);
+    static QList<HistoryEntry> scanEntryDirectories();
 };
 
 } // namespace SnapTray
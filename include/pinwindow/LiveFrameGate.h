@@ -0,0 +1,59 @@
+#ifndef LIVEFRAMEGATE_H
+#define LIVEFRAMEGATE_H
+
+#include <QRegion>
+#include <QtGlobal>
+
+#include <optional>
+
+class QImage;
+
+struct LiveFrameStats
+{
+    quint64 captured = 0;
+    quint64 skipped = 0;
+    quint64 painted = 0;
+};
+
+// Decides which live capture frames are worth repainting and how long to
+// wait before polling again. Unchanged frames are detected from the engine's
+// dirty region when it reports one, otherwise from the image cache key and a
+// hash of the pixel rows, so no previous frame is kept alive.
+class LiveFrameGate
+{
+public:
+    // Consecutive unchanged frames polled at the full rate before backing off.
+    static constexpr int kIdleFramesBeforeBackoff = 8;
+    // Upper bound for the idle polling interval, unless the base is slower.
+    static constexpr int kMaxIdleIntervalMs = 500;
+
+    // Forgets the last frame and the stats, keeping the base interval.
+    void reset();
+
+    // Sets the polling interval for changing content and drops any back-off.
+    void setBaseInterval(int intervalMs);
+    int baseIntervalMs() const { return m_baseIntervalMs; }
+
+    // Records a captured frame. Returns true if it differs from the last
+    // painted frame and should be painted.
+    bool submitFrame(const QImage& frame, const std::optional<QRegion>& dirtyRegion);
+
+    // Interval to use for the next poll.
+    int intervalMs() const { return m_intervalMs; }
+
+    const LiveFrameStats& stats() const { return m_stats; }
+
+private:
+    bool frameChanged(const QImage& frame, const std::optional<QRegion>& dirtyRegion);
+
+    LiveFrameStats m_stats;
+    bool m_hasFrame = false;
+    bool m_hasHash = false;
+    qint64 m_lastCacheKey = 0;
+    quint64 m_lastHash = 0;
+    int m_idleFrames = 0;
+    int m_baseIntervalMs = 1000 / 15;
+    int m_intervalMs = 1000 / 15;
+};
+
+#endif // LIVEFRAMEGATE_H
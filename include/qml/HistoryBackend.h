@@ -2,9 +2,14 @@
 
 #include "history/HistoryStore.h"
 
+#include <QCache>
+#include <QFuture>
+#include <QHash>
+#include <QImage>
 #include <QObject>
 #include <QPointer>
 #include <QPixmap>
+#include <QTimer>
 #include <QWindow>
 #include <functional>
 
@@ -33,18 +38,29 @@ public:
     Q_INVOKABLE void deleteEntry(int index);
     Q_INVOKABLE void openHistoryFolder();
 
+    // Hover hint: decodes the entry's full image in the background so a
+    // following copy, save or pin doesn't decode it on the GUI thread.
+    Q_INVOKABLE void prefetch(int index);
+
 signals:
     void toastRequested(int level, const QString& title, const QString& message);
     void closeRequested();
 
 private:
-    bool loadPixmap(const HistoryEntry& entry, QPixmap* pixmapOut) const;
+    bool loadPixmap(const HistoryEntry& entry, QPixmap* pixmapOut);
+    void startPrefetch();
+    QImage takeDecodedImage(const QString& path);
     void showError(const QString& title, const QString& message);
 
     HistoryModel* m_model = nullptr;
     PinWindowManager* m_pinWindowManager = nullptr;
     std::function<bool(const QString&)> m_startReplay;
     QPointer<QWindow> m_hostWindow;
+
+    QTimer m_prefetchTimer;
+    int m_prefetchIndex = -1;
+    QHash<QString, QFuture<QImage>> m_pendingDecodes;
+    QCache<QString, QImage> m_decodedImages;   // Cost in KiB
 };
 
 } // namespace SnapTray
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QQuickAsyncImageProvider>
+#include <QString>
+#include <QThreadPool>
+#include <memory>
+
+namespace SnapTray {
+
+// Serves history thumbnails as "image://history/<entry id>". Decoding runs
+// on a private thread pool so scrolling the history grid never waits on
+// PNG decodes, and recently shown thumbnails stay in an LRU cache bounded
+// by pixel memory.
+class HistoryImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    static constexpr auto kProviderId = "history";
+
+    HistoryImageProvider();
+    ~HistoryImageProvider() override;
+
+    QQuickImageResponse* requestImageResponse(const QString& id, const QSize& requestedSize) override;
+
+    static QString urlForEntry(const QString& entryId);
+
+    class ThumbnailCache
+    {
+    public:
+        explicit ThumbnailCache(qint64 maxBytes);
+
+        bool lookup(const QString& id, QImage* image);
+        void insert(const QString& id, const QImage& image);
+
+    private:
+        QMutex m_mutex;
+        QCache<QString, QImage> m_images;   // Cost in KiB
+    };
+
+private:
+    std::shared_ptr<ThumbnailCache> m_cache;
+    QThreadPool m_pool;
+};
+
+} // namespace SnapTray
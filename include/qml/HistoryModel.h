@@ -53,7 +53,12 @@ public:
 
     explicit HistoryModel(QObject* parent = nullptr);
 
+    // Rows are exposed a page at a time; views pull the rest through
+    // fetchMore() as they scroll, so large histories don't build every
+    // delegate up front.
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
     int totalCount() const;
     int filterCountsRevision() const;
     QVariant data(const QModelIndex& index, int role) const override;
@@ -70,10 +75,12 @@ public:
     void setSortOrder(SortOrder sortOrder);
 
     void refresh();
+    // Lookups cover every entry that passes the filter, loaded or not.
+    // indexOfId() loads rows up to the one it returns.
     HistoryEntry entryAt(int index) const;
 
     Q_INVOKABLE int countForFilter(Filter filter) const;
-    Q_INVOKABLE int indexOfId(const QString& id) const;
+    Q_INVOKABLE int indexOfId(const QString& id);
     Q_INVOKABLE QString idAt(int index) const;
 
 signals:
@@ -84,7 +91,8 @@ signals:
     void sortOrderChanged();
 
 private:
-    void rebuildVisibleEntries();
+    void rebuildVisibleEntries(int loadedCount);
+    void loadRowsThrough(int row);
     bool matchesFilter(const HistoryEntry& entry, Filter filter) const;
     QString capturedAtText(const HistoryEntry& entry) const;
     QString displayTitle(const HistoryEntry& entry) const;
@@ -97,6 +105,7 @@ private:
 
     QList<HistoryEntry> m_allEntries;
     QList<HistoryEntry> m_entries;
+    int m_loadedCount = 0;
     int m_filterCountsRevision = 0;
     Filter m_activeFilter = AllScreenshots;
     SortOrder m_sortOrder = NewestFirst;
@@ -30,7 +30,7 @@ public:
     bool loadShadowEnabled() const;
     void saveShadowEnabled(bool enabled);
 
-    // Max history entries (5 - 200)
+    // Max history entries (5 - 2000)
     int loadMaxCacheFiles() const;
     void saveMaxCacheFiles(int maxFiles);
 
@@ -0,0 +1,20 @@
+#ifndef SNAPTRAY_IMAGEHASH_H
+#define SNAPTRAY_IMAGEHASH_H
+
+#include <QtGlobal>
+
+class QImage;
+
+// Content hash of an image, for caches and change detection that compare
+// whole frames.
+
+namespace ImageHash {
+
+// Hashes the visible pixels, size and format of image. Every scanline is
+// hashed, so any edit gives a different value; row padding is skipped.
+// Returns 0 for a null image.
+quint64 hashPixels(const QImage& image);
+
+} // namespace ImageHash
+
+#endif // SNAPTRAY_IMAGEHASH_H
@@ -6,6 +6,7 @@
 #include <QPixmap>
 #include <QString>
 
+class QSaveFile;
 class QScreen;
 
 class ImageSaveUtils
@@ -16,21 +17,34 @@ public:
         QString stage; // open / format / write / commit
     };
 
+    // Speed/size trade-off for PNG output; ignored for other formats.
+    // Balanced matches Qt's default level.
+    enum class PngCompression {
+        Fastest,    // Internal files rewritten often (history)
+        Balanced,
+        Smallest,   // Files handed to the user
+    };
+
     static bool saveImageAtomically(const QImage& image,
                                     const QString& filePath,
                                     const QByteArray& explicitFormat = QByteArray(),
-                                    Error* error = nullptr);
+                                    Error* error = nullptr,
+                                    PngCompression pngCompression = PngCompression::Balanced);
 
     static bool savePixmapAtomically(const QPixmap& pixmap,
                                      const QString& filePath,
                                      const QByteArray& explicitFormat = QByteArray(),
                                      Error* error = nullptr,
-                                     QScreen* sourceScreen = nullptr);
+                                     QScreen* sourceScreen = nullptr,
+                                     PngCompression pngCompression = PngCompression::Balanced);
+
+    static int pngCompressionLevel(PngCompression compression);
 
 private:
     static QByteArray resolveFormat(const QString& filePath,
                                     const QByteArray& explicitFormat,
                                     Error* error);
+    static bool commit(QSaveFile& saveFile, Error* error);
     static void setError(Error* error, const QString& stage, const QString& message);
 };
 
@@ -0,0 +1,35 @@
+#ifndef SNAPTRAY_PARALLELPNGWRITER_H
+#define SNAPTRAY_PARALLELPNGWRITER_H
+
+#include <QImage>
+#include <QString>
+
+class QIODevice;
+
+// PNG encoder for large 8-bit RGB/RGBA images.
+//
+// The image is split into bands of rows. Each band is filtered and deflated
+// on its own thread, primed with the previous band's last 32 KiB so matches
+// can reach across the seam. Bands end on a sync flush, so they concatenate
+// into a single zlib stream and the output is one ordinary PNG. Bands are
+// encoded a window at a time and written out in order, so memory use is
+// bounded by the thread count rather than the image size.
+// Needs zlib at build time; isAvailable() reports whether it was found.
+
+namespace ParallelPngWriter {
+
+bool isAvailable();
+
+// True for the 24/32-bit formats the writer handles. Other formats should
+// go through QImageWriter.
+bool canWrite(const QImage& image);
+
+// compressionLevel is a zlib level, 0 (store) to 9 (smallest).
+bool write(const QImage& image,
+           QIODevice* device,
+           int compressionLevel,
+           QString* errorMessage = nullptr);
+
+} // namespace ParallelPngWriter
+
+#endif // SNAPTRAY_PARALLELPNGWRITER_H
@@ -0,0 +1,31 @@
+#ifndef SNAPTRAY_PIXELATEKERNEL_H
+#define SNAPTRAY_PIXELATEKERNEL_H
+
+#include <QImage>
+#include <QRect>
+
+// Block-average pixelation shared by mosaic annotations.
+//
+// Blocks are aligned to the source image grid (block origin at 0,0) so that
+// adjacent or overlapping mosaics pixelate identically. Each block is filled
+// with the average of its pixels that lie inside the source image.
+//
+// The kernel runs in one pass per block row over ARGB32 scanlines: vertical
+// column sums, horizontal block reduction, then span fill. Column sums and
+// reduction use SSE2 on x86 and NEON on ARM, with a scalar fallback.
+
+namespace PixelateKernel {
+
+// Pixelates targetRect (in source pixel coordinates) and returns a
+// Format_ARGB32 image of targetRect.size(). Pixels whose block has no source
+// coverage stay transparent. Returns a null image when no block covering
+// targetRect overlaps the source.
+//
+// RGB32, ARGB32 and ARGB32_Premultiplied sources are read in place; other
+// formats are converted first. Premultiplied sources are averaged in
+// premultiplied space and unpremultiplied on output.
+QImage pixelate(const QImage& source, const QRect& targetRect, int blockSize);
+
+} // namespace PixelateKernel
+
+#endif // SNAPTRAY_PIXELATEKERNEL_H
@@ -0,0 +1,56 @@
+#ifndef SNAPTRAY_QOICODEC_H
+#define SNAPTRAY_QOICODEC_H
+
+#include <QtGlobal>
+
+// QOI ("Quite OK Image") op coder over QImage's 32-bit pixels (RGB32 and
+// ARGB32 layouts, premultiplied or not: channels are coded as raw bytes).
+//
+// Only the op stream lives here; callers add their own framing. Encoder and
+// Decoder keep the coder state (previous pixel, colour index, pending run)
+// between calls, so a stream can be fed a row or a band at a time.
+
+namespace QoiCodec {
+
+// Worst-case output per input pixel: an RGBA literal.
+constexpr int kMaxBytesPerPixel = 5;
+
+// End-of-stream marker of the QOI file format.
+constexpr uchar kEndMarker[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+class Encoder
+{
+public:
+    // Writes the ops for count pixels at out and returns the new end.
+    // out needs room for count * kMaxBytesPerPixel + 1 bytes; a run left
+    // over from the previous call may be flushed here.
+    uchar* encode(const quint32* pixels, int count, uchar* out);
+
+    // Flushes a pending run (at most one byte).
+    uchar* finish(uchar* out);
+
+private:
+    quint32 m_index[64] = {};
+    quint32 m_previous = 0xff000000u;
+    int m_run = 0;
+};
+
+class Decoder
+{
+public:
+    // Decodes count pixels from [*in, end), advancing *in. Returns false if
+    // the input runs out first.
+    bool decode(const uchar** in, const uchar* end, quint32* pixels, int count);
+
+    // True when no run continues past the pixels decoded so far.
+    bool atOpBoundary() const { return m_run == 0; }
+
+private:
+    quint32 m_index[64] = {};
+    quint32 m_previous = 0xff000000u;
+    int m_run = 0;
+};
+
+} // namespace QoiCodec
+
+#endif // SNAPTRAY_QOICODEC_H
@@ -0,0 +1,72 @@
+#ifndef DECODEDFRAMEQUEUE_H
+#define DECODEDFRAMEQUEUE_H
+
+#include <QImage>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <deque>
+
+/**
+ * @brief Bounded hand-off of decoded video frames between two threads
+ *
+ * A decoder thread pushes frames while a consumer on another thread encodes
+ * them. push() blocks while the queue is full, so decoding runs at most
+ * capacity frames ahead of encoding and memory stays bounded.
+ *
+ * Thread roles:
+ * - Producer: push(), close()
+ * - Consumer: tryPop(), abort()
+ */
+class DecodedFrameQueue
+{
+public:
+    struct Frame {
+        QImage image;
+        qint64 timestampMs = 0;
+    };
+
+    explicit DecodedFrameQueue(int capacity);
+    DecodedFrameQueue(const DecodedFrameQueue&) = delete;
+    DecodedFrameQueue& operator=(const DecodedFrameQueue&) = delete;
+
+    /**
+     * @brief Append a frame, waiting while the queue is full
+     * @return false if the queue was aborted; the frame is dropped
+     */
+    bool push(const QImage& image, qint64 timestampMs);
+
+    /**
+     * @brief Mark the end of the stream; queued frames stay available
+     */
+    void close();
+
+    /**
+     * @brief Take the oldest frame without waiting
+     * @return false when nothing is queued
+     */
+    bool tryPop(Frame& frame);
+
+    /**
+     * @brief Drop every queued frame and release a blocked producer
+     */
+    void abort();
+
+    /**
+     * @brief True once the producer closed the queue and every frame was taken
+     */
+    bool isDrained() const;
+
+    int size() const;
+    int capacity() const { return m_capacity; }
+
+private:
+    mutable QMutex m_mutex;
+    QWaitCondition m_notFull;
+    std::deque<Frame> m_frames;
+    int m_capacity = 1;
+    bool m_closed = false;
+    bool m_aborted = false;
+};
+
+#endif // DECODEDFRAMEQUEUE_H
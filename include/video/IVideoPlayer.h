@@ -6,6 +6,8 @@
 #include <QSize>
 #include <QString>
 
+#include <functional>
+
 class IVideoPlayer : public QObject
 {
     Q_OBJECT
@@ -14,6 +16,10 @@ public:
     enum class State { Stopped, Playing, Paused };
     Q_ENUM(State)
 
+    // Receives a decoded frame and its presentation time in ms. Runs on the
+    // decoder thread; return false to stop decoding.
+    using SequentialFrameCallback = std::function<bool(const QImage &frame, qint64 timestampMs)>;
+
     explicit IVideoPlayer(QObject *parent = nullptr) : QObject(parent) {}
     ~IVideoPlayer() override = default;
 
@@ -48,6 +54,23 @@ public:
     virtual void setPlaybackRate(float rate) = 0;  // 0.25 - 2.0
     virtual float playbackRate() const = 0;
 
+    // Sequential decode: seek once to startMs, then decode forward and pass
+    // every frame visible in [startMs, endMs) to the callback in presentation
+    // order, without pacing. Emits sequentialDecodeFinished() at the end of
+    // the range, or error() on failure. Playback is paused meanwhile.
+    // stopSequentialDecode() waits for a running callback to return; no
+    // callback runs after it.
+    virtual bool supportsSequentialDecode() const { return false; }
+    virtual bool startSequentialDecode(qint64 startMs, qint64 endMs,
+                                       SequentialFrameCallback callback)
+    {
+        Q_UNUSED(startMs);
+        Q_UNUSED(endMs);
+        Q_UNUSED(callback);
+        return false;
+    }
+    virtual void stopSequentialDecode() {}
+
     // Factory method
     static IVideoPlayer* create(QObject *parent = nullptr);
 
@@ -60,6 +83,7 @@ signals:
     void mediaLoaded();
     void playbackFinished();
     void playbackRateChanged(float rate);
+    void sequentialDecodeFinished();
 };
 
 #endif // IVIDEOPLAYER_H
@@ -1,16 +1,23 @@
 #ifndef VIDEOTRIMMER_H
 #define VIDEOTRIMMER_H
 
+#include <QElapsedTimer>
 #include <QImage>
 #include <QObject>
 #include <QString>
+#include "encoding/AnimationTrimmer.h"
 #include "encoding/EncoderFactory.h"
 
+#include <atomic>
+#include <memory>
+
+class DecodedFrameQueue;
 class IVideoPlayer;
 class IVideoEncoder;
 class NativeGifEncoder;
 class WebPAnimationEncoder;
 class QTimer;
+template <typename T> class QFutureWatcher;
 
 /**
  * @brief Async video trimming by re-encoding.
@@ -18,6 +25,14 @@ class QTimer;
  * This class extracts frames from the specified trim range of a video
  * and re-encodes them into a new video file. The operation runs
  * asynchronously to avoid blocking the UI.
+ *
+ * When the player supports sequential decode, the range is decoded forward
+ * from a single seek on the player's decoder thread while frames are encoded
+ * here, with a bounded queue between the two. Otherwise each output frame
+ * is extracted with its own seek.
+ *
+ * A GIF or WebP trimmed to its own format skips the player and encoder
+ * entirely: AnimationTrimmer copies the frames in range on a worker thread.
  */
 class VideoTrimmer : public QObject
 {
@@ -68,8 +83,9 @@ signals:
     /**
      * @brief Emitted to report progress.
      * @param percent Progress percentage (0-100)
+     * @param framesPerSecond Frames encoded per second of wall time so far
      */
-    void progress(int percent);
+    void progress(int percent, double framesPerSecond);
 
     /**
      * @brief Emitted when trimming completes.
@@ -87,19 +103,27 @@ signals:
 private slots:
     void onFrameReady(const QImage &frame);
     void processNextFrame();
+    void processDecodedFrame();
+    void onSequentialDecodeFinished();
     void onEncodingFinished(bool success, const QString &path);
     void onMediaLoaded();
 
 private:
     friend class TestVideoTrimmerSafety;
 
+    bool startContainerTrim();
     void requestFrame(qint64 positionMs);
+    bool startSequentialDecode();
+    void stopSequentialDecode();
+    void scheduleDecodedFrame();
+    void finishEncoding();
     void submitFrame(const QImage &frame, qint64 timestampMs);
     void retryPendingFrame();
     void completeCurrentFrame();
     void failTrim(const QString &message);
     void abortEncoders();
     qint64 encoderFramesWritten() const;
+    double encodedFramesPerSecond() const;
     void cleanup();
 
     QString m_inputPath;
@@ -124,6 +148,22 @@ private:
     qint64 m_seekPosition = 0;    // Position we requested frame from (for timestamp calculation)
     int m_frameCount = 0;
     int m_totalFrames = 0;
+
+    // Sequential decode
+    bool m_sequential = false;
+    bool m_decodeFinished = false;
+    std::shared_ptr<DecodedFrameQueue> m_frameQueue;
+    std::atomic<bool> m_decodedFrameScheduled{false};
+    qint64 m_lastEncodedTimestamp = 0;
+    QElapsedTimer m_elapsed;
+
+    // Container-level GIF/WebP trim, done in memory on the thread pool and
+    // written out by the trimmer only if it is still current
+    struct ContainerTrimOutput {
+        AnimationTrimmer::Result result;
+        QByteArray data;
+    };
+    QFutureWatcher<ContainerTrimOutput> *m_containerTrim = nullptr;
 };
 
 #endif // VIDEOTRIMMER_H
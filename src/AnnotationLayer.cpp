@@ -27,10 +27,13 @@ AnnotationLayer::~AnnotationLayer() = default;
 
 void AnnotationLayer::addItem(std::unique_ptr<AnnotationItem> item)
 {
+    const AnnotationItem* added = item.get();
     m_items.push_back(std::move(item));
     m_redoStack.clear();  // Clear redo stack when new item is added
+    dropExcludeIndexCaches();
+    invalidateItemCache(added);
+    appendToSpatialIndex(added);
     trimHistory();
-    invalidateCache();
     emit changed();
 }
 
@@ -42,7 +45,11 @@ void AnnotationLayer::trimHistory()
 
     // Calculate items to trim and remove in one O(n) operation instead of O(n²)
     size_t trimCount = m_items.size() - kMaxHistorySize;
+    for (size_t i = 0; i < trimCount; ++i) {
+        invalidateItemCache(m_items[i].get());
+    }
     m_items.erase(m_items.begin(), m_items.begin() + static_cast<ptrdiff_t>(trimCount));
+    invalidateSpatialIndex();
 
     // Adjust stored indices in all ErasedItemsGroups
     for (auto& item : m_items) {
@@ -86,16 +93,20 @@ void AnnotationLayer::undo()
         // Re-insert items at their original indices
         for (auto &indexed : restoredItems) {
             size_t insertPos = (std::min)(indexed.originalIndex, m_items.size());
+            invalidateItemCache(indexed.item.get());
             m_items.insert(m_items.begin() + static_cast<ptrdiff_t>(insertPos), std::move(indexed.item));
         }
+        invalidateSpatialIndex();
     } else {
         // Normal undo: move last item to redo stack
+        invalidateItemCache(m_items.back().get());
+        popFromSpatialIndex();
         m_redoStack.push_back(std::move(m_items.back()));
         m_items.pop_back();
     }
 
+    dropExcludeIndexCaches();
     renumberStepBadges();
-    invalidateCache();
     clearSelection();
     emit changed();
 }
@@ -134,7 +145,11 @@ void AnnotationLayer::redo()
 
             // Reverse to restore original order (we collected in descending index order)
             std::reverse(itemsToErase.begin(), itemsToErase.end());
+            for (const auto& indexed : itemsToErase) {
+                invalidateItemCache(indexed.item.get());
+            }
             m_items.push_back(std::make_unique<ErasedItemsGroup>(std::move(itemsToErase)));
+            invalidateSpatialIndex();
 
             // Commit only after redo operation succeeds.
             m_redoStack.pop_back();
@@ -157,12 +172,14 @@ void AnnotationLayer::redo()
         }
     } else {
         // Normal redo
+        invalidateItemCache(m_redoStack.back().get());
         m_items.push_back(std::move(m_redoStack.back()));
         m_redoStack.pop_back();
+        appendToSpatialIndex(m_items.back().get());
     }
 
+    dropExcludeIndexCaches();
     renumberStepBadges();
-    invalidateCache();
     clearSelection();
     emit changed();
 }
@@ -276,7 +293,11 @@ void AnnotationLayer::renumberStepBadges()
     int badgeNumber = 1;
     for (auto &item : m_items) {
         if (auto* badge = dynamic_cast<StepBadgeAnnotation*>(item.get())) {
-            badge->setNumber(badgeNumber++);
+            if (badge->number() != badgeNumber) {
+                invalidateItemCache(badge);
+                badge->setNumber(badgeNumber);
+            }
+            ++badgeNumber;
         }
     }
 }
@@ -285,50 +306,56 @@ std::vector<ErasedItemsGroup::IndexedItem> AnnotationLayer::removeItemsIntersect
 {
     std::vector<ErasedItemsGroup::IndexedItem> removedItems;
     int radius = strokeWidth / 2;
-    size_t currentIndex = 0;
+    const QRect eraserRect(point.x() - radius, point.y() - radius, radius * 2 + 1, radius * 2 + 1);
+
+    // Candidates come back bottom-to-top, matching the original scan order.
+    std::vector<int> candidates = spatialIndex().query(eraserRect);
+    if (m_selectedIndex >= 0 && m_selectedIndex < static_cast<int>(m_items.size())) {
+        auto pos = std::lower_bound(candidates.begin(), candidates.end(), m_selectedIndex);
+        if (pos == candidates.end() || *pos != m_selectedIndex) {
+            candidates.insert(pos, m_selectedIndex);
+        }
+    }
+
+    for (int index : candidates) {
+        AnnotationItem* item = m_items[static_cast<size_t>(index)].get();
 
-    for (auto it = m_items.begin(); it != m_items.end(); ) {
         // Skip ErasedItemsGroup items (they are invisible markers)
-        if (dynamic_cast<ErasedItemsGroup*>(it->get())) {
-            ++it;
-            ++currentIndex;
+        if (dynamic_cast<ErasedItemsGroup*>(item)) {
             continue;
         }
 
         bool shouldRemove = false;
 
         // Use path-based intersection for strokes (more accurate)
-        if (auto* pencil = dynamic_cast<PencilStroke*>(it->get())) {
+        if (auto* pencil = dynamic_cast<PencilStroke*>(item)) {
             shouldRemove = pencil->intersectsCircle(point, radius);
-        } else if (auto* marker = dynamic_cast<MarkerStroke*>(it->get())) {
+        } else if (auto* marker = dynamic_cast<MarkerStroke*>(item)) {
             shouldRemove = marker->intersectsCircle(point, radius);
-        } else if (auto* mosaic = dynamic_cast<MosaicStroke*>(it->get())) {
+        } else if (auto* mosaic = dynamic_cast<MosaicStroke*>(item)) {
             shouldRemove = mosaic->intersectsCircle(point, radius);
         } else {
             // Fallback: expanded bounding rect for shapes/text/badges/etc.
-            QRect itemRect = (*it)->boundingRect();
+            QRect itemRect = item->boundingRect();
             QRect expandedRect = itemRect.adjusted(-radius, -radius, radius, radius);
             shouldRemove = expandedRect.contains(point);
         }
 
         if (shouldRemove) {
             // Item intersects with eraser - remove it and record original index
-            removedItems.push_back({currentIndex, std::move(*it)});
-            it = m_items.erase(it);
-            // currentIndex tracks the original scan position, not post-erase offsets.
-            ++currentIndex;
-        } else {
-            ++it;
-            ++currentIndex;
+            invalidateItemCache(item);
+            removedItems.push_back({static_cast<size_t>(index), std::move(m_items[static_cast<size_t>(index)])});
         }
     }
 
     if (!removedItems.empty()) {
+        m_items.erase(std::remove(m_items.begin(), m_items.end(), nullptr), m_items.end());
+        invalidateSpatialIndex();
         if (!m_eraseTransactionActive) {
             m_redoStack.clear();
         }
+        dropExcludeIndexCaches();
         renumberStepBadges();
-        invalidateCache();
         clearSelection();
         emit changed();
     }
@@ -363,84 +390,75 @@ void AnnotationLayer::restoreRemovedItems(std::vector<ErasedItemsGroup::IndexedI
     m_items.reserve(m_items.size() + items.size());
     for (auto& indexed : items) {
         const size_t insertPos = (std::min)(indexed.originalIndex, m_items.size());
+        invalidateItemCache(indexed.item.get());
         m_items.insert(m_items.begin() + static_cast<ptrdiff_t>(insertPos),
             std::move(indexed.item));
     }
 
+    invalidateSpatialIndex();
+    dropExcludeIndexCaches();
     renumberStepBadges();
-    invalidateCache();
     clearSelection();
     emit changed();
 }
 
-int AnnotationLayer::hitTestText(const QPoint &pos) const
+template <typename T>
+int AnnotationLayer::hitTestTopmost(const QPoint &pos) const
 {
+    auto matches = [this, &pos](int index) {
+        const auto* item = dynamic_cast<const T*>(m_items[static_cast<size_t>(index)].get());
+        return item && item->isVisible() && item->containsPoint(pos);
+    };
+
+    const int selectedHit =
+        (m_selectedIndex >= 0 && m_selectedIndex < static_cast<int>(m_items.size()) &&
+         matches(m_selectedIndex)) ? m_selectedIndex : -1;
+
+    const std::vector<int>* candidates = spatialIndex().candidatesAt(pos);
+    if (!candidates) {
+        return selectedHit;
+    }
+
     // Iterate in reverse order (top-most items first)
-    for (int i = static_cast<int>(m_items.size()) - 1; i >= 0; --i) {
-        // Hit-test TextBoxAnnotation items (new resizable text boxes)
-        if (auto* textItem = dynamic_cast<TextBoxAnnotation*>(m_items[i].get())) {
-            if (textItem->isVisible() && textItem->containsPoint(pos)) {
-                return i;
-            }
+    for (auto it = candidates->rbegin(); it != candidates->rend() && *it > selectedHit; ++it) {
+        if (*it != m_selectedIndex && matches(*it)) {
+            return *it;
         }
     }
-    return -1;
+    return selectedHit;
+}
+
+int AnnotationLayer::hitTestText(const QPoint &pos) const
+{
+    return hitTestTopmost<TextBoxAnnotation>(pos);
 }
 
 int AnnotationLayer::hitTestEmojiSticker(const QPoint &pos) const
 {
-    // Iterate in reverse order (top-most items first)
-    for (int i = static_cast<int>(m_items.size()) - 1; i >= 0; --i) {
-        if (auto* emojiItem = dynamic_cast<EmojiStickerAnnotation*>(m_items[i].get())) {
-            if (emojiItem->isVisible() && emojiItem->containsPoint(pos)) {
-                return i;
-            }
-        }
-    }
-    return -1;
+    return hitTestTopmost<EmojiStickerAnnotation>(pos);
 }
 
 int AnnotationLayer::hitTestShape(const QPoint &pos) const
 {
-    // Iterate in reverse order (top-most items first)
-    for (int i = static_cast<int>(m_items.size()) - 1; i >= 0; --i) {
-        if (auto* shapeItem = dynamic_cast<ShapeAnnotation*>(m_items[i].get())) {
-            if (shapeItem->isVisible() && shapeItem->containsPoint(pos)) {
-                return i;
-            }
-        }
-    }
-    return -1;
+    return hitTestTopmost<ShapeAnnotation>(pos);
 }
 
 int AnnotationLayer::hitTestArrow(const QPoint &pos) const
 {
-    // Iterate in reverse order (top-most items first)
-    for (int i = static_cast<int>(m_items.size()) - 1; i >= 0; --i) {
-        if (auto* arrowItem = dynamic_cast<ArrowAnnotation*>(m_items[i].get())) {
-            if (arrowItem->isVisible() && arrowItem->containsPoint(pos)) {
-                return i;
-            }
-        }
-    }
-    return -1;
+    return hitTestTopmost<ArrowAnnotation>(pos);
 }
 
 int AnnotationLayer::hitTestPolyline(const QPoint &pos) const
 {
-    // Iterate in reverse order (top-most items first)
-    for (int i = static_cast<int>(m_items.size()) - 1; i >= 0; --i) {
-        if (auto* polylineItem = dynamic_cast<PolylineAnnotation*>(m_items[i].get())) {
-            if (polylineItem->isVisible() && polylineItem->containsPoint(pos)) {
-                return i;
-            }
-        }
-    }
-    return -1;
+    return hitTestTopmost<PolylineAnnotation>(pos);
 }
 
 void AnnotationLayer::setSelectedIndex(int index)
 {
+    if (m_selectedIndex >= 0 && index != m_selectedIndex) {
+        invalidateSpatialIndex();
+    }
+
     if (index < 0 || index >= static_cast<int>(m_items.size())) {
         m_selectedIndex = -1;
         return;
@@ -450,6 +468,15 @@ void AnnotationLayer::setSelectedIndex(int index)
     m_selectedIndex = (candidate && candidate->isVisible()) ? index : -1;
 }
 
+void AnnotationLayer::clearSelection()
+{
+    if (m_selectedIndex >= 0) {
+        // The item may have been moved or transformed while selected.
+        invalidateSpatialIndex();
+    }
+    m_selectedIndex = -1;
+}
+
 AnnotationItem* AnnotationLayer::selectedItem()
 {
     if (m_selectedIndex >= 0 && m_selectedIndex < static_cast<int>(m_items.size())) {
@@ -477,16 +504,18 @@ bool AnnotationLayer::removeSelectedItem()
 
     // Use ErasedItemsGroup for proper undo/redo support (same pattern as eraser)
     std::vector<ErasedItemsGroup::IndexedItem> removedItems;
+    invalidateItemCache(m_items[m_selectedIndex].get());
     removedItems.push_back({static_cast<size_t>(m_selectedIndex), std::move(m_items[m_selectedIndex])});
     m_items.erase(m_items.begin() + m_selectedIndex);
+    invalidateSpatialIndex();
 
     // Add ErasedItemsGroup to track the deletion for undo
     m_items.push_back(std::make_unique<ErasedItemsGroup>(std::move(removedItems)));
 
     m_redoStack.clear();
     m_selectedIndex = -1;
+    dropExcludeIndexCaches();
     renumberStepBadges();
-    invalidateCache();
     emit changed();
     return true;
 }
@@ -494,7 +523,238 @@ bool AnnotationLayer::removeSelectedItem()
 void AnnotationLayer::invalidateCache()
 {
     m_annotationCaches.clear();
+    invalidateSpatialIndex();
+    ++m_revision;
+}
+
+void AnnotationLayer::invalidateCacheRect(const QRect& rect)
+{
+    // The item may have moved or resized, so its indexed bounds are stale.
+    invalidateSpatialIndex();
+    markCacheTilesDirty(rect);
+}
+
+void AnnotationLayer::markCacheTilesDirty(const QRect& rect)
+{
     ++m_revision;
+    if (rect.isEmpty()) {
+        return;
+    }
+
+    for (auto& [key, entry] : m_annotationCaches) {
+        markTilesDirty(entry, cacheDeviceRect(rect, key));
+    }
+}
+
+QRect AnnotationLayer::cacheDeviceRect(const QRect& rect, const CacheKey& key)
+{
+    if (rect.isEmpty()) {
+        return QRect();
+    }
+    const QRect paddedRect = rect.adjusted(
+        -kCacheTilePadding, -kCacheTilePadding, kCacheTilePadding, kCacheTilePadding);
+    return CoordinateHelper::toPhysicalCoveringRect(
+        paddedRect.translated(-key.originX, -key.originY), key.devicePixelRatioMilli / 1000.0)
+        .intersected(QRect(0, 0, key.physicalWidth, key.physicalHeight));
+}
+
+void AnnotationLayer::markTilesDirty(CacheEntry& entry, const QRect& deviceRect)
+{
+    if (deviceRect.isEmpty()) {
+        return;
+    }
+
+    const int firstColumn = deviceRect.left() / kCacheTileSize;
+    const int lastColumn = (std::min)(deviceRect.right() / kCacheTileSize, entry.columns - 1);
+    const int firstRow = deviceRect.top() / kCacheTileSize;
+    const int lastRow = (std::min)(deviceRect.bottom() / kCacheTileSize, entry.rows - 1);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            entry.dirtyTiles[static_cast<size_t>(row * entry.columns + column)] = 1;
+            entry.hasDirtyTiles = true;
+        }
+    }
+}
+
+void AnnotationLayer::invalidateItemCache(const AnnotationItem* item)
+{
+    if (item) {
+        markCacheTilesDirty(item->boundingRect());
+    }
+}
+
+const AnnotationSpatialIndex& AnnotationLayer::spatialIndex() const
+{
+    if (!m_spatialIndexValid) {
+        m_spatialIndex.clear();
+        for (const auto& item : m_items) {
+            const QRect rect = item->boundingRect();
+            m_spatialIndex.append(rect.isEmpty() ? QRect() : rect.adjusted(
+                -kHitTestPadding, -kHitTestPadding, kHitTestPadding, kHitTestPadding));
+        }
+        m_spatialIndexValid = true;
+    }
+    return m_spatialIndex;
+}
+
+void AnnotationLayer::appendToSpatialIndex(const AnnotationItem* item)
+{
+    if (!m_spatialIndexValid) {
+        return;
+    }
+
+    const QRect rect = item->boundingRect();
+    m_spatialIndex.append(rect.isEmpty() ? QRect() : rect.adjusted(
+        -kHitTestPadding, -kHitTestPadding, kHitTestPadding, kHitTestPadding));
+}
+
+void AnnotationLayer::popFromSpatialIndex()
+{
+    if (m_spatialIndexValid) {
+        m_spatialIndex.removeLast();
+    }
+}
+
+void AnnotationLayer::dropExcludeIndexCaches()
+{
+    // Exclude-index caches are keyed by item position, which shifts when
+    // items are inserted or removed.
+    for (auto it = m_annotationCaches.begin(); it != m_annotationCaches.end();) {
+        if (it->first.excludeIndex >= 0) {
+            it = m_annotationCaches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+QRect AnnotationLayer::itemDeviceRect(const AnnotationItem* item,
+                                      const QPoint& origin,
+                                      qreal devicePixelRatio)
+{
+    const QRect rect = item->boundingRect();
+    if (rect.isEmpty()) {
+        return QRect();
+    }
+    return CoordinateHelper::toPhysicalCoveringRect(
+        rect.adjusted(-kCacheTilePadding, -kCacheTilePadding,
+                      kCacheTilePadding, kCacheTilePadding).translated(-origin),
+        devicePixelRatio);
+}
+
+const QPixmap& AnnotationLayer::cachedPixmap(const CacheKey& key,
+                                             const QSize& physicalSize,
+                                             qreal devicePixelRatio,
+                                             const QPoint& origin) const
+{
+    auto cacheIt = m_annotationCaches.find(key);
+    if (cacheIt == m_annotationCaches.end() && key.excludeIndex < 0) {
+        // Promote a drag cache of the same viewport: it already holds every
+        // item except the excluded one, so only that item's tiles need work.
+        for (auto it = m_annotationCaches.begin(); it != m_annotationCaches.end(); ++it) {
+            const CacheKey& existingKey = it->first;
+            if (existingKey.excludeIndex < 0 ||
+                existingKey.excludeIndex >= static_cast<int>(m_items.size()) ||
+                existingKey.physicalWidth != key.physicalWidth ||
+                existingKey.physicalHeight != key.physicalHeight ||
+                existingKey.originX != key.originX ||
+                existingKey.originY != key.originY ||
+                existingKey.devicePixelRatioMilli != key.devicePixelRatioMilli) {
+                continue;
+            }
+
+            CacheEntry promoted = std::move(it->second);
+            const QRect deviceRect = itemDeviceRect(
+                m_items[existingKey.excludeIndex].get(), origin, devicePixelRatio)
+                .intersected(QRect(QPoint(0, 0), physicalSize));
+            m_annotationCaches.erase(it);
+
+            markTilesDirty(promoted, deviceRect);
+            cacheIt = m_annotationCaches.emplace(key, std::move(promoted)).first;
+            break;
+        }
+    }
+
+    if (cacheIt == m_annotationCaches.end()) {
+        CacheEntry entry;
+        entry.pixmap = QPixmap(physicalSize);
+        entry.pixmap.setDevicePixelRatio(devicePixelRatio);
+        entry.columns = (physicalSize.width() + kCacheTileSize - 1) / kCacheTileSize;
+        entry.rows = (physicalSize.height() + kCacheTileSize - 1) / kCacheTileSize;
+        entry.dirtyTiles.assign(static_cast<size_t>(entry.columns * entry.rows), 1);
+        entry.hasDirtyTiles = true;
+        cacheIt = m_annotationCaches.emplace(key, std::move(entry)).first;
+    }
+
+    rasterizeDirtyTiles(cacheIt->second, key, devicePixelRatio, origin);
+    return cacheIt->second.pixmap;
+}
+
+void AnnotationLayer::rasterizeDirtyTiles(CacheEntry& entry,
+                                          const CacheKey& key,
+                                          qreal devicePixelRatio,
+                                          const QPoint& origin) const
+{
+    if (!entry.hasDirtyTiles) {
+        return;
+    }
+
+    const QRect canvasRect(0, 0, key.physicalWidth, key.physicalHeight);
+    QRegion dirtyRegion;
+    bool allDirty = true;
+    for (int row = 0; row < entry.rows; ++row) {
+        // Merge horizontal runs of dirty tiles to keep the region small.
+        int runStart = -1;
+        for (int column = 0; column <= entry.columns; ++column) {
+            const bool dirty = column < entry.columns &&
+                entry.dirtyTiles[static_cast<size_t>(row * entry.columns + column)] != 0;
+            if (dirty && runStart < 0) {
+                runStart = column;
+            } else if (!dirty && runStart >= 0) {
+                dirtyRegion += QRect(runStart * kCacheTileSize, row * kCacheTileSize,
+                                     (column - runStart) * kCacheTileSize, kCacheTileSize)
+                                   .intersected(canvasRect);
+                runStart = -1;
+            }
+            if (!dirty && column < entry.columns) {
+                allDirty = false;
+            }
+        }
+    }
+    std::fill(entry.dirtyTiles.begin(), entry.dirtyTiles.end(), 0);
+    entry.hasDirtyTiles = false;
+
+    if (allDirty) {
+        entry.pixmap.fill(Qt::transparent);
+    }
+
+    QPainter cachePainter(&entry.pixmap);
+    if (!allDirty) {
+        // Clip is set before enabling antialiasing so tile edges stay hard.
+        QPainterPath clipPath;
+        for (const QRect& rect : dirtyRegion) {
+            clipPath.addRect(QRectF(QPointF(rect.topLeft()) / devicePixelRatio,
+                                    QSizeF(rect.size()) / devicePixelRatio));
+        }
+        cachePainter.setClipPath(clipPath);
+        cachePainter.setCompositionMode(QPainter::CompositionMode_Source);
+        cachePainter.fillRect(clipPath.boundingRect(), Qt::transparent);
+        cachePainter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    }
+    cachePainter.setRenderHint(QPainter::Antialiasing);
+    cachePainter.setRenderHint(QPainter::SmoothPixmapTransform);
+    cachePainter.translate(-QPointF(origin));
+
+    for (int i = 0; i < static_cast<int>(m_items.size()); ++i) {
+        const AnnotationItem* item = m_items[i].get();
+        if (i == key.excludeIndex || !item->isVisible()) {
+            continue;
+        }
+        if (!allDirty && !dirtyRegion.intersects(itemDeviceRect(item, origin, devicePixelRatio))) {
+            continue;
+        }
+        item->draw(cachePainter);
+    }
 }
 
 void AnnotationLayer::drawCached(QPainter &painter,
@@ -514,29 +774,8 @@ void AnnotationLayer::drawCached(QPainter &painter,
         qRound(devicePixelRatio * 1000.0)
     };
 
-    auto cacheIt = m_annotationCaches.find(cacheKey);
-    if (cacheIt == m_annotationCaches.end()) {
-        QPixmap cache(physicalSize);
-        cache.setDevicePixelRatio(devicePixelRatio);
-        cache.fill(Qt::transparent);
-
-        QPainter cachePainter(&cache);
-        cachePainter.setRenderHint(QPainter::Antialiasing);
-        cachePainter.setRenderHint(QPainter::SmoothPixmapTransform);
-        cachePainter.translate(-QPointF(origin));
-
-        for (const auto &item : m_items) {
-            if (item->isVisible()) {
-                item->draw(cachePainter);
-            }
-        }
-
-        cacheIt = m_annotationCaches.emplace(cacheKey, std::move(cache)).first;
-    }
-
-    painter.drawPixmap(0, 0, cacheIt->second);
+    painter.drawPixmap(0, 0, cachedPixmap(cacheKey, physicalSize, devicePixelRatio, origin));
 }
-
 void AnnotationLayer::markDirtyRect(const QRect& rect)
 {
     if (m_hasDirtyRect) {
@@ -573,6 +812,7 @@ void AnnotationLayer::drawWithDirtyRegion(QPainter &painter, const QSize &canvas
     };
 
     if (normalizedExcludeIndex >= 0) {
+        const bool hasDragCache = m_annotationCaches.count(cacheKey) != 0;
         for (auto it = m_annotationCaches.begin(); it != m_annotationCaches.end();) {
             const CacheKey& existingKey = it->first;
             const bool sameViewport =
@@ -582,36 +822,28 @@ void AnnotationLayer::drawWithDirtyRegion(QPainter &painter, const QSize &canvas
                 existingKey.originY == cacheKey.originY &&
                 existingKey.devicePixelRatioMilli == cacheKey.devicePixelRatioMilli;
 
-            if (sameViewport && existingKey.excludeIndex != normalizedExcludeIndex) {
-                it = m_annotationCaches.erase(it);
-            } else {
+            if (!sameViewport || existingKey.excludeIndex == normalizedExcludeIndex) {
                 ++it;
+                continue;
             }
-        }
-    }
 
-    auto cacheIt = m_annotationCaches.find(cacheKey);
-    if (cacheIt == m_annotationCaches.end()) {
-        QPixmap cache(physicalSize);
-        cache.setDevicePixelRatio(devicePixelRatio);
-        cache.fill(Qt::transparent);
-
-        QPainter cachePainter(&cache);
-        cachePainter.setRenderHint(QPainter::Antialiasing);
-        cachePainter.setRenderHint(QPainter::SmoothPixmapTransform);
-        cachePainter.translate(-QPointF(origin));
-
-        for (int i = 0; i < static_cast<int>(m_items.size()); ++i) {
-            if (i != normalizedExcludeIndex && m_items[i]->isVisible()) {
-                m_items[i]->draw(cachePainter);
+            if (!hasDragCache && existingKey.excludeIndex < 0 && m_hasDirtyRect) {
+                // Demote the full cache: the dirty rect holds the dragged
+                // item's footprint from when the drag started, so only those
+                // tiles need repainting without it.
+                CacheEntry demoted = std::move(it->second);
+                markTilesDirty(demoted, cacheDeviceRect(m_dirtyRect, cacheKey));
+                m_annotationCaches.erase(it);
+                m_annotationCaches.emplace(cacheKey, std::move(demoted));
+                it = m_annotationCaches.begin();
+                continue;
             }
+            it = m_annotationCaches.erase(it);
         }
-
-        cacheIt = m_annotationCaches.emplace(cacheKey, std::move(cache)).first;
     }
 
     // Draw the cached background (all items except the one being dragged)
-    painter.drawPixmap(0, 0, cacheIt->second);
+    painter.drawPixmap(0, 0, cachedPixmap(cacheKey, physicalSize, devicePixelRatio, origin));
 
     // Draw the excluded item (being dragged) on top, directly to painter
     if (normalizedExcludeIndex >= 0) {
@@ -624,12 +856,17 @@ void AnnotationLayer::drawWithDirtyRegion(QPainter &painter, const QSize &canvas
     }
 }
 
-void AnnotationLayer::commitDirtyRegion(const QSize &canvasSize, qreal devicePixelRatio)
+void AnnotationLayer::commitDirtyRegion()
 {
-    Q_UNUSED(canvasSize);
-    Q_UNUSED(devicePixelRatio);
-
     if (!m_hasDirtyRect) return;
-    invalidateCache();
+
+    // The dirty rect covers where the dragged item was when the drag began;
+    // together with where it is now, those are the only tiles that changed.
+    // Drag caches are promoted back to full caches on the next cached draw.
+    QRect changedRect = m_dirtyRect;
+    if (const AnnotationItem* item = selectedItem()) {
+        changedRect = changedRect.united(item->boundingRect());
+    }
     clearDirtyRect();
+    invalidateCacheRect(changedRect);
 }
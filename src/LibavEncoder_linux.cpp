@@ -0,0 +1,677 @@
+#include "LibavEncoder.h"
+
+#if defined(Q_OS_LINUX) && defined(SNAPTRAY_HAVE_LIBAV)
+
+#include "encoding/YuvConverter.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QThread>
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+}
+
+namespace {
+
+QString avErrorString(int errnum)
+{
+    char buffer[AV_ERROR_MAX_STRING_SIZE] = {};
+    av_strerror(errnum, buffer, sizeof(buffer));
+    return QString::fromUtf8(buffer);
+}
+
+// Whether the encoder lists format among its accepted inputs. Encoders
+// that do not publish a list are treated as not accepting it.
+template <typename Format>
+bool acceptsFormat(const AVCodec *codec, Format format)
+{
+    const Format *formats = nullptr;
+    int count = 0;
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(61, 13, 100)
+    const AVCodecConfig config = std::is_same_v<Format, AVPixelFormat>
+        ? AV_CODEC_CONFIG_PIX_FORMAT : AV_CODEC_CONFIG_SAMPLE_FORMAT;
+    const void *configs = nullptr;
+    if (avcodec_get_supported_config(nullptr, codec, config, 0, &configs, &count) < 0) {
+        return false;
+    }
+    formats = static_cast<const Format *>(configs);
+#else
+    if constexpr (std::is_same_v<Format, AVPixelFormat>) {
+        formats = codec->pix_fmts;
+    } else {
+        formats = codec->sample_fmts;
+    }
+    // Lists end with AV_PIX_FMT_NONE / AV_SAMPLE_FMT_NONE, both -1
+    while (formats && formats[count] != static_cast<Format>(-1)) {
+        ++count;
+    }
+#endif
+    return formats && std::find(formats, formats + count, format) != formats + count;
+}
+
+const AVCodec *findH264Encoder()
+{
+    // Prefer the software encoders; any other H.264 encoder must take
+    // YUV420P from system memory, which rules out VAAPI and similar
+    for (const char *name : {"libx264", "libopenh264"}) {
+        const AVCodec *codec = avcodec_find_encoder_by_name(name);
+        if (codec && acceptsFormat(codec, AV_PIX_FMT_YUV420P)) {
+            return codec;
+        }
+    }
+    void *iterator = nullptr;
+    while (const AVCodec *codec = av_codec_iterate(&iterator)) {
+        if (av_codec_is_encoder(codec) && codec->id == AV_CODEC_ID_H264
+            && acceptsFormat(codec, AV_PIX_FMT_YUV420P)) {
+            return codec;
+        }
+    }
+    return nullptr;
+}
+
+const AVCodec *findAacEncoder()
+{
+    const AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_AAC);
+    return codec && acceptsFormat(codec, AV_SAMPLE_FMT_FLTP) ? codec : nullptr;
+}
+
+}  // namespace
+
+class LibavEncoderPrivate
+{
+public:
+    AVFormatContext *formatContext = nullptr;
+    AVCodecContext *codecContext = nullptr;
+    AVStream *stream = nullptr;
+    AVFrame *frame = nullptr;
+    AVPacket *packet = nullptr;
+
+    // Audio (AAC)
+    AVCodecContext *audioContext = nullptr;
+    AVStream *audioStream = nullptr;
+    AVFrame *audioFrame = nullptr;
+    bool audioEnabled = false;
+    int audioSampleRate = 48000;
+    int audioChannels = 2;
+    int audioBitsPerSample = 16;
+    std::vector<std::vector<float>> pendingAudio;  // Per channel, not yet encoded
+    qint64 nextAudioPts = -1;
+
+    QString outputPath;
+    QString lastError;
+    QSize sourceSize;  // As requested; may be odd
+    QSize frameSize;   // Encoded size, rounded up to even
+    int frameRate = 30;
+    qint64 framesWritten = 0;
+    qint64 lastPts = -1;
+    bool running = false;
+    int quality = 55;  // 0-100
+    bool warnedAboutFrameResize = false;
+
+    qint64 calculateBitrate() const {
+        int pixels = frameSize.width() * frameSize.height();
+        // Quality 0-100 maps to bits per pixel 0.1-0.3
+        double bitsPerPixel = 0.1 + (quality / 100.0) * 0.2;
+        qint64 bitrate = static_cast<qint64>(pixels * frameRate * bitsPerPixel);
+        // Clamp to reasonable range: 1 Mbps to 50 Mbps
+        return qBound<qint64>(1000000, bitrate, 50000000);
+    }
+
+    // Quality 0-100 maps to CRF 36-18 (lower CRF = better quality)
+    int calculateCrf() const {
+        return 36 - quality * 18 / 100;
+    }
+
+    bool openOutput(const AVCodec *codec) {
+        const QByteArray path = QFile::encodeName(outputPath);
+        int ret = avformat_alloc_output_context2(&formatContext, nullptr, "mp4", path.constData());
+        if (ret < 0 || !formatContext) {
+            lastError = QString("Failed to create MP4 muxer: %1").arg(avErrorString(ret));
+            return false;
+        }
+
+        codecContext = avcodec_alloc_context3(codec);
+        if (!codecContext) {
+            lastError = "Failed to allocate codec context";
+            return false;
+        }
+        codecContext->width = frameSize.width();
+        codecContext->height = frameSize.height();
+        codecContext->pix_fmt = AV_PIX_FMT_YUV420P;
+        // Millisecond time base: frames keep their capture timestamps
+        codecContext->time_base = AVRational{1, 1000};
+        codecContext->framerate = AVRational{frameRate, 1};
+        codecContext->gop_size = frameRate * 2;
+        // No reordering, so packets leave the encoder in capture order
+        codecContext->max_b_frames = 0;
+        codecContext->thread_count = 0;  // One thread per core
+        codecContext->color_primaries = AVCOL_PRI_BT709;
+        codecContext->color_trc = AVCOL_TRC_BT709;
+        codecContext->colorspace = AVCOL_SPC_BT709;
+        codecContext->color_range = AVCOL_RANGE_MPEG;
+        if (formatContext->oformat->flags & AVFMT_GLOBALHEADER) {
+            codecContext->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        }
+
+        AVDictionary *options = nullptr;
+        if (qstrcmp(codec->name, "libx264") == 0) {
+            av_dict_set(&options, "preset", "veryfast", 0);
+            av_dict_set_int(&options, "crf", calculateCrf(), 0);
+        } else {
+            codecContext->bit_rate = calculateBitrate();
+        }
+        ret = avcodec_open2(codecContext, codec, &options);
+        av_dict_free(&options);
+        if (ret < 0) {
+            lastError = QString("Failed to open %1: %2")
+                .arg(QString::fromUtf8(codec->name), avErrorString(ret));
+            return false;
+        }
+
+        stream = avformat_new_stream(formatContext, nullptr);
+        if (!stream) {
+            lastError = "Failed to create video stream";
+            return false;
+        }
+        stream->time_base = codecContext->time_base;
+        ret = avcodec_parameters_from_context(stream->codecpar, codecContext);
+        if (ret < 0) {
+            lastError = QString("Failed to copy codec parameters: %1").arg(avErrorString(ret));
+            return false;
+        }
+
+        if (audioEnabled && !openAudio()) {
+            qWarning() << "LibavEncoder: Failed to configure audio stream, continuing without audio";
+            audioEnabled = false;
+            closeAudio();
+        }
+        if (audioEnabled) {
+            audioStream = avformat_new_stream(formatContext, nullptr);
+            if (!audioStream) {
+                lastError = "Failed to create audio stream";
+                return false;
+            }
+            audioStream->time_base = audioContext->time_base;
+            ret = avcodec_parameters_from_context(audioStream->codecpar, audioContext);
+            if (ret < 0) {
+                lastError = QString("Failed to copy audio parameters: %1").arg(avErrorString(ret));
+                return false;
+            }
+        }
+
+        if (!(formatContext->oformat->flags & AVFMT_NOFILE)) {
+            ret = avio_open(&formatContext->pb, path.constData(), AVIO_FLAG_WRITE);
+            if (ret < 0) {
+                lastError = QString("Failed to open output file: %1").arg(avErrorString(ret));
+                return false;
+            }
+        }
+
+        ret = avformat_write_header(formatContext, nullptr);
+        if (ret < 0) {
+            lastError = QString("Failed to write MP4 header: %1").arg(avErrorString(ret));
+            return false;
+        }
+
+        frame = av_frame_alloc();
+        packet = av_packet_alloc();
+        if (!frame || !packet) {
+            lastError = "Failed to allocate frame buffers";
+            return false;
+        }
+        frame->format = codecContext->pix_fmt;
+        frame->width = codecContext->width;
+        frame->height = codecContext->height;
+        ret = av_frame_get_buffer(frame, 0);
+        if (ret < 0) {
+            lastError = QString("Failed to allocate frame: %1").arg(avErrorString(ret));
+            return false;
+        }
+        return true;
+    }
+
+    // Sets up the AAC encoder and its frame. The stream is added by the
+    // caller, so a failure here leaves the muxer untouched.
+    bool openAudio() {
+        const AVCodec *codec = findAacEncoder();
+        if (!codec || audioBitsPerSample != 16 || audioChannels < 1 || audioSampleRate <= 0) {
+            return false;
+        }
+
+        audioContext = avcodec_alloc_context3(codec);
+        if (!audioContext) {
+            return false;
+        }
+        audioContext->sample_fmt = AV_SAMPLE_FMT_FLTP;
+        audioContext->sample_rate = audioSampleRate;
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100)
+        av_channel_layout_default(&audioContext->ch_layout, audioChannels);
+#else
+        audioContext->channels = audioChannels;
+        audioContext->channel_layout = av_get_default_channel_layout(audioChannels);
+#endif
+        audioContext->bit_rate = 128000;
+        audioContext->time_base = AVRational{1, audioSampleRate};
+        if (formatContext->oformat->flags & AVFMT_GLOBALHEADER) {
+            audioContext->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        }
+        int ret = avcodec_open2(audioContext, codec, nullptr);
+        if (ret < 0) {
+            qWarning() << "LibavEncoder: Failed to open AAC encoder:" << avErrorString(ret);
+            return false;
+        }
+
+        audioFrame = av_frame_alloc();
+        if (!audioFrame) {
+            return false;
+        }
+        audioFrame->format = audioContext->sample_fmt;
+        audioFrame->sample_rate = audioContext->sample_rate;
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100)
+        av_channel_layout_copy(&audioFrame->ch_layout, &audioContext->ch_layout);
+#else
+        audioFrame->channels = audioContext->channels;
+        audioFrame->channel_layout = audioContext->channel_layout;
+#endif
+        audioFrame->nb_samples = audioContext->frame_size > 0 ? audioContext->frame_size : 1024;
+        if (av_frame_get_buffer(audioFrame, 0) < 0) {
+            return false;
+        }
+        pendingAudio.assign(audioChannels, {});
+        nextAudioPts = -1;
+        return true;
+    }
+
+    void closeAudio() {
+        av_frame_free(&audioFrame);
+        avcodec_free_context(&audioContext);
+        audioStream = nullptr;
+        pendingAudio.clear();
+        nextAudioPts = -1;
+    }
+
+    // Encodes the buffered samples in whole encoder frames; with flush set,
+    // the remainder goes out as a shorter last frame
+    bool encodePendingAudio(bool flush) {
+        const size_t available = pendingAudio.empty() ? 0 : pendingAudio.front().size();
+        const size_t frameLength = audioContext->frame_size > 0
+            ? static_cast<size_t>(audioContext->frame_size) : 1024;
+        size_t offset = 0;
+        bool ok = true;
+        while (ok && (available - offset >= frameLength || (flush && offset < available))) {
+            const size_t count = std::min(frameLength, available - offset);
+            int ret = av_frame_make_writable(audioFrame);
+            if (ret < 0) {
+                lastError = QString("Audio frame not writable: %1").arg(avErrorString(ret));
+                ok = false;
+                break;
+            }
+            audioFrame->nb_samples = static_cast<int>(count);
+            for (size_t channel = 0; channel < pendingAudio.size(); ++channel) {
+                std::memcpy(audioFrame->extended_data[channel], pendingAudio[channel].data() + offset,
+                            count * sizeof(float));
+            }
+            audioFrame->pts = nextAudioPts;
+            nextAudioPts += static_cast<qint64>(count);
+            offset += count;
+
+            ret = avcodec_send_frame(audioContext, audioFrame);
+            if (ret < 0) {
+                lastError = QString("Failed to encode audio: %1").arg(avErrorString(ret));
+                ok = false;
+                break;
+            }
+            ok = writePendingPackets(audioContext, audioStream);
+        }
+        for (std::vector<float> &samples : pendingAudio) {
+            samples.erase(samples.begin(), samples.begin() + static_cast<ptrdiff_t>(offset));
+        }
+        return ok;
+    }
+
+    // Repeats the last column and row into the padding of an odd-sized
+    // source. Chroma already covers it: the converter rounds 2x2 blocks up.
+    void padLumaEdges() {
+        uchar *luma = frame->data[0];
+        const int stride = frame->linesize[0];
+        const int width = sourceSize.width();
+        const int height = sourceSize.height();
+        if (width < frameSize.width()) {
+            for (int y = 0; y < height; ++y) {
+                uchar *row = luma + static_cast<qsizetype>(y) * stride;
+                row[width] = row[width - 1];
+            }
+        }
+        if (height < frameSize.height()) {
+            std::memcpy(luma + static_cast<qsizetype>(height) * stride,
+                        luma + static_cast<qsizetype>(height - 1) * stride, frameSize.width());
+        }
+    }
+
+    // Moves every packet the encoder has ready into the muxer
+    bool writePendingPackets(AVCodecContext *context, AVStream *target) {
+        while (true) {
+            int ret = avcodec_receive_packet(context, packet);
+            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+                return true;
+            }
+            if (ret < 0) {
+                lastError = QString("Failed to encode frame: %1").arg(avErrorString(ret));
+                return false;
+            }
+
+            av_packet_rescale_ts(packet, context->time_base, target->time_base);
+            packet->stream_index = target->index;
+            ret = av_interleaved_write_frame(formatContext, packet);
+            if (ret < 0) {
+                lastError = QString("Failed to write packet: %1").arg(avErrorString(ret));
+                return false;
+            }
+        }
+    }
+
+    void cleanup() {
+        closeAudio();
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+        avcodec_free_context(&codecContext);
+        if (formatContext) {
+            if (!(formatContext->oformat->flags & AVFMT_NOFILE)) {
+                avio_closep(&formatContext->pb);
+            }
+            avformat_free_context(formatContext);
+            formatContext = nullptr;
+        }
+        stream = nullptr;
+        running = false;
+    }
+};
+
+LibavEncoder::LibavEncoder(QObject *parent)
+    : IVideoEncoder(parent)
+    , d(new LibavEncoderPrivate)
+{
+}
+
+LibavEncoder::~LibavEncoder()
+{
+    abort();
+    delete d;
+}
+
+bool LibavEncoder::isAvailable() const
+{
+    return findH264Encoder() != nullptr;
+}
+
+QString LibavEncoder::encoderName() const
+{
+    const AVCodec *codec = findH264Encoder();
+    return codec ? QString("libavcodec (%1)").arg(QString::fromUtf8(codec->name))
+                 : QString("libavcodec");
+}
+
+bool LibavEncoder::start(const QString &outputPath, const QSize &frameSize, int frameRate)
+{
+    if (d->running) {
+        d->lastError = "Encoder already running";
+        return false;
+    }
+
+    const AVCodec *codec = findH264Encoder();
+    if (!codec) {
+        d->lastError = "No H.264 encoder available in libavcodec";
+        return false;
+    }
+
+    if (frameSize.width() < 2 || frameSize.height() < 2) {
+        d->lastError = QString("Frame size too small: %1x%2 (minimum 2x2)")
+            .arg(frameSize.width()).arg(frameSize.height());
+        return false;
+    }
+
+    // Ensure dimensions are even (required for 4:2:0 H.264)
+    d->outputPath = outputPath;
+    d->sourceSize = frameSize;
+    d->frameSize = QSize((frameSize.width() + 1) & ~1, (frameSize.height() + 1) & ~1);
+    d->frameRate = qBound(1, frameRate, 240);
+    d->framesWritten = 0;
+    d->lastPts = -1;
+    d->warnedAboutFrameResize = false;
+
+    // Remove existing file if present
+    QFile::remove(outputPath);
+
+    if (!d->openOutput(codec)) {
+        qWarning() << "LibavEncoder:" << d->lastError;
+        d->cleanup();
+        QFile::remove(outputPath);
+        return false;
+    }
+
+    d->running = true;
+    qDebug() << "LibavEncoder: Started encoding to" << outputPath
+             << "codec:" << codec->name << "size:" << d->frameSize
+             << "fps:" << d->frameRate << "quality:" << d->quality
+             << "audio:" << d->audioEnabled;
+    return true;
+}
+
+void LibavEncoder::writeFrame(const QImage &frame, qint64 timestampMs)
+{
+    if (!d->running || frame.isNull()) {
+        return;
+    }
+
+    // Frames of the requested size are converted as is and padded to the
+    // even encoded size; only unexpected sizes are scaled
+    QImage scaledFrame = frame;
+    if (frame.size() != d->sourceSize) {
+        if (!d->warnedAboutFrameResize) {
+            qWarning() << "LibavEncoder: Frame size mismatch, using fallback scaling."
+                       << "incoming:" << frame.size() << "expected:" << d->sourceSize;
+            d->warnedAboutFrameResize = true;
+        }
+        scaledFrame = frame.scaled(d->sourceSize, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+    }
+
+    // Captured frames are already BGRA in memory; convert anything else
+    if (scaledFrame.format() != QImage::Format_RGB32
+        && scaledFrame.format() != QImage::Format_ARGB32) {
+        scaledFrame = scaledFrame.convertToFormat(QImage::Format_RGB32);
+    }
+
+    int ret = av_frame_make_writable(d->frame);
+    if (ret < 0) {
+        qWarning() << "LibavEncoder: Frame buffer not writable:" << avErrorString(ret);
+        return;
+    }
+
+    YuvConverter::I420Planes planes;
+    planes.y = d->frame->data[0];
+    planes.yStride = d->frame->linesize[0];
+    planes.u = d->frame->data[1];
+    planes.uStride = d->frame->linesize[1];
+    planes.v = d->frame->data[2];
+    planes.vStride = d->frame->linesize[2];
+    YuvConverter::bgraToI420(scaledFrame, planes);
+    if (d->sourceSize != d->frameSize) {
+        d->padLumaEdges();
+    }
+
+    // Presentation times must increase strictly, even when two frames land
+    // in the same millisecond
+    qint64 pts = timestampMs >= 0 ? timestampMs : d->framesWritten * 1000 / d->frameRate;
+    if (pts <= d->lastPts) {
+        pts = d->lastPts + 1;
+    }
+    d->frame->pts = pts;
+    d->lastPts = pts;
+
+    ret = avcodec_send_frame(d->codecContext, d->frame);
+    if (ret < 0) {
+        qWarning() << "LibavEncoder: avcodec_send_frame failed:" << avErrorString(ret);
+        return;
+    }
+    if (!d->writePendingPackets(d->codecContext, d->stream)) {
+        qWarning() << "LibavEncoder:" << d->lastError;
+        return;
+    }
+
+    d->framesWritten++;
+    emit progress(d->framesWritten);
+}
+
+void LibavEncoder::finish()
+{
+    if (!d->running) {
+        emit finished(false, QString());
+        return;
+    }
+
+    qDebug() << "LibavEncoder: Finalize on thread"
+             << reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+    QString outputPath = d->outputPath;
+    qint64 framesWritten = d->framesWritten;
+
+    // Flush frames still buffered in the encoder, then write the index
+    bool success = framesWritten > 0;
+    if (!success) {
+        d->lastError = "No frames were written";
+    } else {
+        int ret = avcodec_send_frame(d->codecContext, nullptr);
+        success = ret >= 0 && d->writePendingPackets(d->codecContext, d->stream);
+        if (success && d->audioEnabled) {
+            success = d->encodePendingAudio(true);
+            if (success) {
+                ret = avcodec_send_frame(d->audioContext, nullptr);
+                success = ret >= 0 && d->writePendingPackets(d->audioContext, d->audioStream);
+            }
+        }
+        if (success) {
+            ret = av_write_trailer(d->formatContext);
+            if (ret < 0) {
+                d->lastError = QString("Failed to finalize: %1").arg(avErrorString(ret));
+                success = false;
+            }
+        } else if (ret < 0) {
+            d->lastError = QString("Failed to flush encoder: %1").arg(avErrorString(ret));
+        }
+    }
+    d->cleanup();
+
+    if (success) {
+        qDebug() << "LibavEncoder: Finished successfully, frames:" << framesWritten;
+        emit finished(true, outputPath);
+    } else {
+        QFile::remove(outputPath);
+        qWarning() << "LibavEncoder:" << d->lastError;
+        emit error(d->lastError);
+        emit finished(false, QString());
+    }
+}
+
+void LibavEncoder::abort()
+{
+    if (!d->running) return;
+
+    QString outputPath = d->outputPath;
+    d->cleanup();
+
+    // Remove partial output file
+    QFile::remove(outputPath);
+    qDebug() << "LibavEncoder: Aborted, removed" << outputPath;
+}
+
+bool LibavEncoder::isRunning() const
+{
+    return d->running;
+}
+
+QString LibavEncoder::lastError() const
+{
+    return d->lastError;
+}
+
+qint64 LibavEncoder::framesWritten() const
+{
+    return d->framesWritten;
+}
+
+QString LibavEncoder::outputPath() const
+{
+    return d->outputPath;
+}
+
+void LibavEncoder::setQuality(int quality)
+{
+    d->quality = qBound(0, quality, 100);
+}
+
+void LibavEncoder::setAudioFormat(int sampleRate, int channels, int bitsPerSample)
+{
+    if (d->running) {
+        qDebug() << "LibavEncoder: Cannot set audio format while running";
+        return;
+    }
+    d->audioEnabled = true;
+    d->audioSampleRate = sampleRate;
+    d->audioChannels = channels;
+    d->audioBitsPerSample = bitsPerSample;
+    qDebug() << "LibavEncoder: Audio format set -" << sampleRate << "Hz,"
+             << channels << "ch," << bitsPerSample << "bit";
+}
+
+bool LibavEncoder::isAudioSupported() const
+{
+    return findAacEncoder() != nullptr;
+}
+
+bool LibavEncoder::isAudioEnabled() const
+{
+    return d->audioEnabled;
+}
+
+void LibavEncoder::writeAudioSamples(const QByteArray &pcmData, qint64 timestampMs)
+{
+    if (!d->running || !d->audioEnabled) {
+        return;
+    }
+
+    const int channels = d->audioChannels;
+    const qsizetype sampleCount = pcmData.size() / (channels * qsizetype(sizeof(qint16)));
+    if (sampleCount == 0) {
+        return;
+    }
+
+    // The first chunk places audio on the video timeline; after that the
+    // capture delivers a continuous stream, so samples simply follow on
+    if (d->nextAudioPts < 0) {
+        d->nextAudioPts = qMax<qint64>(0, timestampMs) * d->audioSampleRate / 1000;
+    }
+
+    const auto *samples = reinterpret_cast<const qint16 *>(pcmData.constData());
+    for (int channel = 0; channel < channels; ++channel) {
+        std::vector<float> &planar = d->pendingAudio[channel];
+        planar.reserve(planar.size() + sampleCount);
+        for (qsizetype i = 0; i < sampleCount; ++i) {
+            planar.push_back(samples[i * channels + channel] / 32768.0f);
+        }
+    }
+
+    if (!d->encodePendingAudio(false)) {
+        qWarning() << "LibavEncoder:" << d->lastError << "- dropping audio";
+        d->audioEnabled = false;
+    }
+}
+
+#endif // Q_OS_LINUX && SNAPTRAY_HAVE_LIBAV
@@ -13,7 +13,9 @@
 #include "qml/QmlSettingsWindow.h"
 #include "pinwindow/PinWindowPlacement.h"
 #include "ImageColorSpaceHelper.h"
+#include "cli/CLIHandler.h"
 #include "cli/IPCProtocol.h"
+#include "cli/IPCServerSession.h"
 #include "hotkey/HotkeyManager.h"
 #include "qml/QmlToast.h"
 #include "qml/RecordingPreviewBackend.h"
@@ -23,6 +25,7 @@
 #include "utils/CoordinateHelper.h"
 
 #include <QFile>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QPointer>
@@ -225,6 +228,49 @@ void MainApplication::handleCLICommand(const QByteArray& commandData)
     }
 }
 
+void MainApplication::attachCLISession(SnapTray::CLI::IPCServerSession* session)
+{
+    using SnapTray::CLI::IPCServerSession;
+
+    connect(session, &IPCServerSession::commandReceived, this,
+        [this, session](quint32 requestId, const QByteArray& commandData) {
+            handleCLIRequest(session, requestId, commandData);
+        });
+}
+
+void MainApplication::handleCLIRequest(SnapTray::CLI::IPCServerSession* session,
+                                       quint32 requestId,
+                                       const QByteArray& commandData)
+{
+    using namespace SnapTray::CLI;
+
+    // The client may hang up while a command runs.
+    QPointer<IPCServerSession> guardedSession(session);
+    const IPCMessage msg = IPCMessage::fromJson(commandData);
+
+    CLIResult result;
+    bool preferSharedMemory = false;
+    if (msg.command == QLatin1String(IPCMessage::kRunCommand)) {
+        preferSharedMemory = msg.options["sharedMemory"].toBool();
+        QStringList arguments{QCoreApplication::applicationFilePath()};
+        const QJsonArray forwarded = msg.options["arguments"].toArray();
+        for (const QJsonValue& argument : forwarded) {
+            arguments.append(argument.toString());
+        }
+        qDebug() << "CLI: Running forwarded command:" << arguments.mid(1);
+        CLIHandler handler;
+        result = handler.processInMainInstance(arguments);
+    }
+    else {
+        handleCLICommand(commandData);
+        result = CLIResult::success();
+    }
+
+    if (guardedSession) {
+        guardedSession->sendResult(requestId, result, preferSharedMemory);
+    }
+}
+
 void MainApplication::initialize()
 {
     // Create pin window manager first (needed by capture manager)
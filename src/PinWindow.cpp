@@ -831,6 +831,10 @@ void PinWindow::compensateNewestEmojiIfNeeded(const AnnotationItem* previousLast
 
     auto* newestEmoji = dynamic_cast<EmojiStickerAnnotation*>(newestItem);
     applyEmojiOrientationCompensation(newestEmoji);
+    if (newestEmoji) {
+        // Orientation changes the item's footprint after addItem() marked its tiles.
+        m_annotationLayer->invalidateCacheRect(newestItem->boundingRect());
+    }
 }
 
 void PinWindow::applyStepBadgeOrientationCompensation(StepBadgeAnnotation* badgeItem) const
@@ -865,6 +869,9 @@ void PinWindow::compensateNewestStepBadgeIfNeeded(const AnnotationItem* previous
 
     auto* newestBadge = dynamic_cast<StepBadgeAnnotation*>(newestItem);
     applyStepBadgeOrientationCompensation(newestBadge);
+    if (newestBadge) {
+        m_annotationLayer->invalidateCacheRect(newestItem->boundingRect());
+    }
 }
 
 void PinWindow::setWatermarkSettings(const WatermarkRenderer::Settings& settings)
@@ -1238,6 +1245,8 @@ void PinWindow::createContextMenu()
     m_opacityInfoAction = addInfoItem(tr("Opacity"), QString("%1%").arg(qRound(m_opacity * 100)));
     m_flipHorizontalInfoAction = addInfoItem(tr("X-mirror"), m_flipHorizontal ? tr("Yes") : tr("No"));
     m_flipVerticalInfoAction = addInfoItem(tr("Y-mirror"), m_flipVertical ? tr("Yes") : tr("No"));
+    m_liveFramesInfoAction = addInfoItem(tr("Live frames"), liveFrameStatsText());
+    m_liveFramesInfoAction->setVisible(m_isLiveMode);
 
     // Live capture section - actions are updated dynamically in contextMenuEvent
     m_contextMenu->addSeparator();
@@ -1925,6 +1934,9 @@ void PinWindow::copyAllInfo()
     info << tr("Opacity: %1%").arg(qRound(m_opacity * 100));
     info << tr("X-mirror: %1").arg(m_flipHorizontal ? tr("Yes") : tr("No"));
     info << tr("Y-mirror: %1").arg(m_flipVertical ? tr("Yes") : tr("No"));
+    if (m_isLiveMode) {
+        info << tr("Live frames: %1").arg(liveFrameStatsText());
+    }
 
     QGuiApplication::clipboard()->setText(info.join("\n"));
 }
@@ -2114,6 +2126,10 @@ void PinWindow::refreshInfoMenu()
     updateInfoAction(m_opacityInfoAction, tr("Opacity"), QString("%1%").arg(qRound(m_opacity * 100)));
     updateInfoAction(m_flipHorizontalInfoAction, tr("X-mirror"), m_flipHorizontal ? tr("Yes") : tr("No"));
     updateInfoAction(m_flipVerticalInfoAction, tr("Y-mirror"), m_flipVertical ? tr("Yes") : tr("No"));
+    updateInfoAction(m_liveFramesInfoAction, tr("Live frames"), liveFrameStatsText());
+    if (m_liveFramesInfoAction) {
+        m_liveFramesInfoAction->setVisible(m_isLiveMode);
+    }
 }
 
 QString PinWindow::cacheFolderPath()
@@ -5034,10 +5050,12 @@ void PinWindow::startLiveCapture()
         return;
     }
 
-    // Timer-driven polling
+    // Timer-driven polling; the gate slows it down while the content is idle
+    m_liveFrameGate.setBaseInterval(1000 / m_captureFrameRate);
+    m_liveFrameGate.reset();
     m_captureTimer = new QTimer(this);
     connect(m_captureTimer, &QTimer::timeout, this, &PinWindow::updateLiveFrame);
-    m_captureTimer->start(1000 / m_captureFrameRate);
+    m_captureTimer->start(m_liveFrameGate.intervalMs());
 
     // Pulsing indicator animation timer
     m_liveIndicatorTimer = new QTimer(this);
@@ -5095,8 +5113,9 @@ void PinWindow::resumeLiveCapture()
     if (!m_isLiveMode || !m_livePaused) return;
 
     m_livePaused = false;
+    m_liveFrameGate.setBaseInterval(1000 / m_captureFrameRate);
     if (m_captureTimer) {
-        m_captureTimer->start(1000 / m_captureFrameRate);
+        m_captureTimer->start(m_liveFrameGate.intervalMs());
     }
     update();
 }
@@ -5109,8 +5128,9 @@ void PinWindow::setLiveFrameRate(int fps)
         m_captureEngine->setFrameRate(m_captureFrameRate);
     }
 
+    m_liveFrameGate.setBaseInterval(1000 / m_captureFrameRate);
     if (m_captureTimer && m_captureTimer->isActive()) {
-        m_captureTimer->setInterval(1000 / m_captureFrameRate);
+        m_captureTimer->setInterval(m_liveFrameGate.intervalMs());
     }
 }
 
@@ -5127,28 +5147,48 @@ void PinWindow::updateLiveFrame()
         return;
     }
 
-    QImage frame = m_captureEngine->captureFrame();
-    if (!frame.isNull()) {
-        m_originalPixmap = QPixmap::fromImage(frame);
-        m_originalPixmap.setDevicePixelRatio(sourceScreen->devicePixelRatio());
-        setContentLogicalSize(!m_sourceRegion.isEmpty()
-            ? m_sourceRegion.size()
-            : logicalSizeFromPixmap(m_originalPixmap));
-        resetSourceSampleRect();
-        clearCropUndoHistory();
+    const QImage frame = m_captureEngine->captureFrame();
+    if (frame.isNull()) {
+        return;
+    }
 
-        // Update shared pixmap for mosaic tool to use latest frame
-        m_sharedSourcePixmap = std::make_shared<const QPixmap>(m_originalPixmap);
-        if (m_toolManager) {
-            m_toolManager->setSourcePixmap(m_sharedSourcePixmap);
-        }
+    const bool changed = m_liveFrameGate.submitFrame(frame, m_captureEngine->lastDirtyRegion());
+    if (m_captureTimer && m_captureTimer->interval() != m_liveFrameGate.intervalMs()) {
+        m_captureTimer->setInterval(m_liveFrameGate.intervalMs());
+    }
+    if (!changed) {
+        // Same pixels as the painted frame: keep the pixmap and transform cache.
+        return;
+    }
 
-        // Invalidate transform cache
-        m_cachedRotation = -1;
+    m_originalPixmap = QPixmap::fromImage(frame);
+    m_originalPixmap.setDevicePixelRatio(sourceScreen->devicePixelRatio());
+    setContentLogicalSize(!m_sourceRegion.isEmpty()
+        ? m_sourceRegion.size()
+        : logicalSizeFromPixmap(m_originalPixmap));
+    resetSourceSampleRect();
+    clearCropUndoHistory();
 
-        // Update display
-        updateSize();
+    // Update shared pixmap for mosaic tool to use latest frame
+    m_sharedSourcePixmap = std::make_shared<const QPixmap>(m_originalPixmap);
+    if (m_toolManager) {
+        m_toolManager->setSourcePixmap(m_sharedSourcePixmap);
     }
+
+    // Invalidate transform cache
+    m_cachedRotation = -1;
+
+    // Update display
+    updateSize();
+}
+
+QString PinWindow::liveFrameStatsText() const
+{
+    const LiveFrameStats& stats = m_liveFrameGate.stats();
+    return tr("%1 captured, %2 skipped, %3 painted")
+        .arg(stats.captured)
+        .arg(stats.skipped)
+        .arg(stats.painted);
 }
 
 // ============================================================================
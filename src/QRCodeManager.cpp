@@ -1,4 +1,5 @@
 #include "QRCodeManager.h"
+#include "detection/DetectionResultCache.h"
 
 #include <QDebug>
 #include <QImage>
@@ -87,6 +88,30 @@ int maxEncodableBytesForEccLevel(int eccLevel)
     }
 }
 
+// The reader options are fixed at construction, so one tag covers them.
+constexpr quint64 kReaderConfigHash = 1;
+
+bool lookupCachedDecode(quint64 imageHash, const QString &notFoundError, QRDecodeResult *result)
+{
+    if (!DetectionResultCache::instance().lookup(DetectionResultCache::Kind::Barcode,
+                                                 imageHash, kReaderConfigHash, result)) {
+        return false;
+    }
+    if (!result->success) {
+        result->error = notFoundError;
+    }
+    return true;
+}
+
+// Decodes and misses are both cached; exceptions are not, so they retry.
+void storeDecode(quint64 imageHash, const QRDecodeResult &result)
+{
+    const qint64 cost = (result.text.size() + result.format.size() + result.error.size())
+                        * static_cast<qint64>(sizeof(QChar));
+    DetectionResultCache::instance().insert(DetectionResultCache::Kind::Barcode, imageHash,
+                                            kReaderConfigHash, result, cost);
+}
+
 } // anonymous namespace
 
 class QRCodeManager::Private
@@ -153,42 +178,49 @@ void QRCodeManager::decode(const QPixmap &pixmap, const QRDecodeCallback &callba
 
         qDebug() << "QRCodeManager: Thread started, creating ImageView...";
 
-        try {
-            auto imageView = createImageViewFromShared(imagePtr);
-
-            qDebug() << "QRCodeManager: Calling ReadBarcode...";
-            auto zxResult = ZXing::ReadBarcode(imageView, options);
-
-            qDebug() << "QRCodeManager: ReadBarcode completed, valid:"
-                     << zxResult.isValid();
-
-            if (zxResult.isValid()) {
-                result.success = true;
-                result.text = QString::fromStdString(zxResult.text());
-                result.format = formatToString(zxResult.format());
-
-                // Get bounding box
-                auto pos = zxResult.position();
-                int minX = std::min({pos.topLeft().x, pos.topRight().x,
-                                    pos.bottomLeft().x, pos.bottomRight().x});
-                int minY = std::min({pos.topLeft().y, pos.topRight().y,
-                                    pos.bottomLeft().y, pos.bottomRight().y});
-                int maxX = std::max({pos.topLeft().x, pos.topRight().x,
-                                    pos.bottomLeft().x, pos.bottomRight().x});
-                int maxY = std::max({pos.topLeft().y, pos.topRight().y,
-                                    pos.bottomLeft().y, pos.bottomRight().y});
-                result.boundingBox = QRect(minX, minY, maxX - minX, maxY - minY);
-
-                qDebug() << "QRCodeManager: Decoded" << result.format
-                         << "content length:" << result.text.length()
-                         << "bbox:" << result.boundingBox;
-            } else {
-                result.error = QObject::tr("No barcode found in image");
-                qDebug() << "QRCodeManager: No barcode found";
+        const QString notFoundError = QObject::tr("No barcode found in image");
+        const quint64 imageHash = DetectionResultCache::hashImage(*imagePtr);
+        if (lookupCachedDecode(imageHash, notFoundError, &result)) {
+            qDebug() << "QRCodeManager: Reusing cached result, valid:" << result.success;
+        } else {
+            try {
+                auto imageView = createImageViewFromShared(imagePtr);
+
+                qDebug() << "QRCodeManager: Calling ReadBarcode...";
+                auto zxResult = ZXing::ReadBarcode(imageView, options);
+
+                qDebug() << "QRCodeManager: ReadBarcode completed, valid:"
+                         << zxResult.isValid();
+
+                if (zxResult.isValid()) {
+                    result.success = true;
+                    result.text = QString::fromStdString(zxResult.text());
+                    result.format = formatToString(zxResult.format());
+
+                    // Get bounding box
+                    auto pos = zxResult.position();
+                    int minX = std::min({pos.topLeft().x, pos.topRight().x,
+                                        pos.bottomLeft().x, pos.bottomRight().x});
+                    int minY = std::min({pos.topLeft().y, pos.topRight().y,
+                                        pos.bottomLeft().y, pos.bottomRight().y});
+                    int maxX = std::max({pos.topLeft().x, pos.topRight().x,
+                                        pos.bottomLeft().x, pos.bottomRight().x});
+                    int maxY = std::max({pos.topLeft().y, pos.topRight().y,
+                                        pos.bottomLeft().y, pos.bottomRight().y});
+                    result.boundingBox = QRect(minX, minY, maxX - minX, maxY - minY);
+
+                    qDebug() << "QRCodeManager: Decoded" << result.format
+                             << "content length:" << result.text.length()
+                             << "bbox:" << result.boundingBox;
+                } else {
+                    result.error = notFoundError;
+                    qDebug() << "QRCodeManager: No barcode found";
+                }
+                storeDecode(imageHash, result);
+            } catch (const std::exception &e) {
+                result.error = QString::fromStdString(e.what());
+                qDebug() << "QRCodeManager: Exception:" << result.error;
             }
-        } catch (const std::exception &e) {
-            result.error = QString::fromStdString(e.what());
-            qDebug() << "QRCodeManager: Exception:" << result.error;
         }
 
         // Return to main thread
@@ -219,6 +251,11 @@ QRDecodeResult QRCodeManager::decodeSync(const QPixmap &pixmap)
             image = image.convertToFormat(QImage::Format_RGB888);
         }
 
+        const quint64 imageHash = DetectionResultCache::hashImage(image);
+        if (lookupCachedDecode(imageHash, tr("No barcode found"), &result)) {
+            return result;
+        }
+
         // Use shared pointer for consistency with async version
         auto imagePtr = std::make_shared<QImage>(image);
         auto imageView = createImageViewFromShared(imagePtr);
@@ -243,6 +280,7 @@ QRDecodeResult QRCodeManager::decodeSync(const QPixmap &pixmap)
         } else {
             result.error = tr("No barcode found");
         }
+        storeDecode(imageHash, result);
     } catch (const std::exception &e) {
         result.error = QString::fromStdString(e.what());
     }
@@ -744,6 +744,13 @@ void RecordingManager::onInitializationComplete(const QSharedPointer<RecordingIn
         }
     }
 
+    // Captured frames go through a buffer pool sized for the physical
+    // capture region instead of a fresh allocation per frame. Engines that
+    // hand over their own images replace the buffers, so only the slots are
+    // set up for them.
+    m_encodingWorker->configureFramePool(task->config().frameSize, 0,
+                                         m_captureEngine->writesInPlace());
+
     const quint64 encodingGeneration = ++m_encodingGeneration;
     const bool useDedicatedEncodingThread = shouldUseDedicatedEncodingThread(hasNativeEncoder);
     if (useDedicatedEncodingThread) {
@@ -1010,26 +1017,33 @@ void RecordingManager::captureFrame()
         return;
     }
 
-    // Capture frame using the capture engine (fast - returns cached frame)
-    QImage frame = captureEngine->captureFrame();
+    // Lease a pooled buffer. None is free when the encoder has fallen behind
+    // by the whole pool; the frame is dropped and counted by the pool.
+    const int slot = encodingWorker->acquireFrameBuffer();
+    if (slot < 0) {
+        return;
+    }
 
-    if (!frame.isNull()) {
-        // Calculate timestamp (keep on main thread for accuracy)
-        qint64 elapsedMs = 0;
-        {
-            QMutexLocker locker(&m_durationMutex);
-            qint64 rawElapsed = m_elapsedTimer.elapsed();
-            elapsedMs = rawElapsed - m_pausedDuration;
-        }
-        if (elapsedMs < 0) {
-            elapsedMs = 0;
-        }
+    // Capture into the leased buffer (engines hand over their cached frame)
+    if (!captureEngine->captureFrameInto(encodingWorker->frameBuffer(slot))) {
+        encodingWorker->cancelFrameBuffer(slot);
+        return;
+    }
 
-        // Enqueue frame for encoding (non-blocking)
-        // Watermark is applied by the worker thread
-        EncodingWorker::FrameData frameData{frame, elapsedMs};
-        encodingWorker->enqueueFrame(frameData);
+    // Calculate timestamp (keep on main thread for accuracy)
+    qint64 elapsedMs = 0;
+    {
+        QMutexLocker locker(&m_durationMutex);
+        qint64 rawElapsed = m_elapsedTimer.elapsed();
+        elapsedMs = rawElapsed - m_pausedDuration;
+    }
+    if (elapsedMs < 0) {
+        elapsedMs = 0;
+    }
 
+    // Submit the buffer for encoding (non-blocking)
+    // Watermark is applied by the worker thread
+    if (encodingWorker->submitFrameBuffer(slot, elapsedMs)) {
         m_frameCount++;
     }
 }
@@ -1140,6 +1154,10 @@ void RecordingManager::stopRecording()
 
     // Request encoding worker to finish (processes remaining queue then finishes encoder)
     if (m_encodingWorker) {
+        const FrameBufferPool::Stats poolStats = m_encodingWorker->framePoolStats();
+        qDebug() << "RecordingManager: Captured" << m_frameCount << "frames,"
+                 << poolStats.dropped << "dropped; frame pool peak"
+                 << poolStats.peakInFlight << "of" << poolStats.capacity;
         m_encodingWorker->requestFinish();
         // Worker will emit finished() when encoding is complete
     }
@@ -2,6 +2,7 @@
 #include "annotation/AnnotationContext.h"
 #include "history/AnnotationSerializer.h"
 #include "history/HistoryRecorder.h"
+#include "history/HistorySnapshotCodec.h"
 #include "platform/WindowLevel.h"
 #include "region/RegionPainter.h"
 #include "region/RegionInputHandler.h"
@@ -1696,7 +1697,8 @@ bool RegionSelector::applyHistoryReplayEntry(const SnapTray::HistoryEntry& entry
         return false;
     }
 
-    QPixmap canvas(entry.canvasPath);
+    // Older entries store the canvas as PNG; read() handles both.
+    QPixmap canvas = QPixmap::fromImage(SnapTray::HistorySnapshotCodec::read(entry.canvasPath));
     if (canvas.isNull()) {
         return false;
     }
@@ -1,5 +1,7 @@
 #include "SingleInstanceGuard.h"
 
+#include "cli/IPCServerSession.h"
+
 #include <QCryptographicHash>
 #include <QDataStream>
 #include <QDebug>
@@ -185,6 +187,7 @@ void SingleInstanceGuard::onNewConnection()
     enum class ParseResult {
         Incomplete,
         Processed,
+        HandedOff,
         Invalid
     };
 
@@ -192,7 +195,7 @@ void SingleInstanceGuard::onNewConnection()
     const QByteArray kActivateMessage = "activate";
     auto state = std::make_shared<ClientMessageState>();
 
-    auto parseBuffer = [this, state, kActivateMessage]() -> ParseResult {
+    auto parseBuffer = [this, client, state, kActivateMessage]() -> ParseResult {
         if (state->processed) {
             return ParseResult::Processed;
         }
@@ -217,6 +220,17 @@ void SingleInstanceGuard::onNewConnection()
             return ParseResult::Incomplete;
         }
 
+        // Framed protocol: the connection stays open for any number of
+        // commands and responses, so it moves to its own session object.
+        if (SnapTray::CLI::IPCFrame::hasMagicPrefix(state->buffer)) {
+            state->processed = true;
+            client->disconnect(this);
+            auto* session = new SnapTray::CLI::IPCServerSession(client, state->buffer, this);
+            emit sessionStarted(session);
+            session->start();
+            return ParseResult::HandedOff;
+        }
+
         QDataStream stream(state->buffer);
         quint32 messageSize = 0;
         stream >> messageSize;
@@ -258,7 +272,9 @@ void SingleInstanceGuard::onNewConnection()
     connect(client, &QLocalSocket::disconnected, this, [client, state, parseBuffer, cleanupClient]() {
         if (!state->processed) {
             state->buffer.append(client->readAll());
-            parseBuffer();
+            if (parseBuffer() == ParseResult::HandedOff) {
+                return;
+            }
         }
         cleanupClient();
     });
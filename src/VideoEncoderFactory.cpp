@@ -9,6 +9,10 @@
 #include "MediaFoundationEncoder.h"
 #endif
 
+#if defined(Q_OS_LINUX) && defined(SNAPTRAY_HAVE_LIBAV)
+#include "LibavEncoder.h"
+#endif
+
 IVideoEncoder* IVideoEncoder::createNativeEncoder(QObject *parent)
 {
 #ifdef Q_OS_MAC
@@ -31,6 +35,16 @@ IVideoEncoder* IVideoEncoder::createNativeEncoder(QObject *parent)
     delete encoder;
 #endif
 
+#if defined(Q_OS_LINUX) && defined(SNAPTRAY_HAVE_LIBAV)
+    auto encoder = new LibavEncoder(parent);
+    if (encoder->isAvailable()) {
+        qDebug() << "VideoEncoderFactory: Using libavcodec encoder";
+        return encoder;
+    }
+    qDebug() << "VideoEncoderFactory: No H.264 encoder in libavcodec";
+    delete encoder;
+#endif
+
     qWarning() << "VideoEncoderFactory: No native encoder available on this platform";
     return nullptr;
 }
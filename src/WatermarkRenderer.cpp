@@ -112,22 +112,37 @@ QImage WatermarkRenderer::applyToImageWithCache(const QImage &source,
     }
 
     QImage result = source.copy();
-    QPainter painter(&result);
+    if (!applyToImageInPlace(result, cachedWatermark, settings)) {
+        return source;
+    }
+
+    return result;
+}
+
+bool WatermarkRenderer::applyToImageInPlace(QImage &target,
+                                            const QImage &cachedWatermark,
+                                            const Settings &settings)
+{
+    if (!settings.enabled || cachedWatermark.isNull()) {
+        return false;
+    }
+
+    QPainter painter(&target);
 
     if (!painter.isActive()) {
-        return source;
+        return false;
     }
 
     painter.setRenderHint(QPainter::Antialiasing);
 
-    QRect targetRect(QPoint(0, 0), result.size());
+    QRect targetRect(QPoint(0, 0), target.size());
     QRect imageRect = calculateWatermarkRect(targetRect, cachedWatermark.size(), settings.position, settings.margin);
 
     painter.setOpacity(settings.opacity);
     painter.drawImage(imageRect.topLeft(), cachedWatermark);
     painter.end();
 
-    return result;
+    return true;
 }
 
 QRect WatermarkRenderer::calculateWatermarkRect(const QRect &targetRect, const QSize &size, Position position, int margin)
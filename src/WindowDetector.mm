@@ -620,6 +620,7 @@ void WindowDetector::refreshWindowList(QueryMode queryMode)
         previousScreen = m_cacheScreen;
         previousQueryMode = m_cacheQueryMode;
         m_windowCache.clear();
+        m_hitIndex.clear();
         m_cacheReady = false;
         m_cacheScreen = nullptr;
     }
@@ -675,6 +676,7 @@ void WindowDetector::refreshWindowList(QueryMode queryMode)
     {
         QMutexLocker locker(&m_cacheMutex);
         m_windowCache = std::move(newCache);
+        m_hitIndex.build(m_windowCache);
         m_cacheScreen = m_currentScreen.data();
         m_cacheQueryMode = queryMode;
         m_cacheReady = true;
@@ -964,7 +966,8 @@ std::optional<DetectedElement> WindowDetector::detectWindowAt(
             screenRect = m_currentScreen->geometry();
         }
 
-        for (const auto &window : m_windowCache) {
+        for (const uint32_t index : hitIndexLocked().candidatesAt(screenPos)) {
+            const auto &window = m_windowCache[index];
             if (!screenRect.isNull() && !window.bounds.intersects(screenRect)) {
                 continue;
             }
@@ -1112,6 +1115,7 @@ void WindowDetector::refreshWindowListAsync(QueryMode queryMode)
                 {
                     QMutexLocker locker(&guardedThis->m_cacheMutex);
                     guardedThis->m_windowCache = std::move(newCache);
+                    guardedThis->m_hitIndex.build(guardedThis->m_windowCache);
                     guardedThis->m_cacheScreen = targetScreen.data();
                     guardedThis->m_cacheQueryMode = queryMode;
                     guardedThis->m_cacheReady = true;
@@ -1,14 +1,17 @@
 #include "WindowDetector.h"
 
 #include <QByteArray>
+#include <QDebug>
 #include <QGuiApplication>
 #include <QMutexLocker>
 #include <QScreen>
+#include <QSocketNotifier>
 #include <QWindow>
 #include <QtGui/qguiapplication_platform.h>
 
 #include <algorithm>
 #include <unistd.h>
+#include <unordered_map>
 #include <unordered_set>
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
@@ -381,9 +384,12 @@ std::optional<QRect> readWindowBounds(Display* display,
         attributes.height + topExtent + bottomExtent);
 }
 
+// usesClientList is set to false when the window manager publishes no EWMH
+// client list and the root's children are used instead.
 std::vector<::Window> readRootWindowList(Display* display,
                                          ::Window rootWindow,
-                                         const X11Atoms& atoms)
+                                         const X11Atoms& atoms,
+                                         bool* usesClientList = nullptr)
 {
     std::vector<::Window> windows;
     const auto stackingValues = readCardinalListProperty(
@@ -403,6 +409,9 @@ std::vector<::Window> readRootWindowList(Display* display,
         windows.push_back(static_cast<::Window>(value));
     }
 
+    if (usesClientList) {
+        *usesClientList = !windows.empty();
+    }
     if (windows.empty()) {
         ::Window rootReturn = 0;
         ::Window parentReturn = 0;
@@ -458,6 +467,49 @@ std::unordered_set<unsigned long> ownQtTopLevelWindowIds()
     return ids;
 }
 
+// Per-window state read from the X server, before filtering.
+struct X11WindowInfo
+{
+    std::optional<QRect> physicalBounds;
+    QString title;
+    QString ownerApp;
+    qint64 ownerPid = 0;
+    ElementType elementType = ElementType::Window;
+};
+
+bool isOwnWindow(::Window window,
+                 qint64 ownerPid,
+                 const std::unordered_set<unsigned long>& ownWindowIds)
+{
+    return ownWindowIds.find(static_cast<unsigned long>(window)) != ownWindowIds.cend() ||
+           ownerPid == static_cast<qint64>(::getpid());
+}
+
+std::optional<DetectedElement> makeDetectedElement(::Window window,
+                                                   const X11WindowInfo& info,
+                                                   qreal dpr,
+                                                   DetectionFlags flags)
+{
+    if (!shouldIncludeElementType(info.elementType, flags) || !info.physicalBounds.has_value()) {
+        return std::nullopt;
+    }
+
+    const int minSize = getMinimumSize(info.elementType);
+    if (info.physicalBounds->width() < minSize || info.physicalBounds->height() < minSize) {
+        return std::nullopt;
+    }
+
+    DetectedElement element;
+    element.bounds = physicalToLogicalRect(*info.physicalBounds, dpr);
+    element.windowTitle = info.title;
+    element.ownerApp = info.ownerApp;
+    element.windowLayer = 0;
+    element.windowId = static_cast<uint32_t>(window);
+    element.elementType = info.elementType;
+    element.ownerPid = info.ownerPid;
+    return element;
+}
+
 std::vector<DetectedElement> enumerateWindowsSnapshot(qreal dpr, DetectionFlags flags)
 {
     std::vector<DetectedElement> cache;
@@ -470,56 +522,354 @@ std::vector<DetectedElement> enumerateWindowsSnapshot(qreal dpr, DetectionFlags
     const ::Window rootWindow = DefaultRootWindow(display);
     const std::vector<::Window> windows = readRootWindowList(display, rootWindow, atoms);
     const std::unordered_set<unsigned long> ownWindowIds = ownQtTopLevelWindowIds();
-    const qint64 currentPid = static_cast<qint64>(::getpid());
 
     cache.reserve(windows.size());
     for (auto it = windows.crbegin(); it != windows.crend(); ++it) {
         const ::Window window = *it;
-        if (ownWindowIds.find(static_cast<unsigned long>(window)) != ownWindowIds.cend()) {
+        X11WindowInfo info;
+        info.ownerPid = readOwnerPid(display, window, atoms);
+        if (isOwnWindow(window, info.ownerPid, ownWindowIds)) {
             continue;
         }
 
-        const qint64 ownerPid = readOwnerPid(display, window, atoms);
-        if (ownerPid == currentPid) {
+        info.elementType = classifyElementType(display, window, atoms);
+        if (!shouldIncludeElementType(info.elementType, flags)) {
             continue;
         }
 
-        const ElementType elementType = classifyElementType(display, window, atoms);
-        if (!shouldIncludeElementType(elementType, flags)) {
+        info.physicalBounds = readWindowBounds(display, rootWindow, window, atoms);
+        if (!info.physicalBounds.has_value()) {
             continue;
         }
 
-        const auto physicalBounds = readWindowBounds(display, rootWindow, window, atoms);
-        if (!physicalBounds.has_value()) {
-            continue;
+        info.title = readWindowTitle(display, window, atoms);
+        info.ownerApp = readOwnerApp(display, window, atoms);
+        if (auto element = makeDetectedElement(window, info, dpr, flags)) {
+            cache.push_back(std::move(*element));
         }
-
-        const int minSize = getMinimumSize(elementType);
-        if (physicalBounds->width() < minSize || physicalBounds->height() < minSize) {
-            continue;
-        }
-
-        DetectedElement element;
-        element.bounds = physicalToLogicalRect(*physicalBounds, dpr);
-        element.windowTitle = readWindowTitle(display, window, atoms);
-        element.ownerApp = readOwnerApp(display, window, atoms);
-        element.windowLayer = 0;
-        element.windowId = static_cast<uint32_t>(window);
-        element.elementType = elementType;
-        element.ownerPid = ownerPid;
-        cache.push_back(element);
     }
 
     return cache;
 }
 
+// Outermost ancestor below the root, i.e. the window manager's frame for a
+// reparented client, or the window itself.
+::Window topLevelAncestor(Display* display, ::Window rootWindow, ::Window window)
+{
+    ::Window current = window;
+    for (int depth = 0; depth < 16; ++depth) {
+        ::Window rootReturn = 0;
+        ::Window parent = 0;
+        ::Window* children = nullptr;
+        unsigned int childCount = 0;
+        if (XQueryTree(display, current, &rootReturn, &parent, &children, &childCount) == 0) {
+            return 0;
+        }
+        if (children) {
+            XFree(children);
+        }
+        if (parent == rootWindow || parent == 0) {
+            return current;
+        }
+        current = parent;
+    }
+    return current;
+}
+
 } // namespace
 
+/*
+ * Mirror of the X11 window list that is patched from server events instead
+ * of being re-read for every capture.
+ *
+ * It runs on its own Display connection: event masks are per client, so
+ * selecting events on Qt's connection would replace the masks Qt relies on.
+ * The root window is watched for client list changes and for structure
+ * changes of its children (which include window manager frames); each
+ * tracked client is watched for property and structure changes. Events only
+ * mark fields dirty, and dirty fields are re-read once per batch, so a
+ * refresh costs one round trip per changed property rather than several per
+ * window.
+ */
+class WindowDetector::X11WindowTracker
+{
+public:
+    static std::unique_ptr<X11WindowTracker> create(Display* qtDisplay)
+    {
+        if (!qtDisplay) {
+            return nullptr;
+        }
+        Display* display = XOpenDisplay(DisplayString(qtDisplay));
+        if (!display) {
+            qWarning() << "WindowDetector: Failed to open X11 connection for window tracking";
+            return nullptr;
+        }
+        return std::unique_ptr<X11WindowTracker>(new X11WindowTracker(display));
+    }
+
+    ~X11WindowTracker()
+    {
+        m_notifier.reset();
+        XCloseDisplay(m_display);
+    }
+
+    std::vector<DetectedElement> snapshot(qreal dpr, DetectionFlags flags)
+    {
+        sync();
+
+        std::vector<DetectedElement> cache;
+        const std::unordered_set<unsigned long> ownWindowIds = ownQtTopLevelWindowIds();
+        cache.reserve(m_windows.size());
+        for (auto it = m_stacking.crbegin(); it != m_stacking.crend(); ++it) {
+            const auto tracked = m_windows.find(static_cast<unsigned long>(*it));
+            if (tracked == m_windows.cend() ||
+                isOwnWindow(*it, tracked->second.info.ownerPid, ownWindowIds)) {
+                continue;
+            }
+            if (auto element = makeDetectedElement(*it, tracked->second.info, dpr, flags)) {
+                cache.push_back(std::move(*element));
+            }
+        }
+        return cache;
+    }
+
+private:
+    enum DirtyField : unsigned {
+        DirtyBounds = 1 << 0,
+        DirtyTitle = 1 << 1,
+        DirtyOwnerApp = 1 << 2,
+        DirtyPid = 1 << 3,
+        DirtyType = 1 << 4,
+        DirtyFrame = 1 << 5,
+        DirtyAll = DirtyBounds | DirtyTitle | DirtyOwnerApp | DirtyPid | DirtyType | DirtyFrame
+    };
+
+    struct TrackedWindow
+    {
+        X11WindowInfo info;
+        ::Window frame = 0;
+        unsigned dirty = DirtyAll;
+    };
+
+    explicit X11WindowTracker(Display* display)
+        : m_display(display)
+        , m_rootWindow(DefaultRootWindow(display))
+        , m_atoms(makeAtoms(display))
+    {
+        XSelectInput(m_display, m_rootWindow, PropertyChangeMask | SubstructureNotifyMask);
+        m_notifier = std::make_unique<QSocketNotifier>(ConnectionNumber(m_display),
+                                                       QSocketNotifier::Read);
+        QObject::connect(m_notifier.get(), &QSocketNotifier::activated,
+                         m_notifier.get(), [this]() { sync(); });
+        sync();
+    }
+
+    // Applies all queued events. Reading dirty fields can queue more events,
+    // so this goes a few rounds; anything left wakes the notifier again.
+    void sync()
+    {
+        for (int round = 0; round < 4; ++round) {
+            while (XPending(m_display) > 0) {
+                XEvent event;
+                XNextEvent(m_display, &event);
+                handleEvent(event);
+            }
+            if (m_listDirty) {
+                reloadWindowList();
+            }
+            refreshDirtyWindows();
+            if (XPending(m_display) == 0) {
+                break;
+            }
+        }
+    }
+
+    void handleEvent(const XEvent& event)
+    {
+        switch (event.type) {
+        case PropertyNotify:
+            handlePropertyNotify(event.xproperty);
+            break;
+        case CreateNotify:
+            m_listDirty = m_listDirty || !m_usesClientList;
+            break;
+        case DestroyNotify:
+            untrackWindow(event.xdestroywindow.window);
+            markDirty(event.xdestroywindow.window, DirtyFrame | DirtyBounds);
+            m_listDirty = m_listDirty || !m_usesClientList;
+            break;
+        case ReparentNotify:
+            markDirty(event.xreparent.window, DirtyFrame | DirtyBounds);
+            m_listDirty = m_listDirty || !m_usesClientList;
+            break;
+        case ConfigureNotify:
+            markDirty(event.xconfigure.window, DirtyBounds);
+            // Without a client list the stacking order is the root's child order.
+            m_listDirty = m_listDirty ||
+                          (!m_usesClientList && event.xconfigure.event == m_rootWindow);
+            break;
+        case MapNotify:
+            markDirty(event.xmap.window, DirtyBounds);
+            break;
+        case UnmapNotify:
+            markDirty(event.xunmap.window, DirtyBounds);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void handlePropertyNotify(const XPropertyEvent& event)
+    {
+        if (event.window == m_rootWindow) {
+            if (event.atom == m_atoms.netClientListStacking || event.atom == m_atoms.netClientList) {
+                m_listDirty = true;
+            }
+            return;
+        }
+
+        unsigned fields = 0;
+        if (event.atom == m_atoms.netWmName || event.atom == XA_WM_NAME) {
+            fields = DirtyTitle;
+        } else if (event.atom == m_atoms.wmClass) {
+            fields = DirtyOwnerApp;
+        } else if (event.atom == m_atoms.netWmPid) {
+            fields = DirtyPid;
+        } else if (event.atom == m_atoms.netWmWindowType) {
+            fields = DirtyType;
+        } else if (event.atom == m_atoms.netFrameExtents) {
+            fields = DirtyBounds;
+        }
+        if (fields != 0) {
+            markDirty(event.window, fields);
+        }
+    }
+
+    // window may be a tracked client or the frame of one.
+    void markDirty(::Window window, unsigned fields)
+    {
+        auto tracked = m_windows.find(static_cast<unsigned long>(window));
+        if (tracked == m_windows.end()) {
+            const auto frame = m_frameToClient.find(static_cast<unsigned long>(window));
+            if (frame == m_frameToClient.cend()) {
+                return;
+            }
+            tracked = m_windows.find(frame->second);
+            if (tracked == m_windows.end()) {
+                return;
+            }
+        }
+        if (tracked->second.dirty == 0) {
+            m_dirtyWindows.push_back(static_cast<::Window>(tracked->first));
+        }
+        tracked->second.dirty |= fields;
+    }
+
+    void reloadWindowList()
+    {
+        m_listDirty = false;
+        m_stacking = readRootWindowList(m_display, m_rootWindow, m_atoms, &m_usesClientList);
+
+        std::unordered_set<unsigned long> listed;
+        listed.reserve(m_stacking.size());
+        for (const ::Window window : m_stacking) {
+            const auto key = static_cast<unsigned long>(window);
+            listed.insert(key);
+            if (m_windows.find(key) == m_windows.cend()) {
+                // Select before reading so no change between the two is missed.
+                XSelectInput(m_display, window, PropertyChangeMask | StructureNotifyMask);
+                m_windows.emplace(key, TrackedWindow{});
+                m_dirtyWindows.push_back(window);
+            }
+        }
+
+        std::vector<::Window> removed;
+        for (const auto& tracked : m_windows) {
+            if (listed.find(tracked.first) == listed.cend()) {
+                removed.push_back(static_cast<::Window>(tracked.first));
+            }
+        }
+        for (const ::Window window : removed) {
+            XSelectInput(m_display, window, NoEventMask);
+            untrackWindow(window);
+        }
+    }
+
+    void untrackWindow(::Window window)
+    {
+        const auto tracked = m_windows.find(static_cast<unsigned long>(window));
+        if (tracked == m_windows.end()) {
+            return;
+        }
+        if (tracked->second.frame != 0) {
+            m_frameToClient.erase(static_cast<unsigned long>(tracked->second.frame));
+        }
+        m_windows.erase(tracked);
+    }
+
+    void refreshDirtyWindows()
+    {
+        std::vector<::Window> dirtyWindows;
+        dirtyWindows.swap(m_dirtyWindows);
+        for (const ::Window window : dirtyWindows) {
+            const auto tracked = m_windows.find(static_cast<unsigned long>(window));
+            if (tracked == m_windows.end() || tracked->second.dirty == 0) {
+                continue;
+            }
+
+            TrackedWindow& state = tracked->second;
+            const unsigned dirty = state.dirty;
+            state.dirty = 0;
+
+            if (dirty & DirtyFrame) {
+                if (state.frame != 0) {
+                    m_frameToClient.erase(static_cast<unsigned long>(state.frame));
+                    state.frame = 0;
+                }
+                const ::Window frame = topLevelAncestor(m_display, m_rootWindow, window);
+                if (frame != 0 && frame != window) {
+                    state.frame = frame;
+                    m_frameToClient[static_cast<unsigned long>(frame)] =
+                        static_cast<unsigned long>(window);
+                }
+            }
+            if (dirty & DirtyPid) {
+                state.info.ownerPid = readOwnerPid(m_display, window, m_atoms);
+            }
+            if (dirty & DirtyType) {
+                state.info.elementType = classifyElementType(m_display, window, m_atoms);
+            }
+            if (dirty & DirtyBounds) {
+                state.info.physicalBounds =
+                    readWindowBounds(m_display, m_rootWindow, window, m_atoms);
+            }
+            if (dirty & DirtyTitle) {
+                state.info.title = readWindowTitle(m_display, window, m_atoms);
+            }
+            if (dirty & DirtyOwnerApp) {
+                state.info.ownerApp = readOwnerApp(m_display, window, m_atoms);
+            }
+        }
+    }
+
+    Display* m_display = nullptr;
+    ::Window m_rootWindow = 0;
+    X11Atoms m_atoms;
+    std::unique_ptr<QSocketNotifier> m_notifier;
+    std::vector<::Window> m_stacking;  // Bottom to top
+    std::unordered_map<unsigned long, TrackedWindow> m_windows;
+    std::unordered_map<unsigned long, unsigned long> m_frameToClient;
+    std::vector<::Window> m_dirtyWindows;
+    bool m_usesClientList = true;
+    bool m_listDirty = true;
+};
+
 WindowDetector::WindowDetector(QObject* parent)
     : QObject(parent)
     , m_currentScreen(nullptr)
     , m_enabled(true)
     , m_detectionFlags(DetectionFlag::All)
+    , m_x11Tracker(X11WindowTracker::create(qtX11Display()))
 {
 }
 
@@ -562,15 +912,16 @@ void WindowDetector::refreshWindowList(QueryMode queryMode)
         previousScreen = m_cacheScreen;
         previousQueryMode = m_cacheQueryMode;
         m_windowCache.clear();
+        m_hitIndex.clear();
         m_cacheReady = false;
         m_cacheScreen = nullptr;
     }
 
     std::vector<DetectedElement> newCache;
     if (m_enabled) {
-        newCache = enumerateWindowsSnapshot(
-            m_currentScreen ? m_currentScreen->devicePixelRatio() : 1.0,
-            flags);
+        const qreal dpr = m_currentScreen ? m_currentScreen->devicePixelRatio() : 1.0;
+        newCache = m_x11Tracker ? m_x11Tracker->snapshot(dpr, flags)
+                                : enumerateWindowsSnapshot(dpr, flags);
         mergePreservedTopLevelElements(
             newCache,
             previousCache,
@@ -583,6 +934,7 @@ void WindowDetector::refreshWindowList(QueryMode queryMode)
     {
         QMutexLocker locker(&m_cacheMutex);
         m_windowCache = std::move(newCache);
+        m_hitIndex.build(m_windowCache);
         m_cacheScreen = m_currentScreen.data();
         m_cacheQueryMode = queryMode;
         m_cacheReady = true;
@@ -631,7 +983,7 @@ std::optional<DetectedElement> WindowDetector::detectWindowAt(const QPoint& scre
         m_cacheQueryMode == QueryMode::IncludeChildControls &&
         m_detectionFlags.testFlag(DetectionFlag::ChildControls);
 
-    for (size_t i = 0; i < m_windowCache.size(); ++i) {
+    for (const uint32_t i : hitIndexLocked().candidatesAt(screenPos)) {
         const auto& element = m_windowCache[i];
         if (element.windowLayer == 1) {
             continue;
@@ -468,12 +468,14 @@ void WindowDetector::refreshWindowList(QueryMode queryMode)
 
     QMutexLocker locker(&m_cacheMutex);
     m_windowCache.clear();
+    m_hitIndex.clear();
     m_cacheReady = false;
     m_cacheScreen = nullptr;
     enumerateWindowsInternal(
         m_windowCache,
         m_currentScreen ? m_currentScreen->devicePixelRatio() : 1.0,
         flags);
+    m_hitIndex.build(m_windowCache);
     m_cacheScreen = m_currentScreen.data();
     m_cacheQueryMode = queryMode;
     m_cacheReady = true;
@@ -579,12 +581,14 @@ std::optional<DetectedElement> WindowDetector::detectChildElementAt(
     const qint64 windowArea =
         static_cast<qint64>(topWindow.bounds.width()) * topWindow.bounds.height();
 
-    for (size_t j = topLevelIndex + 1; j < m_windowCache.size(); ++j) {
+    // Only the children overlapping the cursor's grid cell are visited; they
+    // come in cache order, so ties still go to the earlier child.
+    const WindowHitIndex &hitIndex = hitIndexLocked();
+    for (const uint32_t j : hitIndex.candidatesAt(screenPos)) {
         const auto &child = m_windowCache[j];
-
-        // Stop when we reach the next top-level window
-        if (child.windowLayer == 0) {
-            break;
+        if (j <= topLevelIndex || child.windowLayer != 1 ||
+            hitIndex.topLevelIndexOf(j) != topLevelIndex) {
+            continue;
         }
 
         if (!child.bounds.contains(screenPos)) {
@@ -639,7 +643,9 @@ std::optional<DetectedElement> WindowDetector::detectWindowAt(
     // Layout: [Window A, Child A1, Child A2, Window B, Child B1, ...]
     // Child elements (windowLayer == 1) always follow their parent window
     // (windowLayer == 0) because EnumChildWindows runs inside enumWindowsProc.
-    for (size_t i = 0; i < m_windowCache.size(); ++i) {
+    // The hit index narrows this to the elements in the cursor's grid cell,
+    // keeping the same order.
+    for (const uint32_t i : hitIndexLocked().candidatesAt(screenPos)) {
         const auto &element = m_windowCache[i];
 
         // Skip child elements at the top of the iteration -- they belong to a
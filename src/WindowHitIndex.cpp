@@ -0,0 +1,116 @@
+#include "WindowHitIndex.h"
+#include "WindowDetector.h"
+
+#include <algorithm>
+
+void WindowHitIndex::build(const std::vector<DetectedElement>& elements)
+{
+    clear();
+    m_source = elements.data();
+    m_sourceSize = elements.size();
+    m_built = true;
+
+    m_topLevelIndex.resize(elements.size(), kNoTopLevel);
+    uint32_t currentTopLevel = kNoTopLevel;
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (elements[i].windowLayer != 1) {
+            currentTopLevel = static_cast<uint32_t>(i);
+        }
+        m_topLevelIndex[i] = currentTopLevel;
+        if (!elements[i].bounds.isEmpty()) {
+            m_extent = m_extent.united(elements[i].bounds);
+        }
+    }
+    if (m_extent.isEmpty()) {
+        return;
+    }
+
+    // Cells stay at least kMinCellSize wide; a very large extent (e.g. a
+    // bogus off-screen window) grows the cells instead of the cell count.
+    const int longestSide = std::max(m_extent.width(), m_extent.height());
+    m_cellSize = std::max(kMinCellSize, (longestSide + kMaxCellsPerAxis - 1) / kMaxCellsPerAxis);
+    m_columns = (m_extent.width() + m_cellSize - 1) / m_cellSize;
+    m_rows = (m_extent.height() + m_cellSize - 1) / m_cellSize;
+
+    // Two passes over the elements: count per cell, then fill. Filling in
+    // element order keeps every cell sorted by z-order.
+    const size_t cellCount = static_cast<size_t>(m_columns) * static_cast<size_t>(m_rows);
+    m_cellOffsets.assign(cellCount + 1, 0);
+    const auto forEachCell = [this](const QRect& bounds, auto&& visit) {
+        const int firstColumn = cellColumn(bounds.left());
+        const int lastColumn = cellColumn(bounds.right());
+        const int firstRow = cellRow(bounds.top());
+        const int lastRow = cellRow(bounds.bottom());
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int column = firstColumn; column <= lastColumn; ++column) {
+                visit(static_cast<size_t>(row) * static_cast<size_t>(m_columns) +
+                      static_cast<size_t>(column));
+            }
+        }
+    };
+
+    for (const auto& element : elements) {
+        if (!element.bounds.isEmpty()) {
+            forEachCell(element.bounds, [this](size_t cell) { ++m_cellOffsets[cell + 1]; });
+        }
+    }
+    for (size_t cell = 0; cell < cellCount; ++cell) {
+        m_cellOffsets[cell + 1] += m_cellOffsets[cell];
+    }
+
+    m_cellEntries.resize(m_cellOffsets[cellCount]);
+    std::vector<uint32_t> cursor(m_cellOffsets.cbegin(), m_cellOffsets.cend() - 1);
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (!elements[i].bounds.isEmpty()) {
+            forEachCell(elements[i].bounds, [this, &cursor, i](size_t cell) {
+                m_cellEntries[cursor[cell]++] = static_cast<uint32_t>(i);
+            });
+        }
+    }
+}
+
+void WindowHitIndex::clear()
+{
+    m_source = nullptr;
+    m_sourceSize = 0;
+    m_built = false;
+    m_extent = QRect();
+    m_cellSize = kMinCellSize;
+    m_columns = 0;
+    m_rows = 0;
+    m_cellOffsets.clear();
+    m_cellEntries.clear();
+    m_topLevelIndex.clear();
+}
+
+bool WindowHitIndex::isBuiltFor(const std::vector<DetectedElement>& elements) const
+{
+    return m_built && m_source == elements.data() && m_sourceSize == elements.size();
+}
+
+WindowHitIndex::Candidates WindowHitIndex::candidatesAt(const QPoint& point) const
+{
+    if (m_columns == 0 || !m_extent.contains(point)) {
+        return {};
+    }
+
+    const size_t cell = static_cast<size_t>(cellRow(point.y())) * static_cast<size_t>(m_columns) +
+                        static_cast<size_t>(cellColumn(point.x()));
+    return Candidates(m_cellEntries.data() + m_cellOffsets[cell],
+                      m_cellEntries.data() + m_cellOffsets[cell + 1]);
+}
+
+uint32_t WindowHitIndex::topLevelIndexOf(size_t index) const
+{
+    return index < m_topLevelIndex.size() ? m_topLevelIndex[index] : kNoTopLevel;
+}
+
+int WindowHitIndex::cellColumn(int x) const
+{
+    return std::clamp((x - m_extent.left()) / m_cellSize, 0, m_columns - 1);
+}
+
+int WindowHitIndex::cellRow(int y) const
+{
+    return std::clamp((y - m_extent.top()) / m_cellSize, 0, m_rows - 1);
+}
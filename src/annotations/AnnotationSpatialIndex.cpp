@@ -0,0 +1,100 @@
+#include "annotations/AnnotationSpatialIndex.h"
+
+#include <algorithm>
+
+void AnnotationSpatialIndex::clear()
+{
+    m_cells.clear();
+    m_rects.clear();
+}
+
+qint64 AnnotationSpatialIndex::cellKey(int column, int row)
+{
+    return (static_cast<qint64>(column) << 32) ^ static_cast<quint32>(row);
+}
+
+int AnnotationSpatialIndex::cellCoordinate(int value)
+{
+    // Floor division so negative coordinates (items dragged off-canvas) map
+    // to their own cells instead of sharing cell 0.
+    return value >= 0 ? value / kCellSize : -((-value - 1) / kCellSize) - 1;
+}
+
+void AnnotationSpatialIndex::append(const QRect& rect)
+{
+    const int index = static_cast<int>(m_rects.size());
+    m_rects.push_back(rect);
+    if (rect.isEmpty()) {
+        return;
+    }
+
+    const int lastColumn = cellCoordinate(rect.right());
+    const int lastRow = cellCoordinate(rect.bottom());
+    for (int row = cellCoordinate(rect.top()); row <= lastRow; ++row) {
+        for (int column = cellCoordinate(rect.left()); column <= lastColumn; ++column) {
+            m_cells[cellKey(column, row)].push_back(index);
+        }
+    }
+}
+
+void AnnotationSpatialIndex::removeLast()
+{
+    if (m_rects.empty()) {
+        return;
+    }
+
+    const QRect rect = m_rects.back();
+    m_rects.pop_back();
+    if (rect.isEmpty()) {
+        return;
+    }
+
+    const int lastColumn = cellCoordinate(rect.right());
+    const int lastRow = cellCoordinate(rect.bottom());
+    for (int row = cellCoordinate(rect.top()); row <= lastRow; ++row) {
+        for (int column = cellCoordinate(rect.left()); column <= lastColumn; ++column) {
+            auto it = m_cells.find(cellKey(column, row));
+            if (it == m_cells.end()) {
+                continue;
+            }
+            it->second.pop_back();
+            if (it->second.empty()) {
+                m_cells.erase(it);
+            }
+        }
+    }
+}
+
+const std::vector<int>* AnnotationSpatialIndex::candidatesAt(const QPoint& point) const
+{
+    auto it = m_cells.find(cellKey(cellCoordinate(point.x()), cellCoordinate(point.y())));
+    return it == m_cells.end() ? nullptr : &it->second;
+}
+
+std::vector<int> AnnotationSpatialIndex::query(const QRect& rect) const
+{
+    std::vector<int> result;
+    if (rect.isEmpty()) {
+        return result;
+    }
+
+    const int lastColumn = cellCoordinate(rect.right());
+    const int lastRow = cellCoordinate(rect.bottom());
+    for (int row = cellCoordinate(rect.top()); row <= lastRow; ++row) {
+        for (int column = cellCoordinate(rect.left()); column <= lastColumn; ++column) {
+            auto it = m_cells.find(cellKey(column, row));
+            if (it == m_cells.end()) {
+                continue;
+            }
+            for (int index : it->second) {
+                if (m_rects[static_cast<size_t>(index)].intersects(rect)) {
+                    result.push_back(index);
+                }
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
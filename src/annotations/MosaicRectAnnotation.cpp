@@ -1,5 +1,6 @@
 #include "annotations/MosaicRectAnnotation.h"
 #include "utils/MatConverter.h"
+#include "utils/PixelateKernel.h"
 #include <QPainter>
 #include <QDebug>
 #include <algorithm>
@@ -19,45 +20,12 @@ MosaicRectAnnotation::MosaicRectAnnotation(const QRect& rect, SharedPixmap sourc
 {
 }
 
-QRgb MosaicRectAnnotation::calculateBlockAverageColor(const QImage& image, int x, int y,
-                                                       int blockW, int blockH) const
+const QImage& MosaicRectAnnotation::sourceImage() const
 {
-    // Calculate sampling bounds
-    int startX = qBound(0, x, image.width() - 1);
-    int startY = qBound(0, y, image.height() - 1);
-    int endX = qBound(0, x + blockW, image.width());
-    int endY = qBound(0, y + blockH, image.height());
-
-    if (startX >= endX || startY >= endY) {
-        return qRgba(128, 128, 128, 255);  // Fallback gray
+    if (m_sourceImage.isNull() && m_sourcePixmap) {
+        m_sourceImage = m_sourcePixmap->toImage();
     }
-
-    // Calculate average color using scanLine for performance
-    qint64 totalR = 0, totalG = 0, totalB = 0, totalA = 0;
-    int pixelCount = 0;
-
-    for (int py = startY; py < endY; ++py) {
-        const QRgb* scanLine = reinterpret_cast<const QRgb*>(image.constScanLine(py));
-        for (int px = startX; px < endX; ++px) {
-            QRgb pixel = scanLine[px];
-            totalR += qRed(pixel);
-            totalG += qGreen(pixel);
-            totalB += qBlue(pixel);
-            totalA += qAlpha(pixel);
-            ++pixelCount;
-        }
-    }
-
-    if (pixelCount == 0) {
-        return qRgba(128, 128, 128, 255);
-    }
-
-    return qRgba(
-        static_cast<int>(totalR / pixelCount),
-        static_cast<int>(totalG / pixelCount),
-        static_cast<int>(totalB / pixelCount),
-        static_cast<int>(totalA / pixelCount)
-    );
+    return m_sourceImage;
 }
 
 QImage MosaicRectAnnotation::applyPixelatedMosaic(qreal dpr) const
@@ -81,92 +49,8 @@ QImage MosaicRectAnnotation::applyPixelatedMosaic(qreal dpr) const
         return QImage();
     }
 
-    // Determine the source region to copy (aligned to blocks)
-    // We need to fetch enough context to handle the blocks correctly
-    auto floorToBlock = [](int value, int block) {
-        int rem = value % block;
-        if (rem < 0) {
-            rem += block;
-        }
-        return value - rem;
-    };
-
-    int startBlockX = floorToBlock(deviceRect.left(), effectiveBlockSize);
-    int startBlockY = floorToBlock(deviceRect.top(), effectiveBlockSize);
-    int endBlockX = deviceRect.right();
-    int endBlockY = deviceRect.bottom();
-
-    // Calculate the union of all involved blocks
-    QRect blockAlignedRect(
-        startBlockX,
-        startBlockY,
-        endBlockX - startBlockX + effectiveBlockSize, // Add one extra block size to be safe
-        endBlockY - startBlockY + effectiveBlockSize
-    );
-    
-    // Intersect with source image bounds
-    if (!m_sourcePixmap) {
-        return QImage();
-    }
-    QRect sourceBounds(0, 0, m_sourcePixmap->width(), m_sourcePixmap->height());
-    QRect fetchRect = blockAlignedRect.intersected(sourceBounds);
-
-    if (fetchRect.isEmpty()) {
-        return QImage();
-    }
-
-    // Fetch ONLY the required part of the image
-    // This is the key optimization: avoiding full screen conversion
-    QImage sourcePatch = m_sourcePixmap->copy(fetchRect).toImage().convertToFormat(QImage::Format_ARGB32);
-
-    // Create result image in device pixels (matching deviceRect size)
-    QImage resultImage(deviceRect.size(), QImage::Format_ARGB32);
-    resultImage.fill(Qt::transparent);
-
     // Process blocks aligned to the full image grid for stable pixelation
-    // Iterate in GLOBAL coordinates (relative to full image)
-    for (int blockY = startBlockY; blockY <= endBlockY; blockY += effectiveBlockSize) {
-        for (int blockX = startBlockX; blockX <= endBlockX; blockX += effectiveBlockSize) {
-            // Check intersection with deviceRect (target area)
-            QRect blockRectGlobal(blockX, blockY, effectiveBlockSize, effectiveBlockSize);
-            QRect targetRect = blockRectGlobal.intersected(deviceRect);
-            if (targetRect.isEmpty()) {
-                continue;
-            }
-
-            // Check intersection with fetchRect (source data available)
-            QRect sampleRectGlobal = blockRectGlobal.intersected(fetchRect);
-            if (sampleRectGlobal.isEmpty()) {
-                continue;
-            }
-            
-            // Calculate local coordinates for sampling from sourcePatch
-            int localSampleX = sampleRectGlobal.x() - fetchRect.x();
-            int localSampleY = sampleRectGlobal.y() - fetchRect.y();
-
-            QRgb blockColor = calculateBlockAverageColor(
-                sourcePatch,
-                localSampleX,
-                localSampleY,
-                sampleRectGlobal.width(),
-                sampleRectGlobal.height()
-            );
-
-            int destX = targetRect.x() - deviceRect.x();
-            int destY = targetRect.y() - deviceRect.y();
-
-            for (int py = 0; py < targetRect.height(); ++py) {
-                if (destY + py >= resultImage.height()) break;
-                QRgb* destLine = reinterpret_cast<QRgb*>(resultImage.scanLine(destY + py));
-                int fillWidth = qMin(targetRect.width(), resultImage.width() - destX);
-                if (fillWidth > 0 && destX >= 0) {
-                    std::fill(destLine + destX, destLine + destX + fillWidth, blockColor);
-                }
-            }
-        }
-    }
-
-    return resultImage;
+    return PixelateKernel::pixelate(sourceImage(), deviceRect, effectiveBlockSize);
 }
 
 QImage MosaicRectAnnotation::applyGaussianBlur(qreal dpr) const
@@ -186,11 +70,11 @@ QImage MosaicRectAnnotation::applyGaussianBlur(qreal dpr) const
     }
 
     // Clamp to image bounds
-    if (!m_sourcePixmap) {
+    const QImage& source = sourceImage();
+    if (source.isNull()) {
         return QImage();
     }
-    QRect sourceBounds(0, 0, m_sourcePixmap->width(), m_sourcePixmap->height());
-    QRect clampedRect = deviceRect.intersected(sourceBounds);
+    QRect clampedRect = deviceRect.intersected(source.rect());
 
     if (clampedRect.isEmpty()) {
         return QImage();
@@ -201,8 +85,7 @@ QImage MosaicRectAnnotation::applyGaussianBlur(qreal dpr) const
     // Note: Technically for proper edge blurring we might need a margin,
     // but clampedRect is usually sufficient for visual purposes or we could expand it slightly.
     // For simplicity and correctness with existing logic, we use the intersection.
-    QImage regionImage = m_sourcePixmap->copy(clampedRect).toImage();
-    QImage rgb = regionImage.convertToFormat(QImage::Format_RGB32);
+    QImage rgb = source.copy(clampedRect).convertToFormat(QImage::Format_RGB32);
 
     // Calculate sigma based on block size (larger block = more blur)
     double sigma = static_cast<double>(m_blockSize) * sourceDpr / 2.0;
@@ -297,6 +180,7 @@ void MosaicRectAnnotation::setSourcePixmap(SharedPixmap pixmap)
         m_devicePixelRatio = 1.0;
     }
 
+    m_sourceImage = QImage();
     m_renderedCache = QPixmap();
     m_cachedRect = QRect();
     m_cachedDpr = 0.0;
@@ -1,6 +1,7 @@
 #include "annotations/MosaicStroke.h"
 #include "utils/CoordinateHelper.h"
 #include "utils/MatConverter.h"
+#include "utils/PixelateKernel.h"
 #include <QPainter>
 #include <QPainterPath>
 #include <QPainterPathStroker>
@@ -26,45 +27,12 @@ MosaicStroke::MosaicStroke(const QVector<QPoint> &points, SharedPixmap sourcePix
     }
 }
 
-QRgb MosaicStroke::calculateBlockAverageColor(const QImage &image, int x, int y,
-                                               int blockW, int blockH) const
+const QImage& MosaicStroke::sourceImage() const
 {
-    // Calculate sampling bounds
-    int startX = qBound(0, x, image.width() - 1);
-    int startY = qBound(0, y, image.height() - 1);
-    int endX = qBound(0, x + blockW, image.width());
-    int endY = qBound(0, y + blockH, image.height());
-
-    if (startX >= endX || startY >= endY) {
-        return qRgba(128, 128, 128, 255);  // Fallback gray
+    if (m_sourceImage.isNull() && m_sourcePixmap) {
+        m_sourceImage = m_sourcePixmap->toImage();
     }
-
-    // Calculate average color using scanLine for performance
-    qint64 totalR = 0, totalG = 0, totalB = 0, totalA = 0;
-    int pixelCount = 0;
-
-    for (int py = startY; py < endY; ++py) {
-        const QRgb *scanLine = reinterpret_cast<const QRgb*>(image.constScanLine(py));
-        for (int px = startX; px < endX; ++px) {
-            QRgb pixel = scanLine[px];
-            totalR += qRed(pixel);
-            totalG += qGreen(pixel);
-            totalB += qBlue(pixel);
-            totalA += qAlpha(pixel);
-            ++pixelCount;
-        }
-    }
-
-    if (pixelCount == 0) {
-        return qRgba(128, 128, 128, 255);
-    }
-
-    return qRgba(
-        static_cast<int>(totalR / pixelCount),
-        static_cast<int>(totalG / pixelCount),
-        static_cast<int>(totalB / pixelCount),
-        static_cast<int>(totalA / pixelCount)
-    );
+    return m_sourceImage;
 }
 
 QImage MosaicStroke::applyPixelatedMosaic(const QRect &strokeBounds) const
@@ -80,89 +48,8 @@ QImage MosaicStroke::applyPixelatedMosaic(const QRect &strokeBounds) const
         return QImage();
     }
 
-    auto floorToBlock = [](int value, int block) {
-        int rem = value % block;
-        if (rem < 0) {
-            rem += block;
-        }
-        return value - rem;
-    };
-
-    int startBlockX = floorToBlock(deviceStrokeBounds.left(), effectiveBlockSize);
-    int startBlockY = floorToBlock(deviceStrokeBounds.top(), effectiveBlockSize);
-    int endBlockX = deviceStrokeBounds.right();
-    int endBlockY = deviceStrokeBounds.bottom();
-
-    // Determine fetch area (aligned blocks)
-    QRect blockAlignedRect(
-        startBlockX,
-        startBlockY,
-        endBlockX - startBlockX + effectiveBlockSize,
-        endBlockY - startBlockY + effectiveBlockSize
-    );
-    
-    // Intersect with source image bounds
-    if (!m_sourcePixmap) {
-        return QImage();
-    }
-    QRect sourceBounds(0, 0, m_sourcePixmap->width(), m_sourcePixmap->height());
-    QRect fetchRect = blockAlignedRect.intersected(sourceBounds);
-
-    if (fetchRect.isEmpty()) {
-        return QImage();
-    }
-
-    // Fetch ONLY the required patch
-    QImage sourcePatch = m_sourcePixmap->copy(fetchRect).toImage().convertToFormat(QImage::Format_ARGB32);
-
-    // Create result image for the stroke bounds region
-    QImage resultImage(deviceStrokeBounds.size(), QImage::Format_ARGB32);
-    resultImage.fill(Qt::transparent);
-
     // Process blocks aligned to the full image grid for stable pixelation
-    for (int blockY = startBlockY; blockY <= endBlockY; blockY += effectiveBlockSize) {
-        for (int blockX = startBlockX; blockX <= endBlockX; blockX += effectiveBlockSize) {
-            QRect blockRectGlobal(blockX, blockY, effectiveBlockSize, effectiveBlockSize);
-            
-            // Check intersection with deviceStrokeBounds (target)
-            QRect targetRect = blockRectGlobal.intersected(deviceStrokeBounds);
-            if (targetRect.isEmpty()) {
-                continue;
-            }
-
-            // Check intersection with fetchRect (source data)
-            QRect sampleRectGlobal = blockRectGlobal.intersected(fetchRect);
-            if (sampleRectGlobal.isEmpty()) {
-                continue;
-            }
-
-            // Calculate local coordinates for sampling from sourcePatch
-            int localSampleX = sampleRectGlobal.x() - fetchRect.x();
-            int localSampleY = sampleRectGlobal.y() - fetchRect.y();
-
-            QRgb blockColor = calculateBlockAverageColor(
-                sourcePatch,
-                localSampleX,
-                localSampleY,
-                sampleRectGlobal.width(),
-                sampleRectGlobal.height()
-            );
-
-            int destX = targetRect.x() - deviceStrokeBounds.x();
-            int destY = targetRect.y() - deviceStrokeBounds.y();
-
-            for (int py = 0; py < targetRect.height(); ++py) {
-                if (destY + py >= resultImage.height()) break;
-                QRgb *destLine = reinterpret_cast<QRgb*>(resultImage.scanLine(destY + py));
-                int fillWidth = qMin(targetRect.width(), resultImage.width() - destX);
-                if (fillWidth > 0 && destX >= 0) {
-                    std::fill(destLine + destX, destLine + destX + fillWidth, blockColor);
-                }
-            }
-        }
-    }
-
-    return resultImage;
+    return PixelateKernel::pixelate(sourceImage(), deviceStrokeBounds, effectiveBlockSize);
 }
 
 QImage MosaicStroke::applyGaussianBlur(const QRect &strokeBounds) const
@@ -175,19 +62,18 @@ QImage MosaicStroke::applyGaussianBlur(const QRect &strokeBounds) const
     }
 
     // Clamp to image bounds
-    if (!m_sourcePixmap) {
+    const QImage& source = sourceImage();
+    if (source.isNull()) {
         return QImage();
     }
-    QRect sourceBounds(0, 0, m_sourcePixmap->width(), m_sourcePixmap->height());
-    QRect clampedBounds = deviceStrokeBounds.intersected(sourceBounds);
+    QRect clampedBounds = deviceStrokeBounds.intersected(source.rect());
 
     if (clampedBounds.isEmpty()) {
         return QImage();
     }
 
     // Extract region from source (Just the needed part)
-    QImage regionImage = m_sourcePixmap->copy(clampedBounds).toImage();
-    QImage rgb = regionImage.convertToFormat(QImage::Format_RGB32);
+    QImage rgb = source.copy(clampedBounds).convertToFormat(QImage::Format_RGB32);
 
     // Calculate sigma based on physical block size (larger block = more blur)
     const int physicalBlockSize = CoordinateHelper::toPhysical(
@@ -221,119 +107,198 @@ QImage MosaicStroke::applyGaussianBlur(const QRect &strokeBounds) const
     return resultImage;
 }
 
-void MosaicStroke::draw(QPainter &painter) const
+namespace {
+// Minimum slack (logical pixels) added when the render cache has to grow
+constexpr int kCacheGrowSlack = 128;
+}
+
+QImage MosaicStroke::applyEffect(const QRect &rect) const
 {
-    if (m_points.size() < 2) return;
+    switch (m_blurType) {
+    case BlurType::Gaussian: {
+        // Blur a padded area and crop it, so pixels near the edge of a
+        // segment see their real neighbours and segments join without seams.
+        const int padding = m_blockSize * 2;
+        const QRect paddedRect = rect.adjusted(-padding, -padding, padding, padding);
+        const QImage blurred = applyGaussianBlur(paddedRect);
+        if (blurred.isNull()) {
+            return QImage();
+        }
+        const QRect deviceRect = CoordinateHelper::toPhysical(rect, m_devicePixelRatio);
+        const QPoint offset = deviceRect.topLeft()
+            - CoordinateHelper::toPhysical(paddedRect, m_devicePixelRatio).topLeft();
+        return blurred.copy(QRect(offset, deviceRect.size()));
+    }
+    case BlurType::Pixelate:
+    default:
+        return applyPixelatedMosaic(rect);
+    }
+}
 
-    QRect bounds = boundingRect();
-    if (bounds.isEmpty()) return;
+void MosaicStroke::invalidateRenderCache() const
+{
+    m_renderedCache = QImage();
+    m_cachedPointCount = 0;
+    m_cachedBounds = QRect();
+    m_cachedDpr = 0.0;
+}
 
-    qreal dpr = painter.device()->devicePixelRatio();
+void MosaicStroke::growRenderCache(const QRect &bounds, qreal dpr) const
+{
+    QRect newBounds = bounds;
+    if (!m_renderedCache.isNull()) {
+        // Add slack on the sides the stroke is growing towards, so a long drag
+        // reallocates a logarithmic number of times instead of on every point.
+        const int slackX = qMax(kCacheGrowSlack, m_cachedBounds.width() / 2);
+        const int slackY = qMax(kCacheGrowSlack, m_cachedBounds.height() / 2);
+        newBounds = m_cachedBounds.united(bounds);
+        if (bounds.left() < m_cachedBounds.left()) newBounds.setLeft(newBounds.left() - slackX);
+        if (bounds.right() > m_cachedBounds.right()) newBounds.setRight(newBounds.right() + slackX);
+        if (bounds.top() < m_cachedBounds.top()) newBounds.setTop(newBounds.top() - slackY);
+        if (bounds.bottom() > m_cachedBounds.bottom()) newBounds.setBottom(newBounds.bottom() + slackY);
+    }
 
-    // Check if cache is valid
-    bool cacheValid = !m_renderedCache.isNull()
-        && m_cachedPointCount == m_points.size()
-        && m_cachedBounds == bounds
-        && m_cachedDpr == dpr;
-
-    if (!cacheValid) {
-        // Use 2x width for mosaic brush (UI shows half the actual drawing size)
-        int effectiveWidth = m_width * 2;
-        int halfWidth = effectiveWidth / 2;
-
-        // === Step 1: Create blurred/pixelated effect ===
-        QImage mosaicImage;
-        switch (m_blurType) {
-        case BlurType::Gaussian:
-            mosaicImage = applyGaussianBlur(bounds);
-            break;
-        case BlurType::Pixelate:
-        default:
-            mosaicImage = applyPixelatedMosaic(bounds);
-            break;
-        }
-        if (mosaicImage.isNull()) {
-            m_renderedCache = QPixmap();
-            return;
-        }
+    QImage grownCache(CoordinateHelper::toPhysical(newBounds.size(), dpr),
+                      QImage::Format_ARGB32_Premultiplied);
+    grownCache.fill(Qt::transparent);
+    if (!m_renderedCache.isNull()) {
+        QPainter p(&grownCache);
+        p.setCompositionMode(QPainter::CompositionMode_Source);
+        p.drawImage(CoordinateHelper::toPhysical(m_cachedBounds.topLeft() - newBounds.topLeft(), dpr),
+                    m_renderedCache);
+    }
+
+    m_renderedCache = std::move(grownCache);
+    m_cachedBounds = newBounds;
+    m_cachedDpr = dpr;
+}
+
+void MosaicStroke::renderPointsIntoCache(int firstPoint, qreal dpr) const
+{
+    // Use 2x width for mosaic brush (UI shows half the actual drawing size)
+    int effectiveWidth = m_width * 2;
+    int halfWidth = effectiveWidth / 2;
+
+    // Bounds of the new points, with the same margin as boundingRect()
+    int minX = m_points[firstPoint].x();
+    int maxX = minX;
+    int minY = m_points[firstPoint].y();
+    int maxY = minY;
+    for (int i = firstPoint + 1; i < m_points.size(); ++i) {
+        minX = qMin(minX, m_points[i].x());
+        maxX = qMax(maxX, m_points[i].x());
+        minY = qMin(minY, m_points[i].y());
+        maxY = qMax(maxY, m_points[i].y());
+    }
+    const int margin = m_width + m_blockSize;
+    const QRect patch(minX - margin, minY - margin,
+                      maxX - minX + 2 * margin, maxY - minY + 2 * margin);
+
+    // === Step 1: Create blurred/pixelated effect for the patch ===
+    const QImage mosaicImage = applyEffect(patch);
+    if (mosaicImage.isNull()) {
+        return;
+    }
 
-        // === Step 2: Create mask from stroke path (square brush) ===
-        QImage maskImage(CoordinateHelper::toPhysical(bounds.size(), dpr), QImage::Format_Grayscale8);
-        maskImage.fill(0);  // Start fully transparent
-
-        QPainter maskPainter(&maskImage);
-        maskPainter.setRenderHint(QPainter::Antialiasing, false);
-        maskPainter.setPen(Qt::NoPen);
-        maskPainter.setBrush(Qt::white);
-
-        // Interpolation step for gap-free coverage
-        int interpolationStep = qMax(1, halfWidth / 2);
-
-        // Draw squares along the stroke path with interpolation
-        for (int i = 0; i < m_points.size(); ++i) {
-            QPoint pt = m_points[i];
-            // Convert to mask coordinates (relative to bounds)
-            const QPoint maskPos = CoordinateHelper::toPhysical(pt - bounds.topLeft(), dpr);
-            const int mx = maskPos.x();
-            const int my = maskPos.y();
-            const int size = CoordinateHelper::toPhysical(QSize(effectiveWidth, effectiveWidth), dpr).width();
-
-            maskPainter.fillRect(mx - size / 2, my - size / 2, size, size, Qt::white);
-
-            // Interpolate to next point
-            if (i < m_points.size() - 1) {
-                QPoint nextPt = m_points[i + 1];
-                int dx = nextPt.x() - pt.x();
-                int dy = nextPt.y() - pt.y();
-                int distSq = dx * dx + dy * dy;
-
-                if (distSq > interpolationStep * interpolationStep) {
-                    double dist = qSqrt(static_cast<double>(distSq));
-                    int steps = static_cast<int>(dist / interpolationStep);
-
-                    for (int s = 1; s < steps; ++s) {
-                        double t = static_cast<double>(s) / steps;
-                        const QPointF interpPoint(
-                            pt.x() + dx * t - bounds.left(),
-                            pt.y() + dy * t - bounds.top());
-                        const QPoint interpPos = CoordinateHelper::toPhysical(interpPoint, dpr);
-                        const int interpX = interpPos.x();
-                        const int interpY = interpPos.y();
-                        maskPainter.fillRect(interpX - size / 2, interpY - size / 2, size, size, Qt::white);
-                    }
+    // === Step 2: Create mask from stroke path (square brush) ===
+    QImage maskImage(CoordinateHelper::toPhysical(patch.size(), dpr), QImage::Format_Grayscale8);
+    maskImage.fill(0);  // Start fully transparent
+
+    QPainter maskPainter(&maskImage);
+    maskPainter.setRenderHint(QPainter::Antialiasing, false);
+    maskPainter.setPen(Qt::NoPen);
+    maskPainter.setBrush(Qt::white);
+
+    // Interpolation step for gap-free coverage
+    int interpolationStep = qMax(1, halfWidth / 2);
+    const int size = CoordinateHelper::toPhysical(QSize(effectiveWidth, effectiveWidth), dpr).width();
+
+    // Draw squares along the stroke path with interpolation
+    for (int i = firstPoint; i < m_points.size(); ++i) {
+        QPoint pt = m_points[i];
+        // Convert to mask coordinates (relative to patch)
+        const QPoint maskPos = CoordinateHelper::toPhysical(pt - patch.topLeft(), dpr);
+        const int mx = maskPos.x();
+        const int my = maskPos.y();
+
+        maskPainter.fillRect(mx - size / 2, my - size / 2, size, size, Qt::white);
+
+        // Interpolate to next point
+        if (i < m_points.size() - 1) {
+            QPoint nextPt = m_points[i + 1];
+            int dx = nextPt.x() - pt.x();
+            int dy = nextPt.y() - pt.y();
+            int distSq = dx * dx + dy * dy;
+
+            if (distSq > interpolationStep * interpolationStep) {
+                double dist = qSqrt(static_cast<double>(distSq));
+                int steps = static_cast<int>(dist / interpolationStep);
+
+                for (int s = 1; s < steps; ++s) {
+                    double t = static_cast<double>(s) / steps;
+                    const QPointF interpPoint(
+                        pt.x() + dx * t - patch.left(),
+                        pt.y() + dy * t - patch.top());
+                    const QPoint interpPos = CoordinateHelper::toPhysical(interpPoint, dpr);
+                    const int interpX = interpPos.x();
+                    const int interpY = interpPos.y();
+                    maskPainter.fillRect(interpX - size / 2, interpY - size / 2, size, size, Qt::white);
                 }
             }
         }
-        maskPainter.end();
-
-        // === Step 3: Composite mosaic image using mask ===
-        // Apply mask to mosaic image
-        for (int y = 0; y < qMin(mosaicImage.height(), maskImage.height()); ++y) {
-            QRgb *pixelRow = reinterpret_cast<QRgb*>(mosaicImage.scanLine(y));
-            const uchar *maskRow = maskImage.constScanLine(y);
-
-            for (int x = 0; x < qMin(mosaicImage.width(), maskImage.width()); ++x) {
-                int alpha = maskRow[x];  // 0-255 from grayscale mask
-                if (alpha == 0) {
-                    pixelRow[x] = qRgba(0, 0, 0, 0);  // Fully transparent
-                } else {
-                    // Keep original color, set alpha from mask
-                    QRgb orig = pixelRow[x];
-                    pixelRow[x] = qRgba(qRed(orig), qGreen(orig), qBlue(orig), alpha);
-                }
+    }
+    maskPainter.end();
+
+    // === Step 3: Composite masked mosaic into the cache ===
+    // Only masked pixels are written, so earlier segments are left untouched.
+    const QPoint offset = CoordinateHelper::toPhysical(patch.topLeft() - m_cachedBounds.topLeft(), dpr);
+    const int rows = (std::min)({mosaicImage.height(), maskImage.height(),
+                                 m_renderedCache.height() - offset.y()});
+    const int columns = (std::min)({mosaicImage.width(), maskImage.width(),
+                                    m_renderedCache.width() - offset.x()});
+    for (int y = 0; y < rows; ++y) {
+        const QRgb *pixelRow = reinterpret_cast<const QRgb*>(mosaicImage.constScanLine(y));
+        const uchar *maskRow = maskImage.constScanLine(y);
+        QRgb *cacheRow = reinterpret_cast<QRgb*>(m_renderedCache.scanLine(offset.y() + y)) + offset.x();
+
+        for (int x = 0; x < columns; ++x) {
+            int alpha = maskRow[x];  // 0-255 from grayscale mask
+            if (alpha != 0) {
+                // Keep original color, set alpha from mask
+                QRgb orig = pixelRow[x];
+                cacheRow[x] = qPremultiply(qRgba(qRed(orig), qGreen(orig), qBlue(orig), alpha));
             }
         }
+    }
+}
+
+void MosaicStroke::draw(QPainter &painter) const
+{
+    if (m_points.size() < 2) return;
+
+    QRect bounds = boundingRect();
+    if (bounds.isEmpty()) return;
 
-        m_renderedCache = QPixmap::fromImage(mosaicImage);
-        m_renderedCache.setDevicePixelRatio(dpr);
+    qreal dpr = painter.device()->devicePixelRatio();
 
+    if (m_cachedDpr != dpr || m_cachedPointCount > m_points.size()) {
+        invalidateRenderCache();
+    }
+    if (m_renderedCache.isNull() || !m_cachedBounds.contains(bounds)) {
+        growRenderCache(bounds, dpr);
+    }
+
+    // Only points added since the last draw are rendered. The previously last
+    // point is included so its interpolation towards the new points is drawn.
+    if (m_cachedPointCount < m_points.size()) {
+        renderPointsIntoCache(qMax(0, m_cachedPointCount - 1), dpr);
         m_cachedPointCount = m_points.size();
-        m_cachedBounds = bounds;
-        m_cachedDpr = dpr;
     }
 
-    // Draw cached result
-    painter.drawPixmap(bounds.topLeft(), m_renderedCache);
+    // Draw the part of the cache covered by the stroke
+    const QRect sourceRect = CoordinateHelper::toPhysical(
+        QRect(bounds.topLeft() - m_cachedBounds.topLeft(), bounds.size()), dpr);
+    painter.drawImage(QRectF(bounds), m_renderedCache, QRectF(sourceRect));
 }
 
 QRect MosaicStroke::boundingRect() const
@@ -375,6 +340,7 @@ void MosaicStroke::translate(const QPointF& delta)
     for (QPoint& point : m_points) {
         point += d;
     }
+    invalidateRenderCache();
 }
 
 void MosaicStroke::setSourcePixmap(SharedPixmap pixmap)
@@ -385,10 +351,8 @@ void MosaicStroke::setSourcePixmap(SharedPixmap pixmap)
         m_devicePixelRatio = 1.0;
     }
 
-    m_renderedCache = QPixmap();
-    m_cachedPointCount = 0;
-    m_cachedBounds = QRect();
-    m_cachedDpr = 0.0;
+    m_sourceImage = QImage();
+    invalidateRenderCache();
 }
 
 bool MosaicStroke::intersectsCircle(const QPoint &center, int radius) const
@@ -1,4 +1,5 @@
 #include "beautify/BeautifyRenderer.h"
+#include "beautify/ShadowNinePatch.h"
 #include "utils/CoordinateHelper.h"
 #include <QPainterPath>
 #include <QLinearGradient>
@@ -136,35 +137,32 @@ void BeautifyRenderer::drawBackground(QPainter& painter, const QRect& rect,
 void BeautifyRenderer::drawShadow(QPainter& painter, const QRect& insetRect,
                                    const BeautifySettings& settings)
 {
-    if (!settings.shadowEnabled) return;
-
-    painter.save();
-    painter.setPen(Qt::NoPen);
+    if (!settings.shadowEnabled || settings.shadowBlur <= 0) return;
 
+    // Shadows used to be drawn as up to 20 stacked rounded rects, each larger
+    // and fainter than the last. The Gaussian below keeps that look: the same
+    // opacity under the screenshot (the stacked layers composited), with
+    // spread and falloff fitted to the stack's profile.
     const int blur = settings.shadowBlur;
     const int steps = qMin(blur, 20);
     const int baseAlpha = settings.shadowColor.alpha();
 
+    qreal transparency = 1.0;
     for (int i = steps; i > 0; --i) {
         float ratio = static_cast<float>(i) / steps;
-        int expand = static_cast<int>(blur * ratio);
         int alpha = static_cast<int>(baseAlpha * (1.0f - ratio) * 0.15f);
-
-        QColor c = settings.shadowColor;
-        c.setAlpha(alpha);
-        painter.setBrush(c);
-
-        QRect shadowRect = insetRect.adjusted(
-            -expand + settings.shadowOffsetX,
-            -expand + settings.shadowOffsetY,
-            expand + settings.shadowOffsetX,
-            expand + settings.shadowOffsetY);
-
-        qreal cornerExpand = settings.cornerRadius + expand / 2.0;
-        painter.drawRoundedRect(shadowRect, cornerExpand, cornerExpand);
+        transparency *= 1.0 - alpha / 255.0;
     }
 
-    painter.restore();
+    QColor color = settings.shadowColor;
+    color.setAlphaF(static_cast<float>(1.0 - transparency));
+
+    const qreal spread = 0.36 * blur;
+    const qreal sigma = 0.24 * blur;
+    const QRectF shadowRect = QRectF(insetRect)
+        .translated(settings.shadowOffsetX, settings.shadowOffsetY)
+        .adjusted(-spread, -spread, spread, spread);
+    ShadowNinePatch::draw(painter, shadowRect, settings.cornerRadius + spread / 4.0, sigma, color);
 }
 
 void BeautifyRenderer::drawScreenshot(QPainter& painter, const QRect& insetRect,
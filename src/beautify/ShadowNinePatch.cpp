@@ -0,0 +1,294 @@
+#include "beautify/ShadowNinePatch.h"
+
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPaintDevice>
+#include <QPainter>
+#include <QtGlobal>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SNAPTRAY_SHADOW_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SNAPTRAY_SHADOW_NEON 1
+#endif
+#endif
+
+namespace {
+
+// A Gaussian is cut off at three sigma, where it has fallen below 1.2%.
+constexpr qreal kKernelReach = 3.0;
+constexpr qsizetype kCacheMaxBytes = 16 * 1024 * 1024;
+
+// Cache keys quantize geometry so that float noise from slider positions and
+// transforms does not create near-duplicate tiles.
+constexpr qreal kGeometrySteps = 16.0;
+constexpr qreal kScaleSteps = 64.0;
+
+struct TileKey {
+    int radius;
+    int sigma;
+    QRgb color;
+    int scale;
+
+    bool operator==(const TileKey& other) const
+    {
+        return radius == other.radius && sigma == other.sigma && color == other.color
+               && scale == other.scale;
+    }
+    friend size_t qHash(const TileKey& key, size_t seed = 0)
+    {
+        return qHashMulti(seed, key.radius, key.sigma, key.color, key.scale);
+    }
+};
+
+QMutex& cacheMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QCache<TileKey, QImage>& tileCache()
+{
+    static QCache<TileKey, QImage> cache(kCacheMaxBytes);   // Cost in bytes
+    return cache;
+}
+
+std::vector<float> gaussianKernel(qreal sigma)
+{
+    const int radius = qCeil(kKernelReach * sigma);
+    std::vector<float> kernel(2 * radius + 1);
+    double sum = 0.0;
+    for (int i = -radius; i <= radius; ++i) {
+        const double weight = std::exp(-(i * i) / (2.0 * sigma * sigma));
+        kernel[i + radius] = static_cast<float>(weight);
+        sum += weight;
+    }
+    for (float& weight : kernel) {
+        weight = static_cast<float>(weight / sum);
+    }
+    return kernel;
+}
+
+// out[x] += weight * in[x]
+void accumulateRow(float* out, const float* in, float weight, int width)
+{
+    int x = 0;
+#if defined(SNAPTRAY_SHADOW_SSE2)
+    const __m128 weights = _mm_set1_ps(weight);
+    for (; x + 4 <= width; x += 4) {
+        const __m128 product = _mm_mul_ps(weights, _mm_loadu_ps(in + x));
+        _mm_storeu_ps(out + x, _mm_add_ps(_mm_loadu_ps(out + x), product));
+    }
+#elif defined(SNAPTRAY_SHADOW_NEON)
+    for (; x + 4 <= width; x += 4) {
+        vst1q_f32(out + x, vmlaq_n_f32(vld1q_f32(out + x), vld1q_f32(in + x), weight));
+    }
+#endif
+    for (; x < width; ++x) {
+        out[x] += weight * in[x];
+    }
+}
+
+// Vertical pass: every output row is a weighted sum of whole input rows, so
+// the inner loop runs along contiguous memory. Rows outside are zero.
+void blurColumns(const float* src, float* dst, int width, int height,
+                 const std::vector<float>& kernel)
+{
+    const int radius = static_cast<int>(kernel.size() / 2);
+    std::fill(dst, dst + static_cast<size_t>(width) * height, 0.0f);
+    for (int y = 0; y < height; ++y) {
+        float* out = dst + static_cast<size_t>(y) * width;
+        const int first = std::max(-radius, -y);
+        const int last = std::min(radius, height - 1 - y);
+        for (int k = first; k <= last; ++k) {
+            accumulateRow(out, src + static_cast<size_t>(y + k) * width, kernel[k + radius], width);
+        }
+    }
+}
+
+void transpose(const float* src, float* dst, int width, int height)
+{
+    constexpr int kBlock = 32;
+    for (int by = 0; by < height; by += kBlock) {
+        const int yEnd = std::min(by + kBlock, height);
+        for (int bx = 0; bx < width; bx += kBlock) {
+            const int xEnd = std::min(bx + kBlock, width);
+            for (int y = by; y < yEnd; ++y) {
+                const float* row = src + static_cast<size_t>(y) * width;
+                for (int x = bx; x < xEnd; ++x) {
+                    dst[static_cast<size_t>(x) * height + y] = row[x];
+                }
+            }
+        }
+    }
+}
+
+// Renders the blurred shadow of a rounded rect of rectSize device pixels,
+// placed margin pixels in from each side of the returned image.
+QImage renderShadow(const QSizeF& rectSize, int margin, qreal radius, qreal sigma,
+                    const QColor& color)
+{
+    const QSize size(qCeil(rectSize.width()) + 2 * margin, qCeil(rectSize.height()) + 2 * margin);
+
+    QImage mask(size, QImage::Format_Alpha8);
+    mask.fill(0);
+    {
+        QPainter maskPainter(&mask);
+        maskPainter.setRenderHint(QPainter::Antialiasing, true);
+        maskPainter.setPen(Qt::NoPen);
+        maskPainter.setBrush(Qt::black);
+        maskPainter.drawRoundedRect(QRectF(QPointF(margin, margin), rectSize), radius, radius);
+    }
+    ShadowNinePatch::blurAlpha(mask, sigma);
+
+    QImage shadow(size, QImage::Format_ARGB32_Premultiplied);
+    shadow.fill(color);
+    QPainter shadowPainter(&shadow);
+    shadowPainter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+    shadowPainter.drawImage(0, 0, mask);
+    shadowPainter.end();
+    return shadow;
+}
+
+// Device pixels per logical unit, including the device pixel ratio and any
+// scaling in the world transform (the Beautify preview draws scaled down).
+qreal deviceScale(const QPainter& painter)
+{
+    const qreal dpr = painter.device() ? painter.device()->devicePixelRatio() : 1.0;
+    const QTransform& world = painter.worldTransform();
+    const qreal worldScale = std::max(std::hypot(world.m11(), world.m12()),
+                                      std::hypot(world.m21(), world.m22()));
+    return std::clamp(dpr * worldScale, 1.0 / kScaleSteps, 16.0);
+}
+
+} // namespace
+
+namespace ShadowNinePatch {
+
+void draw(QPainter& painter, const QRectF& rect, qreal radius, qreal sigma, const QColor& color)
+{
+    if (rect.isEmpty() || color.alpha() == 0) {
+        return;
+    }
+
+    const TileKey key{qRound(std::max<qreal>(radius, 0.0) * kGeometrySteps),
+                      qRound(std::max<qreal>(sigma, 0.0) * kGeometrySteps), color.rgba(),
+                      qRound(deviceScale(painter) * kScaleSteps)};
+    const qreal scale = key.scale / kScaleSteps;
+    const qreal radiusPx = key.radius / kGeometrySteps * scale;
+    const qreal sigmaPx = key.sigma / kGeometrySteps * scale;
+    const int reach = qCeil(kKernelReach * sigmaPx);
+
+    // Past the corner radius plus the blur reach the shadow is constant along
+    // each edge. The tile is a rect just large enough to have one such row and
+    // column through its middle, with a spare pixel either side so smooth
+    // scaling of that band samples identical neighbours.
+    const int inset = qCeil(radiusPx) + reach + 1;
+    const int corner = reach + inset;
+    const qreal cornerLogical = corner / scale;
+    const qreal reachLogical = reach / scale;
+    const QRectF outer = rect.adjusted(-reachLogical, -reachLogical, reachLogical, reachLogical);
+
+    painter.save();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    // Patch edges snap to whole pixels; shared edges round the same way, so
+    // there are no seams between patches.
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    if (outer.width() < 2 * cornerLogical + 1 / scale
+        || outer.height() < 2 * cornerLogical + 1 / scale) {
+        // Too small for the corners to fit; render this one size directly.
+        const QImage shadow =
+            renderShadow(rect.size() * scale, reach, radiusPx, sigmaPx, color);
+        painter.drawImage(QRectF(outer.topLeft(), QSizeF(shadow.size()) / scale), shadow);
+        painter.restore();
+        return;
+    }
+
+    QImage tile;
+    {
+        QMutexLocker locker(&cacheMutex());
+        if (const QImage* cached = tileCache().object(key)) {
+            tile = *cached;
+        }
+    }
+    if (tile.isNull()) {
+        const int side = 2 * inset + 1;
+        tile = renderShadow(QSizeF(side, side), reach, radiusPx, sigmaPx, color);
+        QMutexLocker locker(&cacheMutex());
+        tileCache().insert(key, new QImage(tile), static_cast<qsizetype>(tile.sizeInBytes()));
+    }
+
+    const qreal targetX[] = {outer.left(), outer.left() + cornerLogical,
+                             outer.right() - cornerLogical, outer.right()};
+    const qreal targetY[] = {outer.top(), outer.top() + cornerLogical,
+                             outer.bottom() - cornerLogical, outer.bottom()};
+    const int sourceEdge[] = {0, corner, corner + 1, tile.width()};
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            const QRectF target(QPointF(targetX[column], targetY[row]),
+                                QPointF(targetX[column + 1], targetY[row + 1]));
+            const QRectF source(QPointF(sourceEdge[column], sourceEdge[row]),
+                                QPointF(sourceEdge[column + 1], sourceEdge[row + 1]));
+            painter.drawImage(target, tile, source);
+        }
+    }
+    painter.restore();
+}
+
+void blurAlpha(QImage& image, qreal sigma)
+{
+    if (image.isNull() || sigma < 0.5
+        || (image.format() != QImage::Format_Alpha8
+            && image.format() != QImage::Format_Grayscale8)) {
+        return;
+    }
+
+    const int width = image.width();
+    const int height = image.height();
+    const std::vector<float> kernel = gaussianKernel(sigma);
+    std::vector<float> plane(static_cast<size_t>(width) * height);
+    std::vector<float> scratch(plane.size());
+
+    for (int y = 0; y < height; ++y) {
+        const uchar* line = image.constScanLine(y);
+        std::copy(line, line + width, plane.begin() + static_cast<ptrdiff_t>(y) * width);
+    }
+
+    // Both passes run over rows of the plane; transposing in between turns
+    // the horizontal pass into a vertical one.
+    blurColumns(plane.data(), scratch.data(), width, height, kernel);
+    transpose(scratch.data(), plane.data(), width, height);
+    blurColumns(plane.data(), scratch.data(), height, width, kernel);
+    transpose(scratch.data(), plane.data(), height, width);
+
+    for (int y = 0; y < height; ++y) {
+        uchar* line = image.scanLine(y);
+        const float* values = plane.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) {
+            line[x] = static_cast<uchar>(std::clamp(std::lround(values[x]), 0L, 255L));
+        }
+    }
+}
+
+int cachedTileCount()
+{
+    QMutexLocker locker(&cacheMutex());
+    return static_cast<int>(tileCache().count());
+}
+
+void clearCache()
+{
+    QMutexLocker locker(&cacheMutex());
+    tileCache().clear();
+}
+
+} // namespace ShadowNinePatch
@@ -755,6 +755,18 @@ QImage DXGICaptureEngine::captureFrame()
     return d->getLatestFrame();
 }
 
+bool DXGICaptureEngine::captureFrameInto(QImage &target)
+{
+    // The worker thread allocates a new image for every frame and never
+    // writes to it again, so sharing it is safe and avoids a copy here.
+    QImage frame = captureFrame();
+    if (frame.isNull()) {
+        return false;
+    }
+    target = std::move(frame);
+    return true;
+}
+
 QString DXGICaptureEngine::engineName() const
 {
     if (d->useDXGI) {
@@ -9,9 +9,16 @@
 #include "capture/DXGICaptureEngine.h"
 #endif
 
+#ifdef SNAPTRAY_HAVE_XSHM
+#include "capture/X11CaptureEngine.h"
+#include "platform/PlatformCapabilities.h"
+#endif
+
 #include <QDebug>
 #include <QScreen>
 
+#include <cstring>
+
 #ifdef Q_OS_WIN
 #include <QtGui/qscreen_platform.h>
 #include <Windows.h>
@@ -56,6 +63,31 @@ bool ICaptureEngine::setRegion(const QRect &region, const CaptureScreenInfo &scr
     return false;
 }
 
+bool ICaptureEngine::captureFrameInto(QImage &target)
+{
+    const QImage frame = captureFrame();
+    if (frame.isNull()) {
+        return false;
+    }
+
+    if (target.size() != frame.size() || target.format() != frame.format()) {
+        target = QImage(frame.size(), frame.format());
+        if (target.isNull()) {
+            return false;
+        }
+    }
+    target.setDevicePixelRatio(frame.devicePixelRatio());
+
+    // bits() detaches first if a consumer still shares the previous contents.
+    uchar *dst = target.bits();
+    const qsizetype dstStride = target.bytesPerLine();
+    const qsizetype rowBytes = qMin(dstStride, frame.bytesPerLine());
+    for (int y = 0; y < frame.height(); ++y) {
+        std::memcpy(dst + y * dstStride, frame.constScanLine(y), static_cast<size_t>(rowBytes));
+    }
+    return true;
+}
+
 ICaptureEngine *ICaptureEngine::createBestEngine(QObject *parent)
 {
 #ifdef Q_OS_MAC
@@ -74,6 +106,15 @@ ICaptureEngine *ICaptureEngine::createBestEngine(QObject *parent)
     qDebug() << "ICaptureEngine: DXGI unavailable, using Qt fallback";
 #endif
 
+#ifdef SNAPTRAY_HAVE_XSHM
+    if (SnapTray::currentPlatformCapabilities().displayServer == SnapTray::DisplayServerKind::X11 &&
+        X11CaptureEngine::isAvailable()) {
+        qDebug() << "ICaptureEngine: Using X11 shared memory engine";
+        return new X11CaptureEngine(parent);
+    }
+    qDebug() << "ICaptureEngine: X11 shared memory unavailable, using Qt fallback";
+#endif
+
     qDebug() << "ICaptureEngine: Using Qt capture engine";
     return new QtCaptureEngine(parent);
 }
@@ -114,6 +114,18 @@ QImage QtCaptureEngine::captureFrame()
     return pixmap.toImage();
 }
 
+bool QtCaptureEngine::captureFrameInto(QImage &target)
+{
+    // grabWindow() allocates a new image on every call; adopting it is
+    // cheaper than copying it into the caller's buffer.
+    QImage frame = captureFrame();
+    if (frame.isNull()) {
+        return false;
+    }
+    target = std::move(frame);
+    return true;
+}
+
 QScreen *QtCaptureEngine::resolveTargetScreen() const
 {
     const QList<QScreen *> screens = QGuiApplication::screens();
@@ -678,6 +678,18 @@ QImage SCKCaptureEngine::captureFrame()
     return QImage();
 }
 
+bool SCKCaptureEngine::captureFrameInto(QImage &target)
+{
+    // Frames wrap the stream's pixel buffers, which are read-only once
+    // delivered, so sharing one avoids a copy on the UI thread.
+    QImage frame = captureFrame();
+    if (frame.isNull()) {
+        return false;
+    }
+    target = std::move(frame);
+    return true;
+}
+
 QString SCKCaptureEngine::engineName() const
 {
     return QStringLiteral("ScreenCaptureKit");
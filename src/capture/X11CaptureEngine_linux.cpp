@@ -0,0 +1,547 @@
+#include "capture/X11CaptureEngine.h"
+
+#include <QDebug>
+#include <QHash>
+#include <QScreen>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#ifdef SNAPTRAY_HAVE_XDAMAGE
+#include <X11/extensions/Xdamage.h>
+#include <X11/extensions/Xfixes.h>
+#endif
+
+namespace {
+
+constexpr int kMinimumRegionSize = 10;
+
+// Buffers whose missed damage is tracked. Callers rotate through a small pool;
+// past this many, tracking starts over and each buffer gets one full copy.
+constexpr int kMaxTrackedTargets = 64;
+
+// Routes X errors raised while it is alive into a flag instead of the
+// process-wide handler, whose Xlib default exits the process.
+class X11ErrorTrap
+{
+public:
+    X11ErrorTrap()
+    {
+        s_errorCode.store(0);
+        m_previousHandler = XSetErrorHandler(&X11ErrorTrap::handleError);
+    }
+
+    ~X11ErrorTrap()
+    {
+        XSetErrorHandler(m_previousHandler);
+    }
+
+    bool failed(Display *display) const
+    {
+        XSync(display, False);
+        return s_errorCode.load() != 0;
+    }
+
+private:
+    static int handleError(Display *, XErrorEvent *event)
+    {
+        s_errorCode.store(event->error_code);
+        return 0;
+    }
+
+    static inline std::atomic<int> s_errorCode{0};
+    XErrorHandler m_previousHandler = nullptr;
+};
+
+bool isLocalDisplay(const char *displayName)
+{
+    // MIT-SHM only works when client and server share memory.
+    return displayName &&
+           (displayName[0] == ':' || std::strncmp(displayName, "unix:", 5) == 0);
+}
+
+bool hasRgb32Layout(const XImage *image)
+{
+    const int hostByteOrder = Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? LSBFirst : MSBFirst;
+    return image && image->bits_per_pixel == 32 && image->byte_order == hostByteOrder &&
+           image->red_mask == 0xff0000 && image->green_mask == 0x00ff00 &&
+           image->blue_mask == 0x0000ff;
+}
+
+bool hasRgb32RootVisual(Display *display)
+{
+    const int screen = DefaultScreen(display);
+    const int depth = DefaultDepth(display, screen);
+    Visual *visual = DefaultVisual(display, screen);
+    return (depth == 24 || depth == 32) && visual->c_class == TrueColor &&
+           visual->red_mask == 0xff0000 && visual->green_mask == 0x00ff00 &&
+           visual->blue_mask == 0x0000ff;
+}
+
+// X11 root coordinates are device pixels. Qt keeps each screen's origin and
+// scales only offsets within it by the device pixel ratio.
+QRect physicalCaptureRect(const QRect &logicalRegion, const CaptureScreenInfo &screenInfo)
+{
+    const qreal dpr = screenInfo.devicePixelRatio;
+    const QPoint physicalOrigin = screenInfo.physicalGeometry.isValid()
+        ? screenInfo.physicalGeometry.topLeft()
+        : screenInfo.geometry.topLeft();
+    const QPoint offset = logicalRegion.topLeft() - screenInfo.geometry.topLeft();
+    return QRect(physicalOrigin.x() + qRound(offset.x() * dpr),
+                 physicalOrigin.y() + qRound(offset.y() * dpr),
+                 qRound(logicalRegion.width() * dpr),
+                 qRound(logicalRegion.height() * dpr));
+}
+
+} // namespace
+
+class X11CaptureEngine::Private
+{
+public:
+    ~Private() { cleanup(); }
+
+    bool initialize();
+    bool createSharedImage();
+    bool createFallbackImage();
+    void initializeDamage();
+    void cleanup();
+
+    bool grab();
+    // Changed areas of the capture rect in frame pixels since the last call.
+    QRegion takeDamage();
+
+    CaptureScreenInfo screenInfo;
+    QRect physicalRect;
+    bool running = false;
+
+    Display *display = nullptr;
+    ::Window rootWindow = 0;
+    XImage *image = nullptr;
+    XShmSegmentInfo shmInfo{};
+    bool useShm = false;
+
+#ifdef SNAPTRAY_HAVE_XDAMAGE
+    Damage damage = 0;
+    XserverRegion damageRegion = 0;
+#endif
+    bool trackDamage = false;
+
+    // Damage each caller buffer has missed since it was last written, keyed by
+    // its cacheKey(). A buffer found here, untouched since, only needs those
+    // areas rewritten, so callers may rotate through several buffers.
+    QHash<qint64, QRegion> pendingDamage;
+    QRegion lastDirty;
+    QImage frame;
+};
+
+bool X11CaptureEngine::Private::initialize()
+{
+    display = XOpenDisplay(nullptr);
+    if (!display) {
+        return false;
+    }
+    rootWindow = DefaultRootWindow(display);
+
+    const QRect rootRect(0, 0,
+                         DisplayWidth(display, DefaultScreen(display)),
+                         DisplayHeight(display, DefaultScreen(display)));
+    physicalRect = physicalRect.intersected(rootRect);
+    if (physicalRect.width() < kMinimumRegionSize || physicalRect.height() < kMinimumRegionSize) {
+        return false;
+    }
+
+    useShm = isLocalDisplay(DisplayString(display)) && XShmQueryExtension(display) &&
+             createSharedImage();
+    if (!useShm && !createFallbackImage()) {
+        return false;
+    }
+    if (!hasRgb32Layout(image)) {
+        qWarning() << "X11CaptureEngine: Unsupported root visual layout";
+        return false;
+    }
+
+    initializeDamage();
+    return true;
+}
+
+bool X11CaptureEngine::Private::createSharedImage()
+{
+    const int screen = DefaultScreen(display);
+    image = XShmCreateImage(display,
+                            DefaultVisual(display, screen),
+                            static_cast<unsigned int>(DefaultDepth(display, screen)),
+                            ZPixmap,
+                            nullptr,
+                            &shmInfo,
+                            static_cast<unsigned int>(physicalRect.width()),
+                            static_cast<unsigned int>(physicalRect.height()));
+    if (!image) {
+        return false;
+    }
+
+    shmInfo.shmid = shmget(IPC_PRIVATE,
+                           static_cast<size_t>(image->bytes_per_line) * image->height,
+                           IPC_CREAT | 0600);
+    if (shmInfo.shmid < 0) {
+        XDestroyImage(image);
+        image = nullptr;
+        return false;
+    }
+
+    shmInfo.shmaddr = static_cast<char *>(shmat(shmInfo.shmid, nullptr, 0));
+    if (shmInfo.shmaddr == reinterpret_cast<char *>(-1)) {
+        shmctl(shmInfo.shmid, IPC_RMID, nullptr);
+        shmInfo = {};
+        XDestroyImage(image);
+        image = nullptr;
+        return false;
+    }
+    image->data = shmInfo.shmaddr;
+    shmInfo.readOnly = False;
+
+    X11ErrorTrap trap;
+    const bool attached = XShmAttach(display, &shmInfo) && !trap.failed(display);
+    // The id can go now: the segment lives until both sides detach.
+    shmctl(shmInfo.shmid, IPC_RMID, nullptr);
+    if (!attached) {
+        shmdt(shmInfo.shmaddr);
+        shmInfo = {};
+        image->data = nullptr;
+        XDestroyImage(image);
+        image = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool X11CaptureEngine::Private::createFallbackImage()
+{
+    const int screen = DefaultScreen(display);
+    const int bytesPerLine = physicalRect.width() * 4;
+    char *data = static_cast<char *>(std::malloc(static_cast<size_t>(bytesPerLine) * physicalRect.height()));
+    if (!data) {
+        return false;
+    }
+
+    // XDestroyImage() releases data with free().
+    image = XCreateImage(display,
+                         DefaultVisual(display, screen),
+                         static_cast<unsigned int>(DefaultDepth(display, screen)),
+                         ZPixmap,
+                         0,
+                         data,
+                         static_cast<unsigned int>(physicalRect.width()),
+                         static_cast<unsigned int>(physicalRect.height()),
+                         32,
+                         bytesPerLine);
+    if (!image) {
+        std::free(data);
+        return false;
+    }
+    return true;
+}
+
+void X11CaptureEngine::Private::initializeDamage()
+{
+#ifdef SNAPTRAY_HAVE_XDAMAGE
+    int damageEventBase = 0;
+    int damageErrorBase = 0;
+    int fixesEventBase = 0;
+    int fixesErrorBase = 0;
+    if (!XDamageQueryExtension(display, &damageEventBase, &damageErrorBase) ||
+        !XFixesQueryExtension(display, &fixesEventBase, &fixesErrorBase)) {
+        return;
+    }
+
+    X11ErrorTrap trap;
+    damage = XDamageCreate(display, rootWindow, XDamageReportNonEmpty);
+    damageRegion = XFixesCreateRegion(display, nullptr, 0);
+    if (trap.failed(display)) {
+        damage = 0;
+        damageRegion = 0;
+        return;
+    }
+    trackDamage = true;
+#endif
+}
+
+void X11CaptureEngine::Private::cleanup()
+{
+    if (!display) {
+        return;
+    }
+
+#ifdef SNAPTRAY_HAVE_XDAMAGE
+    if (damage) {
+        XDamageDestroy(display, damage);
+        damage = 0;
+    }
+    if (damageRegion) {
+        XFixesDestroyRegion(display, damageRegion);
+        damageRegion = 0;
+    }
+#endif
+    trackDamage = false;
+
+    if (image) {
+        if (useShm) {
+            XShmDetach(display, &shmInfo);
+            XSync(display, False);
+            shmdt(shmInfo.shmaddr);
+            shmInfo = {};
+            // The pixels belong to the segment, not to the image.
+            image->data = nullptr;
+        }
+        XDestroyImage(image);
+        image = nullptr;
+    }
+    useShm = false;
+
+    XCloseDisplay(display);
+    display = nullptr;
+    rootWindow = 0;
+    pendingDamage.clear();
+    lastDirty = QRegion();
+}
+
+bool X11CaptureEngine::Private::grab()
+{
+    X11ErrorTrap trap;
+    if (useShm) {
+        return XShmGetImage(display, rootWindow, image,
+                            physicalRect.x(), physicalRect.y(), AllPlanes) &&
+               !trap.failed(display);
+    }
+    return XGetSubImage(display, rootWindow,
+                        physicalRect.x(), physicalRect.y(),
+                        static_cast<unsigned int>(physicalRect.width()),
+                        static_cast<unsigned int>(physicalRect.height()),
+                        AllPlanes, ZPixmap, image, 0, 0) &&
+           !trap.failed(display);
+}
+
+QRegion X11CaptureEngine::Private::takeDamage()
+{
+    QRegion changed;
+#ifdef SNAPTRAY_HAVE_XDAMAGE
+    // Take everything accumulated since the last frame and reset it.
+    XDamageSubtract(display, damage, None, damageRegion);
+
+    int rectCount = 0;
+    XRectangle *rects = XFixesFetchRegion(display, damageRegion, &rectCount);
+    for (int i = 0; i < rectCount; ++i) {
+        const QRect damaged(rects[i].x, rects[i].y, rects[i].width, rects[i].height);
+        const QRect clipped = damaged.intersected(physicalRect);
+        if (!clipped.isEmpty()) {
+            changed += clipped.translated(-physicalRect.topLeft());
+        }
+    }
+    if (rects) {
+        XFree(rects);
+    }
+
+    // DamageNotify events are not needed; drop them so they don't pile up.
+    while (XPending(display) > 0) {
+        XEvent event;
+        XNextEvent(display, &event);
+    }
+#endif
+    return changed;
+}
+
+X11CaptureEngine::X11CaptureEngine(QObject *parent)
+    : ICaptureEngine(parent)
+    , d(new Private)
+{
+}
+
+X11CaptureEngine::~X11CaptureEngine()
+{
+    stop();
+    delete d;
+}
+
+bool X11CaptureEngine::setRegion(const QRect &region, QScreen *screen)
+{
+    if (!screen) {
+        emit error("Invalid screen");
+        return false;
+    }
+    return setRegion(region, CaptureScreenInfo::fromScreen(screen));
+}
+
+bool X11CaptureEngine::setRegion(const QRect &region, const CaptureScreenInfo &screenInfo)
+{
+    if (!screenInfo.isValid()) {
+        emit error("Invalid screen metadata");
+        return false;
+    }
+
+    m_captureRegion = region;
+    d->screenInfo = screenInfo;
+    return true;
+}
+
+bool X11CaptureEngine::start()
+{
+    if (d->running) {
+        return true;
+    }
+
+    if (!d->screenInfo.isValid()) {
+        emit error("No target screen configured");
+        return false;
+    }
+
+    if (m_captureRegion.isEmpty() || m_captureRegion.width() < kMinimumRegionSize ||
+        m_captureRegion.height() < kMinimumRegionSize) {
+        emit error("Capture region too small (minimum 10x10 pixels)");
+        return false;
+    }
+
+    d->physicalRect = physicalCaptureRect(m_captureRegion, d->screenInfo);
+    if (!d->initialize()) {
+        d->cleanup();
+        emit error("Failed to initialize X11 capture");
+        return false;
+    }
+
+    d->running = true;
+    qDebug() << "X11CaptureEngine: Started capturing region" << m_captureRegion
+             << "physical" << d->physicalRect
+             << "shm:" << d->useShm << "damage:" << d->trackDamage;
+    return true;
+}
+
+void X11CaptureEngine::stop()
+{
+    if (!d->running) {
+        return;
+    }
+    d->running = false;
+    d->cleanup();
+    d->frame = QImage();
+    qDebug() << "X11CaptureEngine: Stopped";
+}
+
+bool X11CaptureEngine::isRunning() const
+{
+    return d->running;
+}
+
+QImage X11CaptureEngine::captureFrame()
+{
+    // d->frame is shared with the returned image; the next capture only
+    // copies it if the caller still holds this frame.
+    if (!captureFrameInto(d->frame)) {
+        return QImage();
+    }
+    return d->frame;
+}
+
+bool X11CaptureEngine::captureFrameInto(QImage &target)
+{
+    if (!d->running) {
+        return false;
+    }
+
+    const QSize frameSize = d->physicalRect.size();
+    const QRect frameRect(QPoint(0, 0), frameSize);
+    const bool targetMatches = !target.isNull() && target.size() == frameSize &&
+                               target.format() == QImage::Format_RGB32;
+    const qint64 targetKey = target.cacheKey();
+
+    // Damage is taken every frame so it never spans more than one interval,
+    // and every tracked buffer accumulates it until it is written again.
+    QRegion dirty = frameRect;
+    if (d->trackDamage) {
+        const QRegion damage = d->takeDamage();
+        if (!damage.isEmpty()) {
+            for (QRegion &missed : d->pendingDamage) {
+                missed += damage;
+            }
+        }
+        const auto pending = d->pendingDamage.constFind(targetKey);
+        if (targetMatches && pending != d->pendingDamage.constEnd()) {
+            dirty = *pending;
+            if (dirty.isEmpty()) {
+                d->lastDirty = QRegion();
+                return true;
+            }
+        }
+    }
+
+    if (!d->grab()) {
+        emit error("Failed to capture frame");
+        return false;
+    }
+
+    if (target.size() != frameSize || target.format() != QImage::Format_RGB32) {
+        target = QImage(frameSize, QImage::Format_RGB32);
+        if (target.isNull()) {
+            return false;
+        }
+    }
+    target.setDevicePixelRatio(d->screenInfo.devicePixelRatio);
+
+    // bits() detaches first if a consumer still shares the previous frame.
+    uchar *dst = target.bits();
+    const qsizetype dstStride = target.bytesPerLine();
+    const qsizetype srcStride = d->image->bytes_per_line;
+    const auto *src = reinterpret_cast<const uchar *>(d->image->data);
+    for (const QRect &rect : dirty) {
+        const size_t rowBytes = static_cast<size_t>(rect.width()) * 4;
+        for (int y = rect.top(); y <= rect.bottom(); ++y) {
+            std::memcpy(dst + y * dstStride + rect.left() * 4,
+                        src + y * srcStride + rect.left() * 4,
+                        rowBytes);
+        }
+    }
+
+    // Writing changed the key; the buffer is now current.
+    if (d->trackDamage) {
+        d->pendingDamage.remove(targetKey);
+        if (d->pendingDamage.size() >= kMaxTrackedTargets) {
+            d->pendingDamage.clear();
+        }
+        d->pendingDamage.insert(target.cacheKey(), QRegion());
+    }
+    d->lastDirty = dirty;
+    return true;
+}
+
+std::optional<QRegion> X11CaptureEngine::lastDirtyRegion() const
+{
+    if (!d->trackDamage) {
+        return std::nullopt;
+    }
+    return d->lastDirty;
+}
+
+QString X11CaptureEngine::engineName() const
+{
+    return d->trackDamage ? QStringLiteral("X11 Shared Memory + Damage")
+                          : QStringLiteral("X11 Shared Memory");
+}
+
+bool X11CaptureEngine::isAvailable()
+{
+    // Cache the result to avoid opening a display connection on every call
+    static const bool available = []() {
+        Display *display = XOpenDisplay(nullptr);
+        if (!display) {
+            return false;
+        }
+        const bool usable = isLocalDisplay(DisplayString(display)) &&
+                            XShmQueryExtension(display) && hasRgb32RootVisual(display);
+        XCloseDisplay(display);
+        return usable;
+    }();
+    return available;
+}
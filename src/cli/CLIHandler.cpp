@@ -1,6 +1,7 @@
 #include "cli/CLIHandler.h"
 
 #include "cli/IPCProtocol.h"
+#include "cli/SharedImageSegment.h"
 #include "cli/commands/CanvasCommand.h"
 #include "cli/commands/ConfigCommand.h"
 #include "cli/commands/FullCommand.h"
@@ -8,11 +9,15 @@
 #include "cli/commands/PinCommand.h"
 #include "cli/commands/RegionCommand.h"
 #include "cli/commands/ScreenCommand.h"
+#include "cli/commands/TrimCommand.h"
 #include "version.h"
 
 #include <QCommandLineParser>
+#include <QJsonArray>
 #include <QTextStream>
 
+#include <memory>
+
 namespace SnapTray {
 namespace CLI {
 
@@ -23,8 +28,118 @@ bool isCompatibilityStartupArgument(const QString& argument)
     return argument.compare(QStringLiteral("--minimized"), Qt::CaseInsensitive) == 0;
 }
 
+CLIResult::Code resultCodeFromResponse(const IPCResponse& response)
+{
+    const int code = response.exitCode;
+    if (code > static_cast<int>(CLIResult::Code::Success) &&
+        code <= static_cast<int>(CLIResult::Code::InstanceError)) {
+        return static_cast<CLIResult::Code>(code);
+    }
+    return response.success ? CLIResult::Code::Success : CLIResult::Code::GeneralError;
 }
 
+void releaseSharedImage(IPCConnection& connection, const QString& key)
+{
+    IPCMessage release;
+    release.command = QLatin1String(IPCMessage::kReleaseCommand);
+    release.options["key"] = key;
+    if (connection.post(release) != 0) {
+        connection.flush(IPCProtocol::kConnectionTimeout);
+    }
+}
+
+// Runs arguments (command name first) in the main instance. Returns false
+// without a result when no instance accepts the request, so the caller can
+// run it locally; once the request is out, failures are reported instead.
+bool forwardToMainInstance(const CLICommand& command,
+                           const QCommandLineParser& parser,
+                           const QStringList& arguments,
+                           CLIResult* result)
+{
+    auto connection = std::make_shared<IPCConnection>();
+    if (!connection->connectToServer(IPCProtocol::getServerName(), IPCProtocol::kConnectionTimeout)) {
+        return false;
+    }
+
+    // Ask for the capture in shared memory, so the pixels cross over
+    // without being encoded or copied through the socket.
+    IPCMessage msg;
+    msg.command = QLatin1String(IPCMessage::kRunCommand);
+    msg.options["arguments"] = QJsonArray::fromStringList(arguments);
+    msg.options["sharedMemory"] = true;
+    quint32 requestId = connection->post(msg);
+    if (requestId == 0 || !connection->flush(IPCProtocol::kConnectionTimeout)) {
+        return false;
+    }
+
+    IPCResponse response;
+    if (!connection->waitForResponse(requestId, &response, IPCProtocol::kResponseTimeout)) {
+        *result = CLIResult::error(CLIResult::Code::InstanceError, connection->errorString());
+        return true;
+    }
+
+    const CLIResult::Code code = resultCodeFromResponse(response);
+    if (code != CLIResult::Code::Success) {
+        *result = CLIResult::error(code, response.error);
+        return true;
+    }
+
+    if (!response.sharedImage.isEmpty()) {
+        const SharedImageDescriptor descriptor =
+            SharedImageDescriptor::fromJson(response.sharedImage);
+        auto view = std::make_shared<SharedImageView>();
+        if (view->attach(descriptor)) {
+            // The writer encodes from the mapped segment; the main instance
+            // drops it once the image is out.
+            CLIResult output = command.emitForwardedImage(parser, view->image());
+            auto writeImage = std::move(output.writeData);
+            const QString key = descriptor.key;
+            if (!writeImage) {
+                releaseSharedImage(*connection, key);
+            }
+            else {
+                output.writeData = [connection, view, writeImage, key](QIODevice* device) {
+                    const bool ok = writeImage(device);
+                    releaseSharedImage(*connection, key);
+                    return ok;
+                };
+            }
+            *result = std::move(output);
+            return true;
+        }
+
+        // This process cannot map the segment. The main instance still
+        // holds the capture, so have it encode that and stream it over.
+        IPCMessage stream;
+        stream.command = QLatin1String(IPCMessage::kStreamSharedCommand);
+        stream.options["key"] = descriptor.key;
+        requestId = connection->post(stream);
+        if (requestId == 0 || !connection->flush(IPCProtocol::kConnectionTimeout) ||
+            !connection->waitForResponse(requestId, &response, IPCProtocol::kResponseTimeout)) {
+            *result = CLIResult::error(CLIResult::Code::InstanceError, connection->errorString());
+            return true;
+        }
+        if (!response.success || !response.hasData) {
+            *result = CLIResult::error(CLIResult::Code::InstanceError,
+                                       "Failed to map the shared image from SnapTray");
+            return true;
+        }
+    }
+
+    if (!response.hasData) {
+        *result = CLIResult::success(response.message);
+        return true;
+    }
+
+    // The image is copied to stdout chunk by chunk as it arrives.
+    *result = CLIResult::withDataWriter([connection, requestId](QIODevice* device) {
+        return connection->readData(requestId, device, IPCProtocol::kResponseTimeout);
+    });
+    return true;
+}
+
+} // namespace
+
 CLIHandler::CLIHandler() { registerCommands(); }
 
 CLIHandler::~CLIHandler() = default;
@@ -40,6 +155,7 @@ void CLIHandler::registerCommands()
     addCmd(std::make_unique<CanvasCommand>());
     addCmd(std::make_unique<PinCommand>());
     addCmd(std::make_unique<ConfigCommand>());
+    addCmd(std::make_unique<TrimCommand>());
 }
 
 bool CLIHandler::hasArguments(const QStringList& arguments)
@@ -54,6 +170,16 @@ bool CLIHandler::hasArguments(const QStringList& arguments)
 }
 
 CLIResult CLIHandler::process(const QStringList& arguments)
+{
+    return dispatch(arguments, false);
+}
+
+CLIResult CLIHandler::processInMainInstance(const QStringList& arguments)
+{
+    return dispatch(arguments, true);
+}
+
+CLIResult CLIHandler::dispatch(const QStringList& arguments, bool inMainInstance)
 {
     if (arguments.size() < 2) {
         return CLIResult::error(CLIResult::Code::InvalidArguments, getHelpText());
@@ -95,6 +221,22 @@ CLIResult CLIHandler::process(const QStringList& arguments)
         return CLIResult::success(parser.helpText());
     }
 
+    if (inMainInstance) {
+        if (!command->canRunInMainInstance(parser)) {
+            return CLIResult::error(
+                CLIResult::Code::InvalidArguments,
+                QString("Command cannot run in the main instance: %1").arg(command->name()));
+        }
+        return command->execute(parser);
+    }
+
+    if (command->canRunInMainInstance(parser)) {
+        CLIResult forwarded;
+        if (forwardToMainInstance(*command, parser, arguments.mid(1), &forwarded)) {
+            return forwarded;
+        }
+    }
+
     // GUI commands execute via IPC
     if (command->requiresGUI(parser)) {
         // Reuse execute() as a pre-flight validation step for GUI commands.
@@ -7,20 +7,42 @@
 #include "utils/FilenameTemplateEngine.h"
 #include "utils/ImageSaveUtils.h"
 
-#include <QBuffer>
+#include <QCommandLineParser>
 #include <QCoreApplication>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileInfo>
+#include <QFuture>
 #include <QGuiApplication>
 #include <QImage>
+#include <QList>
 #include <QPixmap>
+#include <QRegularExpression>
 #include <QScreen>
+#include <QSet>
+#include <QTextStream>
 #include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
 
 namespace SnapTray {
 namespace CLI {
 namespace {
 
+// Upper bound for --count; keeps a typo from filling the disk.
+constexpr int kMaxBurstCount = 100000;
+
+struct BurstFrame
+{
+    int number = 0;
+    QString filePath;
+    double captureMs = 0.0;
+    double encodeMs = 0.0;
+    QString error;
+};
+
 QString resolveCaptureType(const CaptureMetadata& metadata)
 {
     return metadata.captureType.isEmpty() ? QStringLiteral("Screenshot") : metadata.captureType;
@@ -38,11 +60,41 @@ QImage prepareImageForClipboard(const QPixmap& screenshot, QScreen* sourceScreen
         screenshot.toImage().convertToFormat(QImage::Format_ARGB32), sourceScreen);
 }
 
-QString resolveOutputFilePath(
-    const QPixmap& screenshot, const CaptureOutputOptions& options, const CaptureMetadata& metadata)
+// "{#}" or "{#:width}" in an explicit --output name takes the frame number;
+// other names get "_<frame>" before the extension.
+QString numberedOutputFile(const QString& outputFile, int frameNumber)
+{
+    static const QRegularExpression counterToken(QStringLiteral(R"(\{#(?::(\d+))?\})"));
+
+    const QFileInfo info(outputFile);
+    QString fileName = info.fileName();
+    if (counterToken.match(fileName).hasMatch()) {
+        QRegularExpressionMatch match;
+        while ((match = counterToken.match(fileName)).hasMatch()) {
+            const int width = qMin(match.captured(1).toInt(), 10);
+            fileName.replace(match.capturedStart(), match.capturedLength(),
+                             QStringLiteral("%1").arg(frameNumber, width, 10, QChar('0')));
+        }
+    } else if (info.suffix().isEmpty()) {
+        fileName = QStringLiteral("%1_%2").arg(fileName).arg(frameNumber);
+    } else {
+        fileName = QStringLiteral("%1_%2.%3")
+                       .arg(info.completeBaseName())
+                       .arg(frameNumber)
+                       .arg(info.suffix());
+    }
+    return outputFile.left(outputFile.size() - info.fileName().size()) + fileName;
+}
+
+// frameNumber > 0 names one frame of a burst.
+QString resolveOutputFilePath(const QPixmap& screenshot,
+                              const CaptureOutputOptions& options,
+                              const CaptureMetadata& metadata,
+                              int frameNumber = 0)
 {
     if (!options.outputFile.isEmpty()) {
-        return options.outputFile;
+        return frameNumber > 0 ? numberedOutputFile(options.outputFile, frameNumber)
+                               : options.outputFile;
     }
 
     QString savePath = options.savePath;
@@ -68,12 +120,68 @@ QString resolveOutputFilePath(
     context.regionIndex = -1;
     context.ext = QStringLiteral("png");
     context.dateFormat = fileSettings.loadDateFormat();
+    context.counter = frameNumber;
     context.outputDir = savePath;
 
     return FilenameTemplateEngine::buildUniqueFilePath(
         savePath, fileSettings.loadFilenameTemplate(), context);
 }
 
+// Returns an empty string on success, otherwise the error for the result.
+QString saveCaptureImage(const QImage& image, const QString& filePath)
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    ImageSaveUtils::Error saveError;
+    if (ImageSaveUtils::saveImageAtomically(image, filePath, QByteArrayLiteral("PNG"), &saveError,
+                                            ImageSaveUtils::PngCompression::Smallest)) {
+        return QString();
+    }
+    const QString detail = saveError.stage.isEmpty()
+        ? (saveError.message.isEmpty() ? QStringLiteral("Unknown error") : saveError.message)
+        : QStringLiteral("%1: %2").arg(saveError.stage, saveError.message);
+    return QStringLiteral("Failed to save screenshot to: %1 (%2)").arg(filePath, detail);
+}
+
+double elapsedMs(const QElapsedTimer& timer)
+{
+    return static_cast<double>(timer.nsecsElapsed()) / 1e6;
+}
+
+QString formatBurstReport(const QList<BurstFrame>& frames, double totalMs)
+{
+    QString report;
+    QTextStream out(&report);
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+    out.setRealNumberPrecision(1);
+
+    int saved = 0;
+    double captureSum = 0.0;
+    double encodeSum = 0.0;
+    double captureMax = 0.0;
+    double encodeMax = 0.0;
+    out << "frame  capture_ms  encode_ms  file\n";
+    for (const BurstFrame& frame : frames) {
+        out << qSetFieldWidth(5) << frame.number << qSetFieldWidth(0) << "  "
+            << qSetFieldWidth(10) << frame.captureMs << qSetFieldWidth(0) << "  "
+            << qSetFieldWidth(9) << frame.encodeMs << qSetFieldWidth(0) << "  "
+            << (frame.error.isEmpty() ? frame.filePath : frame.error) << "\n";
+        if (frame.error.isEmpty()) {
+            ++saved;
+        }
+        captureSum += frame.captureMs;
+        encodeSum += frame.encodeMs;
+        captureMax = std::max(captureMax, frame.captureMs);
+        encodeMax = std::max(encodeMax, frame.encodeMs);
+    }
+
+    const double count = frames.isEmpty() ? 1.0 : frames.size();
+    out << "Saved " << saved << " of " << frames.size() << " frames in " << totalMs << " ms"
+        << " (capture avg " << captureSum / count << " / max " << captureMax << " ms,"
+        << " encode avg " << encodeSum / count << " / max " << encodeMax << " ms)";
+    return report;
+}
+
 } // namespace
 
 void applyOptionalDelay(int delayMs)
@@ -90,13 +198,16 @@ CLIResult emitCaptureOutput(
     QCoreApplication::processEvents();
 
     if (options.toRaw) {
-        QImage rawImage = prepareImageForRawOrSave(screenshot, metadata.sourceScreen);
-
-        QByteArray data;
-        QBuffer buffer(&data);
-        buffer.open(QIODevice::WriteOnly);
-        rawImage.save(&buffer, "PNG");
-        return CLIResult::withData(data);
+        // Encoded as the caller writes it out, one batch of rows at a time.
+        const QImage rawImage = prepareImageForRawOrSave(screenshot, metadata.sourceScreen);
+        const RawImageFormat format = options.rawFormat;
+        const bool withHeader = options.rawHeader;
+        CLIResult result =
+            CLIResult::withDataWriter([rawImage, format, withHeader](QIODevice* device) {
+                return writeRawImage(rawImage, format, withHeader, device);
+            });
+        result.image = rawImage;
+        return result;
     }
 
     if (options.toClipboard) {
@@ -111,22 +222,215 @@ CLIResult emitCaptureOutput(
 
     const QString filePath = resolveOutputFilePath(screenshot, options, metadata);
 
-    // Ensure directory exists
-    QDir().mkpath(QFileInfo(filePath).absolutePath());
-
     QImage image = prepareImageForRawOrSave(screenshot, metadata.sourceScreen);
-    ImageSaveUtils::Error saveError;
-    if (!ImageSaveUtils::saveImageAtomically(image, filePath, QByteArrayLiteral("PNG"), &saveError)) {
-        const QString detail = saveError.stage.isEmpty()
-            ? (saveError.message.isEmpty() ? QStringLiteral("Unknown error") : saveError.message)
-            : QStringLiteral("%1: %2").arg(saveError.stage, saveError.message);
-        return CLIResult::error(
-            CLIResult::Code::FileError,
-            QStringLiteral("Failed to save screenshot to: %1 (%2)").arg(filePath, detail));
+    const QString saveError = saveCaptureImage(image, filePath);
+    if (!saveError.isEmpty()) {
+        return CLIResult::error(CLIResult::Code::FileError, saveError);
     }
 
     return CLIResult::success(QString("Screenshot saved to: %1").arg(filePath));
 }
 
+void addRawOutputOptions(QCommandLineParser& parser)
+{
+    parser.addOption({"raw", "Output raw image data to stdout (PNG unless --raw-format is given)"});
+    parser.addOption({"raw-format",
+                      QString("Format for --raw: %1").arg(rawImageFormatNames()),
+                      "format",
+                      "png"});
+    parser.addOption({"raw-header",
+                      "With --raw-format rgba, start with a \"RGBA <width> <height> <stride>\" line"});
+}
+
+bool parseRawOutputOptions(const QCommandLineParser& parser,
+                           CaptureOutputOptions* options,
+                           CLIResult* error)
+{
+    const QString formatValue = parser.value("raw-format");
+    const auto format = parseRawImageFormat(formatValue);
+    if (!format.has_value()) {
+        *error = CLIResult::error(
+            CLIResult::Code::InvalidArguments,
+            QString("Invalid raw format: %1 (expected one of: %2)")
+                .arg(formatValue, rawImageFormatNames()));
+        return false;
+    }
+    if (parser.isSet("raw-header") && format.value() != RawImageFormat::Rgba) {
+        *error = CLIResult::error(
+            CLIResult::Code::InvalidArguments,
+            "--raw-header only applies to --raw-format rgba");
+        return false;
+    }
+
+    options->toRaw = parser.isSet("raw") || parser.isSet("raw-format");
+    options->rawFormat = format.value();
+    options->rawHeader = parser.isSet("raw-header");
+    return true;
+}
+
+bool canCaptureInMainInstance(const QCommandLineParser& parser)
+{
+    if (!parser.isSet("raw") && !parser.isSet("raw-format")) {
+        return false;
+    }
+    if (parser.isSet("clipboard") || parser.value("count") != QLatin1String("1")) {
+        return false;
+    }
+    bool delayOk = false;
+    const int delay = parser.value("delay").toInt(&delayOk);
+    return delayOk && delay == 0;
+}
+
+CLIResult emitForwardedCapture(const QCommandLineParser& parser, const QImage& image)
+{
+    CaptureOutputOptions options;
+    CLIResult rawError;
+    if (!parseRawOutputOptions(parser, &options, &rawError)) {
+        return rawError;
+    }
+
+    const RawImageFormat format = options.rawFormat;
+    const bool withHeader = options.rawHeader;
+    return CLIResult::withDataWriter([image, format, withHeader](QIODevice* device) {
+        return writeRawImage(image, format, withHeader, device);
+    });
+}
+
+void addBurstOptions(QCommandLineParser& parser)
+{
+    parser.addOption({"count", "Number of captures to take (saved to files)", "n", "1"});
+    parser.addOption({"interval-ms", "Milliseconds between captures with --count", "ms", "0"});
+}
+
+bool parseBurstOptions(const QCommandLineParser& parser, BurstOptions* burst, CLIResult* error)
+{
+    const QString countValue = parser.value("count");
+    bool countOk = false;
+    const int count = countValue.toInt(&countOk);
+    if (!countOk || count < 1 || count > kMaxBurstCount) {
+        *error = CLIResult::error(
+            CLIResult::Code::InvalidArguments,
+            QString("Invalid count value: %1 (expected 1-%2)").arg(countValue).arg(kMaxBurstCount));
+        return false;
+    }
+
+    const QString intervalValue = parser.value("interval-ms");
+    bool intervalOk = false;
+    const int intervalMs = intervalValue.toInt(&intervalOk);
+    if (!intervalOk || intervalMs < 0) {
+        *error = CLIResult::error(
+            CLIResult::Code::InvalidArguments,
+            QString("Invalid interval value: %1").arg(intervalValue));
+        return false;
+    }
+
+    if (count > 1 &&
+        (parser.isSet("raw") || parser.isSet("raw-format") || parser.isSet("clipboard"))) {
+        *error = CLIResult::error(
+            CLIResult::Code::InvalidArguments,
+            "--count saves each capture to a file and cannot be combined with --raw or --clipboard");
+        return false;
+    }
+
+    burst->count = count;
+    burst->intervalMs = intervalMs;
+    return true;
+}
+
+CLIResult runCaptureBurst(const BurstOptions& burst,
+                          const CaptureFrameFunction& captureFrame,
+                          const CaptureOutputOptions& options,
+                          const CaptureMetadata& metadata)
+{
+    QCoreApplication::processEvents();
+
+    // Leave a core for grabbing; PNG encoding fans out further on its own.
+    QThreadPool encodePool;
+    const int encodeThreads = qBound(1, QThread::idealThreadCount() - 1, 4);
+    encodePool.setMaxThreadCount(encodeThreads);
+    // Bound the frames held in memory when encoding can't keep up.
+    const int maxInFlight = encodeThreads * 2;
+
+    QList<QFuture<BurstFrame>> pending;
+    QList<BurstFrame> frames;
+    QSet<QString> reservedPaths;
+    QElapsedTimer burstTimer;
+    burstTimer.start();
+
+    auto collectFinished = [&](bool waitForOldest) {
+        while (!pending.isEmpty() && (waitForOldest || pending.constFirst().isFinished())) {
+            frames.append(pending.takeFirst().result());
+            waitForOldest = false;
+        }
+    };
+
+    CLIResult captureError;
+    for (int frameNumber = 1; frameNumber <= burst.count; ++frameNumber) {
+        // Fixed-rate schedule: a slow frame shortens the next wait rather
+        // than shifting every later capture.
+        const qint64 dueMs = qint64(frameNumber - 1) * burst.intervalMs;
+        const qint64 waitMs = dueMs - burstTimer.elapsed();
+        if (waitMs > 0) {
+            QThread::msleep(static_cast<unsigned long>(waitMs));
+        }
+        QCoreApplication::processEvents();
+
+        QElapsedTimer captureTimer;
+        captureTimer.start();
+        QPixmap screenshot;
+        captureError = captureFrame(&screenshot);
+        if (!captureError.isSuccess()) {
+            break;
+        }
+        const QImage image = prepareImageForRawOrSave(screenshot, metadata.sourceScreen);
+
+        const QString resolvedPath =
+            resolveOutputFilePath(screenshot, options, metadata, frameNumber);
+        // Frames still being encoded don't exist on disk yet, so the template
+        // engine can't see them; templates without {#} may collide.
+        QString filePath = resolvedPath;
+        for (int suffix = 1; reservedPaths.contains(filePath); ++suffix) {
+            filePath = numberedOutputFile(resolvedPath, suffix);
+        }
+        reservedPaths.insert(filePath);
+        const double captureMs = elapsedMs(captureTimer);
+
+        if (pending.size() >= maxInFlight) {
+            collectFinished(true);
+        }
+        pending.append(QtConcurrent::run(&encodePool, [image, filePath, frameNumber, captureMs]() {
+            QElapsedTimer encodeTimer;
+            encodeTimer.start();
+            BurstFrame frame;
+            frame.number = frameNumber;
+            frame.filePath = filePath;
+            frame.captureMs = captureMs;
+            frame.error = saveCaptureImage(image, filePath);
+            frame.encodeMs = elapsedMs(encodeTimer);
+            return frame;
+        }));
+        collectFinished(false);
+    }
+
+    while (!pending.isEmpty()) {
+        collectFinished(true);
+    }
+    const QString report = formatBurstReport(frames, elapsedMs(burstTimer));
+
+    if (!captureError.isSuccess()) {
+        captureError.message = frames.isEmpty()
+            ? captureError.message
+            : QStringLiteral("%1\n%2").arg(report, captureError.message);
+        return captureError;
+    }
+    const bool allSaved = std::all_of(frames.cbegin(), frames.cend(), [](const BurstFrame& frame) {
+        return frame.error.isEmpty();
+    });
+    if (!allSaved) {
+        return CLIResult::error(CLIResult::Code::FileError, report);
+    }
+    return CLIResult::success(report);
+}
+
 } // namespace CLI
 } // namespace SnapTray
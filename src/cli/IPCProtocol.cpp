@@ -1,50 +1,24 @@
 #include "cli/IPCProtocol.h"
 #include "version.h"
 
+#include <QBuffer>
 #include <QCryptographicHash>
-#include <QDataStream>
 #include <QElapsedTimer>
 #include <QJsonDocument>
 #include <QLocalSocket>
+#include <QtEndian>
 
-#include <limits>
+#include <cstring>
 
 namespace SnapTray {
 namespace CLI {
 
 namespace {
 
-bool readExactWithDeadline(
-    QLocalSocket& socket,
-    qsizetype targetSize,
-    int timeoutMs,
-    QElapsedTimer& timer,
-    QByteArray& output)
+bool isKnownFrameType(quint8 type)
 {
-    output.clear();
-    if (targetSize <= static_cast<qsizetype>(std::numeric_limits<int>::max())) {
-        output.reserve(static_cast<int>(targetSize));
-    }
-
-    while (output.size() < targetSize) {
-        const qint64 bytesToRead = static_cast<qint64>(targetSize - output.size());
-        const QByteArray chunk = socket.read(bytesToRead);
-        if (!chunk.isEmpty()) {
-            output.append(chunk);
-            continue;
-        }
-
-        const int remainingTimeout = timeoutMs - static_cast<int>(timer.elapsed());
-        if (remainingTimeout <= 0) {
-            return false;
-        }
-
-        if (!socket.waitForReadyRead(remainingTimeout)) {
-            return false;
-        }
-    }
-
-    return true;
+    return type >= static_cast<quint8>(IPCFrame::Type::Command) &&
+           type <= static_cast<quint8>(IPCFrame::Type::DataEnd);
 }
 
 } // namespace
@@ -79,6 +53,12 @@ QByteArray IPCResponse::toJson() const
     obj["success"] = success;
     obj["message"] = message;
     obj["error"] = error;
+    if (exitCode != 0) {
+        obj["code"] = exitCode;
+    }
+    if (!sharedImage.isEmpty()) {
+        obj["sharedImage"] = sharedImage;
+    }
     return QJsonDocument(obj).toJson(QJsonDocument::Compact);
 }
 
@@ -91,10 +71,264 @@ IPCResponse IPCResponse::fromJson(const QByteArray& data)
         resp.success = obj["success"].toBool();
         resp.message = obj["message"].toString();
         resp.error = obj["error"].toString();
+        resp.exitCode = obj["code"].toInt();
+        resp.sharedImage = obj["sharedImage"].toObject();
     }
     return resp;
 }
 
+// --- IPCFrame ---
+
+QByteArray IPCFrame::encodeHeader(Type type, quint16 flags, quint32 requestId, quint32 payloadSize)
+{
+    QByteArray header(kHeaderSize, Qt::Uninitialized);
+    auto* out = reinterpret_cast<uchar*>(header.data());
+    qToBigEndian<quint32>(kMagic, out);
+    out[4] = kVersion;
+    out[5] = static_cast<uchar>(type);
+    qToBigEndian<quint16>(flags, out + 6);
+    qToBigEndian<quint32>(requestId, out + 8);
+    qToBigEndian<quint32>(payloadSize, out + 12);
+    return header;
+}
+
+QByteArray IPCFrame::encode() const
+{
+    QByteArray packet = encodeHeader(type, flags, requestId, static_cast<quint32>(payload.size()));
+    packet.append(payload);
+    return packet;
+}
+
+bool IPCFrame::hasMagicPrefix(const QByteArray& data)
+{
+    uchar magic[4];
+    qToBigEndian<quint32>(kMagic, magic);
+    const qsizetype length = qMin<qsizetype>(data.size(), sizeof(magic));
+    return length > 0 && std::memcmp(data.constData(), magic, size_t(length)) == 0;
+}
+
+// --- IPCFrameReader ---
+
+void IPCFrameReader::append(const QByteArray& data)
+{
+    // Drop consumed frames before growing the buffer.
+    if (m_offset > 0 && m_offset >= m_buffer.size() / 2) {
+        m_buffer.remove(0, m_offset);
+        m_offset = 0;
+    }
+    m_buffer.append(data);
+}
+
+IPCFrameReader::Status IPCFrameReader::next(IPCFrame* frame)
+{
+    const qsizetype available = m_buffer.size() - m_offset;
+    if (available < IPCFrame::kHeaderSize) {
+        return m_offset < m_buffer.size() && !IPCFrame::hasMagicPrefix(m_buffer.mid(m_offset))
+            ? Status::Invalid
+            : Status::Incomplete;
+    }
+
+    const auto* header = reinterpret_cast<const uchar*>(m_buffer.constData() + m_offset);
+    if (qFromBigEndian<quint32>(header) != IPCFrame::kMagic || header[4] != IPCFrame::kVersion ||
+        !isKnownFrameType(header[5])) {
+        return Status::Invalid;
+    }
+
+    const quint32 payloadSize = qFromBigEndian<quint32>(header + 12);
+    if (payloadSize > IPCFrame::kMaxPayloadSize) {
+        return Status::Invalid;
+    }
+    if (available < IPCFrame::kHeaderSize + qsizetype(payloadSize)) {
+        return Status::Incomplete;
+    }
+
+    frame->type = static_cast<IPCFrame::Type>(header[5]);
+    frame->flags = qFromBigEndian<quint16>(header + 6);
+    frame->requestId = qFromBigEndian<quint32>(header + 8);
+    frame->payload = m_buffer.mid(m_offset + IPCFrame::kHeaderSize, payloadSize);
+
+    m_offset += IPCFrame::kHeaderSize + payloadSize;
+    if (m_offset == m_buffer.size()) {
+        m_buffer.clear();
+        m_offset = 0;
+    }
+    return Status::Ready;
+}
+
+// --- IPCConnection ---
+
+IPCConnection::IPCConnection() = default;
+IPCConnection::~IPCConnection() = default;
+
+bool IPCConnection::connectToServer(const QString& serverName, int timeoutMs)
+{
+    close();
+    m_socket = std::make_unique<QLocalSocket>();
+    m_socket->connectToServer(serverName);
+    if (!m_socket->waitForConnected(timeoutMs)) {
+        m_errorString = "Failed to connect to SnapTray";
+        m_socket.reset();
+        return false;
+    }
+    return true;
+}
+
+bool IPCConnection::isConnected() const
+{
+    return m_socket && m_socket->state() == QLocalSocket::ConnectedState;
+}
+
+void IPCConnection::close()
+{
+    if (m_socket) {
+        m_socket->disconnectFromServer();
+        m_socket.reset();
+    }
+    m_reader = IPCFrameReader();
+    m_pendingFrames.clear();
+}
+
+quint32 IPCConnection::post(const IPCMessage& message)
+{
+    if (!isConnected()) {
+        m_errorString = "Failed to send command";
+        return 0;
+    }
+
+    IPCFrame frame;
+    frame.type = IPCFrame::Type::Command;
+    frame.requestId = m_nextRequestId++;
+    frame.payload = message.toJson();
+    if (m_socket->write(frame.encode()) < 0) {
+        m_errorString = "Failed to send command";
+        return 0;
+    }
+    return frame.requestId;
+}
+
+bool IPCConnection::flush(int timeoutMs)
+{
+    if (!m_socket) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    while (m_socket->bytesToWrite() > 0) {
+        const int remainingTimeout = timeoutMs - static_cast<int>(timer.elapsed());
+        if (remainingTimeout <= 0 || !m_socket->waitForBytesWritten(remainingTimeout)) {
+            m_errorString = "Failed to send command";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IPCConnection::readFrame(quint32 requestId, IPCFrame* frame, int timeoutMs)
+{
+    auto pending = m_pendingFrames.find(requestId);
+    if (pending != m_pendingFrames.end()) {
+        *frame = std::move(pending->second.front());
+        pending->second.pop_front();
+        if (pending->second.empty()) {
+            m_pendingFrames.erase(pending);
+        }
+        return true;
+    }
+
+    if (!m_socket) {
+        m_errorString = "Not connected to SnapTray";
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (;;) {
+        IPCFrame next;
+        const IPCFrameReader::Status status = m_reader.next(&next);
+        if (status == IPCFrameReader::Status::Ready) {
+            if (next.requestId == requestId) {
+                *frame = std::move(next);
+                return true;
+            }
+            m_pendingFrames[next.requestId].push_back(std::move(next));
+            continue;
+        }
+        if (status == IPCFrameReader::Status::Invalid) {
+            m_errorString = "Invalid response header";
+            close();
+            return false;
+        }
+
+        if (m_socket->bytesAvailable() > 0) {
+            m_reader.append(m_socket->readAll());
+            continue;
+        }
+
+        const int remainingTimeout = timeoutMs - static_cast<int>(timer.elapsed());
+        if (remainingTimeout <= 0 || !m_socket->waitForReadyRead(remainingTimeout)) {
+            // A disconnect can still leave the final bytes buffered.
+            if (m_socket->bytesAvailable() > 0) {
+                continue;
+            }
+            m_errorString = "Timeout waiting for response";
+            return false;
+        }
+    }
+}
+
+bool IPCConnection::waitForResponse(quint32 requestId, IPCResponse* response, int timeoutMs)
+{
+    IPCFrame frame;
+    if (!readFrame(requestId, &frame, timeoutMs)) {
+        return false;
+    }
+    if (frame.type != IPCFrame::Type::Response) {
+        m_errorString = "Invalid response header";
+        return false;
+    }
+
+    *response = IPCResponse::fromJson(frame.payload);
+    response->hasData = (frame.flags & IPCFrame::HasData) != 0;
+    return true;
+}
+
+bool IPCConnection::readData(quint32 requestId, QIODevice* sink, int timeoutMs)
+{
+    for (;;) {
+        IPCFrame frame;
+        if (!readFrame(requestId, &frame, timeoutMs)) {
+            return false;
+        }
+
+        if (frame.type == IPCFrame::Type::DataEnd) {
+            if (frame.flags & IPCFrame::Aborted) {
+                m_errorString = "SnapTray failed while sending data";
+                return false;
+            }
+            return true;
+        }
+        if (frame.type != IPCFrame::Type::Data) {
+            m_errorString = "Invalid response header";
+            return false;
+        }
+
+        if (sink) {
+            const char* data = frame.payload.constData();
+            qint64 remaining = frame.payload.size();
+            while (remaining > 0) {
+                const qint64 written = sink->write(data, remaining);
+                if (written <= 0) {
+                    m_errorString = "Failed to write received data";
+                    return false;
+                }
+                data += written;
+                remaining -= written;
+            }
+        }
+    }
+}
+
 // --- IPCProtocol ---
 
 IPCProtocol::IPCProtocol() = default;
@@ -108,76 +342,58 @@ QString IPCProtocol::getServerName()
         .arg(QString(QCryptographicHash::hash(appId.toUtf8(), QCryptographicHash::Md5).toHex()));
 }
 
-bool IPCProtocol::isMainInstanceRunning() const
+bool IPCProtocol::ensureConnected()
 {
-    QLocalSocket socket;
-    socket.connectToServer(getServerName());
-    bool connected = socket.waitForConnected(500);
-    if (connected) {
-        socket.disconnectFromServer();
+    if (m_connection && m_connection->isConnected()) {
+        return true;
+    }
+    if (!m_connection) {
+        m_connection = std::make_unique<IPCConnection>();
     }
-    return connected;
+    return m_connection->connectToServer(getServerName(), kConnectionTimeout);
+}
+
+bool IPCProtocol::isMainInstanceRunning()
+{
+    return ensureConnected();
 }
 
 IPCResponse IPCProtocol::sendCommand(const IPCMessage& message, bool waitResponse)
 {
     IPCResponse response;
-    QLocalSocket socket;
-
-    socket.connectToServer(getServerName());
-    if (!socket.waitForConnected(kConnectionTimeout)) {
-        response.error = "Failed to connect to SnapTray";
+    if (!ensureConnected()) {
+        response.error = m_connection->errorString();
         return response;
     }
 
-    // Send message with length prefix
-    QByteArray data = message.toJson();
-    QByteArray packet;
-    QDataStream stream(&packet, QIODevice::WriteOnly);
-    stream << static_cast<quint32>(data.size());
-    packet.append(data);
-    socket.write(packet);
-
-    if (!socket.waitForBytesWritten(kConnectionTimeout)) {
-        response.error = "Failed to send command";
+    const quint32 requestId = m_connection->post(message);
+    if (requestId == 0 || !m_connection->flush(kConnectionTimeout)) {
+        response.error = m_connection->errorString();
         return response;
     }
 
     if (!waitResponse) {
         response.success = true;
         response.message = "Command sent";
-        socket.disconnectFromServer();
         return response;
     }
 
-    // Read response with length prefix
-    QElapsedTimer responseTimer;
-    responseTimer.start();
-
-    QByteArray headerData;
-    if (!readExactWithDeadline(
-            socket, sizeof(quint32), kResponseTimeout, responseTimer, headerData)) {
-        response.error = "Timeout waiting for response";
-        return response;
-    }
-
-    QDataStream readStream(headerData);
-    quint32 size = 0;
-    readStream >> size;
-    constexpr quint32 kMaxResponseSize = 10 * 1024 * 1024; // 10 MB
-    if (readStream.status() != QDataStream::Ok || size == 0 || size > kMaxResponseSize) {
-        response.error = "Invalid response header";
-        return response;
+    if (!m_connection->waitForResponse(requestId, &response, kResponseTimeout)) {
+        IPCResponse failed;
+        failed.error = m_connection->errorString();
+        return failed;
     }
 
-    QByteArray responseData;
-    if (!readExactWithDeadline(socket, size, kResponseTimeout, responseTimer, responseData)) {
-        response.error = "Timeout waiting for response";
-        return response;
+    if (response.hasData) {
+        QBuffer buffer(&response.data);
+        buffer.open(QIODevice::WriteOnly);
+        if (!m_connection->readData(requestId, &buffer, kResponseTimeout)) {
+            IPCResponse failed;
+            failed.error = m_connection->errorString();
+            return failed;
+        }
     }
-
-    socket.disconnectFromServer();
-    return IPCResponse::fromJson(responseData);
+    return response;
 }
 
 } // namespace CLI
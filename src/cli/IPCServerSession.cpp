@@ -0,0 +1,376 @@
+#include "cli/IPCServerSession.h"
+
+#include "cli/SharedImageSegment.h"
+
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QLocalSocket>
+#include <QMutex>
+#include <QSharedMemory>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+namespace SnapTray {
+namespace CLI {
+
+// Shared by the session and the pool thread encoding a streamed reply.
+struct StreamState
+{
+    QMutex mutex;
+    QWaitCondition changed;
+    qint64 queuedBytes = 0;   // Posted to the session, not yet written
+    qint64 socketBytes = 0;   // In the socket's write buffer
+    bool cancelled = false;
+    bool done = false;        // The pool thread has let go of the session
+};
+
+namespace {
+
+// Bytes a streamed reply may have queued for the socket before its encoder
+// waits for the client to read; bounds memory when streaming a large image.
+constexpr qint64 kMaxBufferedBytes = 4 * 1024 * 1024;
+constexpr int kWriteTimeoutMs = 30000;
+
+// Unreleased shared images a client may hold; the oldest is dropped
+// beyond this, so a client that never releases cannot pin captures.
+constexpr size_t kMaxSharedImages = 4;
+
+// Runs on the encoding thread: packs everything written to it into Data
+// frames of one request and posts them to the session, waiting while too
+// many are still on their way to the client.
+class DataFrameDevice : public QIODevice
+{
+public:
+    DataFrameDevice(quint32 requestId,
+                    std::shared_ptr<StreamState> state,
+                    std::function<void(const QByteArray&)> post)
+        : m_requestId(requestId)
+        , m_state(std::move(state))
+        , m_post(std::move(post))
+    {
+        m_chunk.reserve(IPCFrame::kDataChunkSize);
+    }
+
+    bool flushChunk()
+    {
+        if (m_chunk.isEmpty()) {
+            return true;
+        }
+        QByteArray frame = IPCFrame::encodeHeader(
+            IPCFrame::Type::Data, 0, m_requestId, static_cast<quint32>(m_chunk.size()));
+        frame.append(m_chunk);
+        m_chunk.clear();
+
+        {
+            QMutexLocker locker(&m_state->mutex);
+            const QDeadlineTimer deadline(kWriteTimeoutMs);
+            while (!m_state->cancelled &&
+                   m_state->queuedBytes + m_state->socketBytes > kMaxBufferedBytes) {
+                if (!m_state->changed.wait(&m_state->mutex, deadline)) {
+                    return false;
+                }
+            }
+            if (m_state->cancelled) {
+                return false;
+            }
+            m_state->queuedBytes += frame.size();
+        }
+        m_post(frame);
+        return true;
+    }
+
+protected:
+    qint64 readData(char*, qint64) override { return -1; }
+
+    qint64 writeData(const char* data, qint64 size) override
+    {
+        qint64 consumed = 0;
+        while (consumed < size) {
+            const qint64 room = IPCFrame::kDataChunkSize - m_chunk.size();
+            const qint64 take = qMin(room, size - consumed);
+            m_chunk.append(data + consumed, take);
+            consumed += take;
+            if (m_chunk.size() == IPCFrame::kDataChunkSize && !flushChunk()) {
+                return -1;
+            }
+        }
+        return consumed;
+    }
+
+private:
+    quint32 m_requestId;
+    std::shared_ptr<StreamState> m_state;
+    std::function<void(const QByteArray&)> m_post;
+    QByteArray m_chunk;
+};
+
+} // namespace
+
+IPCServerSession::IPCServerSession(QLocalSocket* socket, const QByteArray& receivedData, QObject* parent)
+    : QObject(parent)
+    , m_socket(socket)
+{
+    m_socket->setParent(this);
+    m_reader.append(receivedData);
+
+    connect(m_socket, &QLocalSocket::readyRead, this, &IPCServerSession::readAvailable);
+    connect(m_socket, &QLocalSocket::bytesWritten, this, &IPCServerSession::updateStreamBacklog);
+    connect(m_socket, &QLocalSocket::disconnected, this, [this]() {
+        readAvailable();
+        finish();
+    });
+}
+
+IPCServerSession::~IPCServerSession()
+{
+    // The encoding thread posts to this session until it is done.
+    if (m_stream) {
+        QMutexLocker locker(&m_stream->mutex);
+        m_stream->cancelled = true;
+        m_stream->changed.wakeAll();
+        while (!m_stream->done) {
+            m_stream->changed.wait(&m_stream->mutex);
+        }
+    }
+}
+
+void IPCServerSession::start()
+{
+    m_started = true;
+    readAvailable();
+    // The client may have sent everything and closed before the hand-off.
+    if (m_socket->state() != QLocalSocket::ConnectedState) {
+        finish();
+    }
+}
+
+void IPCServerSession::readAvailable()
+{
+    if (m_socket->bytesAvailable() > 0) {
+        m_reader.append(m_socket->readAll());
+    }
+    dispatchFrames();
+}
+
+void IPCServerSession::dispatchFrames()
+{
+    // Re-entered from a handler that processed events: the outer loop
+    // picks up whatever arrived meanwhile. While a reply is streaming, the
+    // next command waits so responses stay in request order.
+    if (!m_started || m_dispatching || m_stream) {
+        return;
+    }
+
+    m_dispatching = true;
+    while (!m_stream) {
+        IPCFrame frame;
+        const IPCFrameReader::Status status = m_reader.next(&frame);
+        if (status == IPCFrameReader::Status::Incomplete) {
+            break;
+        }
+        if (status == IPCFrameReader::Status::Invalid || frame.type != IPCFrame::Type::Command) {
+            qWarning() << "IPCServerSession: Invalid frame, closing connection";
+            m_socket->abort();
+            m_finished = true;
+            break;
+        }
+
+        const IPCMessage message = IPCMessage::fromJson(frame.payload);
+        if (message.command == QLatin1String(IPCMessage::kReleaseCommand)) {
+            releaseSharedImage(message.options["key"].toString());
+            continue;
+        }
+        if (message.command == QLatin1String(IPCMessage::kStreamSharedCommand)) {
+            streamSharedImage(frame.requestId, message.options["key"].toString());
+            continue;
+        }
+        emit commandReceived(frame.requestId, frame.payload);
+    }
+    m_dispatching = false;
+
+    if (m_finished && !m_stream) {
+        deleteLater();
+    }
+}
+
+void IPCServerSession::finish()
+{
+    m_finished = true;
+    if (m_stream) {
+        // finishStream() deletes the session once the encoder has stopped.
+        QMutexLocker locker(&m_stream->mutex);
+        m_stream->cancelled = true;
+        m_stream->changed.wakeAll();
+        return;
+    }
+    if (!m_dispatching) {
+        deleteLater();
+    }
+}
+
+bool IPCServerSession::sendResponse(quint32 requestId,
+                                    const IPCResponse& response,
+                                    const std::function<bool(QIODevice*)>& writeData)
+{
+    if (m_socket->state() != QLocalSocket::ConnectedState) {
+        return false;
+    }
+
+    IPCFrame frame;
+    frame.type = IPCFrame::Type::Response;
+    frame.flags = writeData ? IPCFrame::HasData : 0;
+    frame.requestId = requestId;
+    frame.payload = response.toJson();
+    if (m_socket->write(frame.encode()) < 0) {
+        return false;
+    }
+    if (!writeData) {
+        m_socket->flush();
+        return true;
+    }
+
+    // Encoding a large image takes long enough to stall the UI, so it runs
+    // on a pool thread. Its frames come back here and are written without
+    // blocking; bytesWritten() tells the encoder when there is room again.
+    auto state = std::make_shared<StreamState>();
+    state->socketBytes = m_socket->bytesToWrite();
+    m_stream = state;
+    m_streamRequestId = requestId;
+
+    auto post = [this](const QByteArray& frame) {
+        QMetaObject::invokeMethod(this, [this, frame]() { writeStreamFrame(frame); },
+                                  Qt::QueuedConnection);
+    };
+    QThreadPool::globalInstance()->start([this, state, requestId, writeData, post]() {
+        DataFrameDevice device(requestId, state, post);
+        device.open(QIODevice::WriteOnly);
+        const bool ok = writeData(&device) && device.flushChunk();
+        QMetaObject::invokeMethod(this, [this, ok]() { finishStream(ok); }, Qt::QueuedConnection);
+
+        QMutexLocker locker(&state->mutex);
+        state->done = true;
+        state->changed.wakeAll();
+    });
+    return true;
+}
+
+void IPCServerSession::writeStreamFrame(const QByteArray& frame)
+{
+    const bool written = m_socket->state() == QLocalSocket::ConnectedState &&
+                         m_socket->write(frame) == frame.size();
+    if (!m_stream) {
+        return;
+    }
+    QMutexLocker locker(&m_stream->mutex);
+    m_stream->queuedBytes -= frame.size();
+    m_stream->socketBytes = m_socket->bytesToWrite();
+    if (!written) {
+        m_stream->cancelled = true;
+    }
+    m_stream->changed.wakeAll();
+}
+
+void IPCServerSession::updateStreamBacklog()
+{
+    if (!m_stream) {
+        return;
+    }
+    QMutexLocker locker(&m_stream->mutex);
+    m_stream->socketBytes = m_socket->bytesToWrite();
+    m_stream->changed.wakeAll();
+}
+
+void IPCServerSession::finishStream(bool ok)
+{
+    // Frames posted before this call have all been written by now.
+    m_stream.reset();
+
+    if (m_socket->state() == QLocalSocket::ConnectedState) {
+        IPCFrame end;
+        end.type = IPCFrame::Type::DataEnd;
+        end.flags = ok ? 0 : IPCFrame::Aborted;
+        end.requestId = m_streamRequestId;
+        m_socket->write(end.encode());
+        m_socket->flush();
+    }
+
+    if (m_finished) {
+        deleteLater();
+        return;
+    }
+    dispatchFrames();
+}
+
+void IPCServerSession::releaseSharedImage(const QString& key)
+{
+    for (auto it = m_sharedImages.begin(); it != m_sharedImages.end(); ++it) {
+        if (it->key == key) {
+            m_sharedImages.erase(it);
+            return;
+        }
+    }
+}
+
+void IPCServerSession::streamSharedImage(quint32 requestId, const QString& key)
+{
+    for (auto it = m_sharedImages.begin(); it != m_sharedImages.end(); ++it) {
+        if (it->key == key) {
+            const std::function<bool(QIODevice*)> writeData = std::move(it->writeData);
+            m_sharedImages.erase(it);
+            if (!writeData) {
+                break;
+            }
+            IPCResponse response;
+            response.success = true;
+            sendResponse(requestId, response, writeData);
+            return;
+        }
+    }
+
+    IPCResponse response;
+    response.success = false;
+    response.exitCode = static_cast<int>(CLIResult::Code::InstanceError);
+    response.error = QStringLiteral("Shared image is no longer available");
+    sendResponse(requestId, response);
+}
+
+bool IPCServerSession::sendResult(quint32 requestId, const CLIResult& result, bool preferSharedMemory)
+{
+    IPCResponse response;
+    response.success = result.isSuccess();
+    response.exitCode = static_cast<int>(result.code);
+    if (result.isSuccess()) {
+        response.message = result.message;
+    }
+    else {
+        response.error = result.message;
+    }
+
+    if (preferSharedMemory && !result.image.isNull()) {
+        SharedImageDescriptor descriptor;
+        if (auto segment = publishSharedImage(result.image, &descriptor)) {
+            // The writer stays with the segment in case the client cannot
+            // map it and asks for the encoded stream instead.
+            m_sharedImages.push_back({descriptor.key, std::move(segment), result.writeData});
+            if (m_sharedImages.size() > kMaxSharedImages) {
+                m_sharedImages.pop_front();
+            }
+            response.sharedImage = descriptor.toJson();
+            return sendResponse(requestId, response);
+        }
+    }
+
+    if (result.writeData) {
+        return sendResponse(requestId, response, result.writeData);
+    }
+    if (!result.data.isEmpty()) {
+        const QByteArray data = result.data;
+        return sendResponse(requestId, response, [data](QIODevice* device) {
+            return device->write(data) == data.size();
+        });
+    }
+    return sendResponse(requestId, response);
+}
+
+} // namespace CLI
+} // namespace SnapTray
@@ -0,0 +1,263 @@
+#include "cli/RawImageWriter.h"
+
+#include "utils/ImageSaveUtils.h"
+#include "utils/ParallelPngWriter.h"
+#include "utils/QoiCodec.h"
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QImage>
+#include <QImageWriter>
+#include <QtEndian>
+
+#include <functional>
+#include <vector>
+
+namespace SnapTray {
+namespace CLI {
+namespace {
+
+// Rows converted per batch: enough to amortise the conversion call, small
+// enough that the batch stays in cache.
+constexpr int kRowsPerBatch = 64;
+
+constexpr int kBmpFileHeaderSize = 14;
+constexpr int kBmpInfoHeaderSize = 40;
+
+bool writeAll(QIODevice* device, const char* data, qint64 size)
+{
+    while (size > 0) {
+        const qint64 written = device->write(data, size);
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool writeAll(QIODevice* device, const QByteArray& data)
+{
+    return writeAll(device, data.constData(), data.size());
+}
+
+// Calls visit(rows, first, count) for consecutive batches of rows in
+// targetFormat: scanlines first .. first + count - 1 of rows. The image is
+// used in place when it already has that format; otherwise only one batch
+// is converted at a time. bottomUp visits the last batch first.
+bool forEachRowBatch(const QImage& image,
+                     QImage::Format targetFormat,
+                     bool bottomUp,
+                     const std::function<bool(const QImage&, int, int)>& visit)
+{
+    const int height = image.height();
+    for (int done = 0; done < height; done += kRowsPerBatch) {
+        const int count = qMin(kRowsPerBatch, height - done);
+        const int firstRow = bottomUp ? height - done - count : done;
+        if (image.format() == targetFormat) {
+            if (!visit(image, firstRow, count)) {
+                return false;
+            }
+            continue;
+        }
+        const QImage batch =
+            image.copy(0, firstRow, image.width(), count).convertToFormat(targetFormat);
+        if (batch.isNull() || !visit(batch, 0, count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writePng(const QImage& image, QIODevice* device)
+{
+    const int level = ImageSaveUtils::pngCompressionLevel(ImageSaveUtils::PngCompression::Balanced);
+    if (ParallelPngWriter::canWrite(image)) {
+        return ParallelPngWriter::write(image, device, level);
+    }
+    QImageWriter writer(device, "png");
+    return writer.write(image);
+}
+
+bool writePpm(const QImage& image, QIODevice* device)
+{
+    const QByteArray header =
+        QStringLiteral("P6\n%1 %2\n255\n").arg(image.width()).arg(image.height()).toLatin1();
+    if (!writeAll(device, header)) {
+        return false;
+    }
+
+    const qint64 rowBytes = qint64(image.width()) * 3;
+    return forEachRowBatch(image, QImage::Format_RGB888, false,
+                           [&](const QImage& rows, int first, int count) {
+        for (int y = first; y < first + count; ++y) {
+            if (!writeAll(device, reinterpret_cast<const char*>(rows.constScanLine(y)), rowBytes)) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+bool writeRgba(const QImage& image, bool withHeader, QIODevice* device)
+{
+    const qint64 rowBytes = qint64(image.width()) * 4;
+    if (withHeader) {
+        const QByteArray header = QStringLiteral("RGBA %1 %2 %3\n")
+                                      .arg(image.width())
+                                      .arg(image.height())
+                                      .arg(rowBytes)
+                                      .toLatin1();
+        if (!writeAll(device, header)) {
+            return false;
+        }
+    }
+
+    return forEachRowBatch(image, QImage::Format_RGBA8888, false,
+                           [&](const QImage& rows, int first, int count) {
+        for (int y = first; y < first + count; ++y) {
+            if (!writeAll(device, reinterpret_cast<const char*>(rows.constScanLine(y)), rowBytes)) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+// 32-bit BI_RGB, bottom-up: the layout every BMP reader accepts.
+bool writeBmp(const QImage& image, QIODevice* device)
+{
+    const quint32 rowBytes = quint32(image.width()) * 4;
+    const quint32 pixelBytes = rowBytes * quint32(image.height());
+    const quint32 dataOffset = kBmpFileHeaderSize + kBmpInfoHeaderSize;
+
+    uchar header[kBmpFileHeaderSize + kBmpInfoHeaderSize] = {};
+    header[0] = 'B';
+    header[1] = 'M';
+    qToLittleEndian<quint32>(dataOffset + pixelBytes, header + 2);
+    qToLittleEndian<quint32>(dataOffset, header + 10);
+    uchar* info = header + kBmpFileHeaderSize;
+    qToLittleEndian<quint32>(kBmpInfoHeaderSize, info);
+    qToLittleEndian<qint32>(image.width(), info + 4);
+    qToLittleEndian<qint32>(image.height(), info + 8);
+    qToLittleEndian<quint16>(1, info + 12);     // Planes
+    qToLittleEndian<quint16>(32, info + 14);    // Bits per pixel
+    qToLittleEndian<quint32>(0, info + 16);     // BI_RGB
+    qToLittleEndian<quint32>(pixelBytes, info + 20);
+    qToLittleEndian<qint32>(image.dotsPerMeterX(), info + 24);
+    qToLittleEndian<qint32>(image.dotsPerMeterY(), info + 28);
+    if (!writeAll(device, reinterpret_cast<const char*>(header), sizeof(header))) {
+        return false;
+    }
+
+    // ARGB32 pixels are B, G, R, A in little-endian memory, which is the BMP
+    // byte order; big-endian hosts swap each row into a buffer.
+    std::vector<quint32> swapped;
+    return forEachRowBatch(image, QImage::Format_ARGB32, true,
+                           [&](const QImage& rows, int first, int count) {
+        for (int y = first + count - 1; y >= first; --y) {
+            const uchar* row = rows.constScanLine(y);
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+            swapped.resize(size_t(image.width()));
+            qToLittleEndian<quint32>(row, image.width(), swapped.data());
+            row = reinterpret_cast<const uchar*>(swapped.data());
+#endif
+            if (!writeAll(device, reinterpret_cast<const char*>(row), rowBytes)) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+bool writeQoi(const QImage& image, QIODevice* device)
+{
+    uchar header[14] = {'q', 'o', 'i', 'f'};
+    qToBigEndian<quint32>(quint32(image.width()), header + 4);
+    qToBigEndian<quint32>(quint32(image.height()), header + 8);
+    header[12] = image.hasAlphaChannel() ? 4 : 3;
+    header[13] = 0;    // sRGB with linear alpha
+    if (!writeAll(device, reinterpret_cast<const char*>(header), sizeof(header))) {
+        return false;
+    }
+
+    // QOI codes straight (not premultiplied) alpha.
+    const QImage::Format sourceFormat = image.format() == QImage::Format_RGB32
+        ? QImage::Format_RGB32
+        : QImage::Format_ARGB32;
+    QoiCodec::Encoder encoder;
+    QByteArray buffer;
+    buffer.resize(qsizetype(image.width()) * kRowsPerBatch * QoiCodec::kMaxBytesPerPixel + 1);
+    const bool ok = forEachRowBatch(image, sourceFormat, false,
+                                    [&](const QImage& rows, int first, int count) {
+        auto* start = reinterpret_cast<uchar*>(buffer.data());
+        uchar* out = start;
+        for (int y = first; y < first + count; ++y) {
+            out = encoder.encode(reinterpret_cast<const quint32*>(rows.constScanLine(y)),
+                                 image.width(), out);
+        }
+        return writeAll(device, buffer.constData(), out - start);
+    });
+    if (!ok) {
+        return false;
+    }
+
+    auto* start = reinterpret_cast<uchar*>(buffer.data());
+    uchar* out = encoder.finish(start);
+    return writeAll(device, buffer.constData(), out - start) &&
+           writeAll(device, reinterpret_cast<const char*>(QoiCodec::kEndMarker),
+                    sizeof(QoiCodec::kEndMarker));
+}
+
+} // namespace
+
+std::optional<RawImageFormat> parseRawImageFormat(const QString& name)
+{
+    const QString normalized = name.trimmed().toLower();
+    if (normalized == QLatin1String("png")) {
+        return RawImageFormat::Png;
+    }
+    if (normalized == QLatin1String("ppm")) {
+        return RawImageFormat::Ppm;
+    }
+    if (normalized == QLatin1String("bmp")) {
+        return RawImageFormat::Bmp;
+    }
+    if (normalized == QLatin1String("qoi")) {
+        return RawImageFormat::Qoi;
+    }
+    if (normalized == QLatin1String("rgba")) {
+        return RawImageFormat::Rgba;
+    }
+    return std::nullopt;
+}
+
+QString rawImageFormatNames()
+{
+    return QStringLiteral("png, ppm, bmp, qoi, rgba");
+}
+
+bool writeRawImage(const QImage& image, RawImageFormat format, bool withHeader, QIODevice* device)
+{
+    if (image.isNull() || !device) {
+        return false;
+    }
+
+    switch (format) {
+    case RawImageFormat::Png:
+        return writePng(image, device);
+    case RawImageFormat::Ppm:
+        return writePpm(image, device);
+    case RawImageFormat::Bmp:
+        return writeBmp(image, device);
+    case RawImageFormat::Qoi:
+        return writeQoi(image, device);
+    case RawImageFormat::Rgba:
+        return writeRgba(image, withHeader, device);
+    }
+    return false;
+}
+
+} // namespace CLI
+} // namespace SnapTray
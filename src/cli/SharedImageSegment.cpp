@@ -0,0 +1,149 @@
+#include "cli/SharedImageSegment.h"
+
+#include <QColorSpace>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QSharedMemory>
+
+#include <atomic>
+#include <cstring>
+
+namespace SnapTray {
+namespace CLI {
+
+namespace {
+
+// Keys already in use (a stale segment of a crashed run) are skipped.
+constexpr int kMaxKeyAttempts = 8;
+
+QString nextSegmentKey()
+{
+    static std::atomic<quint32> counter{0};
+    return QStringLiteral("snaptray-image-%1-%2")
+        .arg(QCoreApplication::applicationPid())
+        .arg(counter.fetch_add(1));
+}
+
+} // namespace
+
+bool SharedImageDescriptor::isValid() const
+{
+    if (key.isEmpty() || width <= 0 || height <= 0) {
+        return false;
+    }
+    if (format <= QImage::Format_Invalid || format >= QImage::NImageFormats) {
+        return false;
+    }
+    const int depth = QImage::toPixelFormat(format).bitsPerPixel();
+    return depth > 0 && bytesPerLine >= (qsizetype(width) * depth + 7) / 8;
+}
+
+QJsonObject SharedImageDescriptor::toJson() const
+{
+    QJsonObject json;
+    json["key"] = key;
+    json["width"] = width;
+    json["height"] = height;
+    json["bytesPerLine"] = static_cast<qint64>(bytesPerLine);
+    json["format"] = static_cast<int>(format);
+    json["dpr"] = devicePixelRatio;
+    if (!iccProfile.isEmpty()) {
+        json["icc"] = QString::fromLatin1(iccProfile.toBase64());
+    }
+    return json;
+}
+
+SharedImageDescriptor SharedImageDescriptor::fromJson(const QJsonObject& json)
+{
+    SharedImageDescriptor descriptor;
+    descriptor.key = json["key"].toString();
+    descriptor.width = json["width"].toInt();
+    descriptor.height = json["height"].toInt();
+    descriptor.bytesPerLine = static_cast<qsizetype>(json["bytesPerLine"].toInteger());
+    descriptor.format = static_cast<QImage::Format>(json["format"].toInt());
+    descriptor.devicePixelRatio = json["dpr"].toDouble(1.0);
+    descriptor.iccProfile = QByteArray::fromBase64(json["icc"].toString().toLatin1());
+    return descriptor;
+}
+
+std::unique_ptr<QSharedMemory> publishSharedImage(const QImage& image,
+                                                  SharedImageDescriptor* descriptor)
+{
+    if (image.isNull() || !descriptor) {
+        return nullptr;
+    }
+
+    SharedImageDescriptor published;
+    published.width = image.width();
+    published.height = image.height();
+    published.bytesPerLine = image.bytesPerLine();
+    published.format = image.format();
+    published.devicePixelRatio = image.devicePixelRatio();
+    if (image.colorSpace().isValid()) {
+        published.iccProfile = image.colorSpace().iccProfile();
+    }
+
+    for (int attempt = 0; attempt < kMaxKeyAttempts; ++attempt) {
+        published.key = nextSegmentKey();
+        auto segment = std::make_unique<QSharedMemory>(published.key);
+        if (!segment->create(published.byteCount())) {
+            if (segment->error() == QSharedMemory::AlreadyExists) {
+                continue;
+            }
+            qWarning() << "publishSharedImage: Failed to create segment:" << segment->errorString();
+            return nullptr;
+        }
+
+        // The client reads only after the IPC response that follows this copy.
+        std::memcpy(segment->data(), image.constBits(), size_t(published.byteCount()));
+        *descriptor = published;
+        return segment;
+    }
+    return nullptr;
+}
+
+SharedImageView::SharedImageView() = default;
+SharedImageView::~SharedImageView() = default;
+
+bool SharedImageView::attach(const SharedImageDescriptor& descriptor)
+{
+    m_segment.reset();
+    if (!descriptor.isValid()) {
+        m_errorString = "Invalid shared image descriptor";
+        return false;
+    }
+
+    auto segment = std::make_unique<QSharedMemory>(descriptor.key);
+    if (!segment->attach(QSharedMemory::ReadOnly)) {
+        m_errorString = QString("Failed to map shared image: %1").arg(segment->errorString());
+        return false;
+    }
+    if (segment->size() < descriptor.byteCount()) {
+        m_errorString = "Shared image segment is smaller than described";
+        return false;
+    }
+
+    m_segment = std::move(segment);
+    m_descriptor = descriptor;
+    return true;
+}
+
+QImage SharedImageView::image() const
+{
+    if (!m_segment) {
+        return QImage();
+    }
+    QImage image(static_cast<const uchar*>(m_segment->constData()),
+                 m_descriptor.width,
+                 m_descriptor.height,
+                 m_descriptor.bytesPerLine,
+                 m_descriptor.format);
+    image.setDevicePixelRatio(m_descriptor.devicePixelRatio);
+    if (!m_descriptor.iccProfile.isEmpty()) {
+        image.setColorSpace(QColorSpace::fromIccProfile(m_descriptor.iccProfile));
+    }
+    return image;
+}
+
+} // namespace CLI
+} // namespace SnapTray
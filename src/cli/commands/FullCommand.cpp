@@ -21,7 +21,8 @@ void FullCommand::setupOptions(QCommandLineParser& parser)
     parser.addOption({{"o", "output"}, "Output file path", "file"});
     parser.addOption({{"c", "clipboard"}, "Copy to clipboard instead of saving"});
     parser.addOption({{"n", "screen"}, "Screen number (0 = primary)", "num"});
-    parser.addOption({"raw", "Output raw PNG to stdout"});
+    addRawOutputOptions(parser);
+    addBurstOptions(parser);
 }
 
 CLIResult FullCommand::execute(const QCommandLineParser& parser)
@@ -39,7 +40,11 @@ CLIResult FullCommand::execute(const QCommandLineParser& parser)
     QString savePath = parser.value("path");
     QString outputFile = parser.value("output");
     bool toClipboard = parser.isSet("clipboard");
-    bool toRaw = parser.isSet("raw");
+    CaptureOutputOptions options;
+    CLIResult rawError;
+    if (!parseRawOutputOptions(parser, &options, &rawError)) {
+        return rawError;
+    }
     int screenNum = -1;
     if (parser.isSet("screen")) {
         const QString screenValue = parser.value("screen");
@@ -52,6 +57,12 @@ CLIResult FullCommand::execute(const QCommandLineParser& parser)
         }
     }
 
+    BurstOptions burst;
+    CLIResult burstError;
+    if (!parseBurstOptions(parser, &burst, &burstError)) {
+        return burstError;
+    }
+
     // Delay before selecting screen/capturing to preserve CLI behavior.
     applyOptionalDelay(delay);
 
@@ -82,24 +93,45 @@ CLIResult FullCommand::execute(const QCommandLineParser& parser)
         return CLIResult::error(CLIResult::Code::GeneralError, "No screen available");
     }
 
-    // Capture screen
-    QPixmap screenshot = screen->grabWindow(0);
-
-    if (screenshot.isNull()) {
-        return CLIResult::error(CLIResult::Code::GeneralError, "Failed to capture screen");
-    }
+    const auto captureFrame = [screen](QPixmap* frame) {
+        *frame = screen->grabWindow(0);
+        if (frame->isNull()) {
+            return CLIResult::error(CLIResult::Code::GeneralError, "Failed to capture screen");
+        }
+        return CLIResult::success();
+    };
 
-    CaptureOutputOptions options;
     options.savePath = savePath;
     options.outputFile = outputFile;
     options.toClipboard = toClipboard;
-    options.toRaw = toRaw;
 
     CaptureMetadata metadata;
     metadata.sourceScreen = screen;
 
+    if (burst.count > 1) {
+        return runCaptureBurst(burst, captureFrame, options, metadata);
+    }
+
+    // Capture screen
+    QPixmap screenshot;
+    const CLIResult captureResult = captureFrame(&screenshot);
+    if (!captureResult.isSuccess()) {
+        return captureResult;
+    }
+
     return emitCaptureOutput(screenshot, options, metadata);
 }
 
+bool FullCommand::canRunInMainInstance(const QCommandLineParser& parser) const
+{
+    return canCaptureInMainInstance(parser);
+}
+
+CLIResult FullCommand::emitForwardedImage(const QCommandLineParser& parser,
+                                          const QImage& image) const
+{
+    return emitForwardedCapture(parser, image);
+}
+
 } // namespace CLI
 } // namespace SnapTray
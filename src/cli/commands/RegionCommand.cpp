@@ -22,7 +22,8 @@ void RegionCommand::setupOptions(QCommandLineParser& parser)
     parser.addOption({{"p", "path"}, "Save directory", "dir"});
     parser.addOption({{"o", "output"}, "Output file path", "file"});
     parser.addOption({{"c", "clipboard"}, "Copy to clipboard"});
-    parser.addOption({"raw", "Output raw PNG to stdout"});
+    addRawOutputOptions(parser);
+    addBurstOptions(parser);
 }
 
 CLIResult RegionCommand::execute(const QCommandLineParser& parser)
@@ -84,7 +85,16 @@ CLIResult RegionCommand::execute(const QCommandLineParser& parser)
     QString savePath = parser.value("path");
     QString outputFile = parser.value("output");
     bool toClipboard = parser.isSet("clipboard");
-    bool toRaw = parser.isSet("raw");
+    CaptureOutputOptions options;
+    CLIResult rawError;
+    if (!parseRawOutputOptions(parser, &options, &rawError)) {
+        return rawError;
+    }
+    BurstOptions burst;
+    CLIResult burstError;
+    if (!parseBurstOptions(parser, &burst, &burstError)) {
+        return burstError;
+    }
 
     QList<QScreen*> screens = QGuiApplication::screens();
     if (screenNum < 0 || screenNum >= screens.size()) {
@@ -100,32 +110,54 @@ CLIResult RegionCommand::execute(const QCommandLineParser& parser)
 
     QScreen* screen = screens.at(screenNum);
 
-    // Capture full screen then crop
-    QPixmap fullScreenshot = screen->grabWindow(0);
-    if (fullScreenshot.isNull()) {
-        return CLIResult::error(CLIResult::Code::GeneralError, "Failed to capture screen");
-    }
-
-    const auto cropResult =
-        SnapTray::ScreenCaptureRegionUtils::cropLogicalRegionFromScreenshot(fullScreenshot, region);
-    if (!cropResult.isValid()) {
-        return CLIResult::error(
-            CLIResult::Code::InvalidArguments,
-            cropResult.error);
-    }
-    QPixmap screenshot = cropResult.pixmap;
+    const auto captureFrame = [screen, region](QPixmap* frame) {
+        // Capture full screen then crop
+        QPixmap fullScreenshot = screen->grabWindow(0);
+        if (fullScreenshot.isNull()) {
+            return CLIResult::error(CLIResult::Code::GeneralError, "Failed to capture screen");
+        }
+
+        const auto cropResult =
+            SnapTray::ScreenCaptureRegionUtils::cropLogicalRegionFromScreenshot(fullScreenshot, region);
+        if (!cropResult.isValid()) {
+            return CLIResult::error(
+                CLIResult::Code::InvalidArguments,
+                cropResult.error);
+        }
+        *frame = cropResult.pixmap;
+        return CLIResult::success();
+    };
 
-    CaptureOutputOptions options;
     options.savePath = savePath;
     options.outputFile = outputFile;
     options.toClipboard = toClipboard;
-    options.toRaw = toRaw;
 
     CaptureMetadata metadata;
     metadata.sourceScreen = screen;
 
+    if (burst.count > 1) {
+        return runCaptureBurst(burst, captureFrame, options, metadata);
+    }
+
+    QPixmap screenshot;
+    const CLIResult captureResult = captureFrame(&screenshot);
+    if (!captureResult.isSuccess()) {
+        return captureResult;
+    }
+
     return emitCaptureOutput(screenshot, options, metadata);
 }
 
+bool RegionCommand::canRunInMainInstance(const QCommandLineParser& parser) const
+{
+    return canCaptureInMainInstance(parser);
+}
+
+CLIResult RegionCommand::emitForwardedImage(const QCommandLineParser& parser,
+                                            const QImage& image) const
+{
+    return emitForwardedCapture(parser, image);
+}
+
 } // namespace CLI
 } // namespace SnapTray
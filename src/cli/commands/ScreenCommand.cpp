@@ -21,8 +21,9 @@ void ScreenCommand::setupOptions(QCommandLineParser& parser)
     parser.addOption({{"p", "path"}, "Save directory", "dir"});
     parser.addOption({{"o", "output"}, "Output file path", "file"});
     parser.addOption({{"c", "clipboard"}, "Copy to clipboard"});
-    parser.addOption({"raw", "Output raw PNG to stdout"});
+    addRawOutputOptions(parser);
     parser.addOption({"list", "List all available screens"});
+    addBurstOptions(parser);
 }
 
 CLIResult ScreenCommand::execute(const QCommandLineParser& parser)
@@ -110,31 +111,60 @@ CLIResult ScreenCommand::execute(const QCommandLineParser& parser)
     QString savePath = parser.value("path");
     QString outputFile = parser.value("output");
     bool toClipboard = parser.isSet("clipboard");
-    bool toRaw = parser.isSet("raw");
+    CaptureOutputOptions options;
+    CLIResult rawError;
+    if (!parseRawOutputOptions(parser, &options, &rawError)) {
+        return rawError;
+    }
+    BurstOptions burst;
+    CLIResult burstError;
+    if (!parseBurstOptions(parser, &burst, &burstError)) {
+        return burstError;
+    }
 
     // Delay before capture to preserve CLI behavior.
     applyOptionalDelay(delay);
 
     QScreen* screen = screens.at(screenNum);
+    const auto captureFrame = [screen](QPixmap* frame) {
+        *frame = screen->grabWindow(0);
+        if (frame->isNull()) {
+            return CLIResult::error(CLIResult::Code::GeneralError, "Failed to capture screen");
+        }
+        return CLIResult::success();
+    };
 
-    // Capture screen
-    QPixmap screenshot = screen->grabWindow(0);
-
-    if (screenshot.isNull()) {
-        return CLIResult::error(CLIResult::Code::GeneralError, "Failed to capture screen");
-    }
-
-    CaptureOutputOptions options;
     options.savePath = savePath;
     options.outputFile = outputFile;
     options.toClipboard = toClipboard;
-    options.toRaw = toRaw;
 
     CaptureMetadata metadata;
     metadata.sourceScreen = screen;
 
+    if (burst.count > 1) {
+        return runCaptureBurst(burst, captureFrame, options, metadata);
+    }
+
+    // Capture screen
+    QPixmap screenshot;
+    const CLIResult captureResult = captureFrame(&screenshot);
+    if (!captureResult.isSuccess()) {
+        return captureResult;
+    }
+
     return emitCaptureOutput(screenshot, options, metadata);
 }
 
+bool ScreenCommand::canRunInMainInstance(const QCommandLineParser& parser) const
+{
+    return canCaptureInMainInstance(parser);
+}
+
+CLIResult ScreenCommand::emitForwardedImage(const QCommandLineParser& parser,
+                                            const QImage& image) const
+{
+    return emitForwardedCapture(parser, image);
+}
+
 } // namespace CLI
 } // namespace SnapTray
@@ -0,0 +1,75 @@
+#include "cli/commands/TrimCommand.h"
+
+#include "encoding/AnimationTrimmer.h"
+
+#include <QFileInfo>
+
+#include <limits>
+
+namespace SnapTray {
+namespace CLI {
+
+QString TrimCommand::name() const { return "trim"; }
+
+QString TrimCommand::description() const { return "Trim an animated GIF or WebP"; }
+
+void TrimCommand::setupOptions(QCommandLineParser& parser)
+{
+    parser.addOption({{"f", "file"}, "Animated GIF or WebP file", "path"});
+    parser.addOption({{"o", "output"}, "Output file path", "file"});
+    parser.addOption({{"s", "start"}, "Start of the kept range in milliseconds", "ms", "0"});
+    parser.addOption({{"e", "end"}, "End of the kept range in milliseconds (default: end of animation)", "ms"});
+}
+
+CLIResult TrimCommand::execute(const QCommandLineParser& parser)
+{
+    if (!parser.isSet("file") || !parser.isSet("output")) {
+        return CLIResult::error(
+            CLIResult::Code::InvalidArguments, "Both --file and --output are required");
+    }
+
+    bool ok = false;
+    const QString startValue = parser.value("start");
+    const qint64 startMs = startValue.toLongLong(&ok);
+    if (!ok || startMs < 0) {
+        return CLIResult::error(
+            CLIResult::Code::InvalidArguments, QString("Invalid start: %1").arg(startValue));
+    }
+
+    qint64 endMs = std::numeric_limits<qint64>::max();
+    if (parser.isSet("end")) {
+        const QString endValue = parser.value("end");
+        endMs = endValue.toLongLong(&ok);
+        if (!ok || endMs <= startMs) {
+            return CLIResult::error(
+                CLIResult::Code::InvalidArguments, QString("Invalid end: %1").arg(endValue));
+        }
+    }
+
+    const QString inputPath = parser.value("file");
+    if (!QFileInfo::exists(inputPath)) {
+        return CLIResult::error(
+            CLIResult::Code::FileError, QString("File not found: %1").arg(inputPath));
+    }
+    if (AnimationTrimmer::detectFileFormat(inputPath) == AnimationTrimmer::Format::Unknown) {
+        return CLIResult::error(
+            CLIResult::Code::FileError,
+            QString("Not a GIF or WebP file: %1").arg(inputPath));
+    }
+
+    const QString outputPath = parser.value("output");
+    const AnimationTrimmer::Result result =
+        AnimationTrimmer::trimFile(inputPath, outputPath, startMs, endMs);
+    if (!result.success) {
+        return CLIResult::error(CLIResult::Code::FileError, result.errorMessage);
+    }
+
+    return CLIResult::success(QString("Trimmed to %1 frames (%2 ms), %3 re-based: %4")
+                                  .arg(result.framesWritten)
+                                  .arg(result.durationMs)
+                                  .arg(result.framesRebased)
+                                  .arg(outputPath));
+}
+
+} // namespace CLI
+} // namespace SnapTray
@@ -1,4 +1,5 @@
 #include "detection/AutoBlurManager.h"
+#include "detection/DetectionResultCache.h"
 #include "detection/FaceDetector.h"
 #include "settings/AutoBlurSettingsManager.h"
 #include "utils/MatConverter.h"
@@ -59,7 +60,16 @@ AutoBlurManager::DetectionResult AutoBlurManager::detect(const QImage& image)
 
     // Detect faces if enabled
     if (m_options.detectFaces && m_faceDetector->isInitialized()) {
-        result.faceRegions = m_faceDetector->detect(image);
+        auto& cache = DetectionResultCache::instance();
+        const quint64 imageHash = DetectionResultCache::hashImage(image);
+        const quint64 configHash = detectionConfigHash();
+        if (!cache.lookup(DetectionResultCache::Kind::Faces, imageHash, configHash,
+                          &result.faceRegions)) {
+            result.faceRegions = m_faceDetector->detect(image);
+            cache.insert(DetectionResultCache::Kind::Faces, imageHash, configHash,
+                         result.faceRegions,
+                         result.faceRegions.size() * static_cast<qint64>(sizeof(QRect)));
+        }
     }
 
     emit detectionProgress(100);
@@ -69,6 +79,25 @@ AutoBlurManager::DetectionResult AutoBlurManager::detect(const QImage& image)
     return result;
 }
 
+void AutoBlurManager::setOptions(const Options& options)
+{
+    m_options = options;
+}
+
+quint64 AutoBlurManager::detectionConfigHash() const
+{
+    const FaceDetector::Config config = m_faceDetector->config();
+    quint64 hash = 0;
+    for (const quint64 value : {static_cast<quint64>(qRound64(config.scaleFactor * 1000.0)),
+                                static_cast<quint64>(config.minNeighbors),
+                                static_cast<quint64>(config.minFaceSize),
+                                static_cast<quint64>(config.maxFaceSize),
+                                static_cast<quint64>(config.tileSize)}) {
+        hash = DetectionResultCache::combineHash(hash, value);
+    }
+    return hash;
+}
+
 void AutoBlurManager::applyBlur(QImage& image, const QVector<QRect>& regions,
                                  int intensity, BlurType type)
 {
@@ -1,4 +1,5 @@
 #include "detection/CredentialDetector.h"
+#include "detection/DetectionResultCache.h"
 
 #include <QRegularExpression>
 #include <QSet>
@@ -627,6 +628,32 @@ QVector<QRect> CredentialDetector::detect(const QVector<OCRTextBlock>& blocks, c
         return {};
     }
 
+    // The patterns are built in, so the OCR output alone determines the result.
+    quint64 blocksHash = DetectionResultCache::combineHash(
+        qHashMulti(0, imageSize.width(), imageSize.height()), static_cast<quint64>(blocks.size()));
+    for (const OCRTextBlock& block : blocks) {
+        const QRectF& rect = block.boundingRect;
+        blocksHash = DetectionResultCache::combineHash(
+            blocksHash, qHashMulti(qHash(block.text), rect.x(), rect.y(), rect.width(), rect.height()));
+    }
+
+    auto& cache = DetectionResultCache::instance();
+    constexpr quint64 kPatternConfigHash = 1;
+    QVector<QRect> regions;
+    if (cache.lookup(DetectionResultCache::Kind::Credentials, blocksHash, kPatternConfigHash,
+                     &regions)) {
+        return regions;
+    }
+
+    regions = detectUncached(blocks, imageSize);
+    cache.insert(DetectionResultCache::Kind::Credentials, blocksHash, kPatternConfigHash, regions,
+                 regions.size() * static_cast<qint64>(sizeof(QRect)));
+    return regions;
+}
+
+QVector<QRect> CredentialDetector::detectUncached(const QVector<OCRTextBlock>& blocks,
+                                                  const QSize& imageSize)
+{
     QVector<PreparedBlock> preparedBlocks;
     QVector<qreal> heights;
     preparedBlocks.reserve(blocks.size());
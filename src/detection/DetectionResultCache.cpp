@@ -0,0 +1,103 @@
+#include "detection/DetectionResultCache.h"
+
+#include "utils/ImageHash.h"
+
+#include <QHash>
+#include <QMutexLocker>
+
+DetectionResultCache& DetectionResultCache::instance()
+{
+    static DetectionResultCache cache;
+    return cache;
+}
+
+DetectionResultCache::DetectionResultCache()
+    : m_results(static_cast<qsizetype>(kDefaultMaxBytes))
+{
+}
+
+quint64 DetectionResultCache::hashImage(const QImage& image)
+{
+    return ImageHash::hashPixels(image);
+}
+
+quint64 DetectionResultCache::combineHash(quint64 seed, quint64 value)
+{
+    return qHashMulti(static_cast<size_t>(seed), value);
+}
+
+void DetectionResultCache::invalidate(Kind kind)
+{
+    QMutexLocker locker(&m_mutex);
+    const QList<Key> keys = m_results.keys();
+    for (const Key& key : keys) {
+        if (key.kind == kind) {
+            m_results.remove(key);
+        }
+    }
+}
+
+void DetectionResultCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_results.clear();
+    m_counters.fill(Counters());
+}
+
+DetectionResultCache::Stats DetectionResultCache::stats(Kind kind) const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    const Counters& counters = m_counters[static_cast<size_t>(kind)];
+    stats.hits = counters.hits;
+    stats.misses = counters.misses;
+
+    const QList<Key> keys = m_results.keys();
+    for (const Key& key : keys) {
+        if (key.kind == kind) {
+            ++stats.entries;
+        }
+    }
+    return stats;
+}
+
+qint64 DetectionResultCache::costBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_results.totalCost();
+}
+
+qint64 DetectionResultCache::maxBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_results.maxCost();
+}
+
+void DetectionResultCache::setMaxBytes(qint64 maxBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_results.setMaxCost(static_cast<qsizetype>(qMax<qint64>(maxBytes, 0)));
+}
+
+bool DetectionResultCache::lookupValue(Kind kind, quint64 contentHash, quint64 configHash,
+                                       std::any* value)
+{
+    QMutexLocker locker(&m_mutex);
+    Counters& counters = m_counters[static_cast<size_t>(kind)];
+    const std::any* cached = m_results.object({kind, contentHash, configHash});
+    if (!cached) {
+        ++counters.misses;
+        return false;
+    }
+    ++counters.hits;
+    *value = *cached;
+    return true;
+}
+
+void DetectionResultCache::insertValue(Kind kind, quint64 contentHash, quint64 configHash,
+                                       std::any value, qint64 costBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_results.insert({kind, contentHash, configHash}, new std::any(std::move(value)),
+                     static_cast<qsizetype>(qMax<qint64>(costBytes, 1)));
+}
@@ -4,16 +4,108 @@
 
 #include <QDebug>
 #include <QFile>
-#include <QTemporaryFile>
+#include <QMutexLocker>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
 
+#include <opencv2/core/persistence.hpp>
 #include <opencv2/objdetect.hpp>
 #include <opencv2/imgproc.hpp>
 
-FaceDetector::FaceDetector()
-    : m_classifier(std::make_unique<cv::CascadeClassifier>())
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Faces up to tileSize / kTileOverlapDivisor proxy pixels are searched per
+// tile; larger ones by a single pass over the whole proxy.
+constexpr int kTileOverlapDivisor = 8;
+
+// Refinement searches sizes around the proxy estimate, in a window padded by
+// this fraction of the face on each side.
+constexpr double kRefineMargin = 0.25;
+constexpr double kRefineMinScale = 0.8;
+constexpr double kRefineMaxScale = 1.25;
+// A refined box must overlap the proxy estimate at least this much (IoU) to
+// replace it; a weaker match is more likely a neighbouring face or clutter.
+constexpr double kRefineMinOverlap = 0.3;
+
+struct DetectionPass {
+    cv::Rect roi;
+    cv::Rect core;  // Keeps only faces centered here
+    cv::Size minSize;
+    cv::Size maxSize;
+    std::vector<cv::Rect> faces;
+};
+
+// Private pool: detection is usually started from the global pool, and waiting
+// for tile work queued behind ourselves would stall.
+QThreadPool* detectionPool()
 {
+    static QThreadPool* pool = []() {
+        auto* threadPool = new QThreadPool();
+        threadPool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+        return threadPool;
+    }();
+    return pool;
 }
 
+cv::Size squareSize(int size)
+{
+    return size > 0 ? cv::Size(size, size) : cv::Size();
+}
+
+// Merge duplicates of the same face, such as one near the overlap size found
+// by both a tile and the whole-proxy pass. groupRectangles drops clusters of
+// a single rectangle, so every rectangle is entered twice to keep lone ones.
+void mergeDetections(std::vector<cv::Rect>& faces)
+{
+    if (faces.size() < 2) {
+        return;
+    }
+    const size_t count = faces.size();
+    faces.reserve(count * 2);
+    for (size_t i = 0; i < count; ++i) {
+        faces.push_back(faces[i]);
+    }
+    cv::groupRectangles(faces, 1, 0.2);
+}
+
+double overlapRatio(const cv::Rect& a, const cv::Rect& b)
+{
+    const double intersection = (a & b).area();
+    const double unionArea = a.area() + b.area() - intersection;
+    return unionArea > 0 ? intersection / unionArea : 0.0;
+}
+
+} // namespace
+
+class FaceDetector::ClassifierLease
+{
+public:
+    explicit ClassifierLease(FaceDetector* detector)
+        : m_detector(detector)
+        , m_classifier(detector->acquireClassifier())
+    {
+    }
+
+    ~ClassifierLease()
+    {
+        if (m_classifier) {
+            m_detector->releaseClassifier(std::move(m_classifier));
+        }
+    }
+
+    cv::CascadeClassifier* get() const { return m_classifier.get(); }
+
+private:
+    FaceDetector* m_detector;
+    std::unique_ptr<cv::CascadeClassifier> m_classifier;
+};
+
+FaceDetector::FaceDetector() = default;
+
 FaceDetector::~FaceDetector() = default;
 
 bool FaceDetector::initialize()
@@ -31,29 +123,29 @@ bool FaceDetector::initialize()
         return false;
     }
 
-    // OpenCV needs a file path, so we extract to a temp file
-    QTemporaryFile tempFile;
-    tempFile.setAutoRemove(false);  // Keep until we load it
-
-    if (!tempFile.open()) {
-        qWarning() << "FaceDetector: Failed to create temp file for cascade";
+    // Parse the XML once; each worker classifier is then read from the
+    // in-memory node tree instead of the file.
+    const QByteArray cascadeXml = resourceFile.readAll();
+    try {
+        m_cascade = std::make_unique<cv::FileStorage>(
+            cascadeXml.toStdString(), cv::FileStorage::READ | cv::FileStorage::MEMORY);
+    } catch (const cv::Exception& e) {
+        qWarning() << "FaceDetector: Failed to parse cascade:" << e.what();
+        m_cascade.reset();
         return false;
     }
 
-    tempFile.write(resourceFile.readAll());
-    tempFile.flush();
-    QString tempPath = tempFile.fileName();
-    tempFile.close();
-
-    // Load the cascade classifier
-    if (!m_classifier->load(tempPath.toStdString())) {
-        qWarning() << "FaceDetector: Failed to load cascade classifier from:" << tempPath;
-        QFile::remove(tempPath);
+    auto classifier = std::make_unique<cv::CascadeClassifier>();
+    if (!m_cascade->isOpened() || !classifier->read(m_cascade->getFirstTopLevelNode())
+        || classifier->empty()) {
+        qWarning() << "FaceDetector: Failed to load cascade classifier from:" << resourcePath;
+        m_cascade.reset();
         return false;
     }
 
-    // Clean up temp file
-    QFile::remove(tempPath);
+    m_windowSize = qMax(classifier->getOriginalWindowSize().width,
+                        classifier->getOriginalWindowSize().height);
+    releaseClassifier(std::move(classifier));
 
     m_initialized = true;
     qDebug() << "FaceDetector: Initialized successfully";
@@ -87,27 +179,135 @@ QVector<QRect> FaceDetector::detect(const QImage& image)
     // Enhance contrast for better detection
     cv::equalizeHist(gray, gray);
 
-    // Detect faces
+    // Shrink until the smallest face we look for just fills the cascade
+    // window; smaller scales would only find faces below minFaceSize.
+    const int minFaceSize = qMax(m_config.minFaceSize, m_windowSize);
+    const double scale = qMin(1.0, static_cast<double>(m_windowSize) / minFaceSize);
+    cv::Mat proxy = gray;
+    if (scale < 1.0) {
+        cv::resize(gray, proxy,
+                   cv::Size(qMax(1, qRound(gray.cols * scale)), qMax(1, qRound(gray.rows * scale))),
+                   0, 0, cv::INTER_AREA);
+    }
+    const double scaleX = static_cast<double>(proxy.cols) / gray.cols;
+    const double scaleY = static_cast<double>(proxy.rows) / gray.rows;
+
+    const int proxyMinFace = qMax(m_windowSize, qRound(m_config.minFaceSize * scale));
+    const int proxyMaxFace = m_config.maxFaceSize > 0
+                                 ? qMax(proxyMinFace, qRound(m_config.maxFaceSize * scale))
+                                 : 0;
+
+    // Neighbouring tiles share an overlap-wide strip and each one owns the
+    // faces centered in its half of it. A face no larger than the overlap lies
+    // wholly inside the tile that owns it, and copies clipped by a seam are
+    // centered in the neighbour's half, so every face is reported once.
+    std::vector<DetectionPass> passes;
+    const int tileSize = m_config.tileSize;
+    const int overlap = tileSize / kTileOverlapDivisor;
+    if (tileSize <= 0 || overlap < proxyMinFace
+        || (proxy.cols <= tileSize + overlap && proxy.rows <= tileSize + overlap)) {
+        const cv::Rect whole(0, 0, proxy.cols, proxy.rows);
+        passes.push_back({whole, whole, squareSize(proxyMinFace), squareSize(proxyMaxFace), {}});
+    } else {
+        const int step = tileSize - overlap;
+        const int tileMaxFace = proxyMaxFace > 0 ? qMin(proxyMaxFace, overlap) : overlap;
+        for (int y = 0; y < qMax(1, proxy.rows - overlap); y += step) {
+            for (int x = 0; x < qMax(1, proxy.cols - overlap); x += step) {
+                const cv::Rect tile(x, y, qMin(tileSize, proxy.cols - x),
+                                    qMin(tileSize, proxy.rows - y));
+                const int left = x > 0 ? x + overlap / 2 : 0;
+                const int top = y > 0 ? y + overlap / 2 : 0;
+                const int right = tile.br().x < proxy.cols ? x + step + overlap / 2 : proxy.cols;
+                const int bottom = tile.br().y < proxy.rows ? y + step + overlap / 2 : proxy.rows;
+                passes.push_back({tile, cv::Rect(left, top, right - left, bottom - top),
+                                  squareSize(proxyMinFace), squareSize(tileMaxFace), {}});
+            }
+        }
+        if (proxyMaxFace == 0 || proxyMaxFace > overlap) {
+            const cv::Rect whole(0, 0, proxy.cols, proxy.rows);
+            passes.push_back({whole, whole, squareSize(overlap), squareSize(proxyMaxFace), {}});
+        }
+    }
+
+    QtConcurrent::blockingMap(detectionPool(), passes, [&](DetectionPass& pass) {
+        ClassifierLease classifier(this);
+        if (!classifier.get()) {
+            return;
+        }
+        classifier.get()->detectMultiScale(
+            proxy(pass.roi),
+            pass.faces,
+            m_config.scaleFactor,
+            m_config.minNeighbors,
+            0,  // flags (deprecated)
+            pass.minSize,
+            pass.maxSize
+            );
+        for (cv::Rect& face : pass.faces) {
+            face += pass.roi.tl();
+        }
+        pass.faces.erase(std::remove_if(pass.faces.begin(), pass.faces.end(),
+                                        [&pass](const cv::Rect& face) {
+                                            return !pass.core.contains(
+                                                (face.tl() + face.br()) / 2);
+                                        }),
+                         pass.faces.end());
+    });
+
     std::vector<cv::Rect> faces;
-    cv::Size minSize(m_config.minFaceSize, m_config.minFaceSize);
-    cv::Size maxSize = m_config.maxFaceSize > 0
-                           ? cv::Size(m_config.maxFaceSize, m_config.maxFaceSize)
-                           : cv::Size();
-
-    m_classifier->detectMultiScale(
-        gray,
-        faces,
-        m_config.scaleFactor,
-        m_config.minNeighbors,
-        0,  // flags (deprecated)
-        minSize,
-        maxSize
-        );
-
-    // Merge overlapping detections (Haar Cascade can detect the same face at multiple scales)
-    // groupThreshold=0 keeps single detections, eps=0.2 merges boxes with 20% overlap
-    if (!faces.empty()) {
-        cv::groupRectangles(faces, 0, 0.2);
+    for (const DetectionPass& pass : passes) {
+        faces.insert(faces.end(), pass.faces.begin(), pass.faces.end());
+    }
+    mergeDetections(faces);
+
+    // Map the proxy hits back to full resolution
+    for (cv::Rect& face : faces) {
+        const int x = qRound(face.x / scaleX);
+        const int y = qRound(face.y / scaleY);
+        face = cv::Rect(x, y, qRound((face.x + face.width) / scaleX) - x,
+                        qRound((face.y + face.height) / scaleY) - y);
+    }
+
+    // Refine each candidate at full resolution. A candidate the full-size
+    // cascade doesn't confirm keeps its proxy bounds rather than being lost.
+    if (scale < 1.0 && !faces.empty()) {
+        const cv::Rect imageRect(0, 0, gray.cols, gray.rows);
+        QtConcurrent::blockingMap(detectionPool(), faces, [&](cv::Rect& face) {
+            const int margin = qRound(face.width * kRefineMargin);
+            const cv::Rect window =
+                cv::Rect(face.x - margin, face.y - margin,
+                         face.width + 2 * margin, face.height + 2 * margin) & imageRect;
+            const int minSize = qMax(m_config.minFaceSize,
+                                     qRound(face.width * kRefineMinScale));
+            int maxSize = qRound(face.width * kRefineMaxScale);
+            if (m_config.maxFaceSize > 0) {
+                maxSize = qMin(maxSize, m_config.maxFaceSize);
+            }
+            if (maxSize < minSize || window.width < minSize || window.height < minSize) {
+                return;
+            }
+
+            ClassifierLease classifier(this);
+            if (!classifier.get()) {
+                return;
+            }
+            std::vector<cv::Rect> refined;
+            classifier.get()->detectMultiScale(gray(window), refined, m_config.scaleFactor,
+                                               m_config.minNeighbors, 0,
+                                               squareSize(minSize), squareSize(maxSize));
+
+            double bestOverlap = kRefineMinOverlap;
+            cv::Rect best = face;
+            for (cv::Rect candidate : refined) {
+                candidate += window.tl();
+                const double ratio = overlapRatio(candidate, face);
+                if (ratio > bestOverlap) {
+                    bestOverlap = ratio;
+                    best = candidate;
+                }
+            }
+            face = best;
+        });
     }
 
     // Convert cv::Rect to QRect
@@ -115,7 +315,8 @@ QVector<QRect> FaceDetector::detect(const QImage& image)
         results.append(QRect(face.x, face.y, face.width, face.height));
     }
 
-    qDebug() << "FaceDetector: Detected" << results.size() << "faces";
+    qDebug() << "FaceDetector: Detected" << results.size() << "faces in"
+             << passes.size() << "passes at scale" << scale;
     return results;
 }
 
@@ -128,3 +329,29 @@ FaceDetector::Config FaceDetector::config() const
 {
     return m_config;
 }
+
+std::unique_ptr<cv::CascadeClassifier> FaceDetector::acquireClassifier()
+{
+    QMutexLocker locker(&m_classifierMutex);
+    if (!m_idleClassifiers.empty()) {
+        auto classifier = std::move(m_idleClassifiers.back());
+        m_idleClassifiers.pop_back();
+        return classifier;
+    }
+    if (!m_cascade) {
+        return nullptr;
+    }
+
+    auto classifier = std::make_unique<cv::CascadeClassifier>();
+    if (!classifier->read(m_cascade->getFirstTopLevelNode())) {
+        qWarning() << "FaceDetector: Failed to create worker classifier";
+        return nullptr;
+    }
+    return classifier;
+}
+
+void FaceDetector::releaseClassifier(std::unique_ptr<cv::CascadeClassifier> classifier)
+{
+    QMutexLocker locker(&m_classifierMutex);
+    m_idleClassifiers.push_back(std::move(classifier));
+}
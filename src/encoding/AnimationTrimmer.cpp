@@ -0,0 +1,935 @@
+#include "encoding/AnimationTrimmer.h"
+
+#include <QBuffer>
+#include <QFile>
+#include <QImage>
+#include <QImageReader>
+#include <QObject>
+#include <QRect>
+#include <QSaveFile>
+
+#include <webp/demux.h>
+#include <webp/encode.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+quint32 readLE16(const uchar *p)
+{
+    return quint32(p[0]) | (quint32(p[1]) << 8);
+}
+
+quint32 readLE24(const uchar *p)
+{
+    return quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16);
+}
+
+quint32 readLE32(const uchar *p)
+{
+    return readLE24(p) | (quint32(p[3]) << 24);
+}
+
+void writeLE16(char *p, quint32 value)
+{
+    p[0] = char(value & 0xff);
+    p[1] = char((value >> 8) & 0xff);
+}
+
+void writeLE24(char *p, quint32 value)
+{
+    writeLE16(p, value);
+    p[2] = char((value >> 16) & 0xff);
+}
+
+void writeLE32(char *p, quint32 value)
+{
+    writeLE24(p, value);
+    p[3] = char((value >> 24) & 0xff);
+}
+
+void appendLE16(QByteArray *out, quint32 value)
+{
+    char bytes[2];
+    writeLE16(bytes, value);
+    out->append(bytes, 2);
+}
+
+void appendLE24(QByteArray *out, quint32 value)
+{
+    char bytes[3];
+    writeLE24(bytes, value);
+    out->append(bytes, 3);
+}
+
+// How long a frame shown from frameStartMs for frameDurationMs stays visible
+// inside [startMs, endMs), or -1 if it is not shown there. A zero-length frame
+// is kept when it starts inside the range.
+qint64 keptDurationMs(qint64 frameStartMs, qint64 frameDurationMs, qint64 startMs, qint64 endMs)
+{
+    if (frameStartMs >= endMs) {
+        return -1;
+    }
+    if (frameDurationMs <= 0) {
+        return frameStartMs >= startMs ? 0 : -1;
+    }
+    const qint64 from = std::max(frameStartMs, startMs);
+    const qint64 to = std::min(frameStartMs + frameDurationMs, endMs);
+    return to > from ? to - from : -1;
+}
+
+// ============================================================================
+// GIF
+// ============================================================================
+
+namespace Gif {
+
+constexpr uchar kExtensionIntroducer = 0x21;
+constexpr uchar kImageSeparator = 0x2C;
+constexpr uchar kTrailer = 0x3B;
+constexpr uchar kGraphicControlLabel = 0xF9;
+constexpr uchar kApplicationLabel = 0xFF;
+
+constexpr int kDisposeNone = 1;
+constexpr int kDisposeBackground = 2;
+constexpr int kDisposePrevious = 3;
+
+constexpr int kMaxLzwCodes = 4096;
+
+struct Block {
+    qsizetype offset = 0;
+    qsizetype size = 0;
+};
+
+struct Frame {
+    std::vector<Block> extensions;  // Extensions in front of the image, in file order
+    int graphicControl = -1;        // Index into extensions
+    Block image;                    // Descriptor, local palette and image data
+    QRect rect;
+    int delayCs = 0;
+    int disposal = 0;
+    bool transparent = false;
+    int transparentIndex = 0;
+};
+
+struct File {
+    int width = 0;
+    int height = 0;
+    Block screen;                       // Signature, screen descriptor and global palette
+    std::vector<Block> globalExtensions;  // Application extensions such as the loop count
+    std::vector<Frame> frames;
+};
+
+// Offset just past a run of data sub-blocks, or -1 if it is truncated
+qsizetype skipSubBlocks(const uchar *data, qsizetype size, qsizetype pos)
+{
+    while (pos < size) {
+        const qsizetype length = data[pos++];
+        if (length == 0) {
+            return pos;
+        }
+        pos += length;
+    }
+    return -1;
+}
+
+bool parse(const QByteArray &input, File *file, QString *error)
+{
+    const auto *data = reinterpret_cast<const uchar *>(input.constData());
+    const qsizetype size = input.size();
+    const QString truncated = QObject::tr("GIF file is truncated");
+
+    if (size < 13 || std::memcmp(data, "GIF", 3) != 0) {
+        *error = QObject::tr("Not a GIF file");
+        return false;
+    }
+
+    file->width = int(readLE16(data + 6));
+    file->height = int(readLE16(data + 8));
+    qsizetype pos = 13;
+    if (data[10] & 0x80) {
+        pos += 3 * (qsizetype(1) << ((data[10] & 0x07) + 1));
+    }
+    if (pos > size) {
+        *error = truncated;
+        return false;
+    }
+    file->screen = {0, pos};
+
+    Frame pending;
+    // A missing trailer is tolerated; everything up to it has been read.
+    while (pos < size && data[pos] != kTrailer) {
+        if (data[pos] == kExtensionIntroducer) {
+            if (pos + 2 > size) {
+                *error = truncated;
+                return false;
+            }
+            const uchar label = data[pos + 1];
+            const qsizetype end = skipSubBlocks(data, size, pos + 2);
+            if (end < 0) {
+                *error = truncated;
+                return false;
+            }
+            const Block block{pos, end - pos};
+            if (label == kApplicationLabel && file->frames.empty()) {
+                file->globalExtensions.push_back(block);
+            } else {
+                if (label == kGraphicControlLabel && block.size >= 8 && data[pos + 2] >= 4) {
+                    const uchar flags = data[pos + 3];
+                    pending.graphicControl = int(pending.extensions.size());
+                    pending.disposal = (flags >> 2) & 0x07;
+                    pending.transparent = (flags & 0x01) != 0;
+                    pending.delayCs = int(readLE16(data + pos + 4));
+                    pending.transparentIndex = data[pos + 6];
+                }
+                pending.extensions.push_back(block);
+            }
+            pos = end;
+        } else if (data[pos] == kImageSeparator) {
+            if (pos + 10 > size) {
+                *error = truncated;
+                return false;
+            }
+            const uchar *descriptor = data + pos + 1;
+            pending.rect = QRect(int(readLE16(descriptor)), int(readLE16(descriptor + 2)),
+                                 int(readLE16(descriptor + 4)), int(readLE16(descriptor + 6)));
+            qsizetype end = pos + 10;
+            if (descriptor[8] & 0x80) {
+                end += 3 * (qsizetype(1) << ((descriptor[8] & 0x07) + 1));
+            }
+            end += 1;  // LZW minimum code size
+            end = end <= size ? skipSubBlocks(data, size, end) : -1;
+            if (end < 0) {
+                *error = truncated;
+                return false;
+            }
+            pending.image = {pos, end - pos};
+            file->frames.push_back(std::move(pending));
+            pending = Frame();
+            pos = end;
+        } else {
+            *error = QObject::tr("GIF file contains an unknown block");
+            return false;
+        }
+    }
+
+    if (file->frames.empty()) {
+        *error = QObject::tr("GIF file has no frames");
+        return false;
+    }
+    return true;
+}
+
+// Whether any pixel of an image block uses the given color index. Encoders
+// often set the transparency flag on every frame, so the image data decides
+// whether a frame really lets the canvas show through. Only the per-code
+// answer is tracked; pixels are never expanded. Malformed data counts as a
+// match.
+bool imageUsesIndex(const uchar *data, const Block &image, int index)
+{
+    const uchar *descriptor = data + image.offset + 1;
+    qsizetype pos = image.offset + 10;
+    if (descriptor[8] & 0x80) {
+        pos += 3 * (qsizetype(1) << ((descriptor[8] & 0x07) + 1));
+    }
+    const qsizetype end = image.offset + image.size;
+    const int minCodeSize = data[pos++];
+    if (minCodeSize < 2 || minCodeSize > 11) {
+        return true;
+    }
+
+    const int clearCode = 1 << minCodeSize;
+    const int endCode = clearCode + 1;
+    if (index >= clearCode) {
+        return false;
+    }
+
+    uchar firstIndex[kMaxLzwCodes];
+    bool containsIndex[kMaxLzwCodes];
+    for (int code = 0; code < clearCode; ++code) {
+        firstIndex[code] = uchar(code);
+        containsIndex[code] = code == index;
+    }
+
+    int codeSize = minCodeSize + 1;
+    int nextCode = endCode + 1;
+    int previous = -1;
+    quint32 bitBuffer = 0;
+    int bitCount = 0;
+    qsizetype blockRemaining = 0;
+
+    while (true) {
+        while (bitCount < codeSize) {
+            if (blockRemaining == 0) {
+                if (pos >= end || data[pos] == 0) {
+                    return true;  // No end code
+                }
+                blockRemaining = data[pos++];
+            }
+            if (pos >= end) {
+                return true;
+            }
+            bitBuffer |= quint32(data[pos++]) << bitCount;
+            bitCount += 8;
+            --blockRemaining;
+        }
+        const int code = int(bitBuffer & ((1u << codeSize) - 1));
+        bitBuffer >>= codeSize;
+        bitCount -= codeSize;
+
+        if (code == clearCode) {
+            codeSize = minCodeSize + 1;
+            nextCode = endCode + 1;
+            previous = -1;
+            continue;
+        }
+        if (code == endCode) {
+            return false;
+        }
+        if (previous < 0) {
+            if (code >= clearCode || containsIndex[code]) {
+                return true;
+            }
+            previous = code;
+            continue;
+        }
+        if (code > nextCode || (code == nextCode && nextCode >= kMaxLzwCodes)) {
+            return true;
+        }
+
+        // A code not yet in the table stands for the previous string plus its own first index.
+        const uchar appended = code < nextCode ? firstIndex[code] : firstIndex[previous];
+        if (nextCode < kMaxLzwCodes) {
+            firstIndex[nextCode] = firstIndex[previous];
+            containsIndex[nextCode] = containsIndex[previous] || appended == index;
+            ++nextCode;
+            if (nextCode == (1 << codeSize) && codeSize < 12) {
+                ++codeSize;
+            }
+        }
+        if (containsIndex[code]) {
+            return true;
+        }
+        previous = code;
+    }
+}
+
+// Variable-length LZW as specified for GIF, packed into 255-byte sub-blocks
+void appendLzwData(QByteArray *out, const std::vector<uchar> &indices, int minCodeSize)
+{
+    out->append(char(minCodeSize));
+
+    const int clearCode = 1 << minCodeSize;
+    const int endCode = clearCode + 1;
+    int codeSize = minCodeSize + 1;
+    int nextCode = endCode + 1;
+
+    char block[256];
+    int blockSize = 0;
+    quint32 bitBuffer = 0;
+    int bitCount = 0;
+
+    auto flushBlock = [&]() {
+        if (blockSize > 0) {
+            block[0] = char(blockSize);
+            out->append(block, blockSize + 1);
+            blockSize = 0;
+        }
+    };
+    auto writeCode = [&](int code) {
+        bitBuffer |= quint32(code) << bitCount;
+        bitCount += codeSize;
+        while (bitCount >= 8) {
+            block[++blockSize] = char(bitBuffer & 0xff);
+            bitBuffer >>= 8;
+            bitCount -= 8;
+            if (blockSize == 255) {
+                flushBlock();
+            }
+        }
+    };
+    // The decoder adds a code for every code it reads after the first, so the
+    // width grows once the next code no longer fits.
+    auto growCodeSize = [&]() {
+        if (nextCode >= (1 << codeSize) && codeSize < 12) {
+            ++codeSize;
+        }
+    };
+
+    std::unordered_map<quint32, int> codes;
+    codes.reserve(kMaxLzwCodes);
+
+    writeCode(clearCode);
+    int prefix = indices.empty() ? 0 : indices.front();
+    for (size_t i = 1; i < indices.size(); ++i) {
+        const quint32 key = (quint32(prefix) << 8) | indices[i];
+        const auto it = codes.find(key);
+        if (it != codes.end()) {
+            prefix = it->second;
+            continue;
+        }
+        writeCode(prefix);
+        growCodeSize();
+        if (nextCode >= kMaxLzwCodes - 1) {
+            writeCode(clearCode);
+            codes.clear();
+            codeSize = minCodeSize + 1;
+            nextCode = endCode + 1;
+        } else {
+            codes.emplace(key, nextCode++);
+        }
+        prefix = indices[i];
+    }
+    writeCode(prefix);
+    growCodeSize();
+    writeCode(endCode);
+
+    if (bitCount > 0) {
+        block[++blockSize] = char(bitBuffer & 0xff);
+    }
+    flushBlock();
+    out->append('\0');
+}
+
+// Writes a composited canvas as one full-screen frame with a local palette.
+// The palette is exact when the canvas has at most 256 colors.
+void appendCanvasFrame(QByteArray *out, const QImage &canvas, int delayCs, int disposal)
+{
+    const QImage argb = canvas.convertToFormat(QImage::Format_ARGB32);
+    const int width = argb.width();
+    const int height = argb.height();
+
+    bool hasTransparency = false;
+    for (int y = 0; y < height && !hasTransparency; ++y) {
+        const auto *line = reinterpret_cast<const QRgb *>(argb.constScanLine(y));
+        for (int x = 0; x < width; ++x) {
+            if (qAlpha(line[x]) < 128) {
+                hasTransparency = true;
+                break;
+            }
+        }
+    }
+
+    const QImage opaque = argb.convertToFormat(QImage::Format_RGB32);
+    QImage indexed = opaque.convertToFormat(QImage::Format_Indexed8);
+    QList<QRgb> palette = indexed.colorTable();
+    if (hasTransparency && palette.size() > 255) {
+        palette.resize(255);
+        indexed = opaque.convertToFormat(QImage::Format_Indexed8, palette);
+    }
+
+    const int transparentIndex = hasTransparency ? int(palette.size()) : 0;
+    std::vector<uchar> indices(size_t(width) * size_t(height));
+    for (int y = 0; y < height; ++y) {
+        const uchar *source = indexed.constScanLine(y);
+        const auto *alpha = reinterpret_cast<const QRgb *>(argb.constScanLine(y));
+        uchar *target = indices.data() + size_t(y) * size_t(width);
+        for (int x = 0; x < width; ++x) {
+            target[x] = qAlpha(alpha[x]) < 128 ? uchar(transparentIndex) : source[x];
+        }
+    }
+
+    const int colorCount = int(palette.size()) + (hasTransparency ? 1 : 0);
+    int paletteBits = 1;
+    while ((1 << paletteBits) < colorCount) {
+        ++paletteBits;
+    }
+
+    const char graphicControl[] = {
+        char(kExtensionIntroducer), char(kGraphicControlLabel), 4,
+        char((disposal << 2) | (hasTransparency ? 1 : 0)),
+        0, 0, char(transparentIndex), 0};
+    const qsizetype controlOffset = out->size();
+    out->append(graphicControl, sizeof(graphicControl));
+    writeLE16(out->data() + controlOffset + 4, quint32(delayCs));
+
+    out->append(char(kImageSeparator));
+    appendLE16(out, 0);
+    appendLE16(out, 0);
+    appendLE16(out, quint32(width));
+    appendLE16(out, quint32(height));
+    out->append(char(0x80 | (paletteBits - 1)));
+    for (int i = 0; i < (1 << paletteBits); ++i) {
+        const QRgb color = i < palette.size() ? palette.at(i) : 0;
+        const char rgb[] = {char(qRed(color)), char(qGreen(color)), char(qBlue(color))};
+        out->append(rgb, 3);
+    }
+
+    appendLzwData(out, indices, std::max(2, paletteBits));
+}
+
+} // namespace Gif
+
+// ============================================================================
+// WebP
+// ============================================================================
+
+namespace WebP {
+
+constexpr uchar kVp8xAnimationFlag = 0x02;
+constexpr uchar kVp8xAlphaFlag = 0x10;
+constexpr uchar kAnmfNoBlendFlag = 0x02;
+constexpr uchar kAnmfDisposeFlag = 0x01;
+constexpr qsizetype kAnmfHeaderSize = 16;
+
+struct Chunk {
+    qsizetype offset = 0;       // Start of the chunk header
+    qsizetype payloadSize = 0;  // Without the header and padding
+};
+
+struct Frame {
+    Chunk chunk;
+    QRect rect;
+    int durationMs = 0;
+    bool blend = true;
+    bool disposeToBackground = false;
+    bool hasAlpha = false;
+};
+
+struct File {
+    int width = 0;
+    int height = 0;
+    std::vector<Chunk> leading;   // VP8X, ICCP and ANIM
+    std::vector<Frame> frames;
+    std::vector<Chunk> trailing;  // EXIF, XMP and unknown chunks
+    int vp8xIndex = -1;           // Index into leading
+};
+
+bool isFourCC(const uchar *p, const char *fourcc)
+{
+    return std::memcmp(p, fourcc, 4) == 0;
+}
+
+// Walks the chunks in [pos, end); returns false on a truncated chunk
+template <typename Visitor>
+bool forEachChunk(const uchar *data, qsizetype pos, qsizetype end, Visitor visit)
+{
+    while (pos + 8 <= end) {
+        const qsizetype payloadSize = qsizetype(readLE32(data + pos + 4));
+        if (payloadSize > end - pos - 8) {
+            return false;
+        }
+        visit(Chunk{pos, payloadSize});
+        pos += 8 + payloadSize + (payloadSize & 1);
+    }
+    return true;
+}
+
+// Whether a frame's bitstream may contain transparent pixels
+bool frameHasAlpha(const uchar *data, qsizetype pos, qsizetype end)
+{
+    bool hasAlpha = false;
+    forEachChunk(data, pos, end, [&](const Chunk &chunk) {
+        const uchar *header = data + chunk.offset;
+        if (isFourCC(header, "ALPH")) {
+            hasAlpha = true;
+        } else if (isFourCC(header, "VP8L") && chunk.payloadSize >= 5) {
+            // Signature byte, then 14 bits width, 14 bits height, alpha_is_used
+            hasAlpha = hasAlpha || ((readLE32(header + 9) >> 28) & 1) != 0;
+        }
+    });
+    return hasAlpha;
+}
+
+bool parse(const QByteArray &input, File *file, QString *error)
+{
+    const auto *data = reinterpret_cast<const uchar *>(input.constData());
+    const qsizetype size = input.size();
+
+    if (size < 12 || !isFourCC(data, "RIFF") || !isFourCC(data + 8, "WEBP")) {
+        *error = QObject::tr("Not a WebP file");
+        return false;
+    }
+    const qsizetype riffEnd = std::min(size, qsizetype(readLE32(data + 4)) + 8);
+
+    bool animated = false;
+    bool valid = true;
+    const bool complete = forEachChunk(data, 12, riffEnd, [&](const Chunk &chunk) {
+        const uchar *header = data + chunk.offset;
+        const uchar *payload = header + 8;
+        if (isFourCC(header, "ANMF")) {
+            if (chunk.payloadSize < kAnmfHeaderSize) {
+                valid = false;
+                return;
+            }
+            Frame frame;
+            frame.chunk = chunk;
+            frame.rect = QRect(int(readLE24(payload)) * 2, int(readLE24(payload + 3)) * 2,
+                               int(readLE24(payload + 6)) + 1, int(readLE24(payload + 9)) + 1);
+            frame.durationMs = int(readLE24(payload + 12));
+            frame.blend = (payload[15] & kAnmfNoBlendFlag) == 0;
+            frame.disposeToBackground = (payload[15] & kAnmfDisposeFlag) != 0;
+            frame.hasAlpha = frameHasAlpha(data, chunk.offset + 8 + kAnmfHeaderSize,
+                                           chunk.offset + 8 + chunk.payloadSize);
+            file->frames.push_back(frame);
+        } else if (!file->frames.empty()) {
+            file->trailing.push_back(chunk);
+        } else {
+            if (isFourCC(header, "VP8X") && chunk.payloadSize >= 10) {
+                animated = (payload[0] & kVp8xAnimationFlag) != 0;
+                file->width = int(readLE24(payload + 4)) + 1;
+                file->height = int(readLE24(payload + 7)) + 1;
+                file->vp8xIndex = int(file->leading.size());
+            }
+            file->leading.push_back(chunk);
+        }
+    });
+
+    if (!complete || !valid) {
+        *error = QObject::tr("WebP file is truncated");
+        return false;
+    }
+    if (!animated || file->vp8xIndex < 0) {
+        *error = QObject::tr("WebP file is not animated");
+        return false;
+    }
+    if (file->frames.empty()) {
+        *error = QObject::tr("WebP file has no frames");
+        return false;
+    }
+    return true;
+}
+
+void appendChunk(QByteArray *out, const QByteArray &input, const Chunk &chunk)
+{
+    out->append(input.constData() + chunk.offset, 8 + chunk.payloadSize);
+    if (chunk.payloadSize & 1) {
+        out->append('\0');
+    }
+}
+
+struct AnimDecoderDeleter {
+    void operator()(WebPAnimDecoder *decoder) const { WebPAnimDecoderDelete(decoder); }
+};
+
+// Encodes an RGBA canvas losslessly and wraps it in a full-canvas ANMF chunk
+// that replaces whatever is below it.
+bool appendCanvasFrame(QByteArray *out, const uint8_t *rgba, int width, int height,
+                       int durationMs, bool disposeToBackground, bool *hasAlpha)
+{
+    uint8_t *encoded = nullptr;
+    const size_t encodedSize = WebPEncodeLosslessRGBA(rgba, width, height, width * 4, &encoded);
+    if (encodedSize < 12) {
+        WebPFree(encoded);
+        return false;
+    }
+
+    // The encoder produces a simple RIFF file holding a single VP8L chunk.
+    Chunk bitstream;
+    bool found = false;
+    forEachChunk(encoded, 12, qsizetype(encodedSize), [&](const Chunk &chunk) {
+        if (!found && isFourCC(encoded + chunk.offset, "VP8L")) {
+            bitstream = chunk;
+            found = true;
+        }
+    });
+    if (!found) {
+        WebPFree(encoded);
+        return false;
+    }
+    *hasAlpha = frameHasAlpha(encoded, bitstream.offset,
+                              bitstream.offset + 8 + bitstream.payloadSize);
+
+    const qsizetype paddedSize = bitstream.payloadSize + (bitstream.payloadSize & 1);
+    out->append("ANMF", 4);
+    char sizeBytes[4];
+    writeLE32(sizeBytes, quint32(kAnmfHeaderSize + 8 + paddedSize));
+    out->append(sizeBytes, 4);
+    appendLE24(out, 0);
+    appendLE24(out, 0);
+    appendLE24(out, quint32(width - 1));
+    appendLE24(out, quint32(height - 1));
+    appendLE24(out, quint32(durationMs));
+    out->append(char(kAnmfNoBlendFlag | (disposeToBackground ? kAnmfDisposeFlag : 0)));
+    out->append(reinterpret_cast<const char *>(encoded) + bitstream.offset,
+                8 + bitstream.payloadSize);
+    if (bitstream.payloadSize & 1) {
+        out->append('\0');
+    }
+
+    WebPFree(encoded);
+    return true;
+}
+
+} // namespace WebP
+
+} // namespace
+
+AnimationTrimmer::Format AnimationTrimmer::detectFormat(const QByteArray &header)
+{
+    if (header.startsWith("GIF87a") || header.startsWith("GIF89a")) {
+        return Format::Gif;
+    }
+    if (header.size() >= 12 && header.startsWith("RIFF") && header.mid(8, 4) == "WEBP") {
+        return Format::WebP;
+    }
+    return Format::Unknown;
+}
+
+AnimationTrimmer::Format AnimationTrimmer::detectFileFormat(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Format::Unknown;
+    }
+    return detectFormat(file.read(12));
+}
+
+AnimationTrimmer::Result AnimationTrimmer::trim(const QByteArray &input, qint64 startMs,
+                                                qint64 endMs, QByteArray *output)
+{
+    if (startMs < 0 || endMs <= startMs) {
+        Result result;
+        result.errorMessage = QObject::tr("Invalid trim range");
+        return result;
+    }
+
+    switch (detectFormat(input)) {
+    case Format::Gif:
+        return trimGif(input, startMs, endMs, output);
+    case Format::WebP:
+        return trimWebP(input, startMs, endMs, output);
+    case Format::Unknown:
+        break;
+    }
+
+    Result result;
+    result.errorMessage = QObject::tr("Only GIF and animated WebP files can be trimmed");
+    return result;
+}
+
+AnimationTrimmer::Result AnimationTrimmer::trimFile(const QString &inputPath,
+                                                    const QString &outputPath,
+                                                    qint64 startMs, qint64 endMs)
+{
+    QFile inputFile(inputPath);
+    if (!inputFile.open(QIODevice::ReadOnly)) {
+        Result result;
+        result.errorMessage = QObject::tr("Cannot open %1: %2")
+                                  .arg(inputPath, inputFile.errorString());
+        return result;
+    }
+    const QByteArray input = inputFile.readAll();
+    inputFile.close();
+
+    QByteArray output;
+    Result result = trim(input, startMs, endMs, &output);
+    if (!result.success) {
+        return result;
+    }
+
+    QSaveFile outputFile(outputPath);
+    if (!outputFile.open(QIODevice::WriteOnly)
+        || outputFile.write(output) != output.size()
+        || !outputFile.commit()) {
+        result.success = false;
+        result.errorMessage = QObject::tr("Cannot write %1: %2")
+                                  .arg(outputPath, outputFile.errorString());
+    }
+    return result;
+}
+
+AnimationTrimmer::Result AnimationTrimmer::trimGif(const QByteArray &input, qint64 startMs,
+                                                   qint64 endMs, QByteArray *output)
+{
+    Result result;
+    Gif::File file;
+    if (!Gif::parse(input, &file, &result.errorMessage)) {
+        return result;
+    }
+    const auto *data = reinterpret_cast<const uchar *>(input.constData());
+
+    QByteArray out;
+    out.reserve(input.size());
+    out.append(input.constData() + file.screen.offset, file.screen.size);
+    // Graphic control extensions need the 89a signature.
+    std::memcpy(out.data() + 3, "89a", 3);
+    for (const Gif::Block &block : file.globalExtensions) {
+        out.append(input.constData() + block.offset, block.size);
+    }
+
+    // The trimmed animation starts from an empty canvas, so once leading
+    // frames are dropped it is out of sync with the original. Until a frame
+    // leaves the canvas as it is in the original, frames that show what is
+    // below them are replaced by the decoded canvas. While out of sync the
+    // output canvas is always empty, since re-based frames that do not
+    // restore sync are disposed to the background.
+    QBuffer buffer;
+    buffer.setData(input);
+    QImageReader reader(&buffer, "gif");
+    QImage canvas;
+    int decodedFrames = 0;
+    bool inSync = true;
+
+    qint64 frameStartMs = 0;
+    for (size_t i = 0; i < file.frames.size(); ++i) {
+        const Gif::Frame &frame = file.frames[i];
+        const qint64 frameDurationMs = qint64(frame.delayCs) * 10;
+        const qint64 keptMs = keptDurationMs(frameStartMs, frameDurationMs, startMs, endMs);
+        frameStartMs += frameDurationMs;
+        if (keptMs < 0) {
+            inSync = inSync && result.framesWritten > 0;
+            continue;
+        }
+
+        const int delayCs = frame.delayCs > 0 ? std::max<int>(1, int((keptMs + 5) / 10)) : 0;
+        const auto coversCanvas = [&]() {
+            return frame.rect.contains(QRect(0, 0, file.width, file.height))
+                && (!frame.transparent
+                    || !Gif::imageUsesIndex(data, frame.image, frame.transparentIndex));
+        };
+
+        if (inSync || coversCanvas()) {
+            for (size_t e = 0; e < frame.extensions.size(); ++e) {
+                const Gif::Block &block = frame.extensions[e];
+                const qsizetype offset = out.size();
+                out.append(input.constData() + block.offset, block.size);
+                if (int(e) == frame.graphicControl) {
+                    writeLE16(out.data() + offset + 4, quint32(delayCs));
+                }
+            }
+            out.append(input.constData() + frame.image.offset, frame.image.size);
+            inSync = inSync || frame.disposal != Gif::kDisposePrevious;
+        } else {
+            while (decodedFrames <= int(i)) {
+                if (!reader.read(&canvas)) {
+                    result.errorMessage = QObject::tr("Failed to decode GIF frame %1: %2")
+                                              .arg(decodedFrames)
+                                              .arg(reader.errorString());
+                    return result;
+                }
+                ++decodedFrames;
+            }
+            if (canvas.size() != QSize(file.width, file.height)) {
+                result.errorMessage = QObject::tr("Decoded GIF frame has an unexpected size");
+                return result;
+            }
+            inSync = frame.disposal != Gif::kDisposeBackground
+                && frame.disposal != Gif::kDisposePrevious;
+            Gif::appendCanvasFrame(&out, canvas, delayCs,
+                                   inSync ? Gif::kDisposeNone : Gif::kDisposeBackground);
+            ++result.framesRebased;
+        }
+
+        ++result.framesWritten;
+        result.durationMs += qint64(delayCs) * 10;
+    }
+
+    if (result.framesWritten == 0) {
+        result.errorMessage = QObject::tr("No frames fall inside the trim range");
+        return result;
+    }
+
+    out.append(char(Gif::kTrailer));
+    *output = std::move(out);
+    result.success = true;
+    return result;
+}
+
+AnimationTrimmer::Result AnimationTrimmer::trimWebP(const QByteArray &input, qint64 startMs,
+                                                    qint64 endMs, QByteArray *output)
+{
+    Result result;
+    WebP::File file;
+    if (!WebP::parse(input, &file, &result.errorMessage)) {
+        return result;
+    }
+
+    QByteArray out;
+    out.reserve(input.size());
+    out.append(input.constData(), 12);
+    qsizetype vp8xOffset = -1;
+    for (size_t i = 0; i < file.leading.size(); ++i) {
+        if (int(i) == file.vp8xIndex) {
+            vp8xOffset = out.size();
+        }
+        WebP::appendChunk(&out, input, file.leading[i]);
+    }
+
+    // Once leading frames are dropped, frames that blend over or only partly
+    // cover the canvas are replaced by the decoded canvas until one leaves it
+    // as the original does. Re-based frames never blend, so they do not
+    // depend on what is below them.
+    const WebPData webpData{reinterpret_cast<const uint8_t *>(input.constData()),
+                            size_t(input.size())};
+    std::unique_ptr<WebPAnimDecoder, WebP::AnimDecoderDeleter> decoder;
+    uint8_t *canvas = nullptr;
+    int decodedFrames = 0;
+    bool inSync = true;
+    bool canvasAlpha = false;
+
+    const QRect canvasRect(0, 0, file.width, file.height);
+    qint64 frameStartMs = 0;
+    for (size_t i = 0; i < file.frames.size(); ++i) {
+        const WebP::Frame &frame = file.frames[i];
+        const qint64 keptMs = keptDurationMs(frameStartMs, frame.durationMs, startMs, endMs);
+        frameStartMs += frame.durationMs;
+        if (keptMs < 0) {
+            inSync = inSync && result.framesWritten > 0;
+            continue;
+        }
+
+        const bool coversCanvas = frame.rect.contains(canvasRect)
+            && (!frame.blend || !frame.hasAlpha);
+
+        if (inSync || coversCanvas) {
+            const qsizetype offset = out.size();
+            WebP::appendChunk(&out, input, frame.chunk);
+            writeLE24(out.data() + offset + 8 + 12, quint32(keptMs));
+            inSync = true;
+        } else {
+            if (!decoder) {
+                WebPAnimDecoderOptions options;
+                WebPAnimDecoderOptionsInit(&options);
+                options.color_mode = MODE_RGBA;
+                decoder.reset(WebPAnimDecoderNew(&webpData, &options));
+                if (!decoder) {
+                    result.errorMessage = QObject::tr("Failed to decode WebP animation");
+                    return result;
+                }
+            }
+            while (decodedFrames <= int(i)) {
+                int timestamp = 0;
+                if (!WebPAnimDecoderGetNext(decoder.get(), &canvas, &timestamp)) {
+                    result.errorMessage = QObject::tr("Failed to decode WebP frame %1")
+                                              .arg(decodedFrames);
+                    return result;
+                }
+                ++decodedFrames;
+            }
+            bool hasAlpha = false;
+            if (!WebP::appendCanvasFrame(&out, canvas, file.width, file.height, int(keptMs),
+                                         frame.disposeToBackground, &hasAlpha)) {
+                result.errorMessage = QObject::tr("Failed to encode WebP frame %1").arg(int(i));
+                return result;
+            }
+            canvasAlpha = canvasAlpha || hasAlpha;
+            inSync = !frame.disposeToBackground || frame.rect.contains(canvasRect);
+            ++result.framesRebased;
+        }
+
+        ++result.framesWritten;
+        result.durationMs += keptMs;
+    }
+
+    if (result.framesWritten == 0) {
+        result.errorMessage = QObject::tr("No frames fall inside the trim range");
+        return result;
+    }
+
+    for (const WebP::Chunk &chunk : file.trailing) {
+        WebP::appendChunk(&out, input, chunk);
+    }
+    if (canvasAlpha && vp8xOffset >= 0) {
+        out[vp8xOffset + 8] = char(uchar(out.at(vp8xOffset + 8)) | WebP::kVp8xAlphaFlag);
+    }
+    writeLE32(out.data() + 4, quint32(out.size() - 8));
+
+    *output = std::move(out);
+    result.success = true;
+    return result;
+}
@@ -1,5 +1,6 @@
 #include "encoding/EncodingWorker.h"
 #include "IVideoEncoder.h"
+#include "encoding/FrameDiff.h"
 #include "encoding/NativeGifEncoder.h"
 #include "encoding/WebPAnimEncoder.h"
 
@@ -7,6 +8,7 @@
 #include <QThread>
 #include <QPointer>
 #include <QMetaObject>
+#include <cstring>
 #include <exception>
 
 EncodingWorker::EncodingWorker(QObject *parent)
@@ -89,6 +91,13 @@ void EncodingWorker::setWatermarkSettings(const WatermarkRenderer::Settings& set
     }, Qt::BlockingQueuedConnection);
 }
 
+void EncodingWorker::configureFramePool(const QSize& frameSize, int capacity, bool preallocate)
+{
+    m_framePoolFrameSize = frameSize;
+    m_framePoolCapacity = capacity;
+    m_framePoolPreallocate = preallocate;
+}
+
 bool EncodingWorker::start()
 {
     if (QThread::currentThread() == thread()) {
@@ -137,6 +146,8 @@ bool EncodingWorker::startOnWorkerThread()
     m_isProcessing = false;
     m_framesWritten = 0;
     m_wasNearFull = false;
+    m_previousFrame = QImage();
+    m_lastSkippedTimestampMs = -1;
 
     // Clear any stale data from previous session
     {
@@ -145,6 +156,21 @@ bool EncodingWorker::startOnWorkerThread()
         m_audioQueue.clear();
     }
 
+    // The producer is blocked in start(), so the pool can be rebuilt safely.
+    if (!m_framePoolFrameSize.isEmpty()) {
+        int capacity = m_framePoolCapacity;
+        if (capacity <= 0) {
+            const qint64 frameBytes =
+                qint64(m_framePoolFrameSize.width()) * m_framePoolFrameSize.height() * 4;
+            capacity = static_cast<int>(qBound<qint64>(
+                MIN_FRAME_POOL_SIZE, FRAME_POOL_BUDGET_BYTES / frameBytes, MAX_QUEUE_SIZE));
+        }
+        // Engines that hand over their own images only need the slots.
+        m_framePool.reset(capacity, m_framePoolPreallocate ? m_framePoolFrameSize : QSize());
+    } else {
+        m_framePool.reset(0, QSize());
+    }
+
     return true;
 }
 
@@ -177,6 +203,8 @@ void EncodingWorker::stopOnWorkerThread()
     m_running = false;
     m_isProcessing = false;
     m_wasNearFull = false;
+    m_previousFrame = QImage();
+    m_lastSkippedTimestampMs = -1;
 
     // Clear queues
     {
@@ -185,6 +213,9 @@ void EncodingWorker::stopOnWorkerThread()
         m_audioQueue.clear();
     }
 
+    // stop() blocks the producer, so pooled buffers can be freed outright.
+    m_framePool.reset(0, QSize());
+
     // Abort encoders. This runs in the worker affinity thread.
     if (m_videoEncoder) {
         m_videoEncoder->abort();
@@ -230,13 +261,7 @@ void EncodingWorker::requestFinishOnWorkerThread()
 
     m_finishRequested = true;
 
-    bool hasPendingWork = false;
-    {
-        QMutexLocker locker(&m_queueMutex);
-        hasPendingWork = !m_audioQueue.isEmpty() || !m_frameQueue.isEmpty();
-    }
-
-    if (hasPendingWork) {
+    if (hasPendingWork()) {
         scheduleProcessing();
         return;
     }
@@ -274,9 +299,8 @@ bool EncodingWorker::enqueueFrame(const FrameData& frame)
     }
 
     // Emit queue pressure signals outside lock
-    if (depth >= QUEUE_NEAR_FULL_THRESHOLD && !m_wasNearFull) {
+    if (depth >= QUEUE_NEAR_FULL_THRESHOLD && !m_wasNearFull.exchange(true)) {
         emit queuePressure(depth, MAX_QUEUE_SIZE);
-        m_wasNearFull = true;
     }
 
     scheduleProcessing();
@@ -284,6 +308,39 @@ bool EncodingWorker::enqueueFrame(const FrameData& frame)
     return true;
 }
 
+int EncodingWorker::acquireFrameBuffer()
+{
+    if (!m_acceptingFrames.load() || !m_running.load()) {
+        return -1;
+    }
+    return m_framePool.acquire();
+}
+
+bool EncodingWorker::submitFrameBuffer(int slot, qint64 timestampMs)
+{
+    if (!m_acceptingFrames.load() || !m_running.load()) {
+        m_framePool.cancel(slot);
+        return false;
+    }
+
+    m_framePool.publish(slot, timestampMs);
+
+    const int capacity = m_framePool.capacity();
+    const int depth = m_framePool.stats().inFlight;
+    if (depth >= capacity * 4 / 5 && !m_wasNearFull.exchange(true)) {
+        emit queuePressure(depth, capacity);
+    }
+
+    scheduleProcessing();
+
+    return true;
+}
+
+void EncodingWorker::cancelFrameBuffer(int slot)
+{
+    m_framePool.cancel(slot);
+}
+
 void EncodingWorker::writeAudioSamples(const QByteArray& data, qint64 timestampMs)
 {
     if (!m_acceptingFrames.load() || !m_running.load()) {
@@ -308,7 +365,13 @@ void EncodingWorker::writeAudioSamples(const QByteArray& data, qint64 timestampM
 int EncodingWorker::queueDepth() const
 {
     QMutexLocker locker(&m_queueMutex);
-    return m_frameQueue.size();
+    return m_frameQueue.size() + m_framePool.readyCount();
+}
+
+bool EncodingWorker::hasPendingWork() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return !m_audioQueue.isEmpty() || !m_frameQueue.isEmpty() || m_framePool.readyCount() > 0;
 }
 
 bool EncodingWorker::isProcessing() const
@@ -346,6 +409,8 @@ void EncodingWorker::processNextFrame()
         AudioData audioData;
         bool hasFrame = false;
         bool hasAudio = false;
+        int pooledSlot = -1;
+        qint64 pooledTimestampMs = 0;
         int frameDepth = 0;
         bool queueBecameEmpty = false;
         bool shouldFinish = false;
@@ -360,6 +425,8 @@ void EncodingWorker::processNextFrame()
             } else if (!m_audioQueue.isEmpty()) {
                 audioData = m_audioQueue.dequeue();
                 hasAudio = true;
+            } else if (m_framePool.takeReady(pooledSlot, pooledTimestampMs)) {
+                frameDepth = m_framePool.readyCount();
             } else if (!m_frameQueue.isEmpty()) {
                 frameData = m_frameQueue.dequeue();
                 frameDepth = m_frameQueue.size();
@@ -379,12 +446,7 @@ void EncodingWorker::processNextFrame()
 
             // Race guard: if new work arrived right after we observed an empty queue,
             // reacquire processing ownership and continue.
-            bool hasPendingWork = false;
-            {
-                QMutexLocker locker(&m_queueMutex);
-                hasPendingWork = !m_audioQueue.isEmpty() || !m_frameQueue.isEmpty();
-            }
-            if (hasPendingWork && m_running.load() && !m_finishCalled.load()
+            if (hasPendingWork() && m_running.load() && !m_finishCalled.load()
                 && !m_isProcessing.exchange(true)) {
                 continue;
             }
@@ -404,16 +466,22 @@ void EncodingWorker::processNextFrame()
                                         QStringLiteral("unknown exception"));
                 return;
             }
+        } else if (pooledSlot >= 0) {
+            const int capacity = m_framePool.capacity();
+            if (frameDepth <= capacity / 5) {
+                notifyQueueLow(frameDepth, capacity);
+            }
+
+            // Encode straight from the pooled buffer, then hand it back
+            encodeFrame(m_framePool.image(pooledSlot), pooledTimestampMs);
+            m_framePool.release(pooledSlot);
+            if (!m_running.load()) {
+                m_isProcessing = false;
+                return;
+            }
         } else if (hasFrame) {
-            // Emit queue low signal outside lock
-            if (frameDepth <= QUEUE_LOW_THRESHOLD && m_wasNearFull) {
-                QPointer<EncodingWorker> guard(this);
-                QMetaObject::invokeMethod(this, [guard, frameDepth]() {
-                    if (guard) {
-                        emit guard->queueLow(frameDepth, MAX_QUEUE_SIZE);
-                    }
-                }, Qt::QueuedConnection);
-                m_wasNearFull = false;
+            if (frameDepth <= QUEUE_LOW_THRESHOLD) {
+                notifyQueueLow(frameDepth, MAX_QUEUE_SIZE);
             }
 
             // Process the frame (heavy work)
@@ -426,24 +494,43 @@ void EncodingWorker::processNextFrame()
     }
 }
 
+void EncodingWorker::notifyQueueLow(int depth, int maxDepth)
+{
+    // Emit queue low signal outside lock. Submitters on the UI thread set
+    // the flag concurrently, so exactly one side wins each transition.
+    if (!m_wasNearFull.exchange(false)) {
+        return;
+    }
+
+    QPointer<EncodingWorker> guard(this);
+    QMetaObject::invokeMethod(this, [guard, depth, maxDepth]() {
+        if (guard) {
+            emit guard->queueLow(depth, maxDepth);
+        }
+    }, Qt::QueuedConnection);
+}
+
 void EncodingWorker::doProcessFrame(const FrameData& frameData)
 {
-    try {
-        // Make a copy for modification (triggers COW only now)
-        QImage frame = frameData.frame;
+    // Make a copy for modification (triggers COW only if watermarked)
+    QImage frame = frameData.frame;
+    encodeFrame(frame, frameData.timestampMs);
+}
 
-        // Apply watermark if enabled
+void EncodingWorker::encodeFrame(QImage& frame, qint64 timestampMs)
+{
+    try {
+        // Apply watermark if enabled (in place)
         if (m_watermarkSettings.enabled) {
             applyWatermark(frame);
         }
 
         // Write to encoder
         if (m_encoderType == EncoderType::Video && m_videoEncoder) {
-            m_videoEncoder->writeFrame(frame, frameData.timestampMs);
-        } else if (m_encoderType == EncoderType::Gif && m_gifEncoder) {
-            m_gifEncoder->writeFrame(frame, frameData.timestampMs);
-        } else if (m_encoderType == EncoderType::WebP && m_webpEncoder) {
-            m_webpEncoder->writeFrame(frame, frameData.timestampMs);
+            m_videoEncoder->writeFrame(frame, timestampMs);
+        } else if ((m_encoderType == EncoderType::Gif && m_gifEncoder)
+                   || (m_encoderType == EncoderType::WebP && m_webpEncoder)) {
+            writeAnimationFrame(frame, timestampMs);
         }
 
         // Update frame count
@@ -467,6 +554,63 @@ void EncodingWorker::doProcessFrame(const FrameData& frameData)
     }
 }
 
+void EncodingWorker::writeAnimationFrame(const QImage& frame, qint64 timestampMs)
+{
+    // Screen recordings are mostly static. An unchanged frame only lengthens
+    // the previous one; a changed frame is cut down to its changed area.
+    const QRect changedRect = FrameDiff::changedRect(m_previousFrame, frame);
+    if (changedRect.isNull()) {
+        m_lastSkippedTimestampMs = timestampMs;
+        return;
+    }
+
+    if (m_encoderType == EncoderType::Gif) {
+        m_gifEncoder->writeFrame(frame, timestampMs, changedRect);
+    } else {
+        // libwebp's animation encoder takes full canvases and crops each
+        // frame to its difference with the previous one itself.
+        m_webpEncoder->writeFrame(frame, timestampMs);
+    }
+    updatePreviousFrame(frame, changedRect);
+    m_lastSkippedTimestampMs = -1;
+}
+
+void EncodingWorker::updatePreviousFrame(const QImage& frame, const QRect& changedRect)
+{
+    // Only the changed area is copied into the worker's own buffer.
+    const QRect rect = changedRect.intersected(frame.rect());
+    if (m_previousFrame.size() != frame.size() || m_previousFrame.format() != frame.format()
+        || frame.depth() % 8 != 0) {
+        m_previousFrame = frame.copy();
+        return;
+    }
+
+    const int bytesPerPixel = frame.depth() / 8;
+    const size_t offset = static_cast<size_t>(rect.x()) * bytesPerPixel;
+    const size_t rowBytes = static_cast<size_t>(rect.width()) * bytesPerPixel;
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        std::memcpy(m_previousFrame.scanLine(y) + offset, frame.constScanLine(y) + offset,
+                    rowBytes);
+    }
+}
+
+void EncodingWorker::flushSkippedFrames()
+{
+    if (m_lastSkippedTimestampMs < 0 || m_previousFrame.isNull()) {
+        return;
+    }
+
+    // Repeat the last frame at the final timestamp so the static tail keeps
+    // its duration.
+    const qint64 timestampMs = m_lastSkippedTimestampMs;
+    m_lastSkippedTimestampMs = -1;
+    if (m_encoderType == EncoderType::Gif && m_gifEncoder) {
+        m_gifEncoder->writeFrame(m_previousFrame, timestampMs, QRect(0, 0, 1, 1));
+    } else if (m_encoderType == EncoderType::WebP && m_webpEncoder) {
+        m_webpEncoder->writeFrame(m_previousFrame, timestampMs);
+    }
+}
+
 void EncodingWorker::handleProcessingFailure(const QString& context, const QString& details)
 {
     const bool wasRunning = m_running.exchange(false);
@@ -481,6 +625,8 @@ void EncodingWorker::handleProcessingFailure(const QString& context, const QStri
         m_frameQueue.clear();
         m_audioQueue.clear();
     }
+    // The producer may still be running; only the consumer side is touched.
+    m_framePool.drain();
 
     // Another path already stopped this worker; avoid duplicate error emissions.
     if (!wasRunning) {
@@ -519,8 +665,9 @@ void EncodingWorker::applyWatermark(QImage& frame)
         return;
     }
 
-    // Use thread-safe QImage-based rendering
-    frame = WatermarkRenderer::applyToImageWithCache(frame, m_cachedWatermarkImage, m_watermarkSettings);
+    // Use thread-safe QImage-based rendering. Painting in place keeps pooled
+    // buffers from being copied; shared frames detach on the first write.
+    WatermarkRenderer::applyToImageInPlace(frame, m_cachedWatermarkImage, m_watermarkSettings);
 }
 
 void EncodingWorker::finishEncoder()
@@ -538,6 +685,15 @@ void EncodingWorker::finishEncoder()
         return;
     }
 
+    try {
+        flushSkippedFrames();
+    } catch (const std::exception& e) {
+        qWarning() << "EncodingWorker: Failed to write trailing frame:" << e.what();
+    } catch (...) {
+        qWarning() << "EncodingWorker: Failed to write trailing frame";
+    }
+    m_previousFrame = QImage();
+
     if (m_encoderType == EncoderType::Video && m_videoEncoder) {
         // Connect to encoder's finished signal before calling finish()
         auto conn = std::make_shared<QMetaObject::Connection>();
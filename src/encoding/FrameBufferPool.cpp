@@ -0,0 +1,130 @@
+#include "encoding/FrameBufferPool.h"
+
+void FrameBufferPool::IndexRing::reset(int capacity)
+{
+    m_items.assign(static_cast<size_t>(qMax(capacity, 0)), -1);
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+}
+
+void FrameBufferPool::IndexRing::push(int value)
+{
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    Q_ASSERT(tail - m_head.load(std::memory_order_acquire) < m_items.size());
+    m_items[tail % m_items.size()] = value;
+    m_tail.store(tail + 1, std::memory_order_release);
+}
+
+bool FrameBufferPool::IndexRing::pop(int& value)
+{
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    value = m_items[head % m_items.size()];
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+int FrameBufferPool::IndexRing::size() const
+{
+    const size_t head = m_head.load(std::memory_order_acquire);
+    const size_t tail = m_tail.load(std::memory_order_acquire);
+    return static_cast<int>(tail - head);
+}
+
+void FrameBufferPool::reset(int capacity, const QSize& frameSize, QImage::Format format)
+{
+    capacity = qMax(capacity, 0);
+
+    // Drop the old buffers before allocating new ones to keep the peak low.
+    m_slots.clear();
+    m_slots.shrink_to_fit();
+    m_slots.resize(static_cast<size_t>(capacity));
+
+    m_free.reset(capacity);
+    m_ready.reset(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        if (frameSize.isValid() && !frameSize.isEmpty()) {
+            m_slots[static_cast<size_t>(i)].image = QImage(frameSize, format);
+        }
+        m_free.push(i);
+    }
+
+    m_spareSlot = -1;
+    m_inFlight.store(0, std::memory_order_relaxed);
+    m_peakInFlight.store(0, std::memory_order_relaxed);
+    m_published.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+}
+
+int FrameBufferPool::acquire()
+{
+    int slot = m_spareSlot;
+    if (slot >= 0) {
+        m_spareSlot = -1;
+    } else if (m_slots.empty() || !m_free.pop(slot)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+
+    const int inFlight = m_inFlight.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (inFlight > m_peakInFlight.load(std::memory_order_relaxed)) {
+        m_peakInFlight.store(inFlight, std::memory_order_relaxed);
+    }
+    return slot;
+}
+
+void FrameBufferPool::publish(int slot, qint64 timestampMs)
+{
+    Q_ASSERT(slot >= 0 && slot < capacity());
+    m_slots[static_cast<size_t>(slot)].timestampMs = timestampMs;
+    m_published.fetch_add(1, std::memory_order_relaxed);
+    m_ready.push(slot);
+}
+
+void FrameBufferPool::cancel(int slot)
+{
+    Q_ASSERT(slot >= 0 && slot < capacity() && m_spareSlot < 0);
+    m_spareSlot = slot;
+    m_inFlight.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool FrameBufferPool::takeReady(int& slot, qint64& timestampMs)
+{
+    if (m_slots.empty() || !m_ready.pop(slot)) {
+        return false;
+    }
+    timestampMs = m_slots[static_cast<size_t>(slot)].timestampMs;
+    return true;
+}
+
+void FrameBufferPool::release(int slot)
+{
+    Q_ASSERT(slot >= 0 && slot < capacity());
+    m_inFlight.fetch_sub(1, std::memory_order_relaxed);
+    m_free.push(slot);
+}
+
+int FrameBufferPool::drain()
+{
+    int discarded = 0;
+    int slot = -1;
+    qint64 timestampMs = 0;
+    while (takeReady(slot, timestampMs)) {
+        release(slot);
+        ++discarded;
+    }
+    return discarded;
+}
+
+FrameBufferPool::Stats FrameBufferPool::stats() const
+{
+    Stats stats;
+    stats.capacity = capacity();
+    stats.inFlight = m_inFlight.load(std::memory_order_relaxed);
+    stats.peakInFlight = m_peakInFlight.load(std::memory_order_relaxed);
+    stats.published = m_published.load(std::memory_order_relaxed);
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,130 @@
+#include "encoding/FrameDiff.h"
+
+#include <QtGlobal>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SNAPTRAY_FRAMEDIFF_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SNAPTRAY_FRAMEDIFF_NEON 1
+#endif
+
+namespace {
+
+// Index of the first pixel in [0, count) that differs, or count.
+int firstDifference(const quint32* a, const quint32* b, int count)
+{
+    int x = 0;
+#if defined(SNAPTRAY_FRAMEDIFF_SSE2)
+    for (; x + 4 <= count; x += 4) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(va, vb)) != 0xffff) {
+            break;
+        }
+    }
+#elif defined(SNAPTRAY_FRAMEDIFF_NEON)
+    for (; x + 4 <= count; x += 4) {
+        const uint32x4_t equal = vceqq_u32(vld1q_u32(a + x), vld1q_u32(b + x));
+        const uint32x2_t folded = vand_u32(vget_low_u32(equal), vget_high_u32(equal));
+        if ((vget_lane_u32(folded, 0) & vget_lane_u32(folded, 1)) != 0xffffffffu) {
+            break;
+        }
+    }
+#endif
+    for (; x < count; ++x) {
+        if (a[x] != b[x]) {
+            return x;
+        }
+    }
+    return count;
+}
+
+// Index of the last pixel in [0, count) that differs, or -1.
+int lastDifference(const quint32* a, const quint32* b, int count)
+{
+    int x = count;
+#if defined(SNAPTRAY_FRAMEDIFF_SSE2)
+    for (; x >= 4; x -= 4) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x - 4));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x - 4));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(va, vb)) != 0xffff) {
+            break;
+        }
+    }
+#elif defined(SNAPTRAY_FRAMEDIFF_NEON)
+    for (; x >= 4; x -= 4) {
+        const uint32x4_t equal = vceqq_u32(vld1q_u32(a + x - 4), vld1q_u32(b + x - 4));
+        const uint32x2_t folded = vand_u32(vget_low_u32(equal), vget_high_u32(equal));
+        if ((vget_lane_u32(folded, 0) & vget_lane_u32(folded, 1)) != 0xffffffffu) {
+            break;
+        }
+    }
+#endif
+    for (--x; x >= 0; --x) {
+        if (a[x] != b[x]) {
+            return x;
+        }
+    }
+    return -1;
+}
+
+const quint32* row(const QImage& image, int y)
+{
+    return reinterpret_cast<const quint32*>(image.constScanLine(y));
+}
+
+} // namespace
+
+namespace FrameDiff {
+
+QRect changedRect(const QImage& previous, const QImage& current)
+{
+    if (previous.isNull() || previous.size() != current.size()
+        || previous.format() != current.format() || current.depth() != 32) {
+        return current.rect();
+    }
+
+    // Shared buffers (e.g. the same captured image queued twice)
+    if (previous.constBits() == current.constBits()) {
+        return QRect();
+    }
+
+    const int width = current.width();
+    const int height = current.height();
+
+    int top = 0;
+    while (top < height && firstDifference(row(previous, top), row(current, top), width) == width) {
+        ++top;
+    }
+    if (top == height) {
+        return QRect();
+    }
+
+    int bottom = height - 1;
+    while (bottom > top && firstDifference(row(previous, bottom), row(current, bottom), width) == width) {
+        --bottom;
+    }
+
+    // Each row only needs scanning up to the extent found so far.
+    int left = width;
+    int right = -1;
+    for (int y = top; y <= bottom; ++y) {
+        const quint32* a = row(previous, y);
+        const quint32* b = row(current, y);
+        left = qMin(left, firstDifference(a, b, left));
+        if (right < width - 1) {
+            const int tail = width - (right + 1);
+            const int last = lastDifference(a + right + 1, b + right + 1, tail);
+            if (last >= 0) {
+                right += 1 + last;
+            }
+        }
+    }
+
+    return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+} // namespace FrameDiff
@@ -6,10 +6,69 @@
 #include "encoding/NativeGifEncoder.h"
 #include <QDebug>
 #include <QSaveFile>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <future>
 
 // Helper macro for casting opaque pointer
 #define GIF_STATE static_cast<MsfGifState*>(m_gifState)
 
+namespace {
+// Bounds memory use: each in-flight frame owns its cooked pixels and 2 MB of
+// LZW tables.
+constexpr int kMaxEncodeThreads = 4;
+// 2-3-2 bits per channel: at most 128 colors, so quantization never retries
+constexpr int kSharedPaletteDepth = 7;
+
+// True if msf_gif will store any pixel of rect as transparent
+bool hasTransparentPixelsIn(const QImage &rgba, const QRect &rect)
+{
+    if (msf_gif_alpha_threshold <= 0) {
+        return false;
+    }
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        const uchar *row = rgba.constScanLine(y) + rect.x() * 4;
+        for (int x = 0; x < rect.width(); ++x) {
+            if (row[x * 4 + 3] < msf_gif_alpha_threshold) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+}
+
+// Scratch buffers for quantizing and compressing one frame. Recycled once no
+// job references them anymore.
+struct NativeGifEncoder::FrameScratch
+{
+    explicit FrameScratch(int pixelCount)
+        : cooked(static_cast<size_t>(pixelCount))
+        , used(usedAllocSize)
+        , tlb(tlbAllocSize)
+        , lzw(lzwAllocSize / sizeof(int16_t))
+    {
+    }
+
+    std::vector<uint32_t> cooked;
+    std::vector<uint8_t> used;
+    std::vector<uint8_t> tlb;
+    std::vector<int16_t> lzw;
+};
+
+struct NativeGifEncoder::FrameJob
+{
+    std::shared_ptr<FrameScratch> scratch;
+    MsfCookedFrame cooked = {};
+    std::promise<void> cookedPromise;
+    std::shared_future<void> cookedReady;  // cooked is valid once ready
+    MsfGifBuffer *encoded = nullptr;
+    QRect rect;  // Area of the canvas the frame covers
+    bool hasTransparentPixels = false;
+    QFuture<void> done;
+};
+
 NativeGifEncoder::NativeGifEncoder(QObject *parent)
     : QObject(parent)
     , m_gifState(nullptr)
@@ -21,7 +80,9 @@ NativeGifEncoder::NativeGifEncoder(QObject *parent)
     , m_lastTimestampMs(0)
     , m_running(false)
     , m_aborted(false)
+    , m_sharedPalette(false)
 {
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, kMaxEncodeThreads));
 }
 
 NativeGifEncoder::~NativeGifEncoder()
@@ -36,6 +97,11 @@ void NativeGifEncoder::setMaxBitDepth(int depth)
     m_maxBitDepth = qBound(1, depth, 16);
 }
 
+void NativeGifEncoder::setSharedPalette(bool enabled)
+{
+    m_sharedPalette = enabled;
+}
+
 bool NativeGifEncoder::start(const QString &outputPath, const QSize &frameSize, int frameRate)
 {
     if (m_running) {
@@ -77,12 +143,25 @@ bool NativeGifEncoder::start(const QString &outputPath, const QSize &frameSize,
         return false;
     }
 
+    // Frames are quantized and compressed with per-job buffers, so release
+    // the ones msf_gif_begin allocated for its single-threaded path.
+    for (MsfCookedFrame *frame : {&GIF_STATE->previousFrame, &GIF_STATE->currentFrame}) {
+        MSF_GIF_FREE(nullptr, frame->pixels, 0);
+        frame->pixels = nullptr;
+    }
+    MSF_GIF_FREE(nullptr, GIF_STATE->lzwMem, lzwAllocSize);
+    MSF_GIF_FREE(nullptr, GIF_STATE->tlbMem, tlbAllocSize);
+    MSF_GIF_FREE(nullptr, GIF_STATE->usedMem, usedAllocSize);
+    GIF_STATE->lzwMem = nullptr;
+    GIF_STATE->tlbMem = nullptr;
+    GIF_STATE->usedMem = nullptr;
+
     m_running = true;
     qDebug() << "NativeGifEncoder: Started -" << m_frameSize << "@" << m_frameRate << "fps";
     return true;
 }
 
-void NativeGifEncoder::writeFrame(const QImage &frame, qint64 timestampMs)
+void NativeGifEncoder::writeFrame(const QImage &frame, qint64 timestampMs, const QRect &changedRect)
 {
     if (!m_running || m_aborted || !m_gifState) {
         qDebug() << "NativeGifEncoder::writeFrame - Skipping: running=" << m_running
@@ -130,19 +209,150 @@ void NativeGifEncoder::writeFrame(const QImage &frame, qint64 timestampMs)
                  << "expected:" << (processed.width() * 4);
     }
 
-    // Calculate delay in centiseconds (1/100 second)
-    int centiSeconds = calculateCentiseconds(timestampMs);
+    // Only the changed area is stored; the first frame and rescaled frames
+    // (whose pixels no longer line up with the caller's) are stored whole.
+    const QRect frameRect(QPoint(0, 0), m_frameSize);
+    QRect rect = frameRect;
+    if (m_framesWritten > 0 && frame.size() == m_frameSize && changedRect.isValid()) {
+        rect = changedRect.intersected(frameRect);
+        if (rect.isEmpty()) {
+            // GIF has no empty frames; a single unchanged pixel extends the
+            // previous one
+            rect = QRect(0, 0, 1, 1);
+        }
+        // Transparent pixels need the previous frame disposed to background,
+        // which would leave holes wherever a sub-rect frame doesn't repaint
+        if (rect != frameRect && hasTransparentPixelsIn(processed, rect)) {
+            rect = frameRect;
+        }
+    }
+
+    // The held frame is shown until this one, which fixes its delay
+    if (!m_heldFrame.isNull()) {
+        submitFrame(m_heldFrame, m_heldRect, calculateCentiseconds(timestampMs));
+    }
+    m_heldFrame = processed;
+    m_heldRect = rect;
+
+    m_framesWritten++;
+    m_lastTimestampMs = timestampMs;
 
-    // Write frame to GIF
-    int pitchInBytes = processed.bytesPerLine();
-    int result = msf_gif_frame(GIF_STATE,
-                       const_cast<uint8_t*>(processed.constBits()),
-                       centiSeconds,
-                       m_maxBitDepth,
-                       pitchInBytes);
-    if (!result) {
+    // Keep at most one queued frame per worker; waits on the oldest frame
+    collectEncodedFrames(static_cast<size_t>(m_pool.maxThreadCount()));
+    if (!m_running) {
+        return;
+    }
+
+    // Emit progress every 30 frames
+    if (m_framesWritten % 30 == 0) {
+        emit progress(m_framesWritten);
+    }
+}
+
+void NativeGifEncoder::submitFrame(const QImage &frame, const QRect &rect, int centiSeconds)
+{
+    // Quantize and compress on the pool. Mirrors msf_gif_frame, except that
+    // the reference to the previous frame goes through its job.
+    auto job = std::make_shared<FrameJob>();
+    job->scratch = acquireScratch();
+    job->cookedReady = job->cookedPromise.get_future().share();
+    job->rect = rect;
+
+    const std::shared_ptr<FrameJob> previous = m_previousJob;
+    const bool sharedPalette = m_sharedPalette;
+    const int quality = sharedPalette ? qMin(m_maxBitDepth, kSharedPaletteDepth) : m_maxBitDepth;
+
+    job->done = QtConcurrent::run(&m_pool, [job, previous, frame, rect, centiSeconds, quality,
+                                            sharedPalette]() {
+        FrameScratch &scratch = *job->scratch;
+        MsfCookedFrame previousFrame = {};
+
+        // The adaptive depth search starts from the previous frame's result,
+        // so only shared-palette frames can be quantized concurrently.
+        int depth = quality;
+        if (!sharedPalette) {
+            if (previous) {
+                previous->cookedReady.wait();
+                previousFrame = previous->cooked;
+            }
+            depth = qMin(quality, previousFrame.depth + 160 / qMax(1, previousFrame.count));
+        }
+
+        const qsizetype bytesPerLine = frame.bytesPerLine();
+        const uchar *origin = frame.constBits() + rect.y() * bytesPerLine + rect.x() * 4;
+        job->cooked.pixels = scratch.cooked.data();
+        msf_cook_frame(&job->cooked, const_cast<uint8_t*>(origin), scratch.used.data(),
+                       rect.width(), rect.height(), static_cast<int>(bytesPerLine), depth);
+        job->cookedPromise.set_value();
+
+        // Pixels equal to the previous frame are encoded as transparent,
+        // which needs both frames to cover the same area.
+        // framesSubmitted stays 0 so the library leaves the output list
+        // alone; the previous frame's disposal is patched on append.
+        MsfGifState context = {};
+        if (previous && previous->rect == rect) {
+            if (sharedPalette) {
+                previous->cookedReady.wait();
+            }
+            context.previousFrame = previous->cooked;
+        }
+        job->encoded = msf_compress_frame(nullptr, rect.width(), rect.height(), centiSeconds,
+                                          job->cooked, &context, scratch.used.data(),
+                                          scratch.tlb.data(), scratch.lzw.data());
+        const int paletteBits = job->cooked.rbits + job->cooked.gbits + job->cooked.bbits;
+        job->hasTransparentPixels = scratch.used[static_cast<size_t>(1) << paletteBits] != 0;
+
+        // msf_gif always places frames at the origin
+        if (job->encoded) {
+            job->encoded->data[9] = static_cast<uint8_t>(rect.x() & 0xff);
+            job->encoded->data[10] = static_cast<uint8_t>(rect.x() >> 8);
+            job->encoded->data[11] = static_cast<uint8_t>(rect.y() & 0xff);
+            job->encoded->data[12] = static_cast<uint8_t>(rect.y() >> 8);
+        }
+    });
+    m_previousJob = job;
+    m_pendingFrames.push_back(std::move(job));
+}
+
+std::shared_ptr<NativeGifEncoder::FrameScratch> NativeGifEncoder::acquireScratch()
+{
+    // Only this thread creates references, so a count of one means no job
+    // or reference frame is using the buffers anymore.
+    for (const auto &scratch : m_scratchPool) {
+        if (scratch.use_count() == 1) {
+            return scratch;
+        }
+    }
+    m_scratchPool.push_back(std::make_shared<FrameScratch>(m_frameSize.width() * m_frameSize.height()));
+    return m_scratchPool.back();
+}
+
+void NativeGifEncoder::collectEncodedFrames(size_t maxPending)
+{
+    while (!m_pendingFrames.empty()) {
+        const std::shared_ptr<FrameJob> job = m_pendingFrames.front();
+        if (m_pendingFrames.size() <= maxPending && !job->done.isFinished()) {
+            break;
+        }
+        job->done.waitForFinished();
+        m_pendingFrames.pop_front();
+        appendEncodedFrame(*job);
+    }
+}
+
+void NativeGifEncoder::appendEncodedFrame(FrameJob &job)
+{
+    MsfGifBuffer *buffer = job.encoded;
+    job.encoded = nullptr;
+
+    if (!m_running || !m_gifState) {
+        MSF_GIF_FREE(nullptr, buffer, 0);
+        return;
+    }
+
+    if (!buffer) {
         m_consecutiveFailures++;
-        qWarning() << "NativeGifEncoder: msf_gif_frame failed for frame" << m_framesWritten
+        qWarning() << "NativeGifEncoder: frame compression failed"
                    << "(consecutive failures:" << m_consecutiveFailures << ")";
 
         // Stop encoding after too many consecutive failures to prevent silent corruption
@@ -155,28 +365,47 @@ void NativeGifEncoder::writeFrame(const QImage &frame, qint64 timestampMs)
         return;
     }
 
+    // Same as msf_gif_frame: dispose the previous frame to background so
+    // transparent pixels of this one show through. Only safe when this frame
+    // repaints everything the disposal clears; writeFrame() stores frames
+    // with transparent pixels whole to guarantee that.
+    MsfGifState *state = GIF_STATE;
+    if (job.hasTransparentPixels && state->framesSubmitted > 0
+        && job.rect.contains(m_appendedRect)) {
+        state->listTail->data[3] = 0x09;
+    }
+    state->listTail->next = buffer;
+    state->listTail = buffer;
+    state->framesSubmitted += 1;
+    m_appendedRect = job.rect;
+
     // Reset failure counter on success
     m_consecutiveFailures = 0;
-    m_framesWritten++;
-    m_lastTimestampMs = timestampMs;
+}
 
-    // Emit progress every 30 frames
-    if (m_framesWritten % 30 == 0) {
-        emit progress(m_framesWritten);
+void NativeGifEncoder::discardPendingFrames()
+{
+    for (const auto &job : m_pendingFrames) {
+        job->done.waitForFinished();
+        MSF_GIF_FREE(nullptr, job->encoded, 0);
+        job->encoded = nullptr;
     }
+    m_pendingFrames.clear();
+    m_previousJob.reset();
+    m_heldFrame = QImage();
 }
 
-int NativeGifEncoder::calculateCentiseconds(qint64 timestampMs)
+int NativeGifEncoder::calculateCentiseconds(qint64 nextTimestampMs)
 {
-    if (timestampMs < 0 || m_framesWritten == 0) {
-        // First frame or no timestamp provided, use base frame rate
+    if (nextTimestampMs < 0 || m_lastTimestampMs < 0) {
+        // Last frame or no timestamp provided, use base frame rate
         // Default to 10 centiseconds (100ms) if frameRate is invalid
         // Use qMax(1, ...) to ensure minimum 1 centisecond (10ms) for high fps
         return (m_frameRate > 0) ? qMax(1, 100 / m_frameRate) : 10;
     }
 
-    // Calculate time delta from previous frame
-    qint64 deltaMs = timestampMs - m_lastTimestampMs;
+    // Calculate time delta until the next frame
+    qint64 deltaMs = nextTimestampMs - m_lastTimestampMs;
 
     // Convert to centiseconds (1/100 second)
     int centiSeconds = static_cast<int>(deltaMs / 10);
@@ -198,6 +427,15 @@ void NativeGifEncoder::finish()
         return;
     }
 
+    // The last frame has nothing after it to time it by
+    if (m_running && !m_heldFrame.isNull()) {
+        submitFrame(m_heldFrame, m_heldRect, calculateCentiseconds(-1));
+    }
+    m_heldFrame = QImage();
+
+    // Wait for frames still being compressed on the pool
+    collectEncodedFrames(0);
+
     if (!m_running || m_framesWritten == 0) {
         MsfGifResult result = msf_gif_end(GIF_STATE);
         if (result.data) {
@@ -271,6 +509,7 @@ void NativeGifEncoder::abort()
 
     qDebug() << "NativeGifEncoder: Aborting";
     m_aborted = true;
+    discardPendingFrames();
 
     if (m_gifState) {
         // End encoding and discard result
@@ -285,6 +524,9 @@ void NativeGifEncoder::abort()
 
 void NativeGifEncoder::cleanup()
 {
+    discardPendingFrames();
+    m_scratchPool.clear();
+
     if (m_gifState) {
         delete GIF_STATE;
         m_gifState = nullptr;
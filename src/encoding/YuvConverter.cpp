@@ -0,0 +1,209 @@
+#include "encoding/YuvConverter.h"
+
+#include <QtGlobal>
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SNAPTRAY_YUV_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SNAPTRAY_YUV_NEON 1
+#endif
+#endif
+
+namespace {
+
+// BT.709 limited range scaled by 256. The chroma offset folds the +128 bias
+// and the rounding term into one constant so every intermediate stays in
+// [0, 65535] and the vector paths can use unsigned 16-bit lanes.
+constexpr int kYR = 47;
+constexpr int kYG = 157;
+constexpr int kYB = 16;
+constexpr int kUR = 26;   // subtracted
+constexpr int kUG = 86;   // subtracted
+constexpr int kUB = 112;
+constexpr int kVR = 112;
+constexpr int kVG = 102;  // subtracted
+constexpr int kVB = 10;   // subtracted
+constexpr int kChromaBias = 128 * 256 + 128;
+
+inline uchar lumaOf(int r, int g, int b)
+{
+    return static_cast<uchar>(((kYR * r + kYG * g + kYB * b + 128) >> 8) + 16);
+}
+
+inline uchar chromaUOf(int r, int g, int b)
+{
+    return static_cast<uchar>((kUB * b - kUR * r - kUG * g + kChromaBias) >> 8);
+}
+
+inline uchar chromaVOf(int r, int g, int b)
+{
+    return static_cast<uchar>((kVR * r - kVG * g - kVB * b + kChromaBias) >> 8);
+}
+
+inline int blue(quint32 pixel) { return static_cast<int>(pixel & 0xff); }
+inline int green(quint32 pixel) { return static_cast<int>((pixel >> 8) & 0xff); }
+inline int red(quint32 pixel) { return static_cast<int>((pixel >> 16) & 0xff); }
+
+#if defined(SNAPTRAY_YUV_SSE2)
+// Splits 8 BGRA pixels into 16-bit blue, green and red lanes.
+inline void loadChannels(const quint32* pixels, __m128i& b, __m128i& g, __m128i& r)
+{
+    const __m128i mask = _mm_set1_epi32(0xff);
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + 4));
+    b = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+    g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 8), mask),
+                        _mm_and_si128(_mm_srli_epi32(hi, 8), mask));
+    r = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 16), mask),
+                        _mm_and_si128(_mm_srli_epi32(hi, 16), mask));
+}
+
+// Sums horizontal pixel pairs of two rows: 8 lanes in, 4 32-bit lanes out.
+inline __m128i pairSums(__m128i row0, __m128i row1)
+{
+    const __m128i sum = _mm_add_epi16(row0, row1);
+    return _mm_add_epi32(_mm_and_si128(sum, _mm_set1_epi32(0xffff)), _mm_srli_epi32(sum, 16));
+}
+
+// Rounded 2x2 averages of one channel for 16 columns of two rows.
+inline __m128i blockAverages(__m128i row0a, __m128i row1a, __m128i row0b, __m128i row1b)
+{
+    const __m128i sums = _mm_packs_epi32(pairSums(row0a, row1a), pairSums(row0b, row1b));
+    return _mm_srli_epi16(_mm_add_epi16(sums, _mm_set1_epi16(2)), 2);
+}
+#endif
+
+void convertLumaRow(const quint32* src, int width, uchar* dst)
+{
+    int x = 0;
+#if defined(SNAPTRAY_YUV_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 8 <= width; x += 8) {
+        __m128i b, g, r;
+        loadChannels(src + x, b, g, r);
+        // True sums stay below 65536, so wrapping 16-bit math is exact.
+        __m128i sum = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(kYR)),
+                                    _mm_mullo_epi16(g, _mm_set1_epi16(kYG)));
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, _mm_set1_epi16(kYB)));
+        sum = _mm_add_epi16(sum, _mm_set1_epi16(128));
+        const __m128i luma = _mm_add_epi16(_mm_srli_epi16(sum, 8), _mm_set1_epi16(16));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(luma, zero));
+    }
+#elif defined(SNAPTRAY_YUV_NEON)
+    for (; x + 8 <= width; x += 8) {
+        const uint8x8x4_t pixels = vld4_u8(reinterpret_cast<const uint8_t*>(src + x));
+        uint16x8_t sum = vmull_u8(pixels.val[2], vdup_n_u8(kYR));
+        sum = vmlal_u8(sum, pixels.val[1], vdup_n_u8(kYG));
+        sum = vmlal_u8(sum, pixels.val[0], vdup_n_u8(kYB));
+        sum = vaddq_u16(sum, vdupq_n_u16(128));
+        vst1_u8(dst + x, vadd_u8(vshrn_n_u16(sum, 8), vdup_n_u8(16)));
+    }
+#endif
+    for (; x < width; ++x) {
+        dst[x] = lumaOf(red(src[x]), green(src[x]), blue(src[x]));
+    }
+}
+
+void convertChromaRow(const quint32* row0, const quint32* row1, int width, uchar* u, uchar* v)
+{
+    const int chromaWidth = (width + 1) / 2;
+    int cx = 0;
+#if defined(SNAPTRAY_YUV_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; cx * 2 + 16 <= width; cx += 8) {
+        const int x = cx * 2;
+        __m128i b0a, g0a, r0a, b1a, g1a, r1a, b0b, g0b, r0b, b1b, g1b, r1b;
+        loadChannels(row0 + x, b0a, g0a, r0a);
+        loadChannels(row1 + x, b1a, g1a, r1a);
+        loadChannels(row0 + x + 8, b0b, g0b, r0b);
+        loadChannels(row1 + x + 8, b1b, g1b, r1b);
+        const __m128i b = blockAverages(b0a, b1a, b0b, b1b);
+        const __m128i g = blockAverages(g0a, g1a, g0b, g1b);
+        const __m128i r = blockAverages(r0a, r1a, r0b, r1b);
+
+        const __m128i bias = _mm_set1_epi16(static_cast<short>(kChromaBias));
+        __m128i su = _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(kUB)), bias);
+        su = _mm_sub_epi16(su, _mm_mullo_epi16(r, _mm_set1_epi16(kUR)));
+        su = _mm_sub_epi16(su, _mm_mullo_epi16(g, _mm_set1_epi16(kUG)));
+        __m128i sv = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(kVR)), bias);
+        sv = _mm_sub_epi16(sv, _mm_mullo_epi16(g, _mm_set1_epi16(kVG)));
+        sv = _mm_sub_epi16(sv, _mm_mullo_epi16(b, _mm_set1_epi16(kVB)));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(u + cx),
+                         _mm_packus_epi16(_mm_srli_epi16(su, 8), zero));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(v + cx),
+                         _mm_packus_epi16(_mm_srli_epi16(sv, 8), zero));
+    }
+#elif defined(SNAPTRAY_YUV_NEON)
+    for (; cx * 2 + 16 <= width; cx += 8) {
+        const int x = cx * 2;
+        const uint8x16x4_t top = vld4q_u8(reinterpret_cast<const uint8_t*>(row0 + x));
+        const uint8x16x4_t bottom = vld4q_u8(reinterpret_cast<const uint8_t*>(row1 + x));
+        const uint16x8_t two = vdupq_n_u16(2);
+        const uint16x8_t b = vshrq_n_u16(
+            vaddq_u16(vaddq_u16(vpaddlq_u8(top.val[0]), vpaddlq_u8(bottom.val[0])), two), 2);
+        const uint16x8_t g = vshrq_n_u16(
+            vaddq_u16(vaddq_u16(vpaddlq_u8(top.val[1]), vpaddlq_u8(bottom.val[1])), two), 2);
+        const uint16x8_t r = vshrq_n_u16(
+            vaddq_u16(vaddq_u16(vpaddlq_u8(top.val[2]), vpaddlq_u8(bottom.val[2])), two), 2);
+
+        const uint16x8_t bias = vdupq_n_u16(kChromaBias);
+        uint16x8_t su = vmlaq_n_u16(bias, b, kUB);
+        su = vmlsq_n_u16(su, r, kUR);
+        su = vmlsq_n_u16(su, g, kUG);
+        uint16x8_t sv = vmlaq_n_u16(bias, r, kVR);
+        sv = vmlsq_n_u16(sv, g, kVG);
+        sv = vmlsq_n_u16(sv, b, kVB);
+        vst1_u8(u + cx, vshrn_n_u16(su, 8));
+        vst1_u8(v + cx, vshrn_n_u16(sv, 8));
+    }
+#endif
+    for (; cx < chromaWidth; ++cx) {
+        const int x0 = cx * 2;
+        const int x1 = qMin(x0 + 1, width - 1);
+        const quint32 p00 = row0[x0];
+        const quint32 p01 = row0[x1];
+        const quint32 p10 = row1[x0];
+        const quint32 p11 = row1[x1];
+        const int b = (blue(p00) + blue(p01) + blue(p10) + blue(p11) + 2) >> 2;
+        const int g = (green(p00) + green(p01) + green(p10) + green(p11) + 2) >> 2;
+        const int r = (red(p00) + red(p01) + red(p10) + red(p11) + 2) >> 2;
+        u[cx] = chromaUOf(r, g, b);
+        v[cx] = chromaVOf(r, g, b);
+    }
+}
+
+const quint32* scanLine(const QImage& image, int y)
+{
+    return reinterpret_cast<const quint32*>(image.constScanLine(y));
+}
+
+} // namespace
+
+namespace YuvConverter {
+
+void bgraToI420(const QImage& image, const I420Planes& planes)
+{
+    Q_ASSERT(image.format() == QImage::Format_RGB32 || image.format() == QImage::Format_ARGB32);
+
+    const int width = image.width();
+    const int height = image.height();
+    for (int y = 0; y < height; y += 2) {
+        const int nextY = qMin(y + 1, height - 1);
+        const quint32* row0 = scanLine(image, y);
+        const quint32* row1 = scanLine(image, nextY);
+
+        convertLumaRow(row0, width, planes.y + static_cast<qsizetype>(y) * planes.yStride);
+        if (nextY != y) {
+            convertLumaRow(row1, width, planes.y + static_cast<qsizetype>(nextY) * planes.yStride);
+        }
+
+        const qsizetype chromaY = y / 2;
+        convertChromaRow(row0, row1, width, planes.u + chromaY * planes.uStride,
+                         planes.v + chromaY * planes.vStride);
+    }
+}
+
+} // namespace YuvConverter
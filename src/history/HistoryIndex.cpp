@@ -0,0 +1,446 @@
+#include "history/HistoryIndex.h"
+
+#include <QColor>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'T', 'H', 'I'};
+constexpr quint32 kVersion = 1;
+constexpr qint64 kHeaderSize = 16;        // magic, version, directory stamp
+constexpr qint64 kStampOffset = 8;
+constexpr qint64 kRecordHeaderSize = 8;   // payload size, type, checksum
+constexpr quint32 kMaxPayloadSize = 1024 * 1024;
+
+enum RecordType : quint16 {
+    EntryRecord = 1,
+    RemovalRecord = 2,
+};
+
+class PayloadWriter
+{
+public:
+    template <typename T>
+    void put(T value)
+    {
+        const T little = qToLittleEndian(value);
+        m_data.append(reinterpret_cast<const char*>(&little), sizeof(T));
+    }
+
+    void putDouble(double value)
+    {
+        quint64 bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        put<quint64>(bits);
+    }
+
+    void putString(const QString& value)
+    {
+        const QByteArray utf8 = value.toUtf8().left(0xffff);
+        put<quint16>(static_cast<quint16>(utf8.size()));
+        m_data.append(utf8);
+    }
+
+    void putRect(const QRect& rect)
+    {
+        put<qint32>(rect.x());
+        put<qint32>(rect.y());
+        put<qint32>(rect.width());
+        put<qint32>(rect.height());
+    }
+
+    void putSize(const QSize& size)
+    {
+        put<qint32>(size.width());
+        put<qint32>(size.height());
+    }
+
+    const QByteArray& data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+};
+
+class PayloadReader
+{
+public:
+    PayloadReader(const uchar* data, qint64 size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    template <typename T>
+    bool get(T* value)
+    {
+        if (m_pos + static_cast<qint64>(sizeof(T)) > m_size) {
+            return false;
+        }
+        *value = qFromLittleEndian<T>(m_data + m_pos);
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool getDouble(double* value)
+    {
+        quint64 bits = 0;
+        if (!get(&bits)) {
+            return false;
+        }
+        std::memcpy(value, &bits, sizeof(bits));
+        return true;
+    }
+
+    bool getString(QString* value)
+    {
+        quint16 length = 0;
+        if (!get(&length) || m_pos + length > m_size) {
+            return false;
+        }
+        *value = QString::fromUtf8(reinterpret_cast<const char*>(m_data + m_pos), length);
+        m_pos += length;
+        return true;
+    }
+
+    bool getRect(QRect* rect)
+    {
+        qint32 x = 0, y = 0, width = 0, height = 0;
+        if (!get(&x) || !get(&y) || !get(&width) || !get(&height)) {
+            return false;
+        }
+        *rect = QRect(x, y, width, height);
+        return true;
+    }
+
+    bool getSize(QSize* size)
+    {
+        qint32 width = 0, height = 0;
+        if (!get(&width) || !get(&height)) {
+            return false;
+        }
+        *size = QSize(width, height);
+        return true;
+    }
+
+    bool atEnd() const { return m_pos == m_size; }
+
+private:
+    const uchar* m_data;
+    qint64 m_size;
+    qint64 m_pos = 0;
+};
+
+// Paths are stored relative to the entry directory, which is derived from
+// the id when reading so the history root can move.
+QString relativeName(const SnapTray::HistoryEntry& entry, const QString& path)
+{
+    const QDir dir(entry.entryDirectory);
+    if (path.isEmpty() || QDir(path) == dir) {
+        return QString();
+    }
+    return dir.relativeFilePath(path);
+}
+
+QByteArray encodeEntry(const SnapTray::HistoryEntry& entry)
+{
+    PayloadWriter writer;
+    writer.put<qint64>(entry.createdAt.isValid() ? entry.createdAt.toMSecsSinceEpoch()
+                                                 : std::numeric_limits<qint64>::min());
+    writer.put<qint64>(entry.fileSizeBytes);
+    writer.putDouble(entry.devicePixelRatio);
+    writer.putSize(entry.resultSize);
+    writer.putRect(entry.selectionRect);
+    writer.putSize(entry.canvasLogicalSize);
+    writer.put<qint32>(entry.cornerRadius);
+    writer.put<quint8>(entry.replayAvailable ? 1 : 0);
+
+    writer.putString(entry.id);
+    writer.putString(relativeName(entry, entry.previewPath));
+    writer.putString(relativeName(entry, entry.resultPath));
+    writer.putString(relativeName(entry, entry.canvasPath));
+    writer.putString(relativeName(entry, entry.annotationsPath));
+
+    writer.put<quint32>(static_cast<quint32>(entry.captureRegions.size()));
+    for (const auto& region : entry.captureRegions) {
+        writer.putRect(region.rect);
+        writer.put<quint32>(region.color.rgba());
+        writer.put<qint32>(region.index);
+        writer.put<quint8>(region.isActive ? 1 : 0);
+    }
+    return writer.data();
+}
+
+bool decodeEntry(PayloadReader& reader, const QString& entriesRoot, SnapTray::HistoryEntry* entry)
+{
+    qint64 createdAtMs = 0;
+    qint32 cornerRadius = 0;
+    quint8 replayAvailable = 0;
+    if (!reader.get(&createdAtMs) ||
+        !reader.get(&entry->fileSizeBytes) ||
+        !reader.getDouble(&entry->devicePixelRatio) ||
+        !reader.getSize(&entry->resultSize) ||
+        !reader.getRect(&entry->selectionRect) ||
+        !reader.getSize(&entry->canvasLogicalSize) ||
+        !reader.get(&cornerRadius) ||
+        !reader.get(&replayAvailable)) {
+        return false;
+    }
+    if (createdAtMs != std::numeric_limits<qint64>::min()) {
+        entry->createdAt = QDateTime::fromMSecsSinceEpoch(createdAtMs);
+    }
+    entry->cornerRadius = cornerRadius;
+    entry->replayAvailable = replayAvailable != 0;
+
+    QString previewName, resultName, canvasName, annotationsName;
+    if (!reader.getString(&entry->id) ||
+        !reader.getString(&previewName) ||
+        !reader.getString(&resultName) ||
+        !reader.getString(&canvasName) ||
+        !reader.getString(&annotationsName) ||
+        entry->id.isEmpty()) {
+        return false;
+    }
+
+    const QDir dir(QDir(entriesRoot).filePath(entry->id));
+    entry->entryDirectory = dir.path();
+    entry->previewPath = dir.filePath(previewName);
+    entry->resultPath = dir.filePath(resultName);
+    entry->canvasPath = dir.filePath(canvasName);
+    entry->annotationsPath = dir.filePath(annotationsName);
+
+    quint32 regionCount = 0;
+    if (!reader.get(&regionCount) || regionCount > kMaxPayloadSize) {
+        return false;
+    }
+    entry->captureRegions.clear();
+    entry->captureRegions.reserve(static_cast<int>(regionCount));
+    for (quint32 i = 0; i < regionCount; ++i) {
+        MultiRegionManager::Region region;
+        quint32 rgba = 0;
+        qint32 index = 0;
+        quint8 isActive = 0;
+        if (!reader.getRect(&region.rect) || !reader.get(&rgba) ||
+            !reader.get(&index) || !reader.get(&isActive)) {
+            return false;
+        }
+        region.color = QColor::fromRgba(rgba);
+        region.index = index;
+        region.isActive = isActive != 0;
+        entry->captureRegions.append(region);
+    }
+    return reader.atEnd();
+}
+
+QByteArray encodeRemoval(const QString& id)
+{
+    PayloadWriter writer;
+    writer.putString(id);
+    return writer.data();
+}
+
+QByteArray header(qint64 directoryStamp)
+{
+    PayloadWriter writer;
+    QByteArray data(kMagic, sizeof(kMagic));
+    writer.put<quint32>(kVersion);
+    writer.put<qint64>(directoryStamp);
+    return data + writer.data();
+}
+
+QByteArray record(RecordType type, const QByteArray& payload)
+{
+    PayloadWriter writer;
+    writer.put<quint32>(static_cast<quint32>(payload.size()));
+    writer.put<quint16>(type);
+    writer.put<quint16>(qChecksum(payload));
+    return writer.data() + payload;
+}
+
+bool appendRecord(const QString& indexPath, const QByteArray& data, qint64 directoryStamp)
+{
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadWrite) || file.size() < kHeaderSize) {
+        return false;
+    }
+
+    // Record first, stamp second: a crash in between leaves a stale stamp,
+    // which only costs a rebuild.
+    if (!file.seek(file.size()) || file.write(data) != data.size()) {
+        return false;
+    }
+
+    PayloadWriter stamp;
+    stamp.put<qint64>(directoryStamp);
+    return file.seek(kStampOffset) && file.write(stamp.data()) == stamp.data().size();
+}
+
+} // namespace
+
+namespace SnapTray {
+namespace HistoryIndex {
+
+qint64 directoryStamp(const QString& entriesRoot)
+{
+    const QFileInfo info(entriesRoot);
+    if (!info.isDir()) {
+        return 0;
+    }
+    return info.lastModified().toMSecsSinceEpoch();
+}
+
+std::optional<qint64> readStamp(const QString& indexPath)
+{
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+
+    const QByteArray data = file.read(kHeaderSize);
+    if (data.size() != kHeaderSize || std::memcmp(data.constData(), kMagic, sizeof(kMagic)) != 0) {
+        return std::nullopt;
+    }
+    const auto* bytes = reinterpret_cast<const uchar*>(data.constData());
+    if (qFromLittleEndian<quint32>(bytes + 4) != kVersion) {
+        return std::nullopt;
+    }
+    return qFromLittleEndian<qint64>(bytes + kStampOffset);
+}
+
+std::optional<Contents> read(const QString& indexPath, const QString& entriesRoot)
+{
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+
+    const qint64 size = file.size();
+    if (size < kHeaderSize) {
+        return std::nullopt;
+    }
+    uchar* data = file.map(0, size);
+    if (!data) {
+        return std::nullopt;
+    }
+
+    std::optional<Contents> result;
+    if (std::memcmp(data, kMagic, sizeof(kMagic)) == 0 &&
+        qFromLittleEndian<quint32>(data + 4) == kVersion) {
+        Contents contents;
+        contents.directoryStamp = qFromLittleEndian<qint64>(data + kStampOffset);
+
+        // Later records for an id replace earlier ones; removals leave a hole.
+        std::vector<std::optional<HistoryEntry>> slots;
+        QHash<QString, size_t> slotById;
+        bool valid = true;
+
+        qint64 pos = kHeaderSize;
+        while (pos < size) {
+            if (pos + kRecordHeaderSize > size) {
+                valid = false;
+                break;
+            }
+            const quint32 payloadSize = qFromLittleEndian<quint32>(data + pos);
+            const quint16 type = qFromLittleEndian<quint16>(data + pos + 4);
+            const quint16 checksum = qFromLittleEndian<quint16>(data + pos + 6);
+            const uchar* payload = data + pos + kRecordHeaderSize;
+            if (payloadSize > kMaxPayloadSize || pos + kRecordHeaderSize + payloadSize > size ||
+                qChecksum(QByteArrayView(payload, payloadSize)) != checksum) {
+                valid = false;
+                break;
+            }
+            pos += kRecordHeaderSize + payloadSize;
+
+            PayloadReader reader(payload, payloadSize);
+            if (type == EntryRecord) {
+                HistoryEntry entry;
+                if (!decodeEntry(reader, entriesRoot, &entry)) {
+                    valid = false;
+                    break;
+                }
+                const auto existing = slotById.constFind(entry.id);
+                if (existing != slotById.constEnd()) {
+                    if (slots[existing.value()].has_value()) {
+                        ++contents.obsoleteRecords;
+                    }
+                    slots[existing.value()] = std::move(entry);
+                } else {
+                    slotById.insert(entry.id, slots.size());
+                    slots.push_back(std::move(entry));
+                }
+            } else if (type == RemovalRecord) {
+                QString id;
+                if (!reader.getString(&id) || !reader.atEnd()) {
+                    valid = false;
+                    break;
+                }
+                ++contents.obsoleteRecords;
+                const auto existing = slotById.constFind(id);
+                if (existing != slotById.constEnd() && slots[existing.value()].has_value()) {
+                    slots[existing.value()].reset();
+                    ++contents.obsoleteRecords;
+                }
+            } else {
+                valid = false;
+                break;
+            }
+        }
+
+        if (valid) {
+            contents.entries.reserve(static_cast<qsizetype>(slots.size()));
+            for (auto& slot : slots) {
+                if (slot.has_value()) {
+                    contents.entries.append(std::move(*slot));
+                }
+            }
+            result = std::move(contents);
+        }
+    }
+
+    file.unmap(data);
+    return result;
+}
+
+bool write(const QString& indexPath, const QList<HistoryEntry>& entries, qint64 directoryStamp)
+{
+    QByteArray data = header(directoryStamp);
+    for (const HistoryEntry& entry : entries) {
+        data += record(EntryRecord, encodeEntry(entry));
+    }
+
+    QSaveFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    if (file.write(data) != data.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool appendEntry(const QString& indexPath, const HistoryEntry& entry, qint64 directoryStamp)
+{
+    return appendRecord(indexPath, record(EntryRecord, encodeEntry(entry)), directoryStamp);
+}
+
+bool appendRemoval(const QString& indexPath, const QString& id, qint64 directoryStamp)
+{
+    return appendRecord(indexPath, record(RemovalRecord, encodeRemoval(id)), directoryStamp);
+}
+
+bool updateStamp(const QString& indexPath, qint64 directoryStamp)
+{
+    return appendRecord(indexPath, QByteArray(), directoryStamp);
+}
+
+} // namespace HistoryIndex
+} // namespace SnapTray
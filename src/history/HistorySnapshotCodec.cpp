@@ -0,0 +1,363 @@
+#include "history/HistorySnapshotCodec.h"
+
+#include "utils/ImageSaveUtils.h"
+#include "utils/QoiCodec.h"
+
+#include <QColorSpace>
+#include <QFile>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtEndian>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'T', 'S', 'N'};
+constexpr quint16 kVersion = 1;
+constexpr qsizetype kHeaderSize = 36;
+
+// Bands shorter than this cost more in coder restarts than they gain.
+constexpr int kMinBandRows = 16;
+constexpr int kMaxBands = 64;
+
+// Guards the decoder against headers asking for absurd allocations.
+constexpr qint64 kMaxPixels = qint64(1) << 28;
+
+enum PixelFormat : quint8 {
+    PixelRgb32 = 0,
+    PixelArgb32 = 1,
+    PixelArgb32Premultiplied = 2,
+};
+
+struct Band
+{
+    int firstRow = 0;
+    int rowCount = 0;
+    QByteArray data;                // Encoded stream (encode only)
+    const uchar* input = nullptr;   // Encoded stream (decode only)
+    qsizetype inputSize = 0;
+    bool ok = false;
+};
+
+// Private pool: history writes already run off the GUI thread and may sit
+// on the global pool themselves.
+QThreadPool* codecPool()
+{
+    static QThreadPool* pool = []() {
+        auto* threadPool = new QThreadPool();
+        threadPool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+        return threadPool;
+    }();
+    return pool;
+}
+
+void setError(QString* errorMessage, const QString& message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
+
+// Formats stored as-is; everything else is converted to the nearest one
+// that keeps every bit of the source.
+QImage storableImage(const QImage& image, quint8* pixelFormat)
+{
+    switch (image.format()) {
+    case QImage::Format_RGB32:
+        *pixelFormat = PixelRgb32;
+        return image;
+    case QImage::Format_ARGB32:
+        *pixelFormat = PixelArgb32;
+        return image;
+    case QImage::Format_ARGB32_Premultiplied:
+        *pixelFormat = PixelArgb32Premultiplied;
+        return image;
+    default:
+        break;
+    }
+    if (image.hasAlphaChannel()) {
+        *pixelFormat = PixelArgb32;
+        return image.convertToFormat(QImage::Format_ARGB32);
+    }
+    *pixelFormat = PixelRgb32;
+    return image.convertToFormat(QImage::Format_RGB32);
+}
+
+QImage::Format imageFormat(quint8 pixelFormat)
+{
+    switch (pixelFormat) {
+    case PixelRgb32:
+        return QImage::Format_RGB32;
+    case PixelArgb32:
+        return QImage::Format_ARGB32;
+    case PixelArgb32Premultiplied:
+        return QImage::Format_ARGB32_Premultiplied;
+    default:
+        return QImage::Format_Invalid;
+    }
+}
+
+void encodeBand(const QImage& image, Band& band)
+{
+    const int width = image.width();
+    band.data.resize(qsizetype(width) * band.rowCount * QoiCodec::kMaxBytesPerPixel + 1);
+    uchar* const start = reinterpret_cast<uchar*>(band.data.data());
+    uchar* out = start;
+
+    QoiCodec::Encoder encoder;
+    for (int y = band.firstRow; y < band.firstRow + band.rowCount; ++y) {
+        out = encoder.encode(reinterpret_cast<const quint32*>(image.constScanLine(y)), width, out);
+    }
+    out = encoder.finish(out);
+
+    band.data.resize(out - start);
+    band.ok = true;
+}
+
+// Writes straight into the image's pixel buffer. Fails on a truncated
+// stream or one that runs past the band.
+void decodeBand(uchar* bits, qsizetype bytesPerLine, int width, Band& band)
+{
+    const uchar* in = band.input;
+    const uchar* const end = band.input + band.inputSize;
+
+    QoiCodec::Decoder decoder;
+    for (int y = band.firstRow; y < band.firstRow + band.rowCount; ++y) {
+        auto* row = reinterpret_cast<quint32*>(bits + y * bytesPerLine);
+        if (!decoder.decode(&in, end, row, width)) {
+            return;
+        }
+    }
+
+    band.ok = decoder.atOpBoundary() && in == end;
+}
+
+void appendLe32(QByteArray& bytes, quint32 value)
+{
+    char buffer[4];
+    qToLittleEndian<quint32>(value, buffer);
+    bytes.append(buffer, 4);
+}
+
+} // namespace
+
+namespace SnapTray {
+
+namespace HistorySnapshotCodec {
+
+QString fileSuffix(Format format)
+{
+    return format == Format::Png ? QStringLiteral("png") : QStringLiteral("snapshot");
+}
+
+bool write(const QImage& image, const QString& filePath, Format format, QString* errorMessage)
+{
+    if (image.isNull()) {
+        setError(errorMessage, QStringLiteral("Image is null"));
+        return false;
+    }
+
+    if (format == Format::Png) {
+        ImageSaveUtils::Error error;
+        // Written on every capture and rarely read back: favour speed.
+        if (!ImageSaveUtils::saveImageAtomically(image, filePath, QByteArrayLiteral("PNG"), &error,
+                                                 ImageSaveUtils::PngCompression::Fastest)) {
+            setError(errorMessage, error.message);
+            return false;
+        }
+        return true;
+    }
+
+    const QByteArray encoded = encodeQoi(image);
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        setError(errorMessage, file.errorString());
+        return false;
+    }
+    if (file.write(encoded) != encoded.size()) {
+        setError(errorMessage, file.errorString());
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        setError(errorMessage, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+QImage read(const QString& filePath, QString* errorMessage)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(errorMessage, file.errorString());
+        return {};
+    }
+
+    char magic[sizeof(kMagic)];
+    if (file.peek(magic, sizeof(magic)) == qint64(sizeof(magic)) &&
+        std::memcmp(magic, kMagic, sizeof(kMagic)) == 0) {
+        const qint64 size = file.size();
+        if (const uchar* mapped = file.map(0, size)) {
+            return decodeQoi(mapped, size, errorMessage);
+        }
+        const QByteArray data = file.readAll();
+        return decodeQoi(reinterpret_cast<const uchar*>(data.constData()), data.size(),
+                         errorMessage);
+    }
+
+    // Entries from before the snapshot format store the canvas as PNG.
+    QImageReader reader(&file);
+    QImage image = reader.read();
+    if (image.isNull()) {
+        setError(errorMessage, reader.errorString());
+    }
+    return image;
+}
+
+QByteArray encodeQoi(const QImage& image)
+{
+    if (image.isNull()) {
+        return {};
+    }
+
+    quint8 pixelFormat = PixelRgb32;
+    const QImage source = storableImage(image, &pixelFormat);
+    const int height = source.height();
+
+    int bandCount = qBound(1, QThread::idealThreadCount() * 2, kMaxBands);
+    bandCount = qMin(bandCount, qMax(1, height / kMinBandRows));
+    const int bandRows = (height + bandCount - 1) / bandCount;
+    bandCount = (height + bandRows - 1) / bandRows;
+
+    std::vector<Band> bands(static_cast<size_t>(bandCount));
+    for (int i = 0; i < bandCount; ++i) {
+        bands[size_t(i)].firstRow = i * bandRows;
+        bands[size_t(i)].rowCount = qMin(bandRows, height - i * bandRows);
+    }
+    QtConcurrent::blockingMap(codecPool(), bands, [&source](Band& band) {
+        encodeBand(source, band);
+    });
+
+    const QByteArray icc = source.colorSpace().isValid() ? source.colorSpace().iccProfile()
+                                                        : QByteArray();
+    quint64 dprBits = 0;
+    const double dpr = source.devicePixelRatio();
+    std::memcpy(&dprBits, &dpr, sizeof(dprBits));
+
+    qsizetype total = kHeaderSize + qsizetype(bandCount) * 4 + icc.size();
+    for (const Band& band : bands) {
+        total += band.data.size();
+    }
+
+    QByteArray bytes;
+    bytes.reserve(total);
+    bytes.append(kMagic, sizeof(kMagic));
+    char version[2];
+    qToLittleEndian<quint16>(kVersion, version);
+    bytes.append(version, 2);
+    bytes.append(char(pixelFormat));
+    bytes.append('\0');
+    appendLe32(bytes, quint32(source.width()));
+    appendLe32(bytes, quint32(height));
+    appendLe32(bytes, quint32(dprBits));
+    appendLe32(bytes, quint32(dprBits >> 32));
+    appendLe32(bytes, quint32(icc.size()));
+    appendLe32(bytes, quint32(bandRows));
+    appendLe32(bytes, quint32(bandCount));
+    for (const Band& band : bands) {
+        appendLe32(bytes, quint32(band.data.size()));
+    }
+    bytes.append(icc);
+    for (const Band& band : bands) {
+        bytes.append(band.data);
+    }
+    return bytes;
+}
+
+QImage decodeQoi(const uchar* data, qsizetype size, QString* errorMessage)
+{
+    if (!data || size < kHeaderSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        setError(errorMessage, QStringLiteral("Not a history snapshot"));
+        return {};
+    }
+    if (qFromLittleEndian<quint16>(data + 4) != kVersion) {
+        setError(errorMessage, QStringLiteral("Unsupported history snapshot version"));
+        return {};
+    }
+
+    const QImage::Format format = imageFormat(data[6]);
+    const quint32 width = qFromLittleEndian<quint32>(data + 8);
+    const quint32 height = qFromLittleEndian<quint32>(data + 12);
+    const quint64 dprBits = qFromLittleEndian<quint32>(data + 16) |
+                            (quint64(qFromLittleEndian<quint32>(data + 20)) << 32);
+    const quint32 iccSize = qFromLittleEndian<quint32>(data + 24);
+    const quint32 bandRows = qFromLittleEndian<quint32>(data + 28);
+    const quint32 bandCount = qFromLittleEndian<quint32>(data + 32);
+
+    if (format == QImage::Format_Invalid || width == 0 || height == 0 ||
+        qint64(width) * height > kMaxPixels || bandRows == 0 ||
+        bandCount != (quint64(height) + bandRows - 1) / bandRows) {
+        setError(errorMessage, QStringLiteral("Corrupt history snapshot header"));
+        return {};
+    }
+
+    qint64 offset = kHeaderSize + qint64(bandCount) * 4;
+    if (offset + iccSize > size) {
+        setError(errorMessage, QStringLiteral("Truncated history snapshot"));
+        return {};
+    }
+    const QByteArray icc(reinterpret_cast<const char*>(data + offset), qsizetype(iccSize));
+    offset += iccSize;
+
+    std::vector<Band> bands(bandCount);
+    for (quint32 i = 0; i < bandCount; ++i) {
+        Band& band = bands[i];
+        band.firstRow = int(i * bandRows);
+        band.rowCount = int(qMin(bandRows, height - i * bandRows));
+        band.inputSize = qFromLittleEndian<quint32>(data + kHeaderSize + i * 4);
+        if (offset + band.inputSize > size) {
+            setError(errorMessage, QStringLiteral("Truncated history snapshot"));
+            return {};
+        }
+        band.input = data + offset;
+        offset += band.inputSize;
+    }
+
+    QImage image(int(width), int(height), format);
+    if (image.isNull()) {
+        setError(errorMessage, QStringLiteral("Out of memory decoding history snapshot"));
+        return {};
+    }
+    // scanLine() may detach, so take the buffer once before going wide.
+    uchar* bits = image.bits();
+    const qsizetype bytesPerLine = image.bytesPerLine();
+    QtConcurrent::blockingMap(codecPool(), bands, [&](Band& band) {
+        decodeBand(bits, bytesPerLine, int(width), band);
+    });
+    for (const Band& band : bands) {
+        if (!band.ok) {
+            setError(errorMessage, QStringLiteral("Corrupt history snapshot data"));
+            return {};
+        }
+    }
+
+    double dpr = 1.0;
+    std::memcpy(&dpr, &dprBits, sizeof(dpr));
+    if (dpr > 0.0) {
+        image.setDevicePixelRatio(dpr);
+    }
+    if (!icc.isEmpty()) {
+        image.setColorSpace(QColorSpace::fromIccProfile(icc));
+    }
+    return image;
+}
+
+} // namespace HistorySnapshotCodec
+
+} // namespace SnapTray
@@ -1,7 +1,9 @@
 #include "history/HistoryStore.h"
 
+#include "history/HistoryIndex.h"
 #include "utils/ImageSaveUtils.h"
 
+#include <QDebug>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -9,6 +11,8 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QStandardPaths>
 #include <QUuid>
 
@@ -18,12 +22,17 @@ namespace {
 
 constexpr auto kEnvHistoryPath = "SNAPTRAY_HISTORY_DIR";
 constexpr auto kEntriesFolderName = "entries";
+constexpr auto kIndexFileName = "index.bin";
 constexpr auto kManifestFileName = "manifest.json";
-constexpr auto kCanvasFileName = "canvas.png";
+constexpr auto kCanvasBaseName = "canvas";
 constexpr auto kResultFileName = "result.png";
+constexpr auto kThumbnailFileName = "thumbnail.png";
 constexpr auto kAnnotationsFileName = "annotations.json";
 constexpr auto kCaptureSessionKind = "capture_session";
 
+// Rewrite the index once this many records no longer describe a live entry.
+constexpr int kIndexCompactionThreshold = 64;
+
 QJsonArray serializeRect(const QRect& rect)
 {
     return QJsonArray{rect.x(), rect.y(), rect.width(), rect.height()};
@@ -126,7 +135,19 @@ bool saveImage(const QImage& image, const QString& filePath)
     }
 
     ImageSaveUtils::Error error;
-    return ImageSaveUtils::saveImageAtomically(image, filePath, QByteArrayLiteral("PNG"), &error);
+    // Written on every capture and never shared: favour speed over size.
+    return ImageSaveUtils::saveImageAtomically(image, filePath, QByteArrayLiteral("PNG"), &error,
+                                               ImageSaveUtils::PngCompression::Fastest);
+}
+
+// Returns a null image when the source already fits the thumbnail size.
+QImage makeThumbnail(const QImage& image)
+{
+    const int maxEdge = SnapTray::HistoryStore::kThumbnailMaxEdge;
+    if (image.width() <= maxEdge && image.height() <= maxEdge) {
+        return {};
+    }
+    return image.scaled(maxEdge, maxEdge, Qt::KeepAspectRatio, Qt::SmoothTransformation);
 }
 
 QJsonObject baseManifest(const QString& id,
@@ -145,6 +166,30 @@ QJsonObject baseManifest(const QString& id,
     };
 }
 
+// Serializes index reads and updates between the history writer thread and
+// the UI.
+QMutex& indexMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QString indexFilePath()
+{
+    return QDir(SnapTray::HistoryStore::historyRootPath()).filePath(fileNameString(kIndexFileName));
+}
+
+void sortNewestFirst(QList<SnapTray::HistoryEntry>& entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const SnapTray::HistoryEntry& lhs,
+                                                 const SnapTray::HistoryEntry& rhs) {
+        if (lhs.createdAt != rhs.createdAt) {
+            return lhs.createdAt > rhs.createdAt;
+        }
+        return lhs.id > rhs.id;
+    });
+}
+
 void trimEntriesToLimit(int maxEntries)
 {
     if (maxEntries <= 0) {
@@ -180,12 +225,44 @@ QString HistoryStore::entriesRootPath()
 
 QList<HistoryEntry> HistoryStore::loadEntries()
 {
+    QMutexLocker locker(&indexMutex());
+
+    const QString entriesRoot = entriesRootPath();
+    const qint64 stamp = HistoryIndex::directoryStamp(entriesRoot);
+    if (stamp == 0) {
+        return {};
+    }
+
+    const QString indexPath = indexFilePath();
+    const auto contents = HistoryIndex::read(indexPath, entriesRoot);
     QList<HistoryEntry> entries;
-    QDir entriesDir(entriesRootPath());
-    if (!entriesDir.exists()) {
-        return entries;
+    if (contents.has_value() && contents->directoryStamp == stamp) {
+        entries = contents->entries;
+        if (contents->obsoleteRecords > qMax(kIndexCompactionThreshold, entries.size())) {
+            HistoryIndex::write(indexPath, entries, stamp);
+        }
+    } else {
+        // Missing, damaged or out of date: rebuild from the manifests.
+        entries = scanEntryDirectories();
+        if (!HistoryIndex::write(indexPath, entries, stamp)) {
+            qWarning() << "HistoryStore: Failed to write history index" << indexPath;
+        }
     }
 
+    sortNewestFirst(entries);
+    return entries;
+}
+
+void HistoryStore::invalidateIndex()
+{
+    QMutexLocker locker(&indexMutex());
+    QFile::remove(indexFilePath());
+}
+
+QList<HistoryEntry> HistoryStore::scanEntryDirectories()
+{
+    QList<HistoryEntry> entries;
+    QDir entriesDir(entriesRootPath());
     const QFileInfoList dirs = entriesDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
     for (const QFileInfo& dirInfo : dirs) {
         const auto entry = loadEntryFromDirectory(dirInfo.filePath());
@@ -193,13 +270,6 @@ QList<HistoryEntry> HistoryStore::loadEntries()
             entries.append(entry.value());
         }
     }
-
-    std::sort(entries.begin(), entries.end(), [](const HistoryEntry& lhs, const HistoryEntry& rhs) {
-        if (lhs.createdAt != rhs.createdAt) {
-            return lhs.createdAt > rhs.createdAt;
-        }
-        return lhs.id > rhs.id;
-    });
     return entries;
 }
 
@@ -222,16 +292,36 @@ std::optional<HistoryEntry> HistoryStore::writeCaptureSession(const CaptureSessi
 
     const QString id = uniqueEntryId(request.createdAt);
     const QString entryDirPath = root.filePath(id);
-    if (!root.mkpath(id)) {
-        return std::nullopt;
+
+    // Creating the entry directory moves the entries stamp. Record whether
+    // the index was current beforehand so the new entry can be appended
+    // rather than forcing a rebuild.
+    bool indexWasCurrent = false;
+    qint64 stampAfterCreate = 0;
+    {
+        QMutexLocker locker(&indexMutex());
+        const auto indexStamp = HistoryIndex::readStamp(indexFilePath());
+        indexWasCurrent = indexStamp.has_value()
+            && indexStamp.value() == HistoryIndex::directoryStamp(root.path());
+        if (!root.mkpath(id)) {
+            return std::nullopt;
+        }
+        stampAfterCreate = HistoryIndex::directoryStamp(root.path());
+        if (indexWasCurrent) {
+            // Readers in the meantime see the new directory before its
+            // manifest exists; moving the stamp keeps them from rebuilding.
+            HistoryIndex::updateStamp(indexFilePath(), stampAfterCreate);
+        }
     }
 
     QDir entryDir(entryDirPath);
-    const QString canvasPath = entryDir.filePath(fileNameString(kCanvasFileName));
+    const QString canvasFileName = QStringLiteral("%1.%2").arg(
+        fileNameString(kCanvasBaseName), HistorySnapshotCodec::fileSuffix(request.canvasFormat));
+    const QString canvasPath = entryDir.filePath(canvasFileName);
     const QString resultPath = entryDir.filePath(fileNameString(kResultFileName));
     const QString annotationsPath = entryDir.filePath(fileNameString(kAnnotationsFileName));
 
-    if (!saveImage(request.canvasImage, canvasPath) ||
+    if (!HistorySnapshotCodec::write(request.canvasImage, canvasPath, request.canvasFormat) ||
         !saveImage(request.resultImage, resultPath) ||
         !writeTextFile(annotationsPath, request.annotationsJson)) {
         QDir(entryDirPath).removeRecursively();
@@ -243,7 +333,7 @@ std::optional<HistoryEntry> HistoryStore::writeCaptureSession(const CaptureSessi
                                         fileNameString(kResultFileName),
                                         fileNameString(kResultFileName),
                                         true);
-    manifest.insert(QStringLiteral("canvasPath"), fileNameString(kCanvasFileName));
+    manifest.insert(QStringLiteral("canvasPath"), canvasFileName);
     manifest.insert(QStringLiteral("annotationsPath"), fileNameString(kAnnotationsFileName));
     manifest.insert(QStringLiteral("selectionRect"), serializeRect(request.selectionRect));
     manifest.insert(QStringLiteral("captureRegions"), serializeCaptureRegions(request.captureRegions));
@@ -258,8 +348,23 @@ std::optional<HistoryEntry> HistoryStore::writeCaptureSession(const CaptureSessi
         return std::nullopt;
     }
 
+    // Optional: without it the history list falls back to the result image.
+    const QImage thumbnail = makeThumbnail(request.resultImage);
+    if (!thumbnail.isNull()) {
+        saveImage(thumbnail, entryDir.filePath(fileNameString(kThumbnailFileName)));
+    }
+
+    const auto entry = loadEntryFromDirectory(entryDirPath);
+    if (entry.has_value()) {
+        QMutexLocker locker(&indexMutex());
+        const QString indexPath = indexFilePath();
+        if (indexWasCurrent && HistoryIndex::readStamp(indexPath) == stampAfterCreate) {
+            HistoryIndex::appendEntry(indexPath, entry.value(), stampAfterCreate);
+        }
+    }
+
     trimEntriesToLimit(request.maxEntries);
-    return loadEntry(id);
+    return entry;
 }
 
 bool HistoryStore::deleteEntry(const HistoryEntry& entry)
@@ -267,7 +372,38 @@ bool HistoryStore::deleteEntry(const HistoryEntry& entry)
     if (entry.entryDirectory.isEmpty()) {
         return false;
     }
-    return QDir(entry.entryDirectory).removeRecursively();
+
+    QMutexLocker locker(&indexMutex());
+    const QString entriesRoot = entriesRootPath();
+    const QString indexPath = indexFilePath();
+    const auto indexStamp = HistoryIndex::readStamp(indexPath);
+    const bool indexWasCurrent = indexStamp.has_value()
+        && indexStamp.value() == HistoryIndex::directoryStamp(entriesRoot);
+
+    if (!QDir(entry.entryDirectory).removeRecursively()) {
+        return false;
+    }
+
+    if (indexWasCurrent) {
+        HistoryIndex::appendRemoval(indexPath, entry.id, HistoryIndex::directoryStamp(entriesRoot));
+    }
+    return true;
+}
+
+QString HistoryStore::thumbnailSourcePath(const QString& id)
+{
+    if (id.isEmpty() || id.contains(QLatin1Char('/')) || id.contains(QLatin1Char('\\')) ||
+        id.startsWith(QLatin1Char('.'))) {
+        return QString();
+    }
+
+    const QDir entryDir(QDir(entriesRootPath()).filePath(id));
+    const QString thumbnailPath = entryDir.filePath(fileNameString(kThumbnailFileName));
+    if (QFileInfo::exists(thumbnailPath)) {
+        return thumbnailPath;
+    }
+    const QString resultPath = entryDir.filePath(fileNameString(kResultFileName));
+    return QFileInfo::exists(resultPath) ? resultPath : QString();
 }
 
 std::optional<HistoryEntry> HistoryStore::loadEntryFromDirectory(const QString& entryDirectory)
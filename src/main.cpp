@@ -105,11 +105,19 @@ int main(int argc, char* argv[])
         QTextStream out(stdout);
         QTextStream err(stderr);
 
-        if (!result.data.isEmpty()) {
+        if (result.hasData()) {
             // Binary data (--raw)
             QFile outFile;
             if (outFile.open(stdout, QIODevice::WriteOnly)) {
-                outFile.write(result.data);
+                if (result.writeData) {
+                    if (!result.writeData(&outFile)) {
+                        err << "Error: Failed to write image data to stdout\n";
+                        result.code = SnapTray::CLI::CLIResult::Code::GeneralError;
+                    }
+                }
+                else {
+                    outFile.write(result.data);
+                }
             }
         }
         else if (!result.message.isEmpty()) {
@@ -179,6 +187,11 @@ int main(int argc, char* argv[])
         &SingleInstanceGuard::commandReceived,
         &mainApp,
         &MainApplication::handleCLICommand);
+    QObject::connect(
+        &guard,
+        &SingleInstanceGuard::sessionStarted,
+        &mainApp,
+        &MainApplication::attachCLISession);
 
     mainApp.initialize();
 
@@ -0,0 +1,74 @@
+#include "pinwindow/LiveFrameGate.h"
+
+#include "utils/ImageHash.h"
+
+#include <QImage>
+
+#include <algorithm>
+
+void LiveFrameGate::reset()
+{
+    m_stats = LiveFrameStats();
+    m_hasFrame = false;
+    m_hasHash = false;
+    m_lastCacheKey = 0;
+    m_lastHash = 0;
+    m_idleFrames = 0;
+    m_intervalMs = m_baseIntervalMs;
+}
+
+void LiveFrameGate::setBaseInterval(int intervalMs)
+{
+    m_baseIntervalMs = std::max(1, intervalMs);
+    m_intervalMs = m_baseIntervalMs;
+    m_idleFrames = 0;
+}
+
+bool LiveFrameGate::submitFrame(const QImage& frame, const std::optional<QRegion>& dirtyRegion)
+{
+    if (frame.isNull()) {
+        return false;
+    }
+
+    ++m_stats.captured;
+    if (frameChanged(frame, dirtyRegion)) {
+        ++m_stats.painted;
+        m_idleFrames = 0;
+        m_intervalMs = m_baseIntervalMs;
+        return true;
+    }
+
+    ++m_stats.skipped;
+    // Double the interval per idle frame once the content has been still for
+    // a while, so a static pin settles at a few polls per second.
+    if (++m_idleFrames >= kIdleFramesBeforeBackoff) {
+        const int maxIntervalMs = std::max(kMaxIdleIntervalMs, m_baseIntervalMs);
+        m_intervalMs = std::min(m_intervalMs * 2, maxIntervalMs);
+    }
+    return false;
+}
+
+bool LiveFrameGate::frameChanged(const QImage& frame, const std::optional<QRegion>& dirtyRegion)
+{
+    const bool firstFrame = !m_hasFrame;
+    const qint64 previousCacheKey = m_lastCacheKey;
+    m_hasFrame = true;
+    m_lastCacheKey = frame.cacheKey();
+
+    if (dirtyRegion.has_value()) {
+        m_hasHash = false;
+        return firstFrame || !dirtyRegion->isEmpty();
+    }
+
+    // Engines hand back the same image when no new frame arrived, and any
+    // write through bits() changes the cache key.
+    if (!firstFrame && frame.cacheKey() == previousCacheKey) {
+        return false;
+    }
+
+    const quint64 hash = ImageHash::hashPixels(frame);
+    const bool changed = firstFrame || !m_hasHash || hash != m_lastHash;
+    m_lastHash = hash;
+    m_hasHash = true;
+    return changed;
+}
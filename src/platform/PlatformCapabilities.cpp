@@ -90,6 +90,8 @@ PlatformCapabilities capabilitiesForPlatform(PlatformKind platform,
         caps.isRuntimeSupported = true;
         return caps;
     case PlatformKind::Linux:
+        // LibavEncoder can encode MP4 here, but recording also needs live
+        // capture, which is still off on Linux
         caps.supportsRecording = false;
         caps.supportsOCR = false;
         caps.supportsGlobalHotkeys = displayServer == DisplayServerKind::X11;
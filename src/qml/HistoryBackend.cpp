@@ -16,12 +16,24 @@
 #include <QDateTime>
 #include <QDesktopServices>
 #include <QDir>
+#include <QFutureWatcher>
 #include <QGuiApplication>
 #include <QScreen>
 #include <QUrl>
+#include <QtConcurrent/QtConcurrentRun>
 
 namespace {
 
+// A 5K capture decodes to ~60 MiB; keep the last few hovered entries.
+constexpr qsizetype kDecodedImageCacheKiB = 192 * 1024;
+// Sweeping the pointer across the grid shouldn't start a decode per card.
+constexpr int kPrefetchDelayMs = 150;
+
+qsizetype imageCostKiB(const QImage& image)
+{
+    return qMax<qsizetype>(image.sizeInBytes() / 1024, 1);
+}
+
 QString historyText(const char* sourceText)
 {
     return QCoreApplication::translate("HistoryWindow", sourceText);
@@ -52,7 +64,11 @@ HistoryBackend::HistoryBackend(HistoryModel* model,
     , m_pinWindowManager(pinWindowManager)
     , m_startReplay(std::move(startReplay))
     , m_hostWindow(hostWindow)
+    , m_decodedImages(kDecodedImageCacheKiB)
 {
+    m_prefetchTimer.setSingleShot(true);
+    m_prefetchTimer.setInterval(kPrefetchDelayMs);
+    connect(&m_prefetchTimer, &QTimer::timeout, this, &HistoryBackend::startPrefetch);
 }
 
 void HistoryBackend::refresh()
@@ -172,7 +188,8 @@ void HistoryBackend::saveAs(int index)
     QScreen* exportScreen = QGuiApplication::primaryScreen();
     const QImage taggedImage = tagImageWithScreenColorSpace(pixmap.toImage(), exportScreen);
     ImageSaveUtils::Error saveError;
-    if (!ImageSaveUtils::saveImageAtomically(taggedImage, filePath, QByteArray(), &saveError)) {
+    if (!ImageSaveUtils::saveImageAtomically(taggedImage, filePath, QByteArray(), &saveError,
+                                             ImageSaveUtils::PngCompression::Smallest)) {
         showError(historyText("Save Failed"),
                   historyText("Failed to save history image: %1").arg(saveErrorDetail(saveError)));
         return;
@@ -212,13 +229,70 @@ void HistoryBackend::openHistoryFolder()
     }
 }
 
-bool HistoryBackend::loadPixmap(const HistoryEntry& entry, QPixmap* pixmapOut) const
+void HistoryBackend::prefetch(int index)
+{
+    m_prefetchIndex = index;
+    m_prefetchTimer.start();
+}
+
+void HistoryBackend::startPrefetch()
+{
+    if (!m_model) {
+        return;
+    }
+
+    const QString path = m_model->entryAt(m_prefetchIndex).resultPath;
+    if (path.isEmpty() || m_decodedImages.contains(path) || m_pendingDecodes.contains(path)) {
+        return;
+    }
+
+    const QFuture<QImage> future = QtConcurrent::run([path]() {
+        return QImage(path);
+    });
+    m_pendingDecodes.insert(path, future);
+
+    auto* watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, path]() {
+        // takeDecodedImage() may already have claimed the result.
+        if (m_pendingDecodes.remove(path) > 0) {
+            const QImage image = watcher->result();
+            if (!image.isNull()) {
+                m_decodedImages.insert(path, new QImage(image), imageCostKiB(image));
+            }
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(future);
+}
+
+QImage HistoryBackend::takeDecodedImage(const QString& path)
+{
+    if (const QImage* cached = m_decodedImages.object(path)) {
+        return *cached;
+    }
+
+    // A decode already in flight is closer to done than a fresh one.
+    const auto pending = m_pendingDecodes.constFind(path);
+    if (pending != m_pendingDecodes.constEnd()) {
+        QFuture<QImage> future = pending.value();
+        m_pendingDecodes.erase(pending);
+        const QImage image = future.result();
+        if (!image.isNull()) {
+            m_decodedImages.insert(path, new QImage(image), imageCostKiB(image));
+        }
+        return image;
+    }
+    return {};
+}
+
+bool HistoryBackend::loadPixmap(const HistoryEntry& entry, QPixmap* pixmapOut)
 {
     if (!pixmapOut || entry.resultPath.isEmpty()) {
         return false;
     }
 
-    const QPixmap pixmap(entry.resultPath);
+    const QImage decoded = takeDecodedImage(entry.resultPath);
+    const QPixmap pixmap = decoded.isNull() ? QPixmap(entry.resultPath) : QPixmap::fromImage(decoded);
     if (pixmap.isNull()) {
         return false;
     }
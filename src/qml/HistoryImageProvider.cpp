@@ -0,0 +1,167 @@
+#include "qml/HistoryImageProvider.h"
+
+#include "history/HistoryStore.h"
+
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QQuickTextureFactory>
+#include <QRunnable>
+#include <QThread>
+
+namespace {
+
+constexpr qint64 kThumbnailCacheBytes = 96LL * 1024LL * 1024LL;
+
+// Decodes one thumbnail on the provider's pool and hands it back to the
+// response on the response's thread. Deleted by the pool after run().
+class ThumbnailDecodeRunnable : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    ThumbnailDecodeRunnable(const QString& id,
+                            const QSize& requestedSize,
+                            std::shared_ptr<SnapTray::HistoryImageProvider::ThumbnailCache> cache)
+        : m_id(id)
+        , m_requestedSize(requestedSize)
+        , m_cache(std::move(cache))
+    {
+    }
+
+    void run() override
+    {
+        QImage image;
+        if (!m_cache->lookup(m_id, &image)) {
+            image = decode(SnapTray::HistoryStore::thumbnailSourcePath(m_id));
+            if (!image.isNull()) {
+                m_cache->insert(m_id, image);
+            }
+        }
+
+        if (!image.isNull() && m_requestedSize.isValid() && !m_requestedSize.isEmpty() &&
+            (image.width() > m_requestedSize.width() || image.height() > m_requestedSize.height())) {
+            image = image.scaled(m_requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        emit done(image);
+    }
+
+signals:
+    void done(const QImage& image);
+
+private:
+    static QImage decode(const QString& path)
+    {
+        if (path.isEmpty()) {
+            return {};
+        }
+
+        QImageReader reader(path);
+        QImage image = reader.read();
+        if (image.isNull()) {
+            return {};
+        }
+
+        // Entries without a stored thumbnail hand back the full result;
+        // keep only a thumbnail-sized copy in the cache.
+        const int maxEdge = SnapTray::HistoryStore::kThumbnailMaxEdge;
+        if (image.width() > maxEdge || image.height() > maxEdge) {
+            image = image.scaled(maxEdge, maxEdge, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        return image;
+    }
+
+    QString m_id;
+    QSize m_requestedSize;
+    std::shared_ptr<SnapTray::HistoryImageProvider::ThumbnailCache> m_cache;
+};
+
+class ThumbnailResponse : public QQuickImageResponse
+{
+    Q_OBJECT
+
+public:
+    ThumbnailResponse(const QString& id,
+                      const QSize& requestedSize,
+                      std::shared_ptr<SnapTray::HistoryImageProvider::ThumbnailCache> cache,
+                      QThreadPool* pool)
+    {
+        auto* runnable = new ThumbnailDecodeRunnable(id, requestedSize, std::move(cache));
+        runnable->setAutoDelete(true);
+        connect(runnable, &ThumbnailDecodeRunnable::done, this, &ThumbnailResponse::handleDone);
+        pool->start(runnable);
+    }
+
+    QQuickTextureFactory* textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    QString errorString() const override
+    {
+        return m_image.isNull() ? QStringLiteral("History image unavailable") : QString();
+    }
+
+private:
+    void handleDone(const QImage& image)
+    {
+        m_image = image;
+        emit finished();
+    }
+
+    QImage m_image;
+};
+
+} // namespace
+
+namespace SnapTray {
+
+HistoryImageProvider::ThumbnailCache::ThumbnailCache(qint64 maxBytes)
+    : m_images(static_cast<qsizetype>(qMax<qint64>(maxBytes / 1024, 1)))
+{
+}
+
+bool HistoryImageProvider::ThumbnailCache::lookup(const QString& id, QImage* image)
+{
+    QMutexLocker locker(&m_mutex);
+    const QImage* cached = m_images.object(id);
+    if (!cached) {
+        return false;
+    }
+    *image = *cached;
+    return true;
+}
+
+void HistoryImageProvider::ThumbnailCache::insert(const QString& id, const QImage& image)
+{
+    QMutexLocker locker(&m_mutex);
+    const qsizetype cost = qMax<qsizetype>(image.sizeInBytes() / 1024, 1);
+    m_images.insert(id, new QImage(image), cost);
+}
+
+HistoryImageProvider::HistoryImageProvider()
+    : m_cache(std::make_shared<ThumbnailCache>(kThumbnailCacheBytes))
+{
+    // Leave cores for the render thread and the rest of the UI.
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+}
+
+HistoryImageProvider::~HistoryImageProvider()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+QQuickImageResponse* HistoryImageProvider::requestImageResponse(const QString& id,
+                                                                const QSize& requestedSize)
+{
+    return new ThumbnailResponse(id, requestedSize, m_cache, &m_pool);
+}
+
+QString HistoryImageProvider::urlForEntry(const QString& entryId)
+{
+    return QStringLiteral("image://%1/%2").arg(QLatin1String(kProviderId), entryId);
+}
+
+} // namespace SnapTray
+
+#include "HistoryImageProvider.moc"
@@ -1,5 +1,7 @@
 #include "qml/HistoryModel.h"
 
+#include "qml/HistoryImageProvider.h"
+
 #include <QDate>
 #include <QCoreApplication>
 #include <QLocale>
@@ -11,6 +13,7 @@ namespace SnapTray {
 namespace {
 
 constexpr qint64 kLargeFileThresholdBytes = 2LL * 1024LL * 1024LL;
+constexpr int kPageSize = 100;
 
 QString historyText(const char* sourceText)
 {
@@ -30,7 +33,36 @@ int HistoryModel::rowCount(const QModelIndex& parent) const
     if (parent.isValid()) {
         return 0;
     }
-    return m_entries.size();
+    return m_loadedCount;
+}
+
+bool HistoryModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_loadedCount < m_entries.size();
+}
+
+void HistoryModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    loadRowsThrough(m_loadedCount);
+}
+
+void HistoryModel::loadRowsThrough(int row)
+{
+    const int newCount = qMin(qMax(row + 1, m_loadedCount + kPageSize),
+                              static_cast<int>(m_entries.size()));
+    if (newCount <= m_loadedCount) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_loadedCount, newCount - 1);
+    m_loadedCount = newCount;
+    endInsertRows();
+
+    emit countChanged();
 }
 
 int HistoryModel::totalCount() const
@@ -45,7 +77,7 @@ int HistoryModel::filterCountsRevision() const
 
 QVariant HistoryModel::data(const QModelIndex& index, int role) const
 {
-    if (!index.isValid() || index.row() < 0 || index.row() >= m_entries.size()) {
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_loadedCount) {
         return {};
     }
 
@@ -60,7 +92,7 @@ QVariant HistoryModel::data(const QModelIndex& index, int role) const
     case PreviewPathRole:
         return entry.previewPath;
     case ThumbnailUrlRole:
-        return QUrl::fromLocalFile(entry.previewPath);
+        return QUrl(HistoryImageProvider::urlForEntry(entry.id));
     case CapturedAtRole:
         return entry.createdAt;
     case CapturedAtTextRole:
@@ -130,7 +162,7 @@ void HistoryModel::setActiveFilter(Filter filter)
 
     beginResetModel();
     m_activeFilter = filter;
-    rebuildVisibleEntries();
+    rebuildVisibleEntries(kPageSize);
     endResetModel();
 
     emit activeFilterChanged();
@@ -160,7 +192,7 @@ void HistoryModel::setSortOrder(SortOrder sortOrder)
 
     beginResetModel();
     m_sortOrder = sortOrder;
-    rebuildVisibleEntries();
+    rebuildVisibleEntries(kPageSize);
     endResetModel();
 
     emit sortOrderChanged();
@@ -169,9 +201,11 @@ void HistoryModel::setSortOrder(SortOrder sortOrder)
 
 void HistoryModel::refresh()
 {
+    // Keep the rows the view already pulled in so a refresh doesn't jump
+    // the scroll position back to the first page.
     beginResetModel();
     m_allEntries = HistoryStore::loadEntries();
-    rebuildVisibleEntries();
+    rebuildVisibleEntries(qMax(m_loadedCount, kPageSize));
     endResetModel();
 
     emit countChanged();
@@ -197,7 +231,7 @@ int HistoryModel::countForFilter(Filter filter) const
     }));
 }
 
-int HistoryModel::indexOfId(const QString& id) const
+int HistoryModel::indexOfId(const QString& id)
 {
     if (id.isEmpty()) {
         return -1;
@@ -205,6 +239,9 @@ int HistoryModel::indexOfId(const QString& id) const
 
     for (int i = 0; i < m_entries.size(); ++i) {
         if (m_entries.at(i).id == id) {
+            // The caller is about to select or scroll to this row, so it
+            // has to exist in the view.
+            loadRowsThrough(i);
             return i;
         }
     }
@@ -220,7 +257,7 @@ QString HistoryModel::idAt(int index) const
     return m_entries.at(index).id;
 }
 
-void HistoryModel::rebuildVisibleEntries()
+void HistoryModel::rebuildVisibleEntries(int loadedCount)
 {
     m_entries.clear();
     m_entries.reserve(m_allEntries.size());
@@ -254,6 +291,8 @@ void HistoryModel::rebuildVisibleEntries()
             return lhs.id > rhs.id;
         }
     });
+
+    m_loadedCount = qMin(loadedCount, static_cast<int>(m_entries.size()));
 }
 
 bool HistoryModel::matchesFilter(const HistoryEntry& entry, Filter filter) const
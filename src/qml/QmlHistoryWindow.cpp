@@ -2,6 +2,7 @@
 
 #include "cursor/CursorSurfaceSupport.h"
 #include "qml/HistoryBackend.h"
+#include "qml/HistoryImageProvider.h"
 #include "qml/HistoryModel.h"
 #include "qml/QmlOverlayManager.h"
 #include "qml/QmlToast.h"
@@ -10,6 +11,7 @@
 #include <QGuiApplication>
 #include <QKeyEvent>
 #include <QQmlContext>
+#include <QQmlEngine>
 #include <QQuickView>
 #include <QScreen>
 #include <QUrl>
@@ -110,6 +112,8 @@ void QmlHistoryWindow::ensureView()
 
     m_view->setMinimumSize(minimumSize);
     m_view->resize(initialSize);
+    m_view->engine()->addImageProvider(QLatin1String(HistoryImageProvider::kProviderId),
+                                       new HistoryImageProvider());
     m_view->rootContext()->setContextProperty(QStringLiteral("historyModel"), m_model);
     m_view->rootContext()->setContextProperty(QStringLiteral("historyBackend"), m_backend);
     m_view->setSource(QUrl(QStringLiteral("qrc:/SnapTrayQml/panels/HistoryWindow.qml")));
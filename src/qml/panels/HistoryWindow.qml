@@ -403,6 +403,7 @@ Item {
         signal selectedEntry(string entryId, int itemIndex)
         signal openRequested(string entryId, int itemIndex)
         signal contextMenuRequested(real globalX, real globalY, string entryId, int itemIndex)
+        signal hovered(int itemIndex)
 
         radius: 18
         color: gridMouse.pressed
@@ -509,6 +510,11 @@ Item {
             hoverEnabled: true
             cursorShape: CursorTokens.clickable
 
+            onContainsMouseChanged: {
+                if (containsMouse)
+                    gridCard.hovered(gridCard.itemIndex)
+            }
+
             onClicked: function(mouse) {
                 gridCard.selectedEntry(gridCard.entryId, gridCard.itemIndex)
                 if (mouse.button === Qt.RightButton) {
@@ -538,6 +544,7 @@ Item {
         signal selectedEntry(string entryId, int itemIndex)
         signal openRequested(string entryId, int itemIndex)
         signal contextMenuRequested(real globalX, real globalY, string entryId, int itemIndex)
+        signal hovered(int itemIndex)
 
         radius: 16
         color: listMouse.pressed
@@ -620,6 +627,11 @@ Item {
             hoverEnabled: true
             cursorShape: CursorTokens.clickable
 
+            onContainsMouseChanged: {
+                if (containsMouse)
+                    listRow.hovered(listRow.itemIndex)
+            }
+
             onClicked: function(mouse) {
                 listRow.selectedEntry(listRow.entryId, listRow.itemIndex)
                 if (mouse.button === Qt.RightButton) {
@@ -745,6 +757,11 @@ Item {
                     onContextMenuRequested: function(globalX, globalY, entryId, itemIndex) {
                         root.openContextMenu(globalX, globalY, entryId, itemIndex)
                     }
+
+                    onHovered: function(itemIndex) {
+                        if (root.backend)
+                            root.backend.prefetch(itemIndex)
+                    }
                 }
             }
         }
@@ -790,6 +807,11 @@ Item {
                     onContextMenuRequested: function(globalX, globalY, entryId, itemIndex) {
                         root.openContextMenu(globalX, globalY, entryId, itemIndex)
                     }
+
+                    onHovered: function(itemIndex) {
+                        if (root.backend)
+                            root.backend.prefetch(itemIndex)
+                    }
                 }
             }
         }
@@ -90,7 +90,8 @@ Flickable {
             label: qsTr("Max history entries")
             value: settingsBackend.pinMaxCacheFiles
             from: 5
-            to: 200
+            to: 2000
+            stepSize: 5
             onMoved: function(value) { settingsBackend.pinMaxCacheFiles = value }
         }
     }
@@ -270,7 +270,8 @@ void RegionExportManager::savePreparedExportAsync(PreparedExport prepared,
         result.filePath = filePath;
         result.renderWarning = renderWarning;
         result.success = ImageSaveUtils::saveImageAtomically(
-            image, filePath, QByteArray(), &result.saveError);
+            image, filePath, QByteArray(), &result.saveError,
+            ImageSaveUtils::PngCompression::Smallest);
         return result;
     }));
 }
@@ -38,6 +38,7 @@ void ShapeAnnotationEditor::startTransformation(const QPoint& pos, GizmoHandle h
         return;
     }
 
+    m_annotationLayer->markDirtyRect(shapeItem->boundingRect());
     m_isTransforming = true;
     m_activeGizmoHandle = handle;
     m_transformStartCenter = shapeItem->center();
@@ -95,12 +96,18 @@ void ShapeAnnotationEditor::updateTransformation(const QPoint& pos)
 
 void ShapeAnnotationEditor::finishTransformation()
 {
+    if (m_isTransforming && m_annotationLayer) {
+        m_annotationLayer->commitDirtyRegion();
+    }
     m_isTransforming = false;
     m_activeGizmoHandle = GizmoHandle::None;
 }
 
 void ShapeAnnotationEditor::startDragging(const QPoint& pos)
 {
+    if (ShapeAnnotation* shapeItem = selectedShape()) {
+        m_annotationLayer->markDirtyRect(shapeItem->boundingRect());
+    }
     m_isDragging = true;
     m_dragStart = pos;
 }
@@ -119,5 +126,8 @@ void ShapeAnnotationEditor::updateDragging(const QPoint& pos)
 
 void ShapeAnnotationEditor::finishDragging()
 {
+    if (m_isDragging && m_annotationLayer) {
+        m_annotationLayer->commitDirtyRegion();
+    }
     m_isDragging = false;
 }
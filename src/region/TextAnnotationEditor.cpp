@@ -203,6 +203,7 @@ void TextAnnotationEditor::startTransformation(const QPoint& pos, GizmoHandle ha
     auto* textItem = dynamic_cast<TextBoxAnnotation*>(m_annotationLayer->selectedItem());
     if (!textItem) return;
 
+    m_annotationLayer->markDirtyRect(textItem->boundingRect());
     m_isTransforming = true;
     m_activeGizmoHandle = handle;
     m_transformStartCenter = textItem->center();
@@ -272,12 +273,20 @@ void TextAnnotationEditor::updateTransformation(const QPoint& pos)
 
 void TextAnnotationEditor::finishTransformation()
 {
+    if (m_isTransforming && m_annotationLayer) {
+        m_annotationLayer->commitDirtyRegion();
+    }
     m_isTransforming = false;
     m_activeGizmoHandle = GizmoHandle::None;
 }
 
 void TextAnnotationEditor::startDragging(const QPoint& pos)
 {
+    if (m_annotationLayer) {
+        if (auto* textItem = dynamic_cast<TextBoxAnnotation*>(m_annotationLayer->selectedItem())) {
+            m_annotationLayer->markDirtyRect(textItem->boundingRect());
+        }
+    }
     m_isDragging = true;
     m_dragStart = pos;
 }
@@ -297,6 +306,9 @@ void TextAnnotationEditor::updateDragging(const QPoint& pos)
 
 void TextAnnotationEditor::finishDragging()
 {
+    if (m_isDragging && m_annotationLayer) {
+        m_annotationLayer->commitDirtyRegion();
+    }
     m_isDragging = false;
 }
 
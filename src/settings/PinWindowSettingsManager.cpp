@@ -73,7 +73,7 @@ int PinWindowSettingsManager::loadMaxCacheFiles() const
     auto settings = SnapTray::getSettings();
     int maxFiles = settings.value(kSettingsKeyMaxCacheFiles, kDefaultMaxCacheFiles).toInt();
     if (maxFiles < 5) maxFiles = 5;
-    if (maxFiles > 200) maxFiles = 200;
+    if (maxFiles > 2000) maxFiles = 2000;
     return maxFiles;
 }
 
@@ -72,6 +72,7 @@ void SelectionToolHandler::onMouseMove(ToolContext* ctx, const QPoint& pos)
 
     QPoint delta = pos - m_lastMousePos;
     m_lastMousePos = pos;
+    const QRect previousRect = m_selectedArrow->boundingRect();
 
     switch (m_activeHandle) {
     case GizmoHandle::ArrowStart:
@@ -99,9 +100,10 @@ void SelectionToolHandler::onMouseMove(ToolContext* ctx, const QPoint& pos)
         break;
     }
 
-    // Invalidate cache and request repaint
+    // Repaint only the cache tiles the arrow left and entered
     if (ctx->annotationLayer) {
-        ctx->annotationLayer->invalidateCache();
+        ctx->annotationLayer->invalidateCacheRect(
+            previousRect.united(m_selectedArrow->boundingRect()));
     }
     ctx->repaint();
 }
@@ -0,0 +1,27 @@
+#include "utils/ImageHash.h"
+
+#include <QHash>
+#include <QImage>
+
+namespace ImageHash {
+
+quint64 hashPixels(const QImage& image)
+{
+    if (image.isNull()) {
+        return 0;
+    }
+
+    size_t seed = qHashMulti(0, image.width(), image.height(), static_cast<int>(image.format()));
+    const size_t rowBytes =
+        static_cast<size_t>(image.width()) * static_cast<size_t>(image.depth()) / 8;
+    if (static_cast<size_t>(image.bytesPerLine()) == rowBytes) {
+        return qHashBits(image.constBits(), static_cast<size_t>(image.sizeInBytes()), seed);
+    }
+    // Skip scanline padding, which may hold stale bytes.
+    for (int y = 0; y < image.height(); ++y) {
+        seed = qHashBits(image.constScanLine(y), rowBytes, seed);
+    }
+    return seed;
+}
+
+} // namespace ImageHash
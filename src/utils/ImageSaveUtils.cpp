@@ -1,5 +1,7 @@
 #include "utils/ImageSaveUtils.h"
 
+#include "utils/ParallelPngWriter.h"
+
 #include <QColorSpace>
 #include <QFileInfo>
 #include <QImageWriter>
@@ -9,6 +11,9 @@
 
 namespace {
 
+// Below this the thread hand-off costs more than it saves.
+constexpr qint64 kParallelPngMinPixels = 1024 * 1024;
+
 QByteArray normalizeFormat(QByteArray format)
 {
     format = format.trimmed().toLower();
@@ -60,7 +65,8 @@ QString formatListForError()
 bool ImageSaveUtils::saveImageAtomically(const QImage& image,
                                          const QString& filePath,
                                          const QByteArray& explicitFormat,
-                                         Error* error)
+                                         Error* error,
+                                         PngCompression pngCompression)
 {
     if (image.isNull()) {
         setError(error, QStringLiteral("write"), QStringLiteral("Image is null"));
@@ -84,7 +90,26 @@ bool ImageSaveUtils::saveImageAtomically(const QImage& image,
         return false;
     }
 
+    const bool isPng = format == "png";
+    const int pngLevel = pngCompressionLevel(pngCompression);
+    if (isPng && ParallelPngWriter::canWrite(image) &&
+        static_cast<qint64>(image.width()) * image.height() >= kParallelPngMinPixels) {
+        QString writeError;
+        if (!ParallelPngWriter::write(image, &saveFile, pngLevel, &writeError)) {
+            saveFile.cancelWriting();
+            setError(error, QStringLiteral("write"),
+                     writeError.isEmpty() ? QStringLiteral("Failed to encode image")
+                                          : writeError);
+            return false;
+        }
+        return commit(saveFile, error);
+    }
+
     QImageWriter writer(&saveFile, format);
+    if (isPng) {
+        // Qt's PNG handler maps quality q to zlib level (100 - q) * 9 / 91.
+        writer.setQuality(100 - (pngLevel * 91 + 8) / 9);
+    }
     if (!writer.write(image)) {
         saveFile.cancelWriting();
         const QString writeError = writer.errorString().trimmed();
@@ -94,22 +119,15 @@ bool ImageSaveUtils::saveImageAtomically(const QImage& image,
         return false;
     }
 
-    if (!saveFile.commit()) {
-        const QString commitError = saveFile.errorString().trimmed();
-        setError(error, QStringLiteral("commit"),
-                 commitError.isEmpty() ? QStringLiteral("Failed to commit output file")
-                                       : commitError);
-        return false;
-    }
-
-    return true;
+    return commit(saveFile, error);
 }
 
 bool ImageSaveUtils::savePixmapAtomically(const QPixmap& pixmap,
                                           const QString& filePath,
                                           const QByteArray& explicitFormat,
                                           Error* error,
-                                          QScreen* sourceScreen)
+                                          QScreen* sourceScreen,
+                                          PngCompression pngCompression)
 {
     if (pixmap.isNull()) {
         setError(error, QStringLiteral("write"), QStringLiteral("Pixmap is null"));
@@ -126,7 +144,32 @@ bool ImageSaveUtils::savePixmapAtomically(const QPixmap& pixmap,
         }
     }
 
-    return saveImageAtomically(image, filePath, explicitFormat, error);
+    return saveImageAtomically(image, filePath, explicitFormat, error, pngCompression);
+}
+
+int ImageSaveUtils::pngCompressionLevel(PngCompression compression)
+{
+    switch (compression) {
+    case PngCompression::Fastest:
+        return 1;
+    case PngCompression::Smallest:
+        return 9;
+    case PngCompression::Balanced:
+    default:
+        return 6;
+    }
+}
+
+bool ImageSaveUtils::commit(QSaveFile& saveFile, Error* error)
+{
+    if (!saveFile.commit()) {
+        const QString commitError = saveFile.errorString().trimmed();
+        setError(error, QStringLiteral("commit"),
+                 commitError.isEmpty() ? QStringLiteral("Failed to commit output file")
+                                       : commitError);
+        return false;
+    }
+    return true;
 }
 
 QByteArray ImageSaveUtils::resolveFormat(const QString& filePath,
@@ -0,0 +1,456 @@
+#include "utils/ParallelPngWriter.h"
+
+#include <QColorSpace>
+#include <QIODevice>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QStringList>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(SNAPTRAY_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace {
+
+#if defined(SNAPTRAY_HAVE_ZLIB)
+
+constexpr qsizetype kTargetBandBytes = 1024 * 1024;
+constexpr int kMaxBands = 256;
+constexpr qsizetype kWindowBytes = 32 * 1024;
+constexpr uchar kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+enum PngFilter : uchar {
+    FilterNone = 0,
+    FilterSub,
+    FilterUp,
+    FilterAverage,
+    FilterPaeth,
+};
+
+struct Band
+{
+    int firstRow = 0;
+    int rowCount = 0;
+    qsizetype offset = 0;      // Into the current window's filtered buffer
+    qsizetype size = 0;
+    bool last = false;
+    QByteArray compressed;
+    uLong adler = 1;
+    bool ok = false;
+};
+
+// Private pool: callers such as the async export already run on the global
+// pool, and waiting for band work queued behind themselves would stall.
+QThreadPool* encodePool()
+{
+    static QThreadPool* pool = []() {
+        auto* threadPool = new QThreadPool();
+        threadPool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+        return threadPool;
+    }();
+    return pool;
+}
+
+int paethPredictor(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Sum of the filtered bytes read as signed values; the smallest sum is a
+// good guess at what deflates best (the heuristic libpng uses).
+quint64 filterCost(const uchar* data, int size)
+{
+    quint64 cost = 0;
+    for (int i = 0; i < size; ++i) {
+        cost += data[i] < 128 ? data[i] : 256 - data[i];
+    }
+    return cost;
+}
+
+// Writes the filter byte and the filtered row to out. candidates needs room
+// for four rows.
+void filterRow(const uchar* row, const uchar* prior, int rowBytes, int bpp,
+               uchar* candidates, uchar* out)
+{
+    uchar* sub = candidates;
+    uchar* up = candidates + rowBytes;
+    uchar* average = candidates + 2 * rowBytes;
+    uchar* paeth = candidates + 3 * rowBytes;
+
+    for (int i = 0; i < rowBytes; ++i) {
+        const int left = i >= bpp ? row[i - bpp] : 0;
+        const int above = prior[i];
+        const int aboveLeft = i >= bpp ? prior[i - bpp] : 0;
+        sub[i] = static_cast<uchar>(row[i] - left);
+        up[i] = static_cast<uchar>(row[i] - above);
+        average[i] = static_cast<uchar>(row[i] - ((left + above) >> 1));
+        paeth[i] = static_cast<uchar>(row[i] - paethPredictor(left, above, aboveLeft));
+    }
+
+    const uchar* best = row;
+    uchar bestFilter = FilterNone;
+    quint64 bestCost = filterCost(row, rowBytes);
+    const uchar* filtered[] = {sub, up, average, paeth};
+    const uchar filterTypes[] = {FilterSub, FilterUp, FilterAverage, FilterPaeth};
+    for (int f = 0; f < 4; ++f) {
+        const quint64 cost = filterCost(filtered[f], rowBytes);
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = filtered[f];
+            bestFilter = filterTypes[f];
+        }
+    }
+
+    out[0] = bestFilter;
+    std::memcpy(out + 1, best, static_cast<size_t>(rowBytes));
+}
+
+bool filterBand(const QImage& image, QImage::Format targetFormat, int rowBytes, int bpp,
+                const Band& band, uchar* filtered)
+{
+    // Convert the band plus the row above it, which the filters predict from.
+    const int top = band.firstRow > 0 ? band.firstRow - 1 : 0;
+    const int rows = band.rowCount + (band.firstRow - top);
+    QImage source = image;
+    if (image.format() != targetFormat) {
+        source = image.copy(0, top, image.width(), rows).convertToFormat(targetFormat);
+    }
+    if (source.isNull()) {
+        return false;
+    }
+    const int sourceTop = image.format() != targetFormat ? top : 0;
+
+    std::vector<uchar> zeroRow(static_cast<size_t>(rowBytes), 0);
+    std::vector<uchar> candidates(static_cast<size_t>(rowBytes) * 4);
+    for (int y = band.firstRow; y < band.firstRow + band.rowCount; ++y) {
+        const uchar* row = source.constScanLine(y - sourceTop);
+        const uchar* prior = y > 0 ? source.constScanLine(y - 1 - sourceTop) : zeroRow.data();
+        uchar* out = filtered + static_cast<qsizetype>(y - band.firstRow) * (rowBytes + 1);
+        filterRow(row, prior, rowBytes, bpp, candidates.data(), out);
+    }
+    return true;
+}
+
+bool deflateBand(const uchar* filtered, int level, Band& band)
+{
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    // Raw deflate: the zlib header and checksum wrap the joined bands.
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+
+    if (band.offset > 0) {
+        const qsizetype dictionarySize = qMin(kWindowBytes, band.offset);
+        deflateSetDictionary(&stream, filtered + band.offset - dictionarySize,
+                             static_cast<uInt>(dictionarySize));
+    }
+
+    band.compressed.resize(static_cast<qsizetype>(deflateBound(&stream, static_cast<uLong>(band.size))) + 64);
+    stream.next_in = const_cast<Bytef*>(filtered + band.offset);
+    stream.avail_in = static_cast<uInt>(band.size);
+
+    // Z_SYNC_FLUSH ends every band but the last on a byte boundary with an
+    // empty stored block, so the bands can simply be concatenated.
+    const int flush = band.last ? Z_FINISH : Z_SYNC_FLUSH;
+    qsizetype produced = 0;
+    bool ok = false;
+    for (;;) {
+        stream.next_out = reinterpret_cast<Bytef*>(band.compressed.data()) + produced;
+        stream.avail_out = static_cast<uInt>(band.compressed.size() - produced);
+        const int result = deflate(&stream, flush);
+        produced = band.compressed.size() - stream.avail_out;
+        if (result == Z_STREAM_END || (!band.last && result == Z_OK && stream.avail_in == 0 &&
+                                       stream.avail_out > 0)) {
+            ok = true;
+            break;
+        }
+        if ((result != Z_OK && result != Z_BUF_ERROR) || stream.avail_out > 0) {
+            break;
+        }
+        band.compressed.resize(band.compressed.size() * 2);
+    }
+    deflateEnd(&stream);
+
+    band.compressed.resize(produced);
+    band.adler = adler32(1, filtered + band.offset, static_cast<uInt>(band.size));
+    return ok;
+}
+
+bool writeChunk(QIODevice* device, const char* type, const char* data, qsizetype size)
+{
+    uchar header[8];
+    qToBigEndian<quint32>(static_cast<quint32>(size), header);
+    std::memcpy(header + 4, type, 4);
+
+    uLong crc = crc32(0, header + 4, 4);
+    if (size > 0) {
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(size));
+    }
+    uchar trailer[4];
+    qToBigEndian<quint32>(static_cast<quint32>(crc), trailer);
+
+    return device->write(reinterpret_cast<const char*>(header), 8) == 8 &&
+           (size == 0 || device->write(data, size) == size) &&
+           device->write(reinterpret_cast<const char*>(trailer), 4) == 4;
+}
+
+bool writeChunk(QIODevice* device, const char* type, const QByteArray& data)
+{
+    return writeChunk(device, type, data.constData(), data.size());
+}
+
+QByteArray bigEndian32(quint32 value)
+{
+    QByteArray bytes(4, Qt::Uninitialized);
+    qToBigEndian<quint32>(value, bytes.data());
+    return bytes;
+}
+
+bool isLatin1(const QString& text)
+{
+    for (const QChar ch : text) {
+        if (ch.unicode() > 0xff) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Colour space, resolution and text, matching what QImageWriter records.
+bool writeMetadata(QIODevice* device, const QImage& image)
+{
+    const QColorSpace colorSpace = image.colorSpace();
+    const QByteArray icc = colorSpace.isValid() ? colorSpace.iccProfile() : QByteArray();
+    if (!icc.isEmpty()) {
+        uLongf compressedSize = compressBound(static_cast<uLong>(icc.size()));
+        QByteArray compressed(static_cast<qsizetype>(compressedSize), Qt::Uninitialized);
+        if (compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressedSize,
+                      reinterpret_cast<const Bytef*>(icc.constData()),
+                      static_cast<uLong>(icc.size()), Z_BEST_COMPRESSION) == Z_OK) {
+            compressed.resize(static_cast<qsizetype>(compressedSize));
+            QByteArray chunk = QByteArrayLiteral("ICC profile");
+            chunk.append('\0');
+            chunk.append('\0');   // Compression method: deflate
+            chunk.append(compressed);
+            if (!writeChunk(device, "iCCP", chunk)) {
+                return false;
+            }
+        }
+    }
+
+    if (image.dotsPerMeterX() > 0 && image.dotsPerMeterY() > 0) {
+        QByteArray chunk = bigEndian32(static_cast<quint32>(image.dotsPerMeterX()));
+        chunk.append(bigEndian32(static_cast<quint32>(image.dotsPerMeterY())));
+        chunk.append('\1');   // Unit: metre
+        if (!writeChunk(device, "pHYs", chunk)) {
+            return false;
+        }
+    }
+
+    const QStringList keys = image.textKeys();
+    for (const QString& key : keys) {
+        const QByteArray keyword = key.toLatin1();
+        if (keyword.isEmpty() || keyword.size() > 79 || !isLatin1(key)) {
+            continue;
+        }
+        const QString value = image.text(key);
+        QByteArray chunk = keyword;
+        chunk.append('\0');
+        if (isLatin1(value)) {
+            chunk.append(value.toLatin1());
+            if (!writeChunk(device, "tEXt", chunk)) {
+                return false;
+            }
+        } else {
+            // Uncompressed international text: no language tag or translation.
+            chunk.append('\0');
+            chunk.append('\0');
+            chunk.append('\0');
+            chunk.append('\0');
+            chunk.append(value.toUtf8());
+            if (!writeChunk(device, "iTXt", chunk)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void setError(QString* errorMessage, const QString& message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
+
+#endif // SNAPTRAY_HAVE_ZLIB
+
+} // namespace
+
+namespace ParallelPngWriter {
+
+bool isAvailable()
+{
+#if defined(SNAPTRAY_HAVE_ZLIB)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool canWrite(const QImage& image)
+{
+    if (!isAvailable() || image.isNull()) {
+        return false;
+    }
+
+    switch (image.format()) {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+    case QImage::Format_RGB888:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool write(const QImage& image, QIODevice* device, int compressionLevel, QString* errorMessage)
+{
+#if defined(SNAPTRAY_HAVE_ZLIB)
+    if (!device || !canWrite(image)) {
+        setError(errorMessage, QStringLiteral("Unsupported image for parallel PNG writer"));
+        return false;
+    }
+
+    const int level = qBound(0, compressionLevel, 9);
+    const bool hasAlpha = image.hasAlphaChannel();
+    const QImage::Format targetFormat = hasAlpha ? QImage::Format_RGBA8888 : QImage::Format_RGB888;
+    const int bpp = hasAlpha ? 4 : 3;
+    const int width = image.width();
+    const int height = image.height();
+    const int rowBytes = width * bpp;
+    const qsizetype filteredRowBytes = rowBytes + 1;
+
+    const int rowsPerBand = qMax(qMax<qsizetype>(1, kTargetBandBytes / filteredRowBytes),
+                                 static_cast<qsizetype>((height + kMaxBands - 1) / kMaxBands));
+
+    // Bands are encoded a window at a time and written in order before the
+    // next window starts, so memory stays at a few bands per thread however
+    // large the image is. Each window keeps the last 32 KiB of filtered data
+    // from the one before to prime its first band.
+    const int bandsPerWindow = 2 * qMax(1, encodePool()->maxThreadCount());
+    std::vector<Band> window;
+    window.reserve(static_cast<size_t>(bandsPerWindow));
+    std::vector<uchar> filtered;
+    std::vector<uchar> history;
+    uLong adler = 1;
+
+    QByteArray header = bigEndian32(static_cast<quint32>(width));
+    header.append(bigEndian32(static_cast<quint32>(height)));
+    header.append('\x08');                          // Bit depth
+    header.append(hasAlpha ? '\x06' : '\x02');      // Colour type: RGBA / RGB
+    header.append('\0');                            // Compression
+    header.append('\0');                            // Filter method
+    header.append('\0');                            // No interlace
+
+    // zlib stream header; FLEVEL is informational only.
+    const uchar flevel = level <= 1 ? 0 : level <= 5 ? 1 : level == 6 ? 2 : 3;
+    uchar zlibHeader[2] = {0x78, static_cast<uchar>(flevel << 6)};
+    zlibHeader[1] = static_cast<uchar>(zlibHeader[1] + 31 - ((zlibHeader[0] * 256 + zlibHeader[1]) % 31));
+
+    bool ok = device->write(reinterpret_cast<const char*>(kSignature), sizeof(kSignature)) ==
+                  static_cast<qint64>(sizeof(kSignature)) &&
+              writeChunk(device, "IHDR", header) &&
+              writeMetadata(device, image) &&
+              writeChunk(device, "IDAT", reinterpret_cast<const char*>(zlibHeader), 2);
+
+    for (int row = 0; ok && row < height;) {
+        window.clear();
+        qsizetype offset = static_cast<qsizetype>(history.size());
+        for (; row < height && window.size() < static_cast<size_t>(bandsPerWindow);
+             row += rowsPerBand) {
+            Band band;
+            band.firstRow = row;
+            band.rowCount = qMin(rowsPerBand, height - row);
+            band.offset = offset;
+            band.size = static_cast<qsizetype>(band.rowCount) * filteredRowBytes;
+            band.last = row + band.rowCount >= height;
+            offset += band.size;
+            window.push_back(band);
+        }
+
+        filtered.resize(static_cast<size_t>(offset));
+        std::copy(history.begin(), history.end(), filtered.begin());
+        uchar* filteredData = filtered.data();
+
+        // Filtering is independent per band; deflate needs the whole window
+        // filtered first because it primes each band with the one before.
+        QtConcurrent::blockingMap(encodePool(), window, [&](Band& band) {
+            band.ok = filterBand(image, targetFormat, rowBytes, bpp, band,
+                                 filteredData + band.offset);
+        });
+        for (const Band& band : window) {
+            if (!band.ok) {
+                setError(errorMessage, QStringLiteral("Failed to convert image for PNG encoding"));
+                return false;
+            }
+        }
+
+        QtConcurrent::blockingMap(encodePool(), window, [&](Band& band) {
+            band.ok = deflateBand(filteredData, level, band);
+        });
+        for (const Band& band : window) {
+            if (!band.ok) {
+                setError(errorMessage, QStringLiteral("Failed to compress PNG data"));
+                return false;
+            }
+        }
+
+        for (size_t i = 0; ok && i < window.size(); ++i) {
+            ok = writeChunk(device, "IDAT", window[i].compressed);
+            adler = adler32_combine(adler, window[i].adler, static_cast<z_off_t>(window[i].size));
+        }
+
+        const qsizetype historyBytes = qMin(kWindowBytes, offset);
+        history.assign(filtered.end() - historyBytes, filtered.end());
+    }
+
+    ok = ok && writeChunk(device, "IDAT", bigEndian32(static_cast<quint32>(adler))) &&
+         writeChunk(device, "IEND", nullptr, 0);
+    if (!ok) {
+        const QString deviceError = device->errorString().trimmed();
+        setError(errorMessage, deviceError.isEmpty() ? QStringLiteral("Failed to write PNG data")
+                                                     : deviceError);
+    }
+    return ok;
+#else
+    Q_UNUSED(image);
+    Q_UNUSED(device);
+    Q_UNUSED(compressionLevel);
+    if (errorMessage) {
+        *errorMessage = QStringLiteral("Parallel PNG writer requires zlib");
+    }
+    return false;
+#endif
+}
+
+} // namespace ParallelPngWriter
@@ -0,0 +1,210 @@
+#include "utils/PixelateKernel.h"
+
+#include <QtGlobal>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SNAPTRAY_PIXELATE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SNAPTRAY_PIXELATE_NEON 1
+#endif
+#endif
+
+namespace {
+
+// Channel sums are stored interleaved per column in memory byte order of a
+// little-endian QRgb: blue, green, red, alpha.
+constexpr int kChannels = 4;
+
+int floorToBlock(int value, int block)
+{
+    int rem = value % block;
+    if (rem < 0) {
+        rem += block;
+    }
+    return value - rem;
+}
+
+void accumulateRow(const quint32* row, int width, quint32* sums)
+{
+    int x = 0;
+#if defined(SNAPTRAY_PIXELATE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 4 <= width; x += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+        const __m128i low16 = _mm_unpacklo_epi8(pixels, zero);
+        const __m128i high16 = _mm_unpackhi_epi8(pixels, zero);
+        __m128i* acc = reinterpret_cast<__m128i*>(sums + x * kChannels);
+        _mm_storeu_si128(acc + 0, _mm_add_epi32(_mm_loadu_si128(acc + 0), _mm_unpacklo_epi16(low16, zero)));
+        _mm_storeu_si128(acc + 1, _mm_add_epi32(_mm_loadu_si128(acc + 1), _mm_unpackhi_epi16(low16, zero)));
+        _mm_storeu_si128(acc + 2, _mm_add_epi32(_mm_loadu_si128(acc + 2), _mm_unpacklo_epi16(high16, zero)));
+        _mm_storeu_si128(acc + 3, _mm_add_epi32(_mm_loadu_si128(acc + 3), _mm_unpackhi_epi16(high16, zero)));
+    }
+#elif defined(SNAPTRAY_PIXELATE_NEON)
+    for (; x + 4 <= width; x += 4) {
+        const uint8x16_t pixels = vld1q_u8(reinterpret_cast<const uint8_t*>(row + x));
+        const uint16x8_t low16 = vmovl_u8(vget_low_u8(pixels));
+        const uint16x8_t high16 = vmovl_u8(vget_high_u8(pixels));
+        uint32_t* acc = sums + x * kChannels;
+        vst1q_u32(acc + 0, vaddw_u16(vld1q_u32(acc + 0), vget_low_u16(low16)));
+        vst1q_u32(acc + 4, vaddw_u16(vld1q_u32(acc + 4), vget_high_u16(low16)));
+        vst1q_u32(acc + 8, vaddw_u16(vld1q_u32(acc + 8), vget_low_u16(high16)));
+        vst1q_u32(acc + 12, vaddw_u16(vld1q_u32(acc + 12), vget_high_u16(high16)));
+    }
+#endif
+    for (; x < width; ++x) {
+        const QRgb pixel = row[x];
+        quint32* acc = sums + x * kChannels;
+        acc[0] += static_cast<quint32>(qBlue(pixel));
+        acc[1] += static_cast<quint32>(qGreen(pixel));
+        acc[2] += static_cast<quint32>(qRed(pixel));
+        acc[3] += static_cast<quint32>(qAlpha(pixel));
+    }
+}
+
+void reduceColumns(const quint32* sums, int columnCount, quint32* out)
+{
+    int column = 0;
+#if defined(SNAPTRAY_PIXELATE_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (; column < columnCount; ++column) {
+        acc = _mm_add_epi32(acc, _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(sums + column * kChannels)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), acc);
+#elif defined(SNAPTRAY_PIXELATE_NEON)
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; column < columnCount; ++column) {
+        acc = vaddq_u32(acc, vld1q_u32(sums + column * kChannels));
+    }
+    vst1q_u32(out, acc);
+#else
+    out[0] = out[1] = out[2] = out[3] = 0;
+    for (; column < columnCount; ++column) {
+        for (int channel = 0; channel < kChannels; ++channel) {
+            out[channel] += sums[column * kChannels + channel];
+        }
+    }
+#endif
+}
+
+void fillSpan(quint32* dest, int count, quint32 color)
+{
+    int x = 0;
+#if defined(SNAPTRAY_PIXELATE_SSE2)
+    const __m128i value = _mm_set1_epi32(static_cast<int>(color));
+    for (; x + 4 <= count; x += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x), value);
+    }
+#elif defined(SNAPTRAY_PIXELATE_NEON)
+    const uint32x4_t value = vdupq_n_u32(color);
+    for (; x + 4 <= count; x += 4) {
+        vst1q_u32(dest + x, value);
+    }
+#endif
+    std::fill(dest + x, dest + count, color);
+}
+
+} // namespace
+
+namespace PixelateKernel {
+
+QImage pixelate(const QImage& sourceImage, const QRect& targetRect, int blockSize)
+{
+    if (sourceImage.isNull() || targetRect.isEmpty() || blockSize <= 0) {
+        return QImage();
+    }
+
+    QImage source = sourceImage;
+    if (source.format() != QImage::Format_RGB32 &&
+        source.format() != QImage::Format_ARGB32 &&
+        source.format() != QImage::Format_ARGB32_Premultiplied) {
+        source = source.convertToFormat(QImage::Format_ARGB32);
+    }
+    const bool premultiplied = source.format() == QImage::Format_ARGB32_Premultiplied;
+
+    const int startBlockX = floorToBlock(targetRect.left(), blockSize);
+    const int startBlockY = floorToBlock(targetRect.top(), blockSize);
+    const int lastBlockX = floorToBlock(targetRect.right(), blockSize);
+    const int blockColumns = (lastBlockX - startBlockX) / blockSize + 1;
+
+    // Source columns covered by the blocks that touch targetRect.
+    const int sampleLeft = qMax(0, startBlockX);
+    const int sampleRight = qMin(source.width(), lastBlockX + blockSize);
+    const int sampleTop = qMax(0, startBlockY);
+    const int sampleBottom = qMin(source.height(), floorToBlock(targetRect.bottom(), blockSize) + blockSize);
+    if (sampleLeft >= sampleRight || sampleTop >= sampleBottom) {
+        return QImage();
+    }
+
+    QImage result(targetRect.size(), QImage::Format_ARGB32);
+    result.fill(Qt::transparent);
+
+    const int sampleWidth = sampleRight - sampleLeft;
+    std::vector<quint32> columnSums(static_cast<size_t>(sampleWidth) * kChannels);
+    std::vector<QRgb> blockColors(static_cast<size_t>(blockColumns));
+    std::vector<std::uint8_t> blockCovered(static_cast<size_t>(blockColumns));
+    quint32 blockSums[kChannels];
+
+    for (int blockY = startBlockY; blockY <= targetRect.bottom(); blockY += blockSize) {
+        const int rowBegin = qMax(blockY, 0);
+        const int rowEnd = qMin(blockY + blockSize, source.height());
+        if (rowBegin >= rowEnd) {
+            continue;
+        }
+
+        // Vertical pass: per-column channel sums over the block row.
+        std::fill(columnSums.begin(), columnSums.end(), 0u);
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const auto* row = reinterpret_cast<const quint32*>(source.constScanLine(y));
+            accumulateRow(row + sampleLeft, sampleWidth, columnSums.data());
+        }
+
+        // Horizontal pass: reduce column sums to one average per block.
+        for (int block = 0; block < blockColumns; ++block) {
+            const int blockX = startBlockX + block * blockSize;
+            const int columnBegin = qMax(blockX, sampleLeft);
+            const int columnEnd = qMin(blockX + blockSize, sampleRight);
+            blockCovered[static_cast<size_t>(block)] = columnBegin < columnEnd ? 1 : 0;
+            if (columnBegin >= columnEnd) {
+                continue;
+            }
+
+            reduceColumns(columnSums.data() + static_cast<size_t>(columnBegin - sampleLeft) * kChannels,
+                          columnEnd - columnBegin, blockSums);
+            const quint32 pixelCount =
+                static_cast<quint32>((columnEnd - columnBegin) * (rowEnd - rowBegin));
+            const QRgb average = qRgba(static_cast<int>(blockSums[2] / pixelCount),
+                                       static_cast<int>(blockSums[1] / pixelCount),
+                                       static_cast<int>(blockSums[0] / pixelCount),
+                                       static_cast<int>(blockSums[3] / pixelCount));
+            blockColors[static_cast<size_t>(block)] = premultiplied ? qUnpremultiply(average) : average;
+        }
+
+        // Fill the target rows of this block row.
+        const int fillTop = qMax(blockY, targetRect.top());
+        const int fillBottom = qMin(blockY + blockSize, targetRect.bottom() + 1);
+        for (int y = fillTop; y < fillBottom; ++y) {
+            auto* dest = reinterpret_cast<quint32*>(result.scanLine(y - targetRect.top()));
+            for (int block = 0; block < blockColumns; ++block) {
+                if (!blockCovered[static_cast<size_t>(block)]) {
+                    continue;
+                }
+                const int blockX = startBlockX + block * blockSize;
+                const int spanBegin = qMax(blockX, targetRect.left());
+                const int spanEnd = qMin(blockX + blockSize, targetRect.right() + 1);
+                fillSpan(dest + (spanBegin - targetRect.left()), spanEnd - spanBegin,
+                         blockColors[static_cast<size_t>(block)]);
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace PixelateKernel
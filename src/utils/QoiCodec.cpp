@@ -0,0 +1,172 @@
+#include "utils/QoiCodec.h"
+
+#include <QRgb>
+
+namespace {
+
+constexpr uchar kOpIndex = 0x00;
+constexpr uchar kOpDiff = 0x40;
+constexpr uchar kOpLuma = 0x80;
+constexpr uchar kOpRun = 0xc0;
+constexpr uchar kOpRgb = 0xfe;
+constexpr uchar kOpRgba = 0xff;
+constexpr uchar kOpMask = 0xc0;
+constexpr int kMaxRun = 62;
+
+inline int pixelHash(quint32 pixel)
+{
+    return (qRed(pixel) * 3 + qGreen(pixel) * 5 + qBlue(pixel) * 7 + qAlpha(pixel) * 11) % 64;
+}
+
+} // namespace
+
+namespace QoiCodec {
+
+uchar* Encoder::encode(const quint32* pixels, int count, uchar* out)
+{
+    quint32 previous = m_previous;
+    int run = m_run;
+
+    for (int i = 0; i < count; ++i) {
+        const quint32 pixel = pixels[i];
+        if (pixel == previous) {
+            if (++run == kMaxRun) {
+                *out++ = static_cast<uchar>(kOpRun | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            *out++ = static_cast<uchar>(kOpRun | (run - 1));
+            run = 0;
+        }
+
+        const int hash = pixelHash(pixel);
+        if (m_index[hash] == pixel) {
+            *out++ = static_cast<uchar>(kOpIndex | hash);
+        } else {
+            m_index[hash] = pixel;
+            if (qAlpha(pixel) == qAlpha(previous)) {
+                const auto dr = static_cast<signed char>(qRed(pixel) - qRed(previous));
+                const auto dg = static_cast<signed char>(qGreen(pixel) - qGreen(previous));
+                const auto db = static_cast<signed char>(qBlue(pixel) - qBlue(previous));
+                const auto drDg = static_cast<signed char>(dr - dg);
+                const auto dbDg = static_cast<signed char>(db - dg);
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    *out++ = static_cast<uchar>(kOpDiff | ((dr + 2) << 4) | ((dg + 2) << 2) |
+                                                (db + 2));
+                } else if (dg >= -32 && dg <= 31 && drDg >= -8 && drDg <= 7 &&
+                           dbDg >= -8 && dbDg <= 7) {
+                    *out++ = static_cast<uchar>(kOpLuma | (dg + 32));
+                    *out++ = static_cast<uchar>(((drDg + 8) << 4) | (dbDg + 8));
+                } else {
+                    *out++ = kOpRgb;
+                    *out++ = static_cast<uchar>(qRed(pixel));
+                    *out++ = static_cast<uchar>(qGreen(pixel));
+                    *out++ = static_cast<uchar>(qBlue(pixel));
+                }
+            } else {
+                *out++ = kOpRgba;
+                *out++ = static_cast<uchar>(qRed(pixel));
+                *out++ = static_cast<uchar>(qGreen(pixel));
+                *out++ = static_cast<uchar>(qBlue(pixel));
+                *out++ = static_cast<uchar>(qAlpha(pixel));
+            }
+        }
+        previous = pixel;
+    }
+
+    m_previous = previous;
+    m_run = run;
+    return out;
+}
+
+uchar* Encoder::finish(uchar* out)
+{
+    if (m_run > 0) {
+        *out++ = static_cast<uchar>(kOpRun | (m_run - 1));
+        m_run = 0;
+    }
+    return out;
+}
+
+bool Decoder::decode(const uchar** input, const uchar* end, quint32* pixels, int count)
+{
+    const uchar* in = *input;
+    quint32 previous = m_previous;
+    bool ok = true;
+
+    int i = 0;
+    for (; i < count; ++i) {
+        if (m_run > 0) {
+            --m_run;
+            pixels[i] = previous;
+            continue;
+        }
+        if (in >= end) {
+            ok = false;
+            break;
+        }
+
+        const uchar op = *in++;
+        quint32 pixel = previous;
+        if (op == kOpRgb) {
+            if (end - in < 3) {
+                ok = false;
+                break;
+            }
+            pixel = qRgba(in[0], in[1], in[2], qAlpha(previous));
+            in += 3;
+            m_index[pixelHash(pixel)] = pixel;
+        } else if (op == kOpRgba) {
+            if (end - in < 4) {
+                ok = false;
+                break;
+            }
+            pixel = qRgba(in[0], in[1], in[2], in[3]);
+            in += 4;
+            m_index[pixelHash(pixel)] = pixel;
+        } else {
+            switch (op & kOpMask) {
+            case kOpIndex:
+                pixel = m_index[op];
+                break;
+            case kOpDiff:
+                pixel = qRgba((qRed(previous) + ((op >> 4) & 0x03) - 2) & 0xff,
+                              (qGreen(previous) + ((op >> 2) & 0x03) - 2) & 0xff,
+                              (qBlue(previous) + (op & 0x03) - 2) & 0xff,
+                              qAlpha(previous));
+                m_index[pixelHash(pixel)] = pixel;
+                break;
+            case kOpLuma: {
+                if (in >= end) {
+                    ok = false;
+                    break;
+                }
+                const uchar second = *in++;
+                const int dg = (op & 0x3f) - 32;
+                pixel = qRgba((qRed(previous) + dg - 8 + ((second >> 4) & 0x0f)) & 0xff,
+                              (qGreen(previous) + dg) & 0xff,
+                              (qBlue(previous) + dg - 8 + (second & 0x0f)) & 0xff,
+                              qAlpha(previous));
+                m_index[pixelHash(pixel)] = pixel;
+                break;
+            }
+            case kOpRun:
+                m_run = op & 0x3f;
+                break;
+            }
+            if (!ok) {
+                break;
+            }
+        }
+        pixels[i] = pixel;
+        previous = pixel;
+    }
+
+    m_previous = previous;
+    *input = in;
+    return ok;
+}
+
+} // namespace QoiCodec
@@ -28,8 +28,145 @@ struct AVFoundationSeekState {
     AVFoundationPlayer *player = nullptr;
 };
 
+// Deep-copies a BGRA pixel buffer into a QImage.
+QImage imageFromPixelBuffer(CVPixelBufferRef pixelBuffer)
+{
+    if (!pixelBuffer) {
+        return QImage();
+    }
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+
+    size_t width = CVPixelBufferGetWidth(pixelBuffer);
+    size_t height = CVPixelBufferGetHeight(pixelBuffer);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
+    void *baseAddress = CVPixelBufferGetBaseAddress(pixelBuffer);
+
+    // Create QImage from pixel buffer (BGRA format)
+    QImage image((const uchar *)baseAddress, (int)width, (int)height,
+                 (int)bytesPerRow, QImage::Format_ARGB32);
+    QImage result = image.copy();  // Deep copy before unlocking
+
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    return result;
+}
+
 } // namespace
 
+// Decodes a time range with AVAssetReader, which seeks once and then reads
+// samples in order as fast as the callback accepts them.
+class AVFoundationSequentialDecoder : public QThread
+{
+    Q_OBJECT
+
+public:
+    AVFoundationSequentialDecoder(AVAsset *asset, qint64 startMs, qint64 endMs,
+                                  IVideoPlayer::SequentialFrameCallback callback,
+                                  QObject *parent = nullptr)
+        : QThread(parent)
+        , m_asset(asset)
+        , m_startMs(startMs)
+        , m_endMs(endMs)
+        , m_callback(std::move(callback))
+    {}
+
+    // Blocks while the callback is running; it is not called again afterwards.
+    void cancel()
+    {
+        QMutexLocker locker(&m_callbackMutex);
+        m_callback = nullptr;
+    }
+
+signals:
+    void decodeFinished();
+    void decodeFailed(const QString &message);
+
+protected:
+    void run() override
+    {
+        @autoreleasepool {
+            AVAssetTrack *track = [[m_asset tracksWithMediaType:AVMediaTypeVideo] firstObject];
+            if (!track) {
+                emit decodeFailed(QStringLiteral("No video track to decode"));
+                return;
+            }
+
+            NSError *readerError = nil;
+            AVAssetReader *reader = [AVAssetReader assetReaderWithAsset:m_asset error:&readerError];
+            if (!reader) {
+                emit decodeFailed(readerError ? QString::fromNSString(readerError.localizedDescription)
+                                              : QStringLiteral("Failed to create asset reader"));
+                return;
+            }
+
+            NSDictionary *outputSettings = @{
+                (NSString *)kCVPixelBufferPixelFormatTypeKey: @(kCVPixelFormatType_32BGRA)
+            };
+            AVAssetReaderTrackOutput *output =
+                [AVAssetReaderTrackOutput assetReaderTrackOutputWithTrack:track
+                                                           outputSettings:outputSettings];
+            output.alwaysCopiesSampleData = NO;
+            if (![reader canAddOutput:output]) {
+                emit decodeFailed(QStringLiteral("Failed to configure asset reader output"));
+                return;
+            }
+            [reader addOutput:output];
+            reader.timeRange = CMTimeRangeFromTimeToTime(CMTimeMake(m_startMs, 1000),
+                                                         CMTimeMake(m_endMs, 1000));
+
+            if (![reader startReading]) {
+                emit decodeFailed(reader.error ? QString::fromNSString(reader.error.localizedDescription)
+                                               : QStringLiteral("Failed to start asset reader"));
+                return;
+            }
+
+            bool stopped = false;
+            while (!stopped) {
+                @autoreleasepool {
+                    CMSampleBufferRef sampleBuffer = [output copyNextSampleBuffer];
+                    if (!sampleBuffer) {
+                        break;
+                    }
+
+                    const CMTime presentationTime = CMSampleBufferGetPresentationTimeStamp(sampleBuffer);
+                    const qint64 timestampMs = CMTIME_IS_NUMERIC(presentationTime)
+                        ? static_cast<qint64>(CMTimeGetSeconds(presentationTime) * 1000.0)
+                        : m_startMs;
+                    const QImage frame = imageFromPixelBuffer(CMSampleBufferGetImageBuffer(sampleBuffer));
+                    CFRelease(sampleBuffer);
+
+                    if (!frame.isNull() && timestampMs < m_endMs) {
+                        QMutexLocker locker(&m_callbackMutex);
+                        stopped = !m_callback || !m_callback(frame, timestampMs);
+                    }
+                }
+            }
+
+            {
+                QMutexLocker locker(&m_callbackMutex);
+                m_callback = nullptr;
+            }
+
+            if (stopped) {
+                [reader cancelReading];
+                emit decodeFinished();
+            } else if (reader.status == AVAssetReaderStatusFailed) {
+                emit decodeFailed(reader.error ? QString::fromNSString(reader.error.localizedDescription)
+                                               : QStringLiteral("Asset reader failed"));
+            } else {
+                emit decodeFinished();
+            }
+        }
+    }
+
+private:
+    AVAsset *m_asset;
+    qint64 m_startMs;
+    qint64 m_endMs;
+    QMutex m_callbackMutex;
+    IVideoPlayer::SequentialFrameCallback m_callback;
+};
+
 // Objective-C helper class for KVO and notifications
 @interface AVFoundationPlayerHelper : NSObject
 @property (nonatomic, assign) AVFoundationPlayer *player;
@@ -77,6 +214,11 @@ public:
     double frameRate() const override { return m_frameIntervalMs > 0 ? 1000.0 / m_frameIntervalMs : 30.0; }
     int frameIntervalMs() const override { return m_frameIntervalMs; }
 
+    bool supportsSequentialDecode() const override { return true; }
+    bool startSequentialDecode(qint64 startMs, qint64 endMs,
+                               SequentialFrameCallback callback) override;
+    void stopSequentialDecode() override;
+
     // Called from Objective-C helper
     void onStatusChanged(int status);
     void onTimeUpdate(qint64 timeMs);
@@ -90,6 +232,8 @@ private:
     std::shared_ptr<AVFoundationSeekState> m_seekState;
     AVFoundationPlayerHelper *m_helper;
     QTimer *m_frameTimer;
+    AVFoundationSequentialDecoder *m_sequentialDecoder = nullptr;
+    quint64 m_sequentialGeneration = 0;
 
     State m_state;
     qint64 m_duration;
@@ -206,21 +350,8 @@ private:
         return QImage();
     }
 
-    CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
-
-    size_t width = CVPixelBufferGetWidth(pixelBuffer);
-    size_t height = CVPixelBufferGetHeight(pixelBuffer);
-    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(pixelBuffer);
-    void *baseAddress = CVPixelBufferGetBaseAddress(pixelBuffer);
-
-    // Create QImage from pixel buffer (BGRA format)
-    QImage image((const uchar *)baseAddress, (int)width, (int)height,
-                 (int)bytesPerRow, QImage::Format_ARGB32);
-    QImage result = image.copy();  // Deep copy before unlocking
-
-    CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    QImage result = imageFromPixelBuffer(pixelBuffer);
     CVPixelBufferRelease(pixelBuffer);
-
     return result;
 }
 
@@ -260,6 +391,7 @@ AVFoundationPlayer::~AVFoundationPlayer()
         QMutexLocker locker(&m_seekState->mutex);
         m_seekState->player = nullptr;
     }
+    stopSequentialDecode();
     m_frameTimer->stop();
     m_helper.player = nullptr;
     [m_helper cleanup];
@@ -270,6 +402,7 @@ AVFoundationPlayer::~AVFoundationPlayer()
 bool AVFoundationPlayer::load(const QString &filePath)
 {
     // Cleanup previous player
+    stopSequentialDecode();
     [m_helper cleanup];
     m_hasVideo = false;
     m_hasAudio = false;
@@ -388,6 +521,53 @@ void AVFoundationPlayer::deliverSeekFrame()
     emit frameReady(frame);
 }
 
+bool AVFoundationPlayer::startSequentialDecode(qint64 startMs, qint64 endMs,
+                                               SequentialFrameCallback callback)
+{
+    AVAsset *asset = m_helper.avPlayer.currentItem.asset;
+    if (!asset || !m_hasVideo || !callback || endMs <= startMs) {
+        return false;
+    }
+
+    stopSequentialDecode();
+    if (m_state == State::Playing) {
+        pause();
+    }
+
+    const quint64 generation = ++m_sequentialGeneration;
+    m_sequentialDecoder = new AVFoundationSequentialDecoder(
+        asset, qMax<qint64>(0, startMs), endMs, std::move(callback), this);
+    // Queued: the decoder emits from its own thread. The generation drops
+    // completions that were already queued when the decode was stopped.
+    connect(m_sequentialDecoder, &AVFoundationSequentialDecoder::decodeFinished, this,
+            [this, generation]() {
+                if (generation == m_sequentialGeneration) {
+                    emit sequentialDecodeFinished();
+                }
+            }, Qt::QueuedConnection);
+    connect(m_sequentialDecoder, &AVFoundationSequentialDecoder::decodeFailed, this,
+            [this, generation](const QString &message) {
+                if (generation == m_sequentialGeneration) {
+                    emit error(message);
+                }
+            }, Qt::QueuedConnection);
+    m_sequentialDecoder->start();
+    return true;
+}
+
+void AVFoundationPlayer::stopSequentialDecode()
+{
+    ++m_sequentialGeneration;
+    if (!m_sequentialDecoder) {
+        return;
+    }
+
+    m_sequentialDecoder->cancel();
+    m_sequentialDecoder->wait();
+    delete m_sequentialDecoder;
+    m_sequentialDecoder = nullptr;
+}
+
 void AVFoundationPlayer::setVolume(float volume)
 {
     m_volume = qBound(0.0f, volume, 1.0f);
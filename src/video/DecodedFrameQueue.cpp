@@ -0,0 +1,59 @@
+#include "video/DecodedFrameQueue.h"
+
+#include <QMutexLocker>
+
+DecodedFrameQueue::DecodedFrameQueue(int capacity)
+    : m_capacity(qMax(capacity, 1))
+{
+}
+
+bool DecodedFrameQueue::push(const QImage& image, qint64 timestampMs)
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_aborted && static_cast<int>(m_frames.size()) >= m_capacity) {
+        m_notFull.wait(&m_mutex);
+    }
+    if (m_aborted || m_closed) {
+        return false;
+    }
+    m_frames.push_back({image, timestampMs});
+    return true;
+}
+
+void DecodedFrameQueue::close()
+{
+    QMutexLocker locker(&m_mutex);
+    m_closed = true;
+}
+
+bool DecodedFrameQueue::tryPop(Frame& frame)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_frames.empty()) {
+        return false;
+    }
+    frame = std::move(m_frames.front());
+    m_frames.pop_front();
+    m_notFull.wakeOne();
+    return true;
+}
+
+void DecodedFrameQueue::abort()
+{
+    QMutexLocker locker(&m_mutex);
+    m_aborted = true;
+    m_frames.clear();
+    m_notFull.wakeAll();
+}
+
+bool DecodedFrameQueue::isDrained() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_closed && m_frames.empty();
+}
+
+int DecodedFrameQueue::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_frames.size());
+}
@@ -148,11 +148,35 @@ public:
         m_waitingAtEndOfStream = false;
         m_wakeCondition.wakeAll();
     }
+    void requestSequentialDecode(quint64 decodeId, qint64 startMs, qint64 endMs,
+                                 IVideoPlayer::SequentialFrameCallback callback) {
+        {
+            QMutexLocker callbackLocker(&m_sequentialMutex);
+            m_sequentialCallback = std::move(callback);
+            m_sequentialCallbackId = decodeId;
+        }
+        QMutexLocker locker(&m_waitMutex);
+        m_sequentialId = decodeId;
+        m_sequentialStartMs = startMs;
+        m_sequentialEndMs = endMs;
+        m_sequentialRequested = true;
+        m_paused = true;
+        m_waitingAtEndOfStream = false;
+        m_wakeCondition.wakeAll();
+    }
+    // Blocks while the callback is running; it is not called again afterwards.
+    void cancelSequentialDecode() {
+        m_sequentialRequested = false;
+        QMutexLocker locker(&m_sequentialMutex);
+        m_sequentialCallback = nullptr;
+        m_sequentialCallbackId = 0;
+    }
 
 signals:
     void frameReady(const QImage &frame, qint64 timestampMs);
     void endOfStream();
     void errorOccurred(const QString &message);
+    void sequentialDecodeFinished(quint64 decodeId);
 
 protected:
     void run() override
@@ -176,6 +200,15 @@ protected:
                 continue;
             }
 
+            // Sequential decode owns the reader until the range is done or
+            // cancelled, then leaves the thread paused.
+            if (m_sequentialRequested.exchange(false)) {
+                if (!runSequentialDecode()) {
+                    break;
+                }
+                continue;
+            }
+
             // A seek while paused is also a request for one frame. Process it
             // before the pause gate, then keep reading until one is delivered.
             const bool seekRequested = m_seekRequested.exchange(false);
@@ -201,7 +234,7 @@ protected:
                 // a seek would only read EOF repeatedly, so wait specifically
                 // for a seek (or shutdown) before touching the reader again.
                 QMutexLocker locker(&m_waitMutex);
-                if (!m_stopRequested && !m_seekRequested
+                if (!m_stopRequested && !m_seekRequested && !m_sequentialRequested
                     && (waitingForSeekAfterEndOfStream
                         || (m_paused && !framePendingAfterSeek))) {
                     m_wakeCondition.wait(&m_waitMutex);
@@ -287,6 +320,106 @@ protected:
     }
 
 private:
+    // Seeks once, then reads samples back to back and hands every frame
+    // visible in the requested range to the callback. Returns false after a
+    // reader failure, which ends the thread like a failed ReadSample does.
+    bool runSequentialDecode()
+    {
+        quint64 decodeId = 0;
+        qint64 startMs = 0;
+        qint64 endMs = 0;
+        {
+            QMutexLocker locker(&m_waitMutex);
+            decodeId = m_sequentialId;
+            startMs = m_sequentialStartMs;
+            endMs = m_sequentialEndMs;
+        }
+
+        PROPVARIANT var;
+        PropVariantInit(&var);
+        var.vt = VT_I8;
+        var.hVal.QuadPart = startMs * 10000;
+        const HRESULT seekHr = m_reader->SetCurrentPosition(GUID_NULL, var);
+        PropVariantClear(&var);
+        if (FAILED(seekHr)) {
+            emit errorOccurred(QString("SetCurrentPosition failed: 0x%1")
+                                   .arg(seekHr, 8, 16, QChar('0')));
+            return false;
+        }
+
+        while (!m_stopRequested && !m_sequentialRequested) {
+            DWORD streamIndex = 0;
+            DWORD flags = 0;
+            LONGLONG timestamp = 0;
+            IMFSample *sample = nullptr;
+
+            const HRESULT hr = m_reader->ReadSample(
+                MF_SOURCE_READER_FIRST_VIDEO_STREAM,
+                0,
+                &streamIndex,
+                &flags,
+                &timestamp,
+                &sample);
+
+            if (FAILED(hr) || (flags & MF_SOURCE_READERF_ERROR)) {
+                if (sample) {
+                    sample->Release();
+                }
+                emit errorOccurred(FAILED(hr)
+                    ? QString("ReadSample failed: 0x%1").arg(hr, 8, 16, QChar('0'))
+                    : QString("Source reader reported an error while reading a video sample"));
+                return false;
+            }
+
+            if (flags & MF_SOURCE_READERF_ENDOFSTREAM) {
+                if (sample) {
+                    sample->Release();
+                }
+                break;
+            }
+
+            if (!sample) {
+                continue;
+            }
+
+            // The reader resumes from the keyframe before startMs; frames that
+            // end before the range are decoded only to reach it.
+            const qint64 timestampMs = timestamp / 10000;
+            if (timestampMs >= endMs) {
+                sample->Release();
+                break;
+            }
+            if (timestampMs + m_frameIntervalMs <= startMs) {
+                sample->Release();
+                continue;
+            }
+
+            const QImage frame = extractFrame(sample);
+            sample->Release();
+            if (frame.isNull()) {
+                continue;
+            }
+
+            // A newer request may already have installed its callback;
+            // frames of this decode must not reach it.
+            QMutexLocker locker(&m_sequentialMutex);
+            if (m_sequentialCallbackId != decodeId || !m_sequentialCallback
+                || !m_sequentialCallback(frame, timestampMs)) {
+                break;
+            }
+        }
+
+        {
+            QMutexLocker locker(&m_sequentialMutex);
+            if (m_sequentialCallbackId == decodeId) {
+                m_sequentialCallback = nullptr;
+                m_sequentialCallbackId = 0;
+            }
+        }
+        emit sequentialDecodeFinished(decodeId);
+        return true;
+    }
+
     QImage extractFrame(IMFSample *sample)
     {
         IMFMediaBuffer *buffer = nullptr;
@@ -427,6 +560,15 @@ private:
     std::atomic<bool> m_waitingAtEndOfStream{false};
     QMutex m_waitMutex;
     QWaitCondition m_wakeCondition;
+
+    // Sequential decode request; id and range are guarded by m_waitMutex
+    std::atomic<bool> m_sequentialRequested{false};
+    quint64 m_sequentialId = 0;
+    qint64 m_sequentialStartMs = 0;
+    qint64 m_sequentialEndMs = 0;
+    QMutex m_sequentialMutex;
+    IVideoPlayer::SequentialFrameCallback m_sequentialCallback;
+    quint64 m_sequentialCallbackId = 0;   // Request the callback belongs to
 };
 
 // MediaFoundationPlayer implementation using IMFSourceReader with background thread
@@ -466,10 +608,16 @@ public:
     double frameRate() const override { return m_frameIntervalMs > 0 ? 1000.0 / m_frameIntervalMs : 30.0; }
     int frameIntervalMs() const override { return m_frameIntervalMs; }
 
+    bool supportsSequentialDecode() const override { return true; }
+    bool startSequentialDecode(qint64 startMs, qint64 endMs,
+                               SequentialFrameCallback callback) override;
+    void stopSequentialDecode() override;
+
 private slots:
     void onFrameReady(const QImage &frame, qint64 timestampMs);
     void onEndOfStream();
     void onReaderError(const QString &message);
+    void onSequentialDecodeFinished(quint64 decodeId);
 
 private:
     void cleanup();
@@ -504,6 +652,8 @@ private:
     float m_playbackRate = 1.0f;
     bool m_mfInitialized = false;
     quint64 m_readerGeneration = 0;
+    quint64 m_sequentialDecodeId = 0;   // 0 when no sequential decode is active
+    quint64 m_nextSequentialDecodeId = 0;
 
     // Frame timing
     int m_frameIntervalMs = 33;
@@ -543,6 +693,8 @@ MediaFoundationPlayer::~MediaFoundationPlayer()
 void MediaFoundationPlayer::stopReaderThread()
 {
     if (m_readerThread) {
+        m_readerThread->cancelSequentialDecode();
+        m_sequentialDecodeId = 0;
         m_readerThread->requestStop();
         m_readerThread->wait(1000);
         if (m_readerThread->isRunning()) {
@@ -640,6 +792,12 @@ bool MediaFoundationPlayer::load(const QString &filePath)
                     onReaderError(message);
                 }
             }, Qt::QueuedConnection);
+    connect(m_readerThread, &FrameReaderThread::sequentialDecodeFinished, this,
+            [this, readerGeneration](quint64 decodeId) {
+                if (readerGeneration == m_readerGeneration) {
+                    onSequentialDecodeFinished(decodeId);
+                }
+            }, Qt::QueuedConnection);
 
     m_readerThread->start();
 
@@ -1027,6 +1185,45 @@ void MediaFoundationPlayer::setPlaybackRate(float rate)
     emit playbackRateChanged(newRate);
 }
 
+bool MediaFoundationPlayer::startSequentialDecode(qint64 startMs, qint64 endMs,
+                                                  SequentialFrameCallback callback)
+{
+    if (!m_readerThread || !m_hasVideo || !callback || endMs <= startMs) {
+        return false;
+    }
+
+    qDebug() << "MediaFoundationPlayer: Sequential decode from" << startMs << "to" << endMs << "ms";
+
+    m_readerThread->cancelSequentialDecode();
+    m_positionTimer->stop();
+    m_atEndOfStream = false;
+    setState(State::Paused);
+
+    m_sequentialDecodeId = ++m_nextSequentialDecodeId;
+    m_readerThread->requestSequentialDecode(m_sequentialDecodeId, qMax<qint64>(0, startMs), endMs,
+                                            std::move(callback));
+    return true;
+}
+
+void MediaFoundationPlayer::stopSequentialDecode()
+{
+    if (m_readerThread) {
+        m_readerThread->cancelSequentialDecode();
+    }
+    m_sequentialDecodeId = 0;
+}
+
+void MediaFoundationPlayer::onSequentialDecodeFinished(quint64 decodeId)
+{
+    // Ignore completions of cancelled or superseded requests.
+    if (decodeId == 0 || decodeId != m_sequentialDecodeId) {
+        return;
+    }
+
+    m_sequentialDecodeId = 0;
+    emit sequentialDecodeFinished();
+}
+
 void MediaFoundationPlayer::onFrameReady(const QImage &frame, qint64 timestampMs)
 {
     m_atEndOfStream = false;
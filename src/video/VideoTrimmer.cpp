@@ -1,4 +1,5 @@
 #include "video/VideoTrimmer.h"
+#include "video/DecodedFrameQueue.h"
 #include "video/IVideoPlayer.h"
 #include "IVideoEncoder.h"
 #include "encoding/NativeGifEncoder.h"
@@ -7,12 +8,18 @@
 
 #include <QDebug>
 #include <QTimer>
+#include <QFile>
 #include <QFileInfo>
+#include <QFutureWatcher>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentRun>
 
 namespace {
 constexpr int kFrameExtractionTimeoutMs = 5000;
 constexpr int kFrameEncodingTimeoutMs = 5000;
 constexpr int kEncoderRetryIntervalMs = 10;
+// Decoded frames buffered ahead of the encoder during sequential decode
+constexpr int kDecodeQueueCapacity = 8;
 }
 
 VideoTrimmer::VideoTrimmer(QObject *parent)
@@ -85,8 +92,16 @@ void VideoTrimmer::startTrim()
     m_waitingForEncoder = false;
     m_pendingFrame = QImage();
     m_pendingTimestamp = 0;
+    m_sequential = false;
+    m_decodeFinished = false;
+    m_lastEncodedTimestamp = 0;
+    m_elapsed.invalidate();
     m_frameTimeout->stop();
 
+    if (startContainerTrim()) {
+        return;
+    }
+
     // Create video player to extract frames
     m_player = IVideoPlayer::create(this);
     if (!m_player) {
@@ -120,6 +135,72 @@ void VideoTrimmer::startTrim()
     // Wait for mediaLoaded signal before proceeding
 }
 
+bool VideoTrimmer::startContainerTrim()
+{
+    const AnimationTrimmer::Format container = AnimationTrimmer::detectFileFormat(m_inputPath);
+    const bool sameFormat =
+        (container == AnimationTrimmer::Format::Gif && m_format == EncoderFactory::Format::GIF)
+        || (container == AnimationTrimmer::Format::WebP && m_format == EncoderFactory::Format::WebP);
+    if (!sameFormat) {
+        return false;
+    }
+
+    qDebug() << "VideoTrimmer: Trimming animation container without re-encoding";
+
+    // The trim runs in memory and only the trimmer writes the output, once
+    // it knows the trim is still current. A cancelled trim, or one whose
+    // trimmer is gone, leaves nothing on disk.
+    const QString inputPath = m_inputPath;
+    const QString outputPath = m_outputPath;
+    const qint64 startMs = m_trimStart;
+    const qint64 endMs = m_trimEnd;
+
+    m_elapsed.start();
+    auto *watcher = new QFutureWatcher<ContainerTrimOutput>(this);
+    m_containerTrim = watcher;
+    connect(watcher, &QFutureWatcher<ContainerTrimOutput>::finished,
+            this, [this, watcher, outputPath]() {
+        const ContainerTrimOutput output = watcher->result();
+        watcher->deleteLater();
+        if (watcher != m_containerTrim) {
+            return;
+        }
+        m_containerTrim = nullptr;
+
+        if (!output.result.success) {
+            failTrim(output.result.errorMessage);
+            return;
+        }
+
+        // QSaveFile replaces the output only once the new contents are
+        // complete; on failure the previous file is left as it was.
+        QSaveFile outputFile(outputPath);
+        if (!outputFile.open(QIODevice::WriteOnly)
+            || outputFile.write(output.data) != output.data.size()
+            || !outputFile.commit()) {
+            failTrim(tr("Cannot write %1: %2").arg(outputPath, outputFile.errorString()));
+            return;
+        }
+
+        m_running = false;
+        const double seconds = qMax<qint64>(1, m_elapsed.elapsed()) / 1000.0;
+        emit progress(100, output.result.framesWritten / seconds);
+        emit finished(true, outputPath);
+    });
+    watcher->setFuture(QtConcurrent::run([inputPath, startMs, endMs]() {
+        ContainerTrimOutput output;
+        QFile inputFile(inputPath);
+        if (!inputFile.open(QIODevice::ReadOnly)) {
+            output.result.errorMessage = QObject::tr("Cannot open %1: %2")
+                                             .arg(inputPath, inputFile.errorString());
+            return output;
+        }
+        output.result = AnimationTrimmer::trim(inputFile.readAll(), startMs, endMs, &output.data);
+        return output;
+    }));
+    return true;
+}
+
 void VideoTrimmer::onMediaLoaded()
 {
     if (m_cancelled || !m_running) {
@@ -180,6 +261,13 @@ void VideoTrimmer::onMediaLoaded()
                 this, &VideoTrimmer::onEncodingFinished);
     }
 
+    m_elapsed.start();
+
+    // Decode forward from a single seek when the backend supports it
+    if (startSequentialDecode()) {
+        return;
+    }
+
     // Initialize seek position to start - we'll extract first frame at m_trimStart
     m_seekPosition = m_trimStart;
     m_currentPosition = m_trimStart;
@@ -194,6 +282,7 @@ void VideoTrimmer::cancel()
         qDebug() << "VideoTrimmer: Cancelled";
         m_cancelled = true;
         m_running = false;
+        m_containerTrim = nullptr;
         m_waitingForFrame = false;
         m_waitingForEncoder = false;
         m_pendingFrame = QImage();
@@ -205,7 +294,7 @@ void VideoTrimmer::cancel()
 
 void VideoTrimmer::onFrameReady(const QImage &frame)
 {
-    if (m_cancelled || !m_running || !m_waitingForFrame) {
+    if (m_cancelled || !m_running || !m_waitingForFrame || m_sequential) {
         return;
     }
 
@@ -287,13 +376,20 @@ void VideoTrimmer::completeCurrentFrame()
     m_frameTimeout->stop();
     m_frameCount++;
 
-    // Update progress
-    int percent = (m_frameCount * 100) / m_totalFrames;
+    // Update progress. Sequential decode follows frame timestamps, which
+    // also covers variable frame rate input.
+    int percent = m_sequential
+        ? static_cast<int>((m_lastEncodedTimestamp * 100) / (m_trimEnd - m_trimStart))
+        : (m_frameCount * 100) / m_totalFrames;
     percent = qBound(0, percent, 99);  // Never show 100% until finished
-    emit progress(percent);
+    emit progress(percent, encodedFramesPerSecond());
 
     // Process next frame
-    QTimer::singleShot(0, this, &VideoTrimmer::processNextFrame);
+    if (m_sequential) {
+        scheduleDecodedFrame();
+    } else {
+        QTimer::singleShot(0, this, &VideoTrimmer::processNextFrame);
+    }
 }
 
 void VideoTrimmer::processNextFrame()
@@ -306,16 +402,7 @@ void VideoTrimmer::processNextFrame()
     m_currentPosition += qMax(1, m_player->frameIntervalMs());
 
     if (m_currentPosition >= m_trimEnd) {
-        // Finished extracting frames
-        qDebug() << "VideoTrimmer: Frame extraction complete, finalizing...";
-
-        if (m_videoEncoder) {
-            m_videoEncoder->finish();
-        } else if (m_gifEncoder) {
-            m_gifEncoder->finish();
-        } else if (m_webpEncoder) {
-            m_webpEncoder->finish();
-        }
+        finishEncoding();
         return;
     }
 
@@ -328,6 +415,126 @@ void VideoTrimmer::processNextFrame()
     }
 }
 
+bool VideoTrimmer::startSequentialDecode()
+{
+    if (!m_player->supportsSequentialDecode()) {
+        return false;
+    }
+
+    connect(m_player, &IVideoPlayer::sequentialDecodeFinished,
+            this, &VideoTrimmer::onSequentialDecodeFinished, Qt::UniqueConnection);
+
+    // The callback runs on the decoder thread. A full queue blocks it in
+    // push(), which keeps decoding at most a queue's worth ahead of encoding.
+    auto queue = std::make_shared<DecodedFrameQueue>(kDecodeQueueCapacity);
+    const bool started = m_player->startSequentialDecode(
+        m_trimStart, m_trimEnd,
+        [this, queue](const QImage &frame, qint64 timestampMs) {
+            if (!queue->push(frame, timestampMs)) {
+                return false;
+            }
+            scheduleDecodedFrame();
+            return true;
+        });
+    if (!started) {
+        qWarning() << "VideoTrimmer: Sequential decode unavailable, seeking per frame";
+        return false;
+    }
+
+    qDebug() << "VideoTrimmer: Sequential decode started";
+    m_frameQueue = queue;
+    m_sequential = true;
+    m_decodeFinished = false;
+    m_waitingForFrame = true;
+    m_frameTimeout->start(kFrameExtractionTimeoutMs);
+    return true;
+}
+
+void VideoTrimmer::stopSequentialDecode()
+{
+    // Release a decoder blocked on a full queue before waiting for it.
+    if (m_frameQueue) {
+        m_frameQueue->abort();
+        m_frameQueue.reset();
+    }
+    if (m_sequential && m_player) {
+        m_player->stopSequentialDecode();
+    }
+    m_sequential = false;
+    m_decodeFinished = false;
+}
+
+void VideoTrimmer::scheduleDecodedFrame()
+{
+    // Called from both threads; coalesces wakeups into one queued call.
+    if (!m_decodedFrameScheduled.exchange(true)) {
+        QMetaObject::invokeMethod(this, &VideoTrimmer::processDecodedFrame,
+                                  Qt::QueuedConnection);
+    }
+}
+
+void VideoTrimmer::processDecodedFrame()
+{
+    m_decodedFrameScheduled = false;
+    if (m_cancelled || !m_running || !m_sequential || !m_frameQueue || m_waitingForEncoder) {
+        return;
+    }
+
+    DecodedFrameQueue::Frame frame;
+    if (!m_frameQueue->tryPop(frame)) {
+        if (m_decodeFinished) {
+            finishEncoding();
+        } else if (!m_waitingForFrame) {
+            m_waitingForFrame = true;
+            m_frameTimeout->start(kFrameExtractionTimeoutMs);
+        }
+        return;
+    }
+
+    m_waitingForFrame = false;
+    m_frameTimeout->stop();
+
+    // The frame covering the range start may begin before it.
+    const qint64 timestampMs = qMax<qint64>(0, frame.timestampMs - m_trimStart);
+    if (m_frameCount > 0 && timestampMs <= m_lastEncodedTimestamp) {
+        scheduleDecodedFrame();
+        return;
+    }
+
+    m_lastEncodedTimestamp = timestampMs;
+    submitFrame(frame.image, timestampMs);
+}
+
+void VideoTrimmer::onSequentialDecodeFinished()
+{
+    if (m_cancelled || !m_running || !m_sequential || !m_frameQueue) {
+        return;
+    }
+
+    m_decodeFinished = true;
+    m_frameQueue->close();
+    scheduleDecodedFrame();
+}
+
+void VideoTrimmer::finishEncoding()
+{
+    qDebug() << "VideoTrimmer: Frame extraction complete, finalizing..."
+             << m_frameCount << "frames at" << encodedFramesPerSecond() << "fps"
+             << (m_sequential ? "(sequential)" : "(per-frame seek)");
+
+    m_waitingForFrame = false;
+    m_frameTimeout->stop();
+    m_frameQueue.reset();
+
+    if (m_videoEncoder) {
+        m_videoEncoder->finish();
+    } else if (m_gifEncoder) {
+        m_gifEncoder->finish();
+    } else if (m_webpEncoder) {
+        m_webpEncoder->finish();
+    }
+}
+
 void VideoTrimmer::onEncodingFinished(bool success, const QString &path)
 {
     qDebug() << "VideoTrimmer: Encoding finished, success:" << success;
@@ -339,7 +546,7 @@ void VideoTrimmer::onEncodingFinished(bool success, const QString &path)
         && outputInfo.exists() && outputInfo.size() > 0;
 
     if (validOutput) {
-        emit progress(100);
+        emit progress(100, encodedFramesPerSecond());
         emit finished(true, path);
     } else {
         emit error(tr("Encoding failed"));
@@ -392,6 +599,14 @@ void VideoTrimmer::abortEncoders()
     }
 }
 
+double VideoTrimmer::encodedFramesPerSecond() const
+{
+    if (!m_elapsed.isValid()) {
+        return 0.0;
+    }
+    return m_frameCount * 1000.0 / qMax<qint64>(1, m_elapsed.elapsed());
+}
+
 qint64 VideoTrimmer::encoderFramesWritten() const
 {
     if (m_videoEncoder) {
@@ -408,6 +623,7 @@ qint64 VideoTrimmer::encoderFramesWritten() const
 
 void VideoTrimmer::cleanup()
 {
+    stopSequentialDecode();
     m_waitingForFrame = false;
     m_waitingForEncoder = false;
     m_pendingFrame = QImage();
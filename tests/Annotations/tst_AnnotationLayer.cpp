@@ -21,11 +21,16 @@ private slots:
     void testDrawCached_RebuildsAfterExcludeCache();
     void testDrawCached_RebuildsAfterDraggedItemMoved();
     void testDrawCached_AppliesViewportOrigin();
+    void testDrawCached_UndoRepaintsOnlyAffectedTiles();
+    void testDrawCached_IncrementalTilesMatchFullRebuild();
+    void testCommitDirtyRegion_RepaintsDirtyTiles();
+    void testDirtyRegionDrag_ReusesFullCacheAndMatchesRebuild();
     void testHitTestText_IgnoresHiddenItems();
     void testHitTestEmojiSticker_IgnoresHiddenItems();
     void testHitTestEmojiSticker_ReturnsTopMostVisible();
     void testHitTestShape_IgnoresHiddenItems();
     void testHitTestShape_ReturnsTopMostVisible();
+    void testHitTestShape_TracksMovesUndoAndTranslate();
     void testSetSelectedIndex_InvalidOrHiddenClearsSelection();
     void testTranslateAll_AlsoTranslatesRedoStackItems();
     void testTranslateAll_TranslatesErasedItemsGroupContents();
@@ -37,6 +42,7 @@ private slots:
 
 private:
     static bool hasVisiblePixel(const QImage& image, const QRect& probe);
+    static QImage renderCached(const AnnotationLayer& layer, const QSize& canvasSize);
     static std::unique_ptr<PolylineAnnotation> createPolyline(int y);
     static std::unique_ptr<PencilStroke> createPencil(int y);
     static std::unique_ptr<MarkerStroke> createMarker(int y);
@@ -56,6 +62,16 @@ bool TestAnnotationLayer::hasVisiblePixel(const QImage& image, const QRect& prob
     return false;
 }
 
+QImage TestAnnotationLayer::renderCached(const AnnotationLayer& layer, const QSize& canvasSize)
+{
+    QImage frame(canvasSize, QImage::Format_ARGB32_Premultiplied);
+    frame.fill(Qt::transparent);
+    QPainter painter(&frame);
+    layer.drawCached(painter, canvasSize, 1.0);
+    painter.end();
+    return frame;
+}
+
 std::unique_ptr<PolylineAnnotation> TestAnnotationLayer::createPolyline(int y)
 {
     QVector<QPoint> points = {
@@ -213,6 +229,117 @@ void TestAnnotationLayer::testDrawCached_AppliesViewportOrigin()
     QVERIFY(hasVisiblePixel(cachedFrame, QRect(70, 32, 24, 16)));
 }
 
+void TestAnnotationLayer::testDrawCached_UndoRepaintsOnlyAffectedTiles()
+{
+    // Tall canvas so the two polylines land in different cache tiles.
+    const QSize canvasSize(180, AnnotationLayer::kCacheTileSize * 3);
+    const int farY = AnnotationLayer::kCacheTileSize * 2 + 40;
+
+    AnnotationLayer layer;
+    layer.addItem(createPolyline(20));
+    layer.addItem(createPolyline(farY));
+
+    QImage before = renderCached(layer, canvasSize);
+    QVERIFY(hasVisiblePixel(before, QRect(70, 12, 24, 16)));
+    QVERIFY(hasVisiblePixel(before, QRect(70, farY - 8, 24, 16)));
+
+    layer.undo();
+
+    QImage after = renderCached(layer, canvasSize);
+    QVERIFY(hasVisiblePixel(after, QRect(70, 12, 24, 16)));
+    QVERIFY(!hasVisiblePixel(after, QRect(70, farY - 8, 24, 16)));
+
+    layer.redo();
+
+    QImage redone = renderCached(layer, canvasSize);
+    QVERIFY(hasVisiblePixel(redone, QRect(70, farY - 8, 24, 16)));
+}
+
+void TestAnnotationLayer::testDrawCached_IncrementalTilesMatchFullRebuild()
+{
+    const QSize canvasSize(AnnotationLayer::kCacheTileSize * 2 + 40,
+                           AnnotationLayer::kCacheTileSize * 2 + 40);
+
+    AnnotationLayer layer;
+    for (int i = 0; i < 12; ++i) {
+        // Diagonal strokes crossing tile seams.
+        QVector<QPointF> points = {
+            QPointF(10.0 + i * 30.0, 10.0 + i * 12.0),
+            QPointF(200.0 + i * 25.0, 240.0 + i * 20.0),
+            QPointF(60.0 + i * 20.0, 500.0 - i * 15.0)
+        };
+        layer.addItem(std::make_unique<PencilStroke>(
+            points, QColor(20 * i, 80, 200), 3 + i % 4, LineStyle::Solid));
+        renderCached(layer, canvasSize);
+    }
+    layer.undo();
+    layer.undo();
+    const QImage incremental = renderCached(layer, canvasSize);
+
+    layer.invalidateCache();
+    const QImage rebuilt = renderCached(layer, canvasSize);
+
+    QCOMPARE(incremental, rebuilt);
+}
+
+void TestAnnotationLayer::testCommitDirtyRegion_RepaintsDirtyTiles()
+{
+    const QSize canvasSize(180, AnnotationLayer::kCacheTileSize * 2);
+
+    AnnotationLayer layer;
+    layer.addItem(createPolyline(20));
+    renderCached(layer, canvasSize);
+
+    auto* polyline = dynamic_cast<PolylineAnnotation*>(layer.itemAt(0));
+    QVERIFY(polyline != nullptr);
+    const QRect oldRect = polyline->boundingRect();
+    const int offset = AnnotationLayer::kCacheTileSize;
+    polyline->moveBy(QPoint(0, offset));
+
+    layer.markDirtyRect(oldRect.united(polyline->boundingRect()));
+    layer.commitDirtyRegion();
+    QVERIFY(!layer.hasDirtyRect());
+
+    const QImage frame = renderCached(layer, canvasSize);
+    QVERIFY(!hasVisiblePixel(frame, QRect(70, 12, 24, 16)));
+    QVERIFY(hasVisiblePixel(frame, QRect(70, 12 + offset, 24, 16)));
+}
+
+void TestAnnotationLayer::testDirtyRegionDrag_ReusesFullCacheAndMatchesRebuild()
+{
+    const QSize canvasSize(180, AnnotationLayer::kCacheTileSize * 2);
+    const int farY = AnnotationLayer::kCacheTileSize + 100;
+
+    AnnotationLayer layer;
+    layer.addItem(createPolyline(20));
+    layer.addItem(createPolyline(farY));
+    renderCached(layer, canvasSize);
+
+    // Editors mark the selected item's footprint when a drag starts.
+    layer.setSelectedIndex(0);
+    auto* dragged = dynamic_cast<PolylineAnnotation*>(layer.itemAt(0));
+    QVERIFY(dragged != nullptr);
+    layer.markDirtyRect(dragged->boundingRect());
+    dragged->moveBy(QPoint(0, 30));
+
+    QImage dragFrame(canvasSize, QImage::Format_ARGB32_Premultiplied);
+    dragFrame.fill(Qt::transparent);
+    {
+        QPainter painter(&dragFrame);
+        layer.drawWithDirtyRegion(painter, canvasSize, 1.0, 0);
+    }
+    QVERIFY(!hasVisiblePixel(dragFrame, QRect(70, 12, 24, 16)));
+    QVERIFY(hasVisiblePixel(dragFrame, QRect(70, 42, 24, 16)));
+    QVERIFY(hasVisiblePixel(dragFrame, QRect(70, farY - 8, 24, 16)));
+
+    layer.commitDirtyRegion();
+    QVERIFY(!layer.hasDirtyRect());
+    const QImage committed = renderCached(layer, canvasSize);
+
+    layer.invalidateCache();
+    QCOMPARE(committed, renderCached(layer, canvasSize));
+}
+
 void TestAnnotationLayer::testHitTestText_IgnoresHiddenItems()
 {
     AnnotationLayer layer;
@@ -293,6 +420,37 @@ void TestAnnotationLayer::testHitTestShape_ReturnsTopMostVisible()
     QCOMPARE(hitIndex, 1);
 }
 
+void TestAnnotationLayer::testHitTestShape_TracksMovesUndoAndTranslate()
+{
+    AnnotationLayer layer;
+    layer.addItem(std::make_unique<ShapeAnnotation>(
+        QRect(40, 40, 120, 80), ShapeType::Rectangle, Qt::red, 3));
+    layer.addItem(std::make_unique<ShapeAnnotation>(
+        QRect(600, 600, 120, 80), ShapeType::Rectangle, Qt::blue, 3));
+    QCOMPARE(layer.hitTestShape(QPoint(660, 640)), 1);
+
+    // Selected items are edited in place without notifying the layer.
+    layer.setSelectedIndex(0);
+    auto* shape = dynamic_cast<ShapeAnnotation*>(layer.selectedItem());
+    QVERIFY(shape != nullptr);
+    shape->moveBy(QPointF(400, 0));
+    QCOMPARE(layer.hitTestShape(QPoint(500, 80)), 0);
+    QCOMPARE(layer.hitTestShape(QPoint(100, 80)), -1);
+
+    layer.clearSelection();
+    QCOMPARE(layer.hitTestShape(QPoint(500, 80)), 0);
+    QCOMPARE(layer.hitTestShape(QPoint(100, 80)), -1);
+
+    layer.undo();
+    QCOMPARE(layer.hitTestShape(QPoint(660, 640)), -1);
+    layer.redo();
+    QCOMPARE(layer.hitTestShape(QPoint(660, 640)), 1);
+
+    layer.translateAll(QPointF(0, 1000));
+    QCOMPARE(layer.hitTestShape(QPoint(660, 640)), -1);
+    QCOMPARE(layer.hitTestShape(QPoint(660, 1640)), 1);
+}
+
 void TestAnnotationLayer::testSetSelectedIndex_InvalidOrHiddenClearsSelection()
 {
     AnnotationLayer layer;
@@ -0,0 +1,146 @@
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QRandomGenerator>
+
+#include "annotations/AnnotationLayer.h"
+#include "annotations/PencilStroke.h"
+
+#include <algorithm>
+#include <vector>
+
+class TestAnnotationLayerBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchmarkAddStroke_5KCanvas();
+    void benchmarkEraserSweep_1000Strokes();
+
+private:
+    static std::unique_ptr<PencilStroke> createRandomStroke(QRandomGenerator& rng,
+                                                            const QSize& canvasSize);
+    static void drawCachedInto(QImage& target, const AnnotationLayer& layer,
+                               const QSize& canvasSize);
+};
+
+std::unique_ptr<PencilStroke> TestAnnotationLayerBenchmark::createRandomStroke(
+    QRandomGenerator& rng, const QSize& canvasSize)
+{
+    // Short freehand stroke, similar to what a user draws with the pencil tool.
+    QVector<QPointF> points;
+    QPointF point(rng.bounded(canvasSize.width()), rng.bounded(canvasSize.height()));
+    for (int i = 0; i < 40; ++i) {
+        points.append(point);
+        point += QPointF(rng.bounded(13) - 6, rng.bounded(13) - 6);
+    }
+    return std::make_unique<PencilStroke>(
+        points, QColor::fromRgb(rng.generate() | 0xff000000u), 3 + rng.bounded(6), LineStyle::Solid);
+}
+
+void TestAnnotationLayerBenchmark::drawCachedInto(QImage& target,
+                                                  const AnnotationLayer& layer,
+                                                  const QSize& canvasSize)
+{
+    QPainter painter(&target);
+    layer.drawCached(painter, canvasSize, 1.0);
+}
+
+void TestAnnotationLayerBenchmark::benchmarkAddStroke_5KCanvas()
+{
+    const QSize canvasSize(5120, 2880);
+    constexpr int kStrokeCount = 200;
+
+    QRandomGenerator rng(0x5eed);
+    AnnotationLayer layer;
+
+    // Only the cache refresh is measured; composing the full 5K pixmap into a
+    // window is the same cost with or without tiling.
+    QImage target(64, 64, QImage::Format_ARGB32_Premultiplied);
+    target.fill(Qt::transparent);
+
+    layer.addItem(createRandomStroke(rng, canvasSize));
+    drawCachedInto(target, layer, canvasSize);
+
+    std::vector<qint64> latenciesNs;
+    latenciesNs.reserve(kStrokeCount);
+    QElapsedTimer timer;
+    for (int i = 0; i < kStrokeCount; ++i) {
+        auto stroke = createRandomStroke(rng, canvasSize);
+        timer.start();
+        layer.addItem(std::move(stroke));
+        drawCachedInto(target, layer, canvasSize);
+        latenciesNs.push_back(timer.nsecsElapsed());
+    }
+
+    timer.start();
+    layer.invalidateCache();
+    drawCachedInto(target, layer, canvasSize);
+    const qint64 fullRebuildNs = timer.nsecsElapsed();
+
+    std::sort(latenciesNs.begin(), latenciesNs.end());
+    qint64 totalNs = 0;
+    for (qint64 latency : latenciesNs) {
+        totalNs += latency;
+    }
+    const auto toMs = [](qint64 ns) { return static_cast<double>(ns) / 1.0e6; };
+    qInfo().nospace()
+        << "AnnotationLayer add+draw on " << canvasSize.width() << "x" << canvasSize.height()
+        << " (" << kStrokeCount << " strokes): mean "
+        << toMs(totalNs / kStrokeCount) << " ms, p50 "
+        << toMs(latenciesNs[latenciesNs.size() / 2]) << " ms, p95 "
+        << toMs(latenciesNs[latenciesNs.size() * 95 / 100]) << " ms, max "
+        << toMs(latenciesNs.back()) << " ms; full rebuild "
+        << toMs(fullRebuildNs) << " ms";
+}
+
+void TestAnnotationLayerBenchmark::benchmarkEraserSweep_1000Strokes()
+{
+    const QSize canvasSize(5120, 2880);
+    constexpr int kStrokeCount = 1000;
+    constexpr int kSweepSteps = 1000;
+    constexpr int kEraserWidth = 20;
+
+    QRandomGenerator rng(0xe7a5e);
+    AnnotationLayer layer;
+    // The layer keeps the newest kMaxHistorySize items, so this leaves it at
+    // capacity with strokes scattered over the whole canvas.
+    for (int i = 0; i < kStrokeCount; ++i) {
+        layer.addItem(createRandomStroke(rng, canvasSize));
+    }
+    const size_t itemsBefore = layer.itemCount();
+
+    QElapsedTimer timer;
+    qint64 hoverNs = 0;
+    qint64 eraseNs = 0;
+    size_t erasedCount = 0;
+    layer.beginEraseTransaction();
+    for (int step = 0; step < kSweepSteps; ++step) {
+        // Diagonal sweep across the canvas, like a long eraser drag.
+        const QPoint point(canvasSize.width() * step / kSweepSteps,
+                           canvasSize.height() * step / kSweepSteps);
+
+        timer.start();
+        layer.hitTestShape(point);
+        layer.hitTestText(point);
+        hoverNs += timer.nsecsElapsed();
+
+        timer.start();
+        erasedCount += layer.removeItemsIntersecting(point, kEraserWidth).size();
+        eraseNs += timer.nsecsElapsed();
+    }
+    layer.endEraseTransaction();
+
+    qInfo().nospace()
+        << "AnnotationLayer eraser sweep over " << itemsBefore << " retained of "
+        << kStrokeCount << " strokes, " << kSweepSteps << " steps: hover "
+        << static_cast<double>(hoverNs) / kSweepSteps / 1000.0 << " us/step, erase "
+        << static_cast<double>(eraseNs) / kSweepSteps / 1000.0 << " us/step, erased "
+        << erasedCount;
+
+    QCOMPARE(layer.itemCount() + erasedCount, itemsBefore);
+}
+
+QTEST_MAIN(TestAnnotationLayerBenchmark)
+#include "tst_AnnotationLayerBenchmark.moc"
@@ -0,0 +1,134 @@
+#include <QtTest/QtTest>
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
+#include <QRandomGenerator>
+
+#include "annotations/MosaicStroke.h"
+
+#include <algorithm>
+
+namespace {
+
+SharedPixmap createNoiseSource(const QSize& logicalSize, qreal dpr)
+{
+    QRandomGenerator rng(0x3051);
+    QImage image(logicalSize * dpr, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        auto* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = rng.generate() | 0xff000000u;
+        }
+    }
+    auto pixmap = std::make_shared<QPixmap>(QPixmap::fromImage(image));
+    pixmap->setDevicePixelRatio(dpr);
+    return pixmap;
+}
+
+QImage render(const MosaicStroke& stroke, const QSize& logicalSize, qreal dpr)
+{
+    QImage target(logicalSize * dpr, QImage::Format_ARGB32_Premultiplied);
+    target.setDevicePixelRatio(dpr);
+    target.fill(Qt::white);
+    QPainter painter(&target);
+    stroke.draw(painter);
+    painter.end();
+    return target;
+}
+
+// Diagonal zig-zag drag that keeps extending the stroke bounds
+QVector<QPoint> dragPath()
+{
+    QVector<QPoint> points;
+    for (int i = 0; i < 40; ++i) {
+        points.append(QPoint(20 + i * 9, 20 + i * 6 + (i % 2) * 7));
+    }
+    return points;
+}
+
+}  // namespace
+
+class TestMosaicStroke : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testIncrementalDraw_MatchesFullRender_data();
+    void testIncrementalDraw_MatchesFullRender();
+    void testIncrementalDraw_GaussianCoversNewSegments();
+    void testTranslate_InvalidatesRenderCache();
+};
+
+void TestMosaicStroke::testIncrementalDraw_MatchesFullRender_data()
+{
+    QTest::addColumn<qreal>("dpr");
+    QTest::newRow("dpr 1") << 1.0;
+    QTest::newRow("dpr 2") << 2.0;
+}
+
+void TestMosaicStroke::testIncrementalDraw_MatchesFullRender()
+{
+    QFETCH(qreal, dpr);
+    const QSize canvasSize(420, 320);
+    const SharedPixmap source = createNoiseSource(canvasSize, dpr);
+    const QVector<QPoint> points = dragPath();
+
+    MosaicStroke stroke({points[0], points[1]}, source, 12, 8, MosaicStroke::BlurType::Pixelate);
+    render(stroke, canvasSize, dpr);
+    for (int i = 2; i < points.size(); ++i) {
+        stroke.addPoint(points[i]);
+        render(stroke, canvasSize, dpr);
+    }
+
+    // A fresh stroke renders everything in one pass.
+    MosaicStroke fullStroke(points, source, 12, 8, MosaicStroke::BlurType::Pixelate);
+    QCOMPARE(render(stroke, canvasSize, dpr), render(fullStroke, canvasSize, dpr));
+}
+
+void TestMosaicStroke::testIncrementalDraw_GaussianCoversNewSegments()
+{
+    const QSize canvasSize(420, 320);
+    const SharedPixmap source = createNoiseSource(canvasSize, 1.0);
+    const QVector<QPoint> points = dragPath();
+
+    MosaicStroke stroke({points[0], points[1]}, source, 12, 8, MosaicStroke::BlurType::Gaussian);
+    render(stroke, canvasSize, 1.0);
+    for (int i = 2; i < points.size(); ++i) {
+        stroke.addPoint(points[i]);
+        render(stroke, canvasSize, 1.0);
+    }
+
+    const QImage incremental = render(stroke, canvasSize, 1.0);
+    MosaicStroke fullStroke(points, source, 12, 8, MosaicStroke::BlurType::Gaussian);
+    const QImage full = render(fullStroke, canvasSize, 1.0);
+
+    // Every point of the drag is painted, and the blurred pixels agree with a
+    // single-pass render except for rounding near patch borders.
+    int maxDifference = 0;
+    for (const QPoint& point : points) {
+        QVERIFY(incremental.pixel(point) != qRgb(255, 255, 255));
+        const QRgb a = incremental.pixel(point);
+        const QRgb b = full.pixel(point);
+        maxDifference = (std::max)({maxDifference, qAbs(qRed(a) - qRed(b)),
+                                    qAbs(qGreen(a) - qGreen(b)), qAbs(qBlue(a) - qBlue(b))});
+    }
+    QVERIFY2(maxDifference <= 8, qPrintable(QString::number(maxDifference)));
+}
+
+void TestMosaicStroke::testTranslate_InvalidatesRenderCache()
+{
+    const QSize canvasSize(420, 320);
+    const SharedPixmap source = createNoiseSource(canvasSize, 1.0);
+
+    MosaicStroke stroke({QPoint(40, 40), QPoint(120, 80)}, source, 12, 8,
+                        MosaicStroke::BlurType::Pixelate);
+    render(stroke, canvasSize, 1.0);
+
+    stroke.translate(QPointF(150.0, 120.0));
+    MosaicStroke expected({QPoint(190, 160), QPoint(270, 200)}, source, 12, 8,
+                          MosaicStroke::BlurType::Pixelate);
+    QCOMPARE(render(stroke, canvasSize, 1.0), render(expected, canvasSize, 1.0));
+}
+
+QTEST_MAIN(TestMosaicStroke)
+#include "tst_MosaicStroke.moc"
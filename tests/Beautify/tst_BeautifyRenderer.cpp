@@ -2,6 +2,7 @@
 #include <QPainter>
 #include "beautify/BeautifyRenderer.h"
 #include "beautify/BeautifySettings.h"
+#include "beautify/ShadowNinePatch.h"
 
 class tst_BeautifyRenderer : public QObject
 {
@@ -27,6 +28,9 @@ private slots:
     void testApplyToPixmap_WithShadow();
     void testApplyToPixmap_ZeroCornerRadius();
     void testApplyToPixmap_HiDPI_CorrectLogicalSize();
+    void testApplyToPixmap_ShadowMatchesLayeredLook_data();
+    void testApplyToPixmap_ShadowMatchesLayeredLook();
+    void testApplyToPixmap_ShadowTileReusedAcrossSizes();
 
     // render tests
     void testRender_NullSource_NoOp();
@@ -34,6 +38,8 @@ private slots:
 
 private:
     QPixmap createTestPixmap(int w, int h, QColor fill = Qt::red);
+    QImage renderLayeredShadow(const QSize& size, const QRect& insetRect,
+                               const BeautifySettings& settings);
 };
 
 QPixmap tst_BeautifyRenderer::createTestPixmap(int w, int h, QColor fill)
@@ -43,6 +49,37 @@ QPixmap tst_BeautifyRenderer::createTestPixmap(int w, int h, QColor fill)
     return pixmap;
 }
 
+// Reference for the shadow look: the stack of expanding rounded rects that
+// BeautifyRenderer drew before shadows became a blurred nine-patch.
+QImage tst_BeautifyRenderer::renderLayeredShadow(const QSize& size, const QRect& insetRect,
+                                                 const BeautifySettings& settings)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(settings.backgroundColor);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(Qt::NoPen);
+
+    const int blur = settings.shadowBlur;
+    const int steps = qMin(blur, 20);
+    for (int i = steps; i > 0; --i) {
+        float ratio = static_cast<float>(i) / steps;
+        int expand = static_cast<int>(blur * ratio);
+        QColor c = settings.shadowColor;
+        c.setAlpha(static_cast<int>(settings.shadowColor.alpha() * (1.0f - ratio) * 0.15f));
+        painter.setBrush(c);
+
+        QRect shadowRect = insetRect.adjusted(
+            -expand + settings.shadowOffsetX, -expand + settings.shadowOffsetY,
+            expand + settings.shadowOffsetX, expand + settings.shadowOffsetY);
+        qreal cornerExpand = settings.cornerRadius + expand / 2.0;
+        painter.drawRoundedRect(shadowRect, cornerExpand, cornerExpand);
+    }
+    painter.end();
+    return image;
+}
+
 // ============================================================================
 // calculateOutputSize Tests
 // ============================================================================
@@ -247,6 +284,77 @@ void tst_BeautifyRenderer::testApplyToPixmap_HiDPI_CorrectLogicalSize()
     QCOMPARE(result.size(), QSize(360, 310));
 }
 
+void tst_BeautifyRenderer::testApplyToPixmap_ShadowMatchesLayeredLook_data()
+{
+    QTest::addColumn<int>("blur");
+    QTest::addColumn<int>("cornerRadius");
+
+    QTest::newRow("defaults") << 40 << 12;
+    QTest::newRow("sharp corners") << 20 << 0;
+    QTest::newRow("wide and round") << 60 << 24;
+}
+
+void tst_BeautifyRenderer::testApplyToPixmap_ShadowMatchesLayeredLook()
+{
+    QFETCH(int, blur);
+    QFETCH(int, cornerRadius);
+
+    QPixmap source = createTestPixmap(200, 150);
+    BeautifySettings settings;
+    settings.backgroundType = BeautifyBackgroundType::Solid;
+    settings.backgroundColor = Qt::white;
+    settings.padding = 64;
+    settings.shadowEnabled = true;
+    settings.shadowBlur = blur;
+    settings.cornerRadius = cornerRadius;
+
+    QImage result = BeautifyRenderer::applyToPixmap(source, settings).toImage()
+                        .convertToFormat(QImage::Format_ARGB32);
+    const QRect insetRect(64, 64, 200, 150);
+    QImage reference = renderLayeredShadow(result.size(), insetRect, settings)
+                           .convertToFormat(QImage::Format_ARGB32);
+
+    // Compare the visible shadow only; the screenshot covers the rest.
+    int maxDiff = 0;
+    qint64 totalDiff = 0;
+    int count = 0;
+    for (int y = 0; y < result.height(); ++y) {
+        for (int x = 0; x < result.width(); ++x) {
+            if (insetRect.contains(x, y)) continue;
+            const int diff = qAbs(qGray(result.pixel(x, y)) - qGray(reference.pixel(x, y)));
+            maxDiff = qMax(maxDiff, diff);
+            totalDiff += diff;
+            ++count;
+        }
+    }
+    const double meanDiff = static_cast<double>(totalDiff) / count;
+    QVERIFY2(maxDiff <= 20, qPrintable(QString("max difference %1").arg(maxDiff)));
+    QVERIFY2(meanDiff <= 4.0, qPrintable(QString("mean difference %1").arg(meanDiff)));
+
+    // The shadow is actually there: darker below the screenshot than far away.
+    QVERIFY(qGray(result.pixel(164, 64 + 150 + 4)) < qGray(result.pixel(2, 2)));
+}
+
+void tst_BeautifyRenderer::testApplyToPixmap_ShadowTileReusedAcrossSizes()
+{
+    ShadowNinePatch::clearCache();
+
+    BeautifySettings settings;
+    settings.shadowEnabled = true;
+    settings.shadowBlur = 40;
+
+    BeautifyRenderer::applyToPixmap(createTestPixmap(200, 150), settings);
+    QCOMPARE(ShadowNinePatch::cachedTileCount(), 1);
+
+    // Same shadow settings at another size stretch the same tile.
+    BeautifyRenderer::applyToPixmap(createTestPixmap(640, 360), settings);
+    QCOMPARE(ShadowNinePatch::cachedTileCount(), 1);
+
+    settings.shadowBlur = 20;
+    BeautifyRenderer::applyToPixmap(createTestPixmap(640, 360), settings);
+    QCOMPARE(ShadowNinePatch::cachedTileCount(), 2);
+}
+
 // ============================================================================
 // render Tests
 // ============================================================================
@@ -1,5 +1,7 @@
 #include <QtTest>
 
+#include <QBuffer>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QImage>
 #include <QPixmap>
@@ -7,10 +9,12 @@
 
 #include "cli/CaptureOutputHelper.h"
 
+using SnapTray::CLI::BurstOptions;
 using SnapTray::CLI::CaptureMetadata;
 using SnapTray::CLI::CaptureOutputOptions;
 using SnapTray::CLI::CLIResult;
 using SnapTray::CLI::emitCaptureOutput;
+using SnapTray::CLI::runCaptureBurst;
 
 class tst_CaptureOutputHelper : public QObject
 {
@@ -19,6 +23,8 @@ class tst_CaptureOutputHelper : public QObject
 private slots:
     void emitCaptureOutput_rawReturnsPngData();
     void emitCaptureOutput_saveWritesPngFile();
+    void runCaptureBurst_writesNumberedFilesAndReport();
+    void runCaptureBurst_stopsOnCaptureError();
 };
 
 static QPixmap makeScreenshot()
@@ -37,13 +43,19 @@ void tst_CaptureOutputHelper::emitCaptureOutput_rawReturnsPngData()
 
     QCOMPARE(result.code, CLIResult::Code::Success);
     QVERIFY(result.message.isEmpty());
-    QVERIFY(!result.data.isEmpty());
+    QVERIFY(result.hasData());
+    QVERIFY(result.writeData);
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(result.writeData(&buffer));
 
     static const QByteArray kPngSignature("\x89PNG\r\n\x1a\n", 8);
-    QCOMPARE(result.data.left(8), kPngSignature);
+    QCOMPARE(data.left(8), kPngSignature);
 
     QImage decoded;
-    QVERIFY(decoded.loadFromData(result.data, "PNG"));
+    QVERIFY(decoded.loadFromData(data, "PNG"));
     QCOMPARE(decoded.size(), QSize(8, 6));
 }
 
@@ -61,7 +73,7 @@ void tst_CaptureOutputHelper::emitCaptureOutput_saveWritesPngFile()
 
     QCOMPARE(result.code, CLIResult::Code::Success);
     QVERIFY(result.message.contains(QString("Screenshot saved to: %1").arg(outputPath)));
-    QVERIFY(result.data.isEmpty());
+    QVERIFY(!result.hasData());
 
     QVERIFY(QFileInfo::exists(outputPath));
     QImage savedImage(outputPath);
@@ -69,5 +81,75 @@ void tst_CaptureOutputHelper::emitCaptureOutput_saveWritesPngFile()
     QCOMPARE(savedImage.size(), QSize(8, 6));
 }
 
+void tst_CaptureOutputHelper::runCaptureBurst_writesNumberedFilesAndReport()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    CaptureOutputOptions options;
+    options.outputFile = tempDir.path() + "/frame_{#:2}.png";
+
+    BurstOptions burst;
+    burst.count = 4;
+    burst.intervalMs = 20;
+
+    int captures = 0;
+    QElapsedTimer timer;
+    timer.start();
+    const CLIResult result = runCaptureBurst(
+        burst,
+        [&captures](QPixmap* frame) {
+            ++captures;
+            *frame = makeScreenshot();
+            return CLIResult::success();
+        },
+        options);
+
+    QCOMPARE(result.code, CLIResult::Code::Success);
+    QCOMPARE(captures, 4);
+    // Captures run on a fixed schedule: the last one is due at 3 intervals.
+    QVERIFY(timer.elapsed() >= 3 * burst.intervalMs);
+    for (int frame = 1; frame <= 4; ++frame) {
+        const QString path = tempDir.path() + QString("/frame_%1.png").arg(frame, 2, 10, QChar('0'));
+        QVERIFY2(QFileInfo::exists(path), qPrintable(path));
+        QVERIFY(result.message.contains(path));
+        QCOMPARE(QImage(path).size(), QSize(8, 6));
+    }
+    QVERIFY(result.message.contains("capture_ms"));
+    QVERIFY(result.message.contains("Saved 4 of 4 frames"));
+}
+
+void tst_CaptureOutputHelper::runCaptureBurst_stopsOnCaptureError()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    CaptureOutputOptions options;
+    options.outputFile = tempDir.path() + "/shot.png";
+
+    BurstOptions burst;
+    burst.count = 5;
+
+    int captures = 0;
+    const CLIResult result = runCaptureBurst(
+        burst,
+        [&captures](QPixmap* frame) {
+            if (++captures == 3) {
+                return CLIResult::error(CLIResult::Code::GeneralError, "Failed to capture screen");
+            }
+            *frame = makeScreenshot();
+            return CLIResult::success();
+        },
+        options);
+
+    QCOMPARE(result.code, CLIResult::Code::GeneralError);
+    QCOMPARE(captures, 3);
+    QVERIFY(result.message.contains("Failed to capture screen"));
+    QVERIFY(result.message.contains("Saved 2 of 2 frames"));
+    QVERIFY(QFileInfo::exists(tempDir.path() + "/shot_1.png"));
+    QVERIFY(QFileInfo::exists(tempDir.path() + "/shot_2.png"));
+    QVERIFY(!QFileInfo::exists(tempDir.path() + "/shot_3.png"));
+}
+
 QTEST_MAIN(tst_CaptureOutputHelper)
 #include "tst_CaptureOutputHelper.moc"
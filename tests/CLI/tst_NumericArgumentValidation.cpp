@@ -8,6 +8,7 @@
 #include "cli/commands/PinCommand.h"
 #include "cli/commands/RegionCommand.h"
 #include "cli/commands/ScreenCommand.h"
+#include "cli/commands/TrimCommand.h"
 
 using SnapTray::CLI::CLIHandler;
 using SnapTray::CLI::CLIResult;
@@ -15,6 +16,7 @@ using SnapTray::CLI::FullCommand;
 using SnapTray::CLI::PinCommand;
 using SnapTray::CLI::RegionCommand;
 using SnapTray::CLI::ScreenCommand;
+using SnapTray::CLI::TrimCommand;
 
 class tst_NumericArgumentValidation : public QObject
 {
@@ -33,6 +35,10 @@ private slots:
     void cliHandler_validatesPinArgumentsBeforeIPC();
     void captureCommands_rejectUnsupportedCursorOption_data();
     void captureCommands_rejectUnsupportedCursorOption();
+    void captureCommands_rejectInvalidBurstOptions_data();
+    void captureCommands_rejectInvalidBurstOptions();
+    void trimCommand_rejectsInvalidRange_data();
+    void trimCommand_rejectsInvalidRange();
 };
 
 void tst_NumericArgumentValidation::screenCommand_rejectsNonNumericScreenOption()
@@ -187,5 +193,71 @@ void tst_NumericArgumentValidation::captureCommands_rejectUnsupportedCursorOptio
     QVERIFY(result.message.contains("cursor", Qt::CaseInsensitive));
 }
 
+void tst_NumericArgumentValidation::captureCommands_rejectInvalidBurstOptions_data()
+{
+    QTest::addColumn<QString>("command");
+    QTest::addColumn<QStringList>("args");
+    QTest::addColumn<QString>("expectedMessage");
+
+    QTest::newRow("full-count") << "full" << QStringList{"--count", "abc"}
+                                << "Invalid count value: abc";
+    QTest::newRow("screen-zero-count") << "screen" << QStringList{"0", "--count", "0"}
+                                       << "Invalid count value: 0";
+    QTest::newRow("region-interval") << "region"
+                                     << QStringList{"--region", "0,0,100,100", "--count", "3",
+                                                    "--interval-ms", "-5"}
+                                     << "Invalid interval value: -5";
+    QTest::newRow("full-raw") << "full" << QStringList{"--count", "2", "--raw"} << "--raw";
+    QTest::newRow("screen-clipboard") << "screen" << QStringList{"0", "--count", "2", "-c"}
+                                      << "--clipboard";
+}
+
+void tst_NumericArgumentValidation::captureCommands_rejectInvalidBurstOptions()
+{
+    QFETCH(QString, command);
+    QFETCH(QStringList, args);
+    QFETCH(QString, expectedMessage);
+
+    CLIHandler handler;
+    QStringList cliArgs{"snaptray", command};
+    cliArgs.append(args);
+
+    const CLIResult result = handler.process(cliArgs);
+    QCOMPARE(result.code, CLIResult::Code::InvalidArguments);
+    QVERIFY2(result.message.contains(expectedMessage), qPrintable(result.message));
+}
+
+void tst_NumericArgumentValidation::trimCommand_rejectsInvalidRange_data()
+{
+    QTest::addColumn<QStringList>("arguments");
+    QTest::addColumn<QString>("message");
+
+    QTest::newRow("non-numeric start")
+        << QStringList{"--start", "abc"} << QString("Invalid start: abc");
+    QTest::newRow("negative start")
+        << QStringList{"--start=-5"} << QString("Invalid start: -5");
+    QTest::newRow("non-numeric end")
+        << QStringList{"--end", "1s"} << QString("Invalid end: 1s");
+    QTest::newRow("end before start")
+        << QStringList{"--start", "500", "--end", "500"} << QString("Invalid end: 500");
+}
+
+void tst_NumericArgumentValidation::trimCommand_rejectsInvalidRange()
+{
+    QFETCH(QStringList, arguments);
+    QFETCH(QString, message);
+
+    TrimCommand command;
+    QCommandLineParser parser;
+    command.setupOptions(parser);
+
+    QVERIFY(parser.parse(QStringList{"snaptray", "--file", "in.gif", "--output", "out.gif"}
+                         + arguments));
+    CLIResult result = command.execute(parser);
+
+    QCOMPARE(result.code, CLIResult::Code::InvalidArguments);
+    QVERIFY2(result.message.contains(message), qPrintable(result.message));
+}
+
 QTEST_MAIN(tst_NumericArgumentValidation)
 #include "tst_NumericArgumentValidation.moc"
@@ -0,0 +1,138 @@
+#include <QtTest>
+
+#include <QBuffer>
+#include <QImage>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "cli/RawImageWriter.h"
+#include "utils/QoiCodec.h"
+
+using SnapTray::CLI::parseRawImageFormat;
+using SnapTray::CLI::RawImageFormat;
+using SnapTray::CLI::writeRawImage;
+
+class tst_RawImageWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseRawImageFormat_acceptsKnownNames();
+    void writeRawImage_ppmDecodes();
+    void writeRawImage_bmpDecodes();
+    void writeRawImage_rgbaRowsWithHeader();
+    void writeRawImage_qoiRoundTrips();
+    void writeRawImage_reportsDeviceFailure();
+};
+
+// Taller than one conversion batch so batch seams are covered.
+static QImage makeImage(QImage::Format format = QImage::Format_RGB32)
+{
+    QImage image(37, 150, format);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixelColor(x, y, QColor((x * 7) & 0xff, (y * 3) & 0xff, ((x ^ y) * 5) & 0xff));
+        }
+    }
+    return image;
+}
+
+static QByteArray encode(const QImage& image, RawImageFormat format, bool withHeader = false)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    if (!writeRawImage(image, format, withHeader, &buffer)) {
+        return QByteArray();
+    }
+    return data;
+}
+
+void tst_RawImageWriter::parseRawImageFormat_acceptsKnownNames()
+{
+    QVERIFY(parseRawImageFormat("png") == RawImageFormat::Png);
+    QVERIFY(parseRawImageFormat("PPM") == RawImageFormat::Ppm);
+    QVERIFY(parseRawImageFormat(" bmp ") == RawImageFormat::Bmp);
+    QVERIFY(parseRawImageFormat("qoi") == RawImageFormat::Qoi);
+    QVERIFY(parseRawImageFormat("rgba") == RawImageFormat::Rgba);
+    QVERIFY(!parseRawImageFormat("jpeg").has_value());
+}
+
+void tst_RawImageWriter::writeRawImage_ppmDecodes()
+{
+    const QImage image = makeImage();
+    const QByteArray data = encode(image, RawImageFormat::Ppm);
+    QVERIFY(data.startsWith("P6\n37 150\n255\n"));
+    QCOMPARE(data.size(), qsizetype(14 + 37 * 150 * 3));
+
+    QImage decoded;
+    QVERIFY(decoded.loadFromData(data, "PPM"));
+    QCOMPARE(decoded.convertToFormat(QImage::Format_RGB32), image);
+}
+
+void tst_RawImageWriter::writeRawImage_bmpDecodes()
+{
+    const QImage image = makeImage();
+    const QByteArray data = encode(image, RawImageFormat::Bmp);
+    QVERIFY(data.startsWith("BM"));
+    QCOMPARE(data.size(), qsizetype(54 + 37 * 150 * 4));
+
+    QImage decoded;
+    QVERIFY(decoded.loadFromData(data, "BMP"));
+    QCOMPARE(decoded.convertToFormat(QImage::Format_RGB32), image);
+}
+
+void tst_RawImageWriter::writeRawImage_rgbaRowsWithHeader()
+{
+    const QImage image = makeImage();
+    const QByteArray data = encode(image, RawImageFormat::Rgba, true);
+    const QByteArray header("RGBA 37 150 148\n");
+    QVERIFY(data.startsWith(header));
+    QCOMPARE(data.size(), header.size() + qsizetype(37 * 150 * 4));
+
+    const QImage expected = image.convertToFormat(QImage::Format_RGBA8888);
+    for (int y = 0; y < expected.height(); ++y) {
+        QVERIFY(std::memcmp(data.constData() + header.size() + y * 148, expected.constScanLine(y),
+                            148) == 0);
+    }
+
+    QCOMPARE(encode(image, RawImageFormat::Rgba, false).size(), qsizetype(37 * 150 * 4));
+}
+
+void tst_RawImageWriter::writeRawImage_qoiRoundTrips()
+{
+    QImage image = makeImage(QImage::Format_ARGB32);
+    image.setPixelColor(3, 4, QColor(10, 20, 30, 40));
+
+    const QByteArray data = encode(image, RawImageFormat::Qoi);
+    QVERIFY(data.startsWith("qoif"));
+    const auto* bytes = reinterpret_cast<const uchar*>(data.constData());
+    QCOMPARE(qFromBigEndian<quint32>(bytes + 4), quint32(37));
+    QCOMPARE(qFromBigEndian<quint32>(bytes + 8), quint32(150));
+    QCOMPARE(int(bytes[12]), 4);
+    QVERIFY(data.endsWith(QByteArray(reinterpret_cast<const char*>(QoiCodec::kEndMarker),
+                                     sizeof(QoiCodec::kEndMarker))));
+
+    QImage decoded(image.size(), QImage::Format_ARGB32);
+    QoiCodec::Decoder decoder;
+    const uchar* in = bytes + 14;
+    const uchar* end = bytes + data.size() - sizeof(QoiCodec::kEndMarker);
+    for (int y = 0; y < decoded.height(); ++y) {
+        QVERIFY(decoder.decode(&in, end, reinterpret_cast<quint32*>(decoded.scanLine(y)),
+                               decoded.width()));
+    }
+    QCOMPARE(in, end);
+    QCOMPARE(decoded, image);
+}
+
+void tst_RawImageWriter::writeRawImage_reportsDeviceFailure()
+{
+    QBuffer readOnly;
+    readOnly.open(QIODevice::ReadOnly);
+    QVERIFY(!writeRawImage(makeImage(), RawImageFormat::Ppm, false, &readOnly));
+    QVERIFY(!writeRawImage(QImage(), RawImageFormat::Rgba, false, &readOnly));
+}
+
+QTEST_MAIN(tst_RawImageWriter)
+#include "tst_RawImageWriter.moc"
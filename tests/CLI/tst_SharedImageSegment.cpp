@@ -0,0 +1,150 @@
+#include <QtTest>
+
+#include <QColorSpace>
+#include <QImage>
+#include <QSharedMemory>
+
+#include "cli/SharedImageSegment.h"
+
+using SnapTray::CLI::publishSharedImage;
+using SnapTray::CLI::SharedImageDescriptor;
+using SnapTray::CLI::SharedImageView;
+
+class tst_SharedImageSegment : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void descriptor_roundTripsThroughJson();
+    void descriptor_rejectsInconsistentLayout();
+    void publishAndAttach_sharesPixelsWithoutCopy();
+    void publishAndAttach_keepsColorSpace();
+    void attach_failsAfterRelease();
+};
+
+static QImage makeImage()
+{
+    QImage image(123, 45, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixel(x, y, qRgba(x, y * 5, (x + y) & 0xff, 255));
+        }
+    }
+    image.setDevicePixelRatio(2.0);
+    return image;
+}
+
+void tst_SharedImageSegment::descriptor_roundTripsThroughJson()
+{
+    SharedImageDescriptor descriptor;
+    descriptor.key = "snaptray-image-test";
+    descriptor.width = 3840;
+    descriptor.height = 2160;
+    descriptor.bytesPerLine = 3840 * 4;
+    descriptor.format = QImage::Format_RGB32;
+    descriptor.devicePixelRatio = 1.5;
+    descriptor.iccProfile = QColorSpace(QColorSpace::DisplayP3).iccProfile();
+
+    const SharedImageDescriptor parsed = SharedImageDescriptor::fromJson(descriptor.toJson());
+    QVERIFY(parsed.isValid());
+    QCOMPARE(parsed.key, descriptor.key);
+    QCOMPARE(parsed.width, descriptor.width);
+    QCOMPARE(parsed.height, descriptor.height);
+    QCOMPARE(parsed.bytesPerLine, descriptor.bytesPerLine);
+    QCOMPARE(parsed.format, descriptor.format);
+    QCOMPARE(parsed.devicePixelRatio, descriptor.devicePixelRatio);
+    QCOMPARE(parsed.iccProfile, descriptor.iccProfile);
+    QCOMPARE(parsed.byteCount(), qsizetype(3840) * 4 * 2160);
+}
+
+void tst_SharedImageSegment::descriptor_rejectsInconsistentLayout()
+{
+    SharedImageDescriptor descriptor;
+    descriptor.key = "snaptray-image-test";
+    descriptor.width = 100;
+    descriptor.height = 10;
+    descriptor.bytesPerLine = 100 * 4;
+    descriptor.format = QImage::Format_RGB32;
+    QVERIFY(descriptor.isValid());
+
+    SharedImageDescriptor shortRows = descriptor;
+    shortRows.bytesPerLine = 100 * 3;
+    QVERIFY(!shortRows.isValid());
+
+    SharedImageDescriptor badFormat = descriptor;
+    badFormat.format = static_cast<QImage::Format>(QImage::NImageFormats);
+    QVERIFY(!badFormat.isValid());
+
+    SharedImageDescriptor noKey = descriptor;
+    noKey.key.clear();
+    QVERIFY(!noKey.isValid());
+}
+
+void tst_SharedImageSegment::publishAndAttach_sharesPixelsWithoutCopy()
+{
+    const QImage image = makeImage();
+    SharedImageDescriptor descriptor;
+    std::unique_ptr<QSharedMemory> segment = publishSharedImage(image, &descriptor);
+    if (!segment) {
+        QSKIP("Shared memory is unavailable in this environment");
+    }
+
+    QCOMPARE(descriptor.width, image.width());
+    QCOMPARE(descriptor.bytesPerLine, image.bytesPerLine());
+    QCOMPARE(descriptor.format, image.format());
+
+    SharedImageView view;
+    QVERIFY2(view.attach(descriptor), qPrintable(view.errorString()));
+    const QImage mapped = view.image();
+    QCOMPARE(mapped, image);
+    QCOMPARE(mapped.devicePixelRatio(), 2.0);
+
+    // The view wraps the mapping instead of owning a copy: a write through
+    // the publisher's segment shows up in it.
+    static_cast<quint32*>(segment->data())[0] = 0xff123456u;
+    QCOMPARE(mapped.pixel(0, 0), QRgb(0xff123456u));
+}
+
+void tst_SharedImageSegment::publishAndAttach_keepsColorSpace()
+{
+    QImage image = makeImage();
+    image.setColorSpace(QColorSpace(QColorSpace::DisplayP3));
+    SharedImageDescriptor descriptor;
+    std::unique_ptr<QSharedMemory> segment = publishSharedImage(image, &descriptor);
+    if (!segment) {
+        QSKIP("Shared memory is unavailable in this environment");
+    }
+    QVERIFY(!descriptor.iccProfile.isEmpty());
+
+    SharedImageView view;
+    QVERIFY2(view.attach(SharedImageDescriptor::fromJson(descriptor.toJson())),
+             qPrintable(view.errorString()));
+    const QImage mapped = view.image();
+    QVERIFY(mapped.colorSpace().isValid());
+    QCOMPARE(mapped.colorSpace().iccProfile(), image.colorSpace().iccProfile());
+
+    // Without a colour space nothing is sent and none is set.
+    SharedImageDescriptor plainDescriptor;
+    std::unique_ptr<QSharedMemory> plainSegment = publishSharedImage(makeImage(), &plainDescriptor);
+    QVERIFY(plainSegment);
+    QVERIFY(plainDescriptor.iccProfile.isEmpty());
+    QVERIFY(!plainDescriptor.toJson().contains("icc"));
+}
+
+void tst_SharedImageSegment::attach_failsAfterRelease()
+{
+    SharedImageDescriptor descriptor;
+    std::unique_ptr<QSharedMemory> segment = publishSharedImage(makeImage(), &descriptor);
+    if (!segment) {
+        QSKIP("Shared memory is unavailable in this environment");
+    }
+    segment.reset();
+
+    SharedImageView view;
+    QVERIFY(!view.attach(descriptor));
+    QVERIFY(view.image().isNull());
+    QVERIFY(!view.errorString().isEmpty());
+}
+
+QTEST_MAIN(tst_SharedImageSegment)
+#include "tst_SharedImageSegment.moc"
@@ -0,0 +1,210 @@
+#include <QtTest/QtTest>
+#include <QImage>
+
+#include "detection/CredentialDetector.h"
+#include "detection/DetectionResultCache.h"
+
+#include <cstring>
+
+namespace {
+
+using Kind = DetectionResultCache::Kind;
+
+QImage createImage(const QSize& size, QImage::Format format = QImage::Format_RGB32)
+{
+    QImage image(size, format);
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            image.setPixelColor(x, y, QColor((x * 7) & 0xff, (y * 5) & 0xff, (x + y) & 0xff));
+        }
+    }
+    return image;
+}
+
+OCRTextBlock makeBlock(const QString& text, const QRectF& rect)
+{
+    OCRTextBlock block;
+    block.text = text;
+    block.boundingRect = rect;
+    return block;
+}
+
+} // namespace
+
+/**
+ * @brief Tests for DetectionResultCache
+ *
+ * Covers:
+ * - Image hashing sensitivity and padding independence
+ * - Hit/miss counters and configuration-specific keys
+ * - LRU eviction under the memory cap
+ * - Per-kind invalidation
+ * - CredentialDetector reuse of cached regions
+ */
+class TestDetectionResultCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanupTestCase();
+
+    void testHashImage_DetectsSinglePixelChange();
+    void testHashImage_IgnoresRowPadding();
+    void testHashImage_DistinguishesSizeAndFormat();
+
+    void testLookup_CountsHitsAndMisses();
+    void testLookup_ConfigHashIsPartOfKey();
+    void testInsert_EvictsLeastRecentlyUsed();
+    void testInvalidate_DropsOnlyThatKind();
+
+    void testCredentialDetector_ReusesCachedRegions();
+};
+
+void TestDetectionResultCache::init()
+{
+    DetectionResultCache::instance().setMaxBytes(DetectionResultCache::kDefaultMaxBytes);
+    DetectionResultCache::instance().clear();
+}
+
+void TestDetectionResultCache::cleanupTestCase()
+{
+    DetectionResultCache::instance().clear();
+}
+
+void TestDetectionResultCache::testHashImage_DetectsSinglePixelChange()
+{
+    const QImage image = createImage(QSize(320, 200));
+    QImage edited = image.copy();
+    edited.setPixelColor(319, 199, QColor(1, 2, 3));
+
+    QCOMPARE(DetectionResultCache::hashImage(image), DetectionResultCache::hashImage(image.copy()));
+    QVERIFY(DetectionResultCache::hashImage(image) != DetectionResultCache::hashImage(edited));
+    QCOMPARE(DetectionResultCache::hashImage(QImage()), quint64(0));
+}
+
+void TestDetectionResultCache::testHashImage_IgnoresRowPadding()
+{
+    // RGB888 rows of odd width are padded to four bytes.
+    const QImage packed = createImage(QSize(33, 17), QImage::Format_RGB888);
+    QVERIFY(packed.bytesPerLine() > packed.width() * 3);
+
+    QImage dirty(packed.size(), packed.format());
+    dirty.fill(Qt::white);
+    for (int y = 0; y < packed.height(); ++y) {
+        std::memcpy(dirty.scanLine(y), packed.constScanLine(y), packed.width() * 3);
+    }
+    QCOMPARE(DetectionResultCache::hashImage(dirty), DetectionResultCache::hashImage(packed));
+}
+
+void TestDetectionResultCache::testHashImage_DistinguishesSizeAndFormat()
+{
+    QImage wide(QSize(64, 16), QImage::Format_RGB32);
+    QImage tall(QSize(16, 64), QImage::Format_RGB32);
+    wide.fill(Qt::black);
+    tall.fill(Qt::black);
+    QVERIFY(DetectionResultCache::hashImage(wide) != DetectionResultCache::hashImage(tall));
+
+    QImage argb = wide.convertToFormat(QImage::Format_ARGB32);
+    QVERIFY(DetectionResultCache::hashImage(wide) != DetectionResultCache::hashImage(argb));
+}
+
+void TestDetectionResultCache::testLookup_CountsHitsAndMisses()
+{
+    auto& cache = DetectionResultCache::instance();
+    const QVector<QRect> faces = {QRect(10, 20, 30, 40), QRect(100, 100, 50, 50)};
+
+    QVector<QRect> result;
+    QVERIFY(!cache.lookup(Kind::Faces, 42, 7, &result));
+    cache.insert(Kind::Faces, 42, 7, faces, faces.size() * qint64(sizeof(QRect)));
+    QVERIFY(cache.lookup(Kind::Faces, 42, 7, &result));
+    QCOMPARE(result, faces);
+
+    const DetectionResultCache::Stats stats = cache.stats(Kind::Faces);
+    QCOMPARE(stats.hits, quint64(1));
+    QCOMPARE(stats.misses, quint64(1));
+    QCOMPARE(stats.entries, 1);
+    QVERIFY(cache.costBytes() > 0);
+
+    // The same hashes under another kind are a separate entry.
+    QVERIFY(!cache.lookup(Kind::Credentials, 42, 7, &result));
+    QCOMPARE(cache.stats(Kind::Credentials).misses, quint64(1));
+    QCOMPARE(cache.stats(Kind::Faces).hits, quint64(1));
+}
+
+void TestDetectionResultCache::testLookup_ConfigHashIsPartOfKey()
+{
+    auto& cache = DetectionResultCache::instance();
+    cache.insert(Kind::Faces, 1, DetectionResultCache::combineHash(0, 30),
+                 QVector<QRect>{QRect(0, 0, 30, 30)}, 16);
+
+    QVector<QRect> result;
+    QVERIFY(!cache.lookup(Kind::Faces, 1, DetectionResultCache::combineHash(0, 60), &result));
+    QVERIFY(cache.lookup(Kind::Faces, 1, DetectionResultCache::combineHash(0, 30), &result));
+    QCOMPARE(result.size(), 1);
+}
+
+void TestDetectionResultCache::testInsert_EvictsLeastRecentlyUsed()
+{
+    auto& cache = DetectionResultCache::instance();
+    const qint64 entryCost = 1000;
+    cache.setMaxBytes(3 * (entryCost + qint64(sizeof(QVector<QRect>))));
+
+    const QVector<QRect> faces = {QRect(1, 2, 3, 4)};
+    cache.insert(Kind::Faces, 1, 0, faces, entryCost);
+    cache.insert(Kind::Faces, 2, 0, faces, entryCost);
+    cache.insert(Kind::Faces, 3, 0, faces, entryCost);
+
+    // Touch the oldest entry so the second one becomes least recently used.
+    QVector<QRect> result;
+    QVERIFY(cache.lookup(Kind::Faces, 1, 0, &result));
+    cache.insert(Kind::Faces, 4, 0, faces, entryCost);
+
+    QVERIFY(cache.lookup(Kind::Faces, 1, 0, &result));
+    QVERIFY(!cache.lookup(Kind::Faces, 2, 0, &result));
+    QVERIFY(cache.lookup(Kind::Faces, 3, 0, &result));
+    QVERIFY(cache.lookup(Kind::Faces, 4, 0, &result));
+    QVERIFY(cache.costBytes() <= cache.maxBytes());
+}
+
+void TestDetectionResultCache::testInvalidate_DropsOnlyThatKind()
+{
+    auto& cache = DetectionResultCache::instance();
+    cache.insert(Kind::Faces, 5, 0, QVector<QRect>{QRect(0, 0, 8, 8)}, 16);
+    cache.insert(Kind::Credentials, 5, 0, QVector<QRect>{QRect(0, 0, 8, 8)}, 16);
+
+    cache.invalidate(Kind::Faces);
+
+    QVector<QRect> result;
+    QVERIFY(!cache.lookup(Kind::Faces, 5, 0, &result));
+    QVERIFY(cache.lookup(Kind::Credentials, 5, 0, &result));
+    QCOMPARE(cache.stats(Kind::Faces).entries, 0);
+    QCOMPARE(cache.stats(Kind::Credentials).entries, 1);
+}
+
+void TestDetectionResultCache::testCredentialDetector_ReusesCachedRegions()
+{
+    auto& cache = DetectionResultCache::instance();
+    const QSize imageSize(1000, 500);
+    const QVector<OCRTextBlock> blocks = {
+        makeBlock(QStringLiteral("password:"), QRectF(0.10, 0.20, 0.10, 0.05)),
+        makeBlock(QStringLiteral("hunter2hunter2"), QRectF(0.22, 0.20, 0.15, 0.05)),
+    };
+
+    const QVector<QRect> first = CredentialDetector::detect(blocks, imageSize);
+    QCOMPARE(cache.stats(Kind::Credentials).misses, quint64(1));
+    QCOMPARE(cache.stats(Kind::Credentials).hits, quint64(0));
+
+    const QVector<QRect> second = CredentialDetector::detect(blocks, imageSize);
+    QCOMPARE(second, first);
+    QCOMPARE(cache.stats(Kind::Credentials).hits, quint64(1));
+
+    // Different OCR geometry is a different key.
+    QVector<OCRTextBlock> moved = blocks;
+    moved[1].boundingRect.moveLeft(0.25);
+    CredentialDetector::detect(moved, imageSize);
+    QCOMPARE(cache.stats(Kind::Credentials).misses, quint64(2));
+}
+
+QTEST_MAIN(TestDetectionResultCache)
+#include "tst_DetectionResultCache.moc"
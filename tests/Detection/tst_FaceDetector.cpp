@@ -3,6 +3,8 @@
 #include <QImage>
 #include <QPainter>
 
+#include <algorithm>
+
 /**
  * @brief Test class for FaceDetector.
  *
@@ -32,12 +34,15 @@ private slots:
     void testDetect_BeforeInitialize();
     void testDetect_SmallImage();
     void testDetect_LargeImage();
+    void testDetect_TiledMatchesSinglePassAcrossSeams();
 
 private:
     FaceDetector* m_detector;
 
     // Helper to create a simple test image
     QImage createTestImage(int width, int height);
+    // Helper to draw a simple frontal face centered on center
+    static void drawFace(QPainter& painter, const QPoint& center, int size);
 };
 
 void tst_FaceDetector::init()
@@ -81,6 +86,7 @@ void tst_FaceDetector::testDefaultConfig()
     QCOMPARE(config.minNeighbors, 5);
     QCOMPARE(config.minFaceSize, 30);
     QCOMPARE(config.maxFaceSize, 0);  // 0 means no limit
+    QCOMPARE(config.tileSize, 640);
 }
 
 void tst_FaceDetector::testSetConfig()
@@ -90,6 +96,7 @@ void tst_FaceDetector::testSetConfig()
     newConfig.minNeighbors = 3;
     newConfig.minFaceSize = 50;
     newConfig.maxFaceSize = 300;
+    newConfig.tileSize = 0;
 
     m_detector->setConfig(newConfig);
 
@@ -98,6 +105,7 @@ void tst_FaceDetector::testSetConfig()
     QCOMPARE(retrievedConfig.minNeighbors, 3);
     QCOMPARE(retrievedConfig.minFaceSize, 50);
     QCOMPARE(retrievedConfig.maxFaceSize, 300);
+    QCOMPARE(retrievedConfig.tileSize, 0);
 }
 
 void tst_FaceDetector::testDetect_EmptyImage()
@@ -154,6 +162,89 @@ void tst_FaceDetector::testDetect_LargeImage()
     QVERIFY(results.size() >= 0);
 }
 
+void tst_FaceDetector::testDetect_TiledMatchesSinglePassAcrossSeams()
+{
+    // minFaceSize 48 halves the image into a 800x600 proxy, which is cut into
+    // 640-pixel tiles overlapping by 80; tile ownership changes at proxy 600,
+    // i.e. x = 1200 and y = 1200 at full resolution.
+    QImage image(1600, 1400, QImage::Format_RGB32);
+    image.fill(QColor(200, 205, 210));
+    QPainter painter(&image);
+    const int seam = 1200;
+    const QList<QPoint> centers = {
+        {seam, 300},          // Centered on the vertical seam
+        {seam - 70, 700},     // In the overlap, owned by the left tile
+        {seam + 70, 1000},    // In the overlap, owned by the right tile
+        {400, seam},          // Centered on the horizontal seam
+        {seam, seam},         // On the corner shared by four tiles
+    };
+    for (const QPoint& center : centers) {
+        drawFace(painter, center, 80);
+    }
+    painter.end();
+
+    FaceDetector tiled;
+    QVERIFY(tiled.initialize());
+    FaceDetector::Config config = tiled.config();
+    config.minFaceSize = 48;
+    tiled.setConfig(config);
+
+    FaceDetector singlePass;
+    QVERIFY(singlePass.initialize());
+    config.tileSize = 0;
+    singlePass.setConfig(config);
+
+    const QVector<QRect> expected = singlePass.detect(image);
+    if (expected.isEmpty()) {
+        QSKIP("The cascade finds none of the synthetic faces");
+    }
+    QVector<QRect> actual = tiled.detect(image);
+
+    // Seams must neither drop nor duplicate a face, and each face must get the
+    // box the single pass reports for it. Tiles resample their own region of
+    // the pyramid, so a box may land a pixel or two away.
+    QCOMPARE(actual.size(), expected.size());
+    for (const QRect& face : expected) {
+        const auto overlap = [&face](const QRect& other) {
+            const QRect common = face.intersected(other);
+            const double intersection = double(common.width()) * common.height();
+            return intersection / (double(face.width()) * face.height()
+                                   + double(other.width()) * other.height() - intersection);
+        };
+        const auto match = std::max_element(actual.begin(), actual.end(),
+                                            [&overlap](const QRect& a, const QRect& b) {
+                                                return overlap(a) < overlap(b);
+                                            });
+        QVERIFY2(overlap(*match) > 0.9,
+                 qPrintable(QString("No tiled match for face at %1,%2")
+                                .arg(face.x()).arg(face.y())));
+        actual.erase(match);
+    }
+}
+
+void tst_FaceDetector::drawFace(QPainter& painter, const QPoint& center, int size)
+{
+    const QRectF face(center.x() - size / 2.0, center.y() - size * 0.6, size, size * 1.2);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(225, 190, 160));
+    painter.drawEllipse(face);
+
+    // Dark brows and eyes over bright cheeks and nose bridge are what a frontal
+    // Haar cascade keys on.
+    painter.setBrush(QColor(40, 30, 25));
+    const qreal eyeY = face.top() + face.height() * 0.38;
+    for (const qreal side : {-1.0, 1.0}) {
+        const qreal eyeX = center.x() + side * size * 0.2;
+        painter.drawRect(QRectF(eyeX - size * 0.14, eyeY - size * 0.16, size * 0.28, size * 0.05));
+        painter.drawEllipse(QPointF(eyeX, eyeY), size * 0.1, size * 0.06);
+    }
+    painter.setBrush(QColor(190, 150, 125));
+    painter.drawRect(QRectF(center.x() - size * 0.05, eyeY + size * 0.05, size * 0.1, size * 0.25));
+    painter.setBrush(QColor(120, 50, 50));
+    painter.drawEllipse(QPointF(center.x(), face.top() + face.height() * 0.75), size * 0.2,
+                        size * 0.05);
+}
+
 QImage tst_FaceDetector::createTestImage(int width, int height)
 {
     QImage image(width, height, QImage::Format_RGB32);
@@ -0,0 +1,138 @@
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QThread>
+
+#include "detection/FaceDetector.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief Latency benchmark for FaceDetector on high-resolution captures
+ *
+ * Times the tiled proxy search against a single pass over the same proxy on
+ * synthetic 4K and 5K screenshots. Timings are only reported; set
+ * SNAPTRAY_ENFORCE_BENCHMARK_BUDGETS=1 to fail when the tiled search misses
+ * its latency budget.
+ */
+class TestFaceDetectorBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchmarkDetect_data();
+    void benchmarkDetect();
+
+private:
+    static QImage createScreenshotLikeImage(const QSize& size);
+    static double medianDetectMs(FaceDetector& detector, const QImage& image,
+                                 int iterations, int* faceCount);
+};
+
+QImage TestFaceDetectorBenchmark::createScreenshotLikeImage(const QSize& size)
+{
+    // Windows, text lines and a few photo-like gradients over a desktop.
+    QRandomGenerator rng(0x5f);
+    QImage image(size, QImage::Format_RGB32);
+    image.fill(QColor(48, 72, 96));
+
+    QPainter painter(&image);
+    for (int i = 0; i < 24; ++i) {
+        const QRect window(rng.bounded(size.width() - 800), rng.bounded(size.height() - 600),
+                           400 + rng.bounded(1200), 300 + rng.bounded(900));
+        painter.fillRect(window, QColor(230 + rng.bounded(25), 230 + rng.bounded(25), 235));
+        painter.fillRect(window.x(), window.y(), window.width(), 32, QColor(60, 60, 70));
+        painter.setPen(Qt::black);
+        for (int y = window.y() + 48; y < window.bottom() - 16; y += 22) {
+            painter.drawText(window.x() + 16, y, QStringLiteral("Lorem ipsum dolor sit amet 0123456789"));
+        }
+    }
+    for (int i = 0; i < 6; ++i) {
+        const QRect photo(rng.bounded(size.width() - 600), rng.bounded(size.height() - 400),
+                          200 + rng.bounded(400), 150 + rng.bounded(250));
+        QRadialGradient gradient(photo.center(), photo.width() / 2.0);
+        gradient.setColorAt(0.0, QColor(220, 180, 150));
+        gradient.setColorAt(1.0, QColor(40, 30, 20));
+        painter.fillRect(photo, gradient);
+    }
+    painter.end();
+    return image;
+}
+
+double TestFaceDetectorBenchmark::medianDetectMs(FaceDetector& detector, const QImage& image,
+                                                 int iterations, int* faceCount)
+{
+    // Warm-up run also creates the per-thread classifiers.
+    *faceCount = detector.detect(image).size();
+
+    std::vector<qint64> timingsNs;
+    timingsNs.reserve(iterations);
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; ++i) {
+        timer.start();
+        detector.detect(image);
+        timingsNs.push_back(timer.nsecsElapsed());
+    }
+    std::sort(timingsNs.begin(), timingsNs.end());
+    return static_cast<double>(timingsNs[timingsNs.size() / 2]) / 1.0e6;
+}
+
+void TestFaceDetectorBenchmark::benchmarkDetect_data()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<int>("minFaceSize");
+    QTest::addColumn<double>("budgetMs");
+
+    QTest::newRow("4K min 30") << QSize(3840, 2160) << 30 << 3000.0;
+    QTest::newRow("4K min 60") << QSize(3840, 2160) << 60 << 1500.0;
+    QTest::newRow("5K min 30") << QSize(5120, 2880) << 30 << 5000.0;
+    QTest::newRow("5K min 60") << QSize(5120, 2880) << 60 << 2500.0;
+}
+
+void TestFaceDetectorBenchmark::benchmarkDetect()
+{
+    QFETCH(QSize, size);
+    QFETCH(int, minFaceSize);
+    QFETCH(double, budgetMs);
+    constexpr int kIterations = 3;
+
+    const QImage image = createScreenshotLikeImage(size);
+
+    FaceDetector tiled;
+    QVERIFY(tiled.initialize());
+    FaceDetector::Config config = tiled.config();
+    config.minFaceSize = minFaceSize;
+    tiled.setConfig(config);
+
+    FaceDetector singlePass;
+    QVERIFY(singlePass.initialize());
+    config.tileSize = 0;
+    singlePass.setConfig(config);
+
+    int tiledFaces = 0;
+    int singlePassFaces = 0;
+    const double tiledMs = medianDetectMs(tiled, image, kIterations, &tiledFaces);
+    const double singlePassMs = medianDetectMs(singlePass, image, kIterations, &singlePassFaces);
+
+    qInfo().nospace()
+        << "FaceDetector " << size.width() << "x" << size.height()
+        << " min " << minFaceSize << ": tiled median " << tiledMs << " ms ("
+        << tiledFaces << " faces), single pass " << singlePassMs << " ms ("
+        << singlePassFaces << " faces), " << QThread::idealThreadCount() << " threads";
+
+    // Wall-clock budgets depend on the machine, so CI only reports them.
+    if (qEnvironmentVariableIntValue("SNAPTRAY_ENFORCE_BENCHMARK_BUDGETS") != 0) {
+        QVERIFY2(tiledMs < budgetMs,
+                 qPrintable(QString("Detection took %1 ms, budget %2 ms")
+                                .arg(tiledMs).arg(budgetMs)));
+    } else if (tiledMs >= budgetMs) {
+        qWarning().nospace() << "Detection took " << tiledMs << " ms, over the " << budgetMs
+                             << " ms budget";
+    }
+}
+
+QTEST_MAIN(TestFaceDetectorBenchmark)
+#include "tst_FaceDetectorBenchmark.moc"
@@ -86,6 +86,7 @@ private slots:
     void testWindowsModernUiRecognizesOnlyImeAndTooltipClasses();
     void testWindowsModernUiDoesNotMaskStyleOrOwnerClassification();
     void testLinuxX11TopLevelWindowDetectionFindsVisibleWindow();
+    void testLinuxX11CacheFollowsWindowChanges();
 };
 
 void tst_WindowDetectorQueryMode::testTopLevelOnlySkipsChildQuery()
@@ -448,5 +449,102 @@ void tst_WindowDetectorQueryMode::testLinuxX11TopLevelWindowDetectionFindsVisibl
 #endif
 }
 
+void tst_WindowDetectorQueryMode::testLinuxX11CacheFollowsWindowChanges()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("Linux X11 window detection is only tested on Linux.");
+#else
+    if (QGuiApplication::platformName() != QStringLiteral("xcb")) {
+        QSKIP("Linux window detection currently supports X11/xcb only.");
+    }
+
+    auto* x11Application = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+    if (!x11Application || !x11Application->display()) {
+        QSKIP("No X11 display available for window detection test.");
+    }
+
+    QScreen* screen = QGuiApplication::primaryScreen();
+    if (!screen) {
+        QSKIP("No screen available for Linux window detection test.");
+    }
+
+    const QRect testBounds =
+        clampRectToScreen(screen->geometry(), screen->geometry().center(), QSize(240, 160));
+    if (!testBounds.isValid()) {
+        QSKIP("Screen geometry is too small for Linux window detection test.");
+    }
+
+    // The detector exists before the window, so the window has to reach the
+    // cache through events rather than the initial enumeration.
+    WindowDetector detector;
+    detector.setScreen(screen);
+    detector.setEnabled(true);
+    detector.refreshWindowList(WindowDetector::QueryMode::TopLevelOnly);
+
+    Display* display = x11Application->display();
+    const int defaultScreen = DefaultScreen(display);
+    ::Window testWindow = XCreateSimpleWindow(
+        display,
+        RootWindow(display, defaultScreen),
+        testBounds.x(),
+        testBounds.y(),
+        static_cast<unsigned int>(testBounds.width()),
+        static_cast<unsigned int>(testBounds.height()),
+        0,
+        BlackPixel(display, defaultScreen),
+        WhitePixel(display, defaultScreen));
+    QVERIFY(testWindow != 0);
+
+    struct WindowGuard
+    {
+        Display* display = nullptr;
+        ::Window* window = nullptr;
+
+        ~WindowGuard()
+        {
+            if (display && *window != 0) {
+                XDestroyWindow(display, *window);
+                XFlush(display);
+            }
+        }
+    } windowGuard{display, &testWindow};
+
+    XStoreName(display, testWindow, "SnapTray X11 cache test");
+    XMapRaised(display, testWindow);
+    XSync(display, False);
+
+    const QPoint hitPoint = testBounds.center();
+    const auto detectTestWindow = [&]() -> std::optional<DetectedElement> {
+        detector.refreshWindowList(WindowDetector::QueryMode::TopLevelOnly);
+        auto result = detector.detectWindowAt(hitPoint, WindowDetector::QueryMode::TopLevelOnly);
+        if (!result.has_value() || result->windowId != static_cast<uint32_t>(testWindow)) {
+            return std::nullopt;
+        }
+        return result;
+    };
+
+    QTRY_VERIFY_WITH_TIMEOUT(detectTestWindow().has_value(), 3000);
+
+    XStoreName(display, testWindow, "SnapTray X11 cache test (renamed)");
+    XSync(display, False);
+    QTRY_VERIFY_WITH_TIMEOUT(([&]() {
+        const auto result = detectTestWindow();
+        return result.has_value() &&
+               result->windowTitle == QStringLiteral("SnapTray X11 cache test (renamed)");
+    }()), 3000);
+
+    const uint32_t destroyedId = static_cast<uint32_t>(testWindow);
+    XDestroyWindow(display, testWindow);
+    testWindow = 0;
+    XSync(display, False);
+    QTRY_VERIFY_WITH_TIMEOUT(([&]() {
+        detector.refreshWindowList(WindowDetector::QueryMode::TopLevelOnly);
+        const auto result =
+            detector.detectWindowAt(hitPoint, WindowDetector::QueryMode::TopLevelOnly);
+        return !result.has_value() || result->windowId != destroyedId;
+    }()), 3000);
+#endif
+}
+
 QTEST_MAIN(tst_WindowDetectorQueryMode)
 #include "tst_WindowDetectorQueryMode.moc"
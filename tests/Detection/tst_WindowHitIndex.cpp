@@ -0,0 +1,184 @@
+#include <QtTest/QtTest>
+
+#include <QRandomGenerator>
+
+#include "WindowDetector.h"
+#include "WindowHitIndex.h"
+
+namespace {
+
+DetectedElement makeElement(const QRect& bounds, int layer = 0)
+{
+    DetectedElement element;
+    element.bounds = bounds;
+    element.windowLayer = layer;
+    element.windowId = 0;
+    return element;
+}
+
+// First element in cache order containing point, as a linear scan finds it.
+int linearTopmostAt(const std::vector<DetectedElement>& elements, const QPoint& point)
+{
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (elements[i].bounds.contains(point)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int indexedTopmostAt(const WindowHitIndex& index,
+                     const std::vector<DetectedElement>& elements,
+                     const QPoint& point)
+{
+    for (const uint32_t i : index.candidatesAt(point)) {
+        if (elements[i].bounds.contains(point)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+class tst_WindowHitIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCandidatesKeepCacheOrder();
+    void testPointsOutsideExtentHaveNoCandidates();
+    void testChildrenMapToPrecedingTopLevel();
+    void testMatchesLinearScanOnDenseDesktop();
+    void testHugeExtentKeepsGridBounded();
+    void testIsBuiltForTracksSource();
+};
+
+void tst_WindowHitIndex::testCandidatesKeepCacheOrder()
+{
+    const std::vector<DetectedElement> elements = {
+        makeElement(QRect(100, 100, 200, 200)),
+        makeElement(QRect(0, 0, 800, 600)),
+        makeElement(QRect(150, 150, 20, 20)),
+    };
+
+    WindowHitIndex index;
+    index.build(elements);
+
+    std::vector<uint32_t> candidates;
+    for (const uint32_t i : index.candidatesAt(QPoint(160, 160))) {
+        candidates.push_back(i);
+    }
+    QVERIFY(std::is_sorted(candidates.cbegin(), candidates.cend()));
+    QCOMPARE(indexedTopmostAt(index, elements, QPoint(160, 160)), 0);
+    QCOMPARE(indexedTopmostAt(index, elements, QPoint(500, 500)), 1);
+}
+
+void tst_WindowHitIndex::testPointsOutsideExtentHaveNoCandidates()
+{
+    const std::vector<DetectedElement> elements = {
+        makeElement(QRect(-1920, 0, 1920, 1080)),
+        makeElement(QRect(0, 0, 1920, 1080)),
+    };
+
+    WindowHitIndex index;
+    index.build(elements);
+
+    QVERIFY(index.candidatesAt(QPoint(-1921, 10)).empty());
+    QVERIFY(index.candidatesAt(QPoint(10, 1080)).empty());
+    QCOMPARE(indexedTopmostAt(index, elements, QPoint(-1920, 0)), 0);
+    QCOMPARE(indexedTopmostAt(index, elements, QPoint(1919, 1079)), 1);
+
+    WindowHitIndex emptyIndex;
+    emptyIndex.build({});
+    QVERIFY(emptyIndex.candidatesAt(QPoint(0, 0)).empty());
+}
+
+void tst_WindowHitIndex::testChildrenMapToPrecedingTopLevel()
+{
+    const std::vector<DetectedElement> elements = {
+        makeElement(QRect(10, 10, 10, 10), 1),
+        makeElement(QRect(0, 0, 400, 300)),
+        makeElement(QRect(10, 10, 50, 20), 1),
+        makeElement(QRect(10, 40, 50, 20), 1),
+        makeElement(QRect(200, 0, 400, 300)),
+        makeElement(QRect(210, 10, 50, 20), 1),
+    };
+
+    WindowHitIndex index;
+    index.build(elements);
+
+    QCOMPARE(index.topLevelIndexOf(0), WindowHitIndex::kNoTopLevel);
+    QCOMPARE(index.topLevelIndexOf(1), 1u);
+    QCOMPARE(index.topLevelIndexOf(2), 1u);
+    QCOMPARE(index.topLevelIndexOf(3), 1u);
+    QCOMPARE(index.topLevelIndexOf(4), 4u);
+    QCOMPARE(index.topLevelIndexOf(5), 4u);
+    QCOMPARE(index.topLevelIndexOf(6), WindowHitIndex::kNoTopLevel);
+}
+
+void tst_WindowHitIndex::testMatchesLinearScanOnDenseDesktop()
+{
+    QRandomGenerator rng(0x5eed);
+    const QRect desktop(-2560, 0, 2560 + 3840, 2160);
+
+    // A few hundred windows, each followed by a run of child controls.
+    std::vector<DetectedElement> elements;
+    for (int window = 0; window < 200; ++window) {
+        const QRect bounds(desktop.left() + rng.bounded(desktop.width() - 300),
+                           desktop.top() + rng.bounded(desktop.height() - 200),
+                           300 + rng.bounded(1200),
+                           200 + rng.bounded(800));
+        elements.push_back(makeElement(bounds));
+        for (int child = 0; child < 20; ++child) {
+            const QRect childBounds(bounds.left() + rng.bounded(bounds.width() - 20),
+                                    bounds.top() + rng.bounded(bounds.height() - 10),
+                                    20 + rng.bounded(200),
+                                    10 + rng.bounded(60));
+            elements.push_back(makeElement(childBounds, 1));
+        }
+    }
+
+    WindowHitIndex index;
+    index.build(elements);
+
+    for (int i = 0; i < 5000; ++i) {
+        const QPoint point(desktop.left() - 50 + rng.bounded(desktop.width() + 100),
+                           desktop.top() - 50 + rng.bounded(desktop.height() + 100));
+        QCOMPARE(indexedTopmostAt(index, elements, point), linearTopmostAt(elements, point));
+    }
+}
+
+void tst_WindowHitIndex::testHugeExtentKeepsGridBounded()
+{
+    const std::vector<DetectedElement> elements = {
+        makeElement(QRect(-1000000, -1000000, 2000000, 2000000)),
+        makeElement(QRect(100, 100, 50, 50)),
+    };
+
+    WindowHitIndex index;
+    index.build(elements);
+
+    QCOMPARE(indexedTopmostAt(index, elements, QPoint(120, 120)), 0);
+    QCOMPARE(indexedTopmostAt(index, elements, QPoint(-999999, 999999)), 0);
+}
+
+void tst_WindowHitIndex::testIsBuiltForTracksSource()
+{
+    std::vector<DetectedElement> elements = {makeElement(QRect(0, 0, 100, 100))};
+
+    WindowHitIndex index;
+    QVERIFY(!index.isBuiltFor(elements));
+    index.build(elements);
+    QVERIFY(index.isBuiltFor(elements));
+
+    elements.push_back(makeElement(QRect(50, 50, 100, 100)));
+    QVERIFY(!index.isBuiltFor(elements));
+
+    index.build(elements);
+    index.clear();
+    QVERIFY(!index.isBuiltFor(elements));
+}
+
+QTEST_MAIN(tst_WindowHitIndex)
+#include "tst_WindowHitIndex.moc"
@@ -0,0 +1,310 @@
+#include <QtTest/QtTest>
+#include <QBuffer>
+#include <QFile>
+#include <QImageReader>
+#include <QPainter>
+#include <QTemporaryDir>
+
+#include "encoding/AnimationTrimmer.h"
+#include "encoding/NativeGifEncoder.h"
+#include "encoding/WebPAnimEncoder.h"
+
+namespace {
+
+constexpr int kFrameCount = 10;
+constexpr int kFrameIntervalMs = 100;
+const QSize kFrameSize(64, 48);
+
+struct DecodedFrame {
+    QImage image;
+    int delayMs = 0;
+};
+
+QRect blockRect(int index)
+{
+    return QRect(index * 4, 10, 12, 12);
+}
+
+// Every pixel differs from the previous frame, so the encoder never marks
+// unchanged pixels transparent and each full frame stands on its own.
+QImage createAnimatedFrame(int index)
+{
+    QImage frame(kFrameSize, QImage::Format_RGB32);
+    QPainter painter(&frame);
+    const int green = index % 2 ? 40 : 200;
+    for (int x = 0; x < kFrameSize.width(); ++x) {
+        painter.setPen(QColor(x * 4, green, 200 - x * 3));
+        painter.drawLine(x, 0, x, kFrameSize.height());
+    }
+    painter.fillRect(blockRect(index), index % 2 ? Qt::yellow : Qt::white);
+    return frame;
+}
+
+QList<DecodedFrame> decodeFrames(const QByteArray& data, const QByteArray& format)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer, format);
+
+    QList<DecodedFrame> frames;
+    QImage image;
+    while (reader.read(&image)) {
+        frames.append({image.convertToFormat(QImage::Format_ARGB32), reader.nextImageDelay()});
+    }
+    return frames;
+}
+
+} // namespace
+
+/**
+ * @brief Tests for AnimationTrimmer
+ *
+ * Covers:
+ * - Container detection
+ * - Byte-for-byte copy of the frames inside the range
+ * - Delay clipping at both ends of the range
+ * - Re-basing a first frame that only stores the changed area
+ * - Animated WebP trimming
+ */
+class TestAnimationTrimmer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testDetectFormat();
+    void testRejectsInvalidInput();
+
+    void testGifFullRangeIsUnchanged();
+    void testGifKeepsFramesInRange();
+    void testGifClipsBoundaryDelays();
+    void testGifRebasesPartialFirstFrame();
+    void testGifEmptyRangeFails();
+
+    void testWebPKeepsFramesInRange();
+
+    void testTrimFileWritesOutput();
+
+private:
+    QByteArray encodeGif(bool changedRectsOnly);
+    QByteArray encodeWebP();
+
+    QTemporaryDir* m_tempDir = nullptr;
+};
+
+void TestAnimationTrimmer::initTestCase()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestAnimationTrimmer::cleanupTestCase()
+{
+    delete m_tempDir;
+    m_tempDir = nullptr;
+}
+
+QByteArray TestAnimationTrimmer::encodeGif(bool changedRectsOnly)
+{
+    const QString path = m_tempDir->filePath(changedRectsOnly ? "rects.gif" : "full.gif");
+    NativeGifEncoder encoder;
+    if (!encoder.start(path, kFrameSize, 1000 / kFrameIntervalMs)) {
+        return QByteArray();
+    }
+    for (int i = 0; i < kFrameCount; ++i) {
+        const QRect changed = changedRectsOnly && i > 0
+            ? blockRect(i - 1).united(blockRect(i))
+            : QRect();
+        encoder.writeFrame(createAnimatedFrame(i), qint64(i) * kFrameIntervalMs, changed);
+    }
+    encoder.finish();
+
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+QByteArray TestAnimationTrimmer::encodeWebP()
+{
+    const QString path = m_tempDir->filePath("anim.webp");
+    WebPAnimationEncoder encoder;
+    if (!encoder.start(path, kFrameSize, 1000 / kFrameIntervalMs)) {
+        return QByteArray();
+    }
+    for (int i = 0; i < kFrameCount; ++i) {
+        encoder.writeFrame(createAnimatedFrame(i), qint64(i) * kFrameIntervalMs);
+    }
+    encoder.finish();
+
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+void TestAnimationTrimmer::testDetectFormat()
+{
+    QCOMPARE(AnimationTrimmer::detectFormat("GIF89a......"), AnimationTrimmer::Format::Gif);
+    QCOMPARE(AnimationTrimmer::detectFormat("GIF87a......"), AnimationTrimmer::Format::Gif);
+    QCOMPARE(AnimationTrimmer::detectFormat(QByteArray("RIFF\x10\0\0\0WEBP", 12)),
+             AnimationTrimmer::Format::WebP);
+    QCOMPARE(AnimationTrimmer::detectFormat(QByteArray("RIFF\x10\0\0\0WAVE", 12)),
+             AnimationTrimmer::Format::Unknown);
+    QCOMPARE(AnimationTrimmer::detectFormat("\x89PNG\r\n"), AnimationTrimmer::Format::Unknown);
+}
+
+void TestAnimationTrimmer::testRejectsInvalidInput()
+{
+    QByteArray output;
+    QVERIFY(!AnimationTrimmer::trim("not an animation", 0, 100, &output).success);
+
+    const QByteArray gif = encodeGif(false);
+    QVERIFY(!gif.isEmpty());
+    QVERIFY(!AnimationTrimmer::trim(gif, 500, 500, &output).success);
+    QVERIFY(!AnimationTrimmer::trim(gif.left(20), 0, 100, &output).success);
+    QVERIFY(output.isEmpty());
+}
+
+void TestAnimationTrimmer::testGifFullRangeIsUnchanged()
+{
+    const QByteArray gif = encodeGif(false);
+    QVERIFY(!gif.isEmpty());
+
+    QByteArray output;
+    const auto result = AnimationTrimmer::trim(gif, 0, kFrameCount * kFrameIntervalMs, &output);
+    QVERIFY2(result.success, qPrintable(result.errorMessage));
+    QCOMPARE(result.framesWritten, kFrameCount);
+    QCOMPARE(result.framesRebased, 0);
+    QCOMPARE(result.durationMs, qint64(kFrameCount * kFrameIntervalMs));
+    QCOMPARE(output, gif);
+}
+
+void TestAnimationTrimmer::testGifKeepsFramesInRange()
+{
+    const QByteArray gif = encodeGif(false);
+    const QList<DecodedFrame> source = decodeFrames(gif, "gif");
+    QCOMPARE(source.size(), kFrameCount);
+
+    QByteArray output;
+    const auto result = AnimationTrimmer::trim(gif, 200, 500, &output);
+    QVERIFY2(result.success, qPrintable(result.errorMessage));
+    QCOMPARE(result.framesWritten, 3);
+    QCOMPARE(result.framesRebased, 0);
+    QVERIFY(output.size() < gif.size());
+
+    const QList<DecodedFrame> trimmed = decodeFrames(output, "gif");
+    QCOMPARE(trimmed.size(), 3);
+    for (int i = 0; i < trimmed.size(); ++i) {
+        QCOMPARE(trimmed[i].image, source[i + 2].image);
+        QCOMPARE(trimmed[i].delayMs, kFrameIntervalMs);
+    }
+}
+
+void TestAnimationTrimmer::testGifClipsBoundaryDelays()
+{
+    const QByteArray gif = encodeGif(false);
+
+    QByteArray output;
+    const auto result = AnimationTrimmer::trim(gif, 250, 420, &output);
+    QVERIFY2(result.success, qPrintable(result.errorMessage));
+    QCOMPARE(result.framesWritten, 3);
+    QCOMPARE(result.durationMs, qint64(170));
+
+    const QList<DecodedFrame> trimmed = decodeFrames(output, "gif");
+    QCOMPARE(trimmed.size(), 3);
+    QCOMPARE(trimmed[0].delayMs, 50);
+    QCOMPARE(trimmed[1].delayMs, 100);
+    QCOMPARE(trimmed[2].delayMs, 20);
+}
+
+void TestAnimationTrimmer::testGifRebasesPartialFirstFrame()
+{
+    const QByteArray gif = encodeGif(true);
+    const QList<DecodedFrame> source = decodeFrames(gif, "gif");
+    QCOMPARE(source.size(), kFrameCount);
+
+    QByteArray output;
+    const auto result = AnimationTrimmer::trim(gif, 300, 800, &output);
+    QVERIFY2(result.success, qPrintable(result.errorMessage));
+    QCOMPARE(result.framesWritten, 5);
+    // Only the first kept frame depends on dropped frames.
+    QCOMPARE(result.framesRebased, 1);
+
+    const QList<DecodedFrame> trimmed = decodeFrames(output, "gif");
+    QCOMPARE(trimmed.size(), 5);
+    for (int i = 0; i < trimmed.size(); ++i) {
+        QCOMPARE(trimmed[i].image, source[i + 3].image);
+    }
+}
+
+void TestAnimationTrimmer::testGifEmptyRangeFails()
+{
+    const QByteArray gif = encodeGif(false);
+
+    QByteArray output;
+    const auto result = AnimationTrimmer::trim(gif, 5000, 6000, &output);
+    QVERIFY(!result.success);
+    QVERIFY(!result.errorMessage.isEmpty());
+    QVERIFY(output.isEmpty());
+}
+
+void TestAnimationTrimmer::testWebPKeepsFramesInRange()
+{
+    const QByteArray webp = encodeWebP();
+    QVERIFY(!webp.isEmpty());
+
+    QByteArray output;
+    const auto result = AnimationTrimmer::trim(webp, 250, 620, &output);
+    QVERIFY2(result.success, qPrintable(result.errorMessage));
+    QCOMPARE(AnimationTrimmer::detectFormat(output), AnimationTrimmer::Format::WebP);
+    QCOMPARE(result.durationMs, qint64(370));
+    QVERIFY(result.framesWritten > 0);
+    QVERIFY(result.framesRebased <= result.framesWritten);
+
+    // The trimmed file parses again and its full range is copied as is.
+    QByteArray again;
+    const auto roundTrip = AnimationTrimmer::trim(output, 0, result.durationMs, &again);
+    QVERIFY2(roundTrip.success, qPrintable(roundTrip.errorMessage));
+    QCOMPARE(roundTrip.framesWritten, result.framesWritten);
+    QCOMPARE(roundTrip.framesRebased, 0);
+    QCOMPARE(again, output);
+
+    if (!QImageReader::supportedImageFormats().contains("webp")) {
+        return;
+    }
+    const QList<DecodedFrame> source = decodeFrames(webp, "webp");
+    QCOMPARE(source.size(), kFrameCount);
+    const QList<DecodedFrame> trimmed = decodeFrames(output, "webp");
+    QCOMPARE(trimmed.size(), result.framesWritten);
+    // 250 ms falls in the third frame, so that is where the output starts.
+    for (int i = 0; i < trimmed.size(); ++i) {
+        QCOMPARE(trimmed[i].image, source[i + 2].image);
+    }
+}
+
+void TestAnimationTrimmer::testTrimFileWritesOutput()
+{
+    const QByteArray gif = encodeGif(false);
+    const QString inputPath = m_tempDir->filePath("input.gif");
+    const QString outputPath = m_tempDir->filePath("output.gif");
+    {
+        QFile input(inputPath);
+        QVERIFY(input.open(QIODevice::WriteOnly));
+        input.write(gif);
+    }
+
+    QCOMPARE(AnimationTrimmer::detectFileFormat(inputPath), AnimationTrimmer::Format::Gif);
+    const auto result = AnimationTrimmer::trimFile(inputPath, outputPath, 100, 300);
+    QVERIFY2(result.success, qPrintable(result.errorMessage));
+    QCOMPARE(result.framesWritten, 2);
+
+    QFile output(outputPath);
+    QVERIFY(output.open(QIODevice::ReadOnly));
+    QCOMPARE(decodeFrames(output.readAll(), "gif").size(), 2);
+
+    QVERIFY(!AnimationTrimmer::trimFile(m_tempDir->filePath("missing.gif"),
+                                        outputPath, 0, 100).success);
+}
+
+QTEST_MAIN(TestAnimationTrimmer)
+#include "tst_AnimationTrimmer.moc"
@@ -3,11 +3,16 @@
 #include <QtConcurrent>
 #include <QCoreApplication>
 #include <QElapsedTimer>
+#include <QFileInfo>
 #include <QMutex>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
 #include <QThread>
 #include <QWaitCondition>
 
 #include "encoding/EncodingWorker.h"
+#include "encoding/NativeGifEncoder.h"
 #include "IVideoEncoder.h"
 
 #include <atomic>
@@ -20,6 +25,31 @@ QImage createTestFrame()
     frame.fill(Qt::red);
     return frame;
 }
+
+// Mostly static screen recording: a gradient desktop with some noise where a
+// small cursor moves every third frame and nothing else changes.
+QImage createStaticRecordingFrame(int index)
+{
+    static const QImage background = []() {
+        QRandomGenerator rng(0x57a7);
+        QImage image(320, 240, QImage::Format_ARGB32);
+        for (int y = 0; y < image.height(); ++y) {
+            auto* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+            for (int x = 0; x < image.width(); ++x) {
+                const int noise = static_cast<int>(rng.bounded(16));
+                line[x] = qRgb((x * 200 / image.width() + noise) & 0xff,
+                               (y * 200 / image.height() + noise) & 0xff, 120 + noise);
+            }
+        }
+        return image;
+    }();
+
+    QImage frame = background.copy();
+    QPainter painter(&frame);
+    const int step = index / 3;
+    painter.fillRect(QRect(20 + step * 8, 30 + step * 5, 12, 12), Qt::black);
+    return frame;
+}
 }
 
 class ThrowingVideoEncoder final : public IVideoEncoder
@@ -248,6 +278,11 @@ private slots:
     void testRequestFinishAfterFailureDoesNotEmitFinished();
     void testRequestFinishIsAsyncAndRunsOnWorkerThread();
     void testStopDuringFrameProcessingResetsProcessingState();
+    void testGifDeltaEncoding_ShrinksStaticRecording();
+    void testPooledFrames_EncodeInOrderAndReturnBuffers();
+    void testPooledFrames_DropWhenEncoderFallsBehind();
+    void testPooledFrames_AnimationDoesNotHoldBuffers();
+    void testPooledFrames_SlotsOnlyWithoutPreallocation();
 };
 
 void TestEncodingWorker::testFrameExceptionStopsWorker()
@@ -415,5 +450,183 @@ void TestEncodingWorker::testStopDuringFrameProcessingResetsProcessingState()
     QVERIFY(workerThread.wait(3000));
 }
 
+void TestEncodingWorker::testGifDeltaEncoding_ShrinksStaticRecording()
+{
+    constexpr int kFrames = 60;
+    constexpr int kFrameRate = 30;
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Baseline: every frame stored whole
+    const QString fullPath = tempDir.filePath(QStringLiteral("full.gif"));
+    NativeGifEncoder fullEncoder;
+    QVERIFY(fullEncoder.start(fullPath, QSize(320, 240), kFrameRate));
+    for (int i = 0; i < kFrames; ++i) {
+        fullEncoder.writeFrame(createStaticRecordingFrame(i), i * 1000 / kFrameRate);
+    }
+    fullEncoder.finish();
+    const qint64 fullSize = QFileInfo(fullPath).size();
+    QVERIFY(fullSize > 0);
+
+    const QString deltaPath = tempDir.filePath(QStringLiteral("delta.gif"));
+    auto* encoder = new NativeGifEncoder();
+    QVERIFY(encoder->start(deltaPath, QSize(320, 240), kFrameRate));
+
+    EncodingWorker worker;
+    worker.setEncoderType(EncodingWorker::EncoderType::Gif);
+    worker.setGifEncoder(encoder);
+    QVERIFY(worker.start());
+    QSignalSpy finishedSpy(&worker, &EncodingWorker::finished);
+
+    for (int i = 0; i < kFrames; ++i) {
+        EncodingWorker::FrameData frameData;
+        frameData.frame = createStaticRecordingFrame(i);
+        frameData.timestampMs = i * 1000 / kFrameRate;
+        QTRY_VERIFY_WITH_TIMEOUT(worker.enqueueFrame(frameData), 5000);
+    }
+    worker.requestFinish();
+
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 10000);
+    QVERIFY(finishedSpy.first().at(0).toBool());
+    QCOMPARE(worker.framesWritten(), kFrames);
+
+    // Identical frames merge into the previous frame's delay, plus the
+    // repeated last frame that keeps the static tail's duration.
+    QCOMPARE(encoder->framesWritten(), kFrames / 3 + 1);
+
+    const qint64 deltaSize = QFileInfo(deltaPath).size();
+    qInfo().nospace() << "GIF static recording: " << fullSize << " bytes full frames, "
+                      << deltaSize << " bytes with deltas";
+    QVERIFY2(deltaSize * 2 < fullSize,
+             qPrintable(QStringLiteral("%1 vs %2 bytes").arg(deltaSize).arg(fullSize)));
+}
+
+void TestEncodingWorker::testPooledFrames_EncodeInOrderAndReturnBuffers()
+{
+    EncodingWorker worker;
+    auto* encoder = new SlowFinishVideoEncoder(0);
+    worker.setEncoderType(EncodingWorker::EncoderType::Video);
+    worker.setVideoEncoder(encoder);
+    worker.configureFramePool(QSize(16, 16), 3);
+    QVERIFY(worker.start());
+    QCOMPARE(worker.framePoolStats().capacity, 3);
+
+    QSignalSpy finishedSpy(&worker, &EncodingWorker::finished);
+
+    constexpr int kFrames = 12;
+    for (int i = 0; i < kFrames; ++i) {
+        int slot = -1;
+        QTRY_VERIFY_WITH_TIMEOUT((slot = worker.acquireFrameBuffer()) >= 0, 3000);
+        worker.frameBuffer(slot).fill(Qt::blue);
+        QVERIFY(worker.submitFrameBuffer(slot, i * 33));
+    }
+    worker.requestFinish();
+
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 5000);
+    QCOMPARE(worker.framesWritten(), kFrames);
+    QCOMPARE(encoder->framesWritten(), kFrames);
+
+    const FrameBufferPool::Stats stats = worker.framePoolStats();
+    QCOMPARE(stats.published, qint64(kFrames));
+    QCOMPARE(stats.inFlight, 0);
+    QVERIFY(stats.peakInFlight <= 3);
+
+    // No longer accepting frames: leases are refused, not counted as drops
+    QCOMPARE(worker.acquireFrameBuffer(), -1);
+    QCOMPARE(worker.framePoolStats().dropped, stats.dropped);
+}
+
+void TestEncodingWorker::testPooledFrames_DropWhenEncoderFallsBehind()
+{
+    EncodingWorker worker;
+    auto* encoder = new BlockingVideoEncoder();
+    worker.setEncoderType(EncodingWorker::EncoderType::Video);
+    worker.setVideoEncoder(encoder);
+    worker.configureFramePool(QSize(16, 16), 2);
+    QThread workerThread;
+    worker.moveToThread(&workerThread);
+    workerThread.start();
+    QVERIFY(worker.start());
+
+    QSignalSpy pressureSpy(&worker, &EncodingWorker::queuePressure);
+
+    // First buffer is stuck in the encoder, second waits behind it
+    int slot = worker.acquireFrameBuffer();
+    QVERIFY(slot >= 0);
+    QVERIFY(worker.submitFrameBuffer(slot, 0));
+    QVERIFY(encoder->waitUntilWriteEntered(3000));
+    slot = worker.acquireFrameBuffer();
+    QVERIFY(slot >= 0);
+    QVERIFY(worker.submitFrameBuffer(slot, 33));
+    QCOMPARE(pressureSpy.count(), 1);
+
+    QCOMPARE(worker.acquireFrameBuffer(), -1);
+    QCOMPARE(worker.acquireFrameBuffer(), -1);
+    FrameBufferPool::Stats stats = worker.framePoolStats();
+    QCOMPARE(stats.inFlight, 2);
+    QCOMPARE(stats.dropped, qint64(2));
+
+    encoder->releaseWrite();
+    QTRY_COMPARE_WITH_TIMEOUT(encoder->writeCount(), 2, 3000);
+    QTRY_COMPARE_WITH_TIMEOUT(worker.framePoolStats().inFlight, 0, 3000);
+    QVERIFY(worker.acquireFrameBuffer() >= 0);
+
+    // stop() releases the pool, including the outstanding lease
+    worker.stop();
+    QCOMPARE(worker.framePoolStats().capacity, 0);
+
+    QThread* mainThread = QCoreApplication::instance()->thread();
+    const bool movedBack = QMetaObject::invokeMethod(&worker, [&worker, mainThread]() {
+        worker.moveToThread(mainThread);
+    }, Qt::BlockingQueuedConnection);
+    QVERIFY(movedBack);
+
+    workerThread.quit();
+    QVERIFY(workerThread.wait(3000));
+}
+
+void TestEncodingWorker::testPooledFrames_AnimationDoesNotHoldBuffers()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    auto* encoder = new NativeGifEncoder();
+    QVERIFY(encoder->start(tempDir.filePath(QStringLiteral("pooled.gif")), QSize(16, 16), 30));
+
+    EncodingWorker worker;
+    worker.setEncoderType(EncodingWorker::EncoderType::Gif);
+    worker.setGifEncoder(encoder);
+    worker.configureFramePool(QSize(16, 16), 2);
+    QVERIFY(worker.start());
+
+    // A buffer that is still shared after encoding would be detached, and so
+    // reallocated, by the next capture into it.
+    const QColor colors[] = {Qt::red, Qt::green, Qt::blue, Qt::yellow};
+    for (int i = 0; i < 4; ++i) {
+        const int slot = worker.acquireFrameBuffer();
+        QVERIFY(slot >= 0);
+        worker.frameBuffer(slot).fill(colors[i]);
+        QVERIFY(worker.submitFrameBuffer(slot, i * 33));
+        QTRY_COMPARE_WITH_TIMEOUT(worker.framePoolStats().inFlight, 0, 3000);
+        QVERIFY(worker.frameBuffer(slot).isDetached());
+    }
+    worker.stop();
+}
+
+void TestEncodingWorker::testPooledFrames_SlotsOnlyWithoutPreallocation()
+{
+    EncodingWorker worker;
+    worker.setEncoderType(EncodingWorker::EncoderType::Video);
+    worker.setVideoEncoder(new SlowFinishVideoEncoder(0));
+    worker.configureFramePool(QSize(16, 16), 3, false);
+    QVERIFY(worker.start());
+
+    QCOMPARE(worker.framePoolStats().capacity, 3);
+    const int slot = worker.acquireFrameBuffer();
+    QVERIFY(slot >= 0);
+    QVERIFY(worker.frameBuffer(slot).isNull());
+    worker.cancelFrameBuffer(slot);
+    worker.stop();
+}
+
 QTEST_MAIN(TestEncodingWorker)
 #include "tst_EncodingWorker.moc"
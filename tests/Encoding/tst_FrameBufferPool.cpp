@@ -0,0 +1,209 @@
+#include <QtTest/QtTest>
+#include <QImage>
+#include <QThread>
+
+#include "encoding/FrameBufferPool.h"
+
+#include <atomic>
+
+/**
+ * @brief Unit tests for the recording frame buffer pool.
+ *
+ * Covers:
+ * - Preallocation and FIFO hand-off between producer and consumer
+ * - Drop and occupancy counters
+ * - Cancelled leases and drain
+ * - Concurrent producer/consumer without buffer reuse races
+ */
+class TestFrameBufferPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testReset_PreallocatesBuffers();
+    void testPublishedFrames_ComeOutInOrder();
+    void testFullPool_CountsDrops();
+    void testCancel_ReusesLease();
+    void testDrain_ReturnsPublishedBuffers();
+    void testConcurrentProducerConsumer();
+};
+
+void TestFrameBufferPool::testReset_PreallocatesBuffers()
+{
+    FrameBufferPool pool;
+    pool.reset(3, QSize(64, 32));
+    QCOMPARE(pool.capacity(), 3);
+
+    QList<const uchar*> buffers;
+    for (int i = 0; i < 3; ++i) {
+        const int slot = pool.acquire();
+        QVERIFY(slot >= 0);
+        QCOMPARE(pool.image(slot).size(), QSize(64, 32));
+        QCOMPARE(pool.image(slot).format(), QImage::Format_RGB32);
+        buffers.append(pool.image(slot).constBits());
+        pool.publish(slot, i);
+    }
+
+    // Buffers are reused, not reallocated, across a full cycle
+    int slot = -1;
+    qint64 timestampMs = 0;
+    while (pool.takeReady(slot, timestampMs)) {
+        pool.release(slot);
+    }
+    for (int i = 0; i < 3; ++i) {
+        slot = pool.acquire();
+        QVERIFY(buffers.contains(pool.image(slot).bits()));
+        pool.publish(slot, i);
+    }
+
+    pool.reset(0, QSize());
+    QCOMPARE(pool.capacity(), 0);
+    QCOMPARE(pool.acquire(), -1);
+}
+
+void TestFrameBufferPool::testPublishedFrames_ComeOutInOrder()
+{
+    FrameBufferPool pool;
+    pool.reset(4, QSize(8, 8));
+
+    qint64 nextExpected = 0;
+    for (qint64 timestampMs = 0; timestampMs < 20; ++timestampMs) {
+        const int slot = pool.acquire();
+        QVERIFY(slot >= 0);
+        pool.image(slot).fill(QColor(int(timestampMs), 0, 0));
+        pool.publish(slot, timestampMs);
+
+        // Consumer lags by two frames
+        if (pool.readyCount() > 2) {
+            int readySlot = -1;
+            qint64 readyTimestampMs = -1;
+            QVERIFY(pool.takeReady(readySlot, readyTimestampMs));
+            QCOMPARE(readyTimestampMs, nextExpected);
+            QCOMPARE(qRed(pool.image(readySlot).pixel(0, 0)), int(nextExpected));
+            pool.release(readySlot);
+            ++nextExpected;
+        }
+    }
+
+    const FrameBufferPool::Stats stats = pool.stats();
+    QCOMPARE(stats.published, qint64(20));
+    QCOMPARE(stats.dropped, qint64(0));
+    QCOMPARE(stats.inFlight, 3);
+    QCOMPARE(stats.peakInFlight, 3);
+}
+
+void TestFrameBufferPool::testFullPool_CountsDrops()
+{
+    FrameBufferPool pool;
+    pool.reset(2, QSize(8, 8));
+
+    pool.publish(pool.acquire(), 0);
+    pool.publish(pool.acquire(), 1);
+    QCOMPARE(pool.acquire(), -1);
+    QCOMPARE(pool.acquire(), -1);
+
+    FrameBufferPool::Stats stats = pool.stats();
+    QCOMPARE(stats.inFlight, 2);
+    QCOMPARE(stats.dropped, qint64(2));
+
+    int slot = -1;
+    qint64 timestampMs = 0;
+    QVERIFY(pool.takeReady(slot, timestampMs));
+    pool.release(slot);
+    QVERIFY(pool.acquire() >= 0);
+
+    stats = pool.stats();
+    QCOMPARE(stats.inFlight, 2);
+    QCOMPARE(stats.peakInFlight, 2);
+    QCOMPARE(stats.dropped, qint64(2));
+}
+
+void TestFrameBufferPool::testCancel_ReusesLease()
+{
+    FrameBufferPool pool;
+    pool.reset(2, QSize(8, 8));
+
+    const int slot = pool.acquire();
+    pool.cancel(slot);
+    QCOMPARE(pool.stats().inFlight, 0);
+    QCOMPARE(pool.readyCount(), 0);
+    QCOMPARE(pool.acquire(), slot);
+    QVERIFY(pool.acquire() >= 0);
+    QCOMPARE(pool.acquire(), -1);
+}
+
+void TestFrameBufferPool::testDrain_ReturnsPublishedBuffers()
+{
+    FrameBufferPool pool;
+    pool.reset(3, QSize(8, 8));
+    pool.publish(pool.acquire(), 0);
+    pool.publish(pool.acquire(), 1);
+
+    QCOMPARE(pool.drain(), 2);
+    QCOMPARE(pool.readyCount(), 0);
+    QCOMPARE(pool.stats().inFlight, 0);
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(pool.acquire() >= 0);
+    }
+}
+
+void TestFrameBufferPool::testConcurrentProducerConsumer()
+{
+    constexpr int kFrames = 20000;
+    FrameBufferPool pool;
+    pool.reset(4, QSize(16, 4));
+
+    // Producer stamps every pixel with the frame number; the consumer checks
+    // the whole buffer so a slot handed out twice would show torn contents.
+    std::atomic<int> produced{0};
+    QThread* producer = QThread::create([&pool, &produced]() {
+        for (int frame = 0; frame < kFrames;) {
+            const int slot = pool.acquire();
+            if (slot < 0) {
+                QThread::yieldCurrentThread();
+                continue;
+            }
+            pool.image(slot).fill(static_cast<uint>(frame));
+            pool.publish(slot, frame);
+            produced.store(++frame, std::memory_order_relaxed);
+        }
+    });
+    producer->start();
+
+    qint64 expected = 0;
+    bool contentsValid = true;
+    while (expected < kFrames) {
+        int slot = -1;
+        qint64 timestampMs = 0;
+        if (!pool.takeReady(slot, timestampMs)) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        if (timestampMs != expected) {
+            break;
+        }
+        const QImage& image = pool.image(slot);
+        for (int y = 0; y < image.height() && contentsValid; ++y) {
+            const auto* line = reinterpret_cast<const quint32*>(image.constScanLine(y));
+            for (int x = 0; x < image.width(); ++x) {
+                contentsValid = contentsValid && (line[x] & 0xffffff) == (quint32(expected) & 0xffffff);
+            }
+        }
+        pool.release(slot);
+        ++expected;
+    }
+
+    QVERIFY(producer->wait(10000));
+    delete producer;
+
+    QCOMPARE(expected, qint64(kFrames));
+    QVERIFY(contentsValid);
+
+    const FrameBufferPool::Stats stats = pool.stats();
+    QCOMPARE(stats.published, qint64(kFrames));
+    QCOMPARE(stats.inFlight, 0);
+    QVERIFY(stats.peakInFlight <= 4);
+}
+
+QTEST_MAIN(TestFrameBufferPool)
+#include "tst_FrameBufferPool.moc"
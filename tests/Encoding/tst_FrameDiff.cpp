@@ -0,0 +1,137 @@
+#include <QtTest/QtTest>
+#include <QImage>
+#include <QRandomGenerator>
+
+#include "encoding/FrameDiff.h"
+
+#include <vector>
+
+/**
+ * @brief Unit tests for recording frame change detection.
+ *
+ * Covers:
+ * - Identical and shared frames
+ * - Single-pixel and multi-region changes at every column alignment
+ * - Frames that cannot be compared
+ */
+class TestFrameDiff : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testIdenticalFrames_ReturnsNullRect();
+    void testSinglePixelChange_AllColumns();
+    void testRandomChanges_MatchReference();
+    void testPaddedScanlines_IgnorePadding();
+    void testIncomparableFrames_ReturnFullRect();
+
+private:
+    static QImage createNoiseFrame(const QSize& size, quint32 seed);
+    static QRect referenceChangedRect(const QImage& previous, const QImage& current);
+};
+
+QImage TestFrameDiff::createNoiseFrame(const QSize& size, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    QImage frame(size, QImage::Format_ARGB32);
+    for (int y = 0; y < size.height(); ++y) {
+        auto* line = reinterpret_cast<QRgb*>(frame.scanLine(y));
+        for (int x = 0; x < size.width(); ++x) {
+            line[x] = rng.generate();
+        }
+    }
+    return frame;
+}
+
+QRect TestFrameDiff::referenceChangedRect(const QImage& previous, const QImage& current)
+{
+    QRect changed;
+    for (int y = 0; y < current.height(); ++y) {
+        for (int x = 0; x < current.width(); ++x) {
+            if (previous.pixel(x, y) != current.pixel(x, y)) {
+                changed |= QRect(x, y, 1, 1);
+            }
+        }
+    }
+    return changed;
+}
+
+void TestFrameDiff::testIdenticalFrames_ReturnsNullRect()
+{
+    const QImage frame = createNoiseFrame(QSize(67, 41), 1);
+
+    QVERIFY(FrameDiff::changedRect(frame, frame).isNull());
+    QVERIFY(FrameDiff::changedRect(frame, frame.copy()).isNull());
+}
+
+void TestFrameDiff::testSinglePixelChange_AllColumns()
+{
+    // Width not a multiple of the vector width, so every lane and the scalar
+    // tail are exercised.
+    const QImage previous = createNoiseFrame(QSize(37, 9), 2);
+    for (int x = 0; x < previous.width(); ++x) {
+        QImage current = previous.copy();
+        current.setPixel(x, 4, ~current.pixel(x, 4));
+        QCOMPARE(FrameDiff::changedRect(previous, current), QRect(x, 4, 1, 1));
+    }
+}
+
+void TestFrameDiff::testRandomChanges_MatchReference()
+{
+    QRandomGenerator rng(0xd1ff);
+    for (int i = 0; i < 200; ++i) {
+        const QSize size(1 + rng.bounded(90), 1 + rng.bounded(60));
+        const QImage previous = createNoiseFrame(size, static_cast<quint32>(i));
+        QImage current = previous.copy();
+        const int changes = rng.bounded(5);
+        for (int c = 0; c < changes; ++c) {
+            const int x = rng.bounded(size.width());
+            const int y = rng.bounded(size.height());
+            current.setPixel(x, y, current.pixel(x, y) ^ (1u + rng.bounded(0xffffff)));
+        }
+
+        QCOMPARE(FrameDiff::changedRect(previous, current),
+                 referenceChangedRect(previous, current));
+    }
+}
+
+void TestFrameDiff::testPaddedScanlines_IgnorePadding()
+{
+    // Frames wrapping external buffers may have bytes past the last pixel of
+    // each row; those must not count as changes.
+    const int width = 21;
+    const int height = 6;
+    const int stride = width + 3;
+    std::vector<quint32> previousPixels(static_cast<size_t>(stride) * height, 0xff102030u);
+    std::vector<quint32> currentPixels = previousPixels;
+    for (int y = 0; y < height; ++y) {
+        for (int x = width; x < stride; ++x) {
+            currentPixels[static_cast<size_t>(y) * stride + x] = 0xffffffffu;
+        }
+    }
+
+    const QImage previous(reinterpret_cast<const uchar*>(previousPixels.data()), width, height,
+                          stride * 4, QImage::Format_ARGB32);
+    const QImage current(reinterpret_cast<const uchar*>(currentPixels.data()), width, height,
+                         stride * 4, QImage::Format_ARGB32);
+    QVERIFY(FrameDiff::changedRect(previous, current).isNull());
+
+    currentPixels[static_cast<size_t>(2) * stride + width - 1] = 0u;
+    QCOMPARE(FrameDiff::changedRect(previous, current), QRect(width - 1, 2, 1, 1));
+}
+
+void TestFrameDiff::testIncomparableFrames_ReturnFullRect()
+{
+    const QImage frame = createNoiseFrame(QSize(40, 30), 4);
+
+    QCOMPARE(FrameDiff::changedRect(QImage(), frame), frame.rect());
+    QCOMPARE(FrameDiff::changedRect(frame.scaled(20, 15), frame), frame.rect());
+    QCOMPARE(FrameDiff::changedRect(frame.convertToFormat(QImage::Format_RGB32), frame),
+             frame.rect());
+    QCOMPARE(FrameDiff::changedRect(frame.convertToFormat(QImage::Format_RGB888),
+                                    frame.convertToFormat(QImage::Format_RGB888)),
+             frame.rect());
+}
+
+QTEST_MAIN(TestFrameDiff)
+#include "tst_FrameDiff.moc"
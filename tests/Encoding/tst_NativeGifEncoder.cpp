@@ -2,7 +2,10 @@
 #include <QTemporaryDir>
 #include <QSignalSpy>
 #include <QFile>
+#include <QImageReader>
+#include <QPainter>
 #include "encoding/NativeGifEncoder.h"
+#include "external/msf_gif.h"
 
 /**
  * @brief Tests for NativeGifEncoder
@@ -63,6 +66,11 @@ private slots:
     void testSetMaxBitDepth();
     void testBitDepthClamping();
 
+    // Parallel pipeline tests
+    void testParallelOutputMatchesSerialEncoder();
+    void testSharedPalette_ProducesValidGif();
+    void testTransparentChangedRect_KeepsUnchangedArea();
+
     // Error handling tests
     void testErrorSignalOnFailure();
     void testLastErrorMessage();
@@ -73,6 +81,7 @@ private:
 
     QString tempFilePath(const QString& name = "test.gif") const;
     QImage createTestFrame(const QSize& size, QRgb color = qRgb(255, 0, 0)) const;
+    QImage createAnimatedFrame(const QSize& size, int index) const;
 };
 
 void TestNativeGifEncoder::initTestCase()
@@ -113,6 +122,22 @@ QImage TestNativeGifEncoder::createTestFrame(const QSize& size, QRgb color) cons
     return frame;
 }
 
+QImage TestNativeGifEncoder::createAnimatedFrame(const QSize& size, int index) const
+{
+    // Gradient background with a moving block, so frames differ partially
+    QImage frame(size, QImage::Format_RGBA8888);
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            frame.setPixel(x, y, qRgb(x * 255 / size.width(), y * 255 / size.height(),
+                                      (x * y + index * 7) & 0xff));
+        }
+    }
+    QPainter painter(&frame);
+    painter.fillRect(QRect(index * 3 % size.width(), 8, 12, 12), QColor(20, 200, 90));
+    painter.end();
+    return frame;
+}
+
 // ============================================================================
 // Default State Tests
 // ============================================================================
@@ -475,6 +500,113 @@ void TestNativeGifEncoder::testBitDepthClamping()
     QCOMPARE(m_encoder->maxBitDepth(), 1);
 }
 
+// ============================================================================
+// Parallel Pipeline Tests
+// ============================================================================
+
+void TestNativeGifEncoder::testParallelOutputMatchesSerialEncoder()
+{
+    const QSize size(64, 48);
+    constexpr int kFrames = 24;
+    constexpr int kFrameRate = 10;
+
+    QString path = tempFilePath("parallel.gif");
+    QVERIFY(m_encoder->start(path, size, kFrameRate));
+    for (int i = 0; i < kFrames; ++i) {
+        m_encoder->writeFrame(createAnimatedFrame(size, i));
+    }
+    m_encoder->finish();
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray parallelData = file.readAll();
+
+    // Reference: the library's own single-threaded path
+    MsfGifState state = {};
+    QVERIFY(msf_gif_begin(&state, size.width(), size.height()));
+    for (int i = 0; i < kFrames; ++i) {
+        QImage frame = createAnimatedFrame(size, i);
+        QVERIFY(msf_gif_frame(&state, frame.bits(), 100 / kFrameRate, m_encoder->maxBitDepth(),
+                              static_cast<int>(frame.bytesPerLine())));
+    }
+    MsfGifResult result = msf_gif_end(&state);
+    QVERIFY(result.data);
+    const QByteArray serialData(static_cast<const char*>(result.data),
+                                static_cast<qsizetype>(result.dataSize));
+    msf_gif_free(result);
+
+    QCOMPARE(parallelData.size(), serialData.size());
+    QVERIFY(parallelData == serialData);
+}
+
+void TestNativeGifEncoder::testSharedPalette_ProducesValidGif()
+{
+    const QSize size(64, 48);
+    constexpr int kFrames = 12;
+
+    m_encoder->setSharedPalette(true);
+    QVERIFY(m_encoder->sharedPalette());
+
+    QString path = tempFilePath("shared_palette.gif");
+    QVERIFY(m_encoder->start(path, size, 10));
+    for (int i = 0; i < kFrames; ++i) {
+        m_encoder->writeFrame(createAnimatedFrame(size, i));
+    }
+    QCOMPARE(m_encoder->framesWritten(), kFrames);
+    m_encoder->finish();
+
+    QImageReader reader(path);
+    if (!reader.canRead()) {
+        QSKIP("GIF image format plugin not available");
+    }
+    QCOMPARE(reader.imageCount(), kFrames);
+    const QImage first = reader.read();
+    QCOMPARE(first.size(), size);
+}
+
+void TestNativeGifEncoder::testTransparentChangedRect_KeepsUnchangedArea()
+{
+    const QSize size(64, 48);
+    const QRect holeRect(4, 4, 8, 8);
+    const QRect patchRect(40, 30, 8, 8);
+
+    QImage first = createTestFrame(size, qRgb(0, 0, 255));
+    QImage second = first.copy();
+    {
+        QPainter painter(&second);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.fillRect(holeRect, Qt::transparent);
+    }
+    QImage third = second.copy();
+    QPainter(&third).fillRect(patchRect, Qt::red);
+
+    // Transparency is only emitted above the library's alpha threshold
+    const int previousThreshold = msf_gif_alpha_threshold;
+    msf_gif_alpha_threshold = 128;
+    QString path = tempFilePath("transparent_rect.gif");
+    QVERIFY(m_encoder->start(path, size, 10));
+    m_encoder->writeFrame(first, 0);
+    m_encoder->writeFrame(second, 100, holeRect);
+    m_encoder->writeFrame(third, 200, patchRect);
+    m_encoder->finish();
+    msf_gif_alpha_threshold = previousThreshold;
+
+    QImageReader reader(path);
+    if (!reader.canRead()) {
+        QSKIP("GIF image format plugin not available");
+    }
+    QCOMPARE(reader.imageCount(), 3);
+    reader.read();
+    for (int frame = 1; frame < 3; ++frame) {
+        const QImage decoded = reader.read();
+        QVERIFY(!decoded.isNull());
+        // Disposing the previous frame must not clear what this one doesn't repaint
+        const QColor unchanged = decoded.pixelColor(20, 20);
+        QCOMPARE(unchanged.alpha(), 255);
+        QVERIFY(unchanged.blue() > 200);
+    }
+}
+
 // ============================================================================
 // Error Handling Tests
 // ============================================================================
@@ -0,0 +1,115 @@
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include "encoding/NativeGifEncoder.h"
+#include "external/msf_gif.h"
+
+#include <vector>
+
+class TestNativeGifEncoderBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchmarkEncode1080p_data();
+    void benchmarkEncode1080p();
+
+private:
+    static std::vector<QImage> createSyntheticFrames(const QSize& size, int count);
+};
+
+std::vector<QImage> TestNativeGifEncoderBenchmark::createSyntheticFrames(const QSize& size, int count)
+{
+    // Screen-recording-like content: a static gradient "desktop" with noise,
+    // a window that slides across it and a few changing text-like rows.
+    QRandomGenerator rng(0x61f);
+    QImage background(size, QImage::Format_RGB32);
+    for (int y = 0; y < size.height(); ++y) {
+        auto* line = reinterpret_cast<QRgb*>(background.scanLine(y));
+        for (int x = 0; x < size.width(); ++x) {
+            const int noise = static_cast<int>(rng.bounded(16));
+            line[x] = qRgb((x * 200 / size.width() + noise) & 0xff,
+                           (y * 200 / size.height() + noise) & 0xff, 120 + noise);
+        }
+    }
+    background = background.convertToFormat(QImage::Format_RGBA8888);
+
+    std::vector<QImage> frames;
+    frames.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        QImage frame = background.copy();
+        QPainter painter(&frame);
+        const QRect window(100 + i * 12, 150 + i * 4, 800, 500);
+        painter.fillRect(window, QColor(245, 245, 245));
+        painter.fillRect(window.adjusted(0, 0, 0, -470), QColor(60, 90, 160));
+        for (int row = 0; row < 12; ++row) {
+            painter.fillRect(window.left() + 20, window.top() + 50 + row * 30,
+                             200 + static_cast<int>(rng.bounded(500)), 12, QColor(40, 40, 40));
+        }
+        painter.end();
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+void TestNativeGifEncoderBenchmark::benchmarkEncode1080p_data()
+{
+    QTest::addColumn<bool>("sharedPalette");
+    QTest::newRow("adaptive palette") << false;
+    QTest::newRow("shared palette") << true;
+}
+
+void TestNativeGifEncoderBenchmark::benchmarkEncode1080p()
+{
+    QFETCH(bool, sharedPalette);
+    const QSize size(1920, 1080);
+    constexpr int kFrames = 60;
+    constexpr int kFrameRate = 30;
+
+    const std::vector<QImage> frames = createSyntheticFrames(size, kFrames);
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Baseline: msf_gif's single-threaded path on the same frames
+    QElapsedTimer timer;
+    timer.start();
+    MsfGifState state = {};
+    QVERIFY(msf_gif_begin(&state, size.width(), size.height()));
+    for (const QImage& frame : frames) {
+        QVERIFY(msf_gif_frame(&state, const_cast<uchar*>(frame.constBits()), 100 / kFrameRate, 16,
+                              static_cast<int>(frame.bytesPerLine())));
+    }
+    MsfGifResult result = msf_gif_end(&state);
+    const qint64 serialNs = timer.nsecsElapsed();
+    const size_t serialBytes = result.dataSize;
+    msf_gif_free(result);
+
+    NativeGifEncoder encoder;
+    encoder.setSharedPalette(sharedPalette);
+    const QString path = tempDir.filePath(QStringLiteral("benchmark.gif"));
+
+    timer.start();
+    QVERIFY(encoder.start(path, size, kFrameRate));
+    for (int i = 0; i < kFrames; ++i) {
+        encoder.writeFrame(frames[static_cast<size_t>(i)], i * 1000 / kFrameRate);
+    }
+    encoder.finish();
+    const qint64 pipelineNs = timer.nsecsElapsed();
+
+    const auto fps = [](qint64 ns) { return kFrames / (static_cast<double>(ns) / 1.0e9); };
+    qInfo().nospace()
+        << "NativeGifEncoder " << size.width() << "x" << size.height() << " x" << kFrames
+        << (sharedPalette ? " (shared palette)" : " (adaptive palette)") << ": "
+        << fps(pipelineNs) << " fps, " << QFileInfo(path).size() << " bytes; serial msf_gif "
+        << fps(serialNs) << " fps, " << serialBytes << " bytes";
+
+    QVERIFY(QFileInfo::exists(path));
+}
+
+QTEST_MAIN(TestNativeGifEncoderBenchmark)
+#include "tst_NativeGifEncoderBenchmark.moc"
@@ -0,0 +1,212 @@
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QPainter>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+#include "IVideoEncoder.h"
+
+#include <memory>
+
+/**
+ * @brief Headless MP4 round trip through the platform's native encoder
+ *
+ * Synthetic frames with irregular timing are encoded and the resulting file
+ * is checked at the container level: ISO BMFF box layout, an H.264 track and
+ * a movie duration that follows the frame timestamps. Skipped where the
+ * build has no native encoder (Linux without libavcodec).
+ */
+class TestNativeVideoEncoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testEncodeVariableFrameTiming_ProducesMp4();
+    void testOddFrameSize_IsRoundedUp();
+    void testAbort_RemovesOutput();
+
+private:
+    static QImage createFrame(const QSize& size, int index);
+    // Returns the payload of the first box of the given type, searching
+    // nested boxes listed in containers.
+    static QByteArray findBox(const QByteArray& data, const QByteArray& type);
+    static QList<QByteArray> topLevelBoxTypes(const QByteArray& data);
+
+    std::unique_ptr<IVideoEncoder> m_encoder;
+    QTemporaryDir m_tempDir;
+};
+
+QImage TestNativeVideoEncoder::createFrame(const QSize& size, int index)
+{
+    QImage frame(size, QImage::Format_RGB32);
+    frame.fill(QColor::fromHsv((index * 17) % 360, 160, 220));
+    QPainter painter(&frame);
+    painter.fillRect(QRect(index * 6 % size.width(), size.height() / 3, 40, 40), Qt::black);
+    return frame;
+}
+
+QList<QByteArray> TestNativeVideoEncoder::topLevelBoxTypes(const QByteArray& data)
+{
+    QList<QByteArray> types;
+    qint64 offset = 0;
+    while (offset + 8 <= data.size()) {
+        const auto* header = reinterpret_cast<const uchar*>(data.constData() + offset);
+        quint64 size = qFromBigEndian<quint32>(header);
+        if (size == 1 && offset + 16 <= data.size()) {
+            size = qFromBigEndian<quint64>(header + 8);
+        } else if (size == 0) {
+            size = static_cast<quint64>(data.size() - offset);
+        }
+        if (size < 8) {
+            break;
+        }
+        types.append(data.mid(offset + 4, 4));
+        offset += static_cast<qint64>(size);
+    }
+    return types;
+}
+
+QByteArray TestNativeVideoEncoder::findBox(const QByteArray& data, const QByteArray& type)
+{
+    static const QList<QByteArray> containers = {"moov", "trak", "mdia", "minf", "stbl"};
+    qint64 offset = 0;
+    while (offset + 8 <= data.size()) {
+        const auto* header = reinterpret_cast<const uchar*>(data.constData() + offset);
+        quint64 size = qFromBigEndian<quint32>(header);
+        qint64 headerSize = 8;
+        if (size == 1 && offset + 16 <= data.size()) {
+            size = qFromBigEndian<quint64>(header + 8);
+            headerSize = 16;
+        } else if (size == 0) {
+            size = static_cast<quint64>(data.size() - offset);
+        }
+        if (size < static_cast<quint64>(headerSize) || offset + static_cast<qint64>(size) > data.size()) {
+            break;
+        }
+
+        const QByteArray boxType = data.mid(offset + 4, 4);
+        const QByteArray payload =
+            data.mid(offset + headerSize, static_cast<qint64>(size) - headerSize);
+        if (boxType == type) {
+            return payload;
+        }
+        if (containers.contains(boxType)) {
+            const QByteArray nested = findBox(payload, type);
+            if (!nested.isNull()) {
+                return nested;
+            }
+        }
+        offset += static_cast<qint64>(size);
+    }
+    return QByteArray();
+}
+
+void TestNativeVideoEncoder::init()
+{
+    QVERIFY(m_tempDir.isValid());
+    m_encoder.reset(IVideoEncoder::createNativeEncoder());
+    if (!m_encoder) {
+        QSKIP("No native MP4 encoder in this build");
+    }
+}
+
+void TestNativeVideoEncoder::testEncodeVariableFrameTiming_ProducesMp4()
+{
+    const QString path = m_tempDir.filePath(QStringLiteral("variable.mp4"));
+    const QSize size(320, 240);
+    if (!m_encoder->start(path, size, 30)) {
+        QSKIP(qPrintable(QStringLiteral("Native encoder cannot start in this environment: %1")
+                             .arg(m_encoder->lastError())));
+    }
+
+    // Capture timing jitters: bursts, stalls and a frame skipped entirely
+    const QList<int> gapsMs = {33, 17, 16, 50, 33, 100, 33, 33, 250, 33};
+    qint64 timestampMs = 0;
+    constexpr int kFrames = 40;
+    for (int i = 0; i < kFrames; ++i) {
+        m_encoder->writeFrame(createFrame(size, i), timestampMs);
+        timestampMs += gapsMs.at(i % gapsMs.size());
+    }
+    const qint64 lastTimestampMs = timestampMs - gapsMs.at((kFrames - 1) % gapsMs.size());
+    QCOMPARE(m_encoder->framesWritten(), kFrames);
+
+    QSignalSpy finishedSpy(m_encoder.get(), &IVideoEncoder::finished);
+    m_encoder->finish();
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 10000);
+    QVERIFY2(finishedSpy.first().at(0).toBool(), qPrintable(m_encoder->lastError()));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+
+    const QList<QByteArray> boxes = topLevelBoxTypes(data);
+    QVERIFY(!boxes.isEmpty());
+    QCOMPARE(boxes.first(), QByteArray("ftyp"));
+    QVERIFY(boxes.contains("moov"));
+    QVERIFY(boxes.contains("mdat"));
+
+    // H.264 sample entry inside the sample description
+    const QByteArray stsd = findBox(data, "stsd");
+    QVERIFY(!stsd.isNull());
+    QVERIFY(stsd.contains("avc1"));
+
+    // Movie duration spans the timestamps rather than frames / frame rate
+    const QByteArray mvhd = findBox(data, "mvhd");
+    QVERIFY(mvhd.size() >= 20);
+    const auto* fields = reinterpret_cast<const uchar*>(mvhd.constData());
+    quint32 timescale = 0;
+    quint64 duration = 0;
+    if (fields[0] == 1) {
+        QVERIFY(mvhd.size() >= 32);
+        timescale = qFromBigEndian<quint32>(fields + 20);
+        duration = qFromBigEndian<quint64>(fields + 24);
+    } else {
+        timescale = qFromBigEndian<quint32>(fields + 12);
+        duration = qFromBigEndian<quint32>(fields + 16);
+    }
+    QVERIFY(timescale > 0);
+    const qint64 durationMs = static_cast<qint64>(duration * 1000 / timescale);
+    QVERIFY2(durationMs >= lastTimestampMs * 9 / 10 && durationMs <= lastTimestampMs + 1000,
+             qPrintable(QStringLiteral("duration %1 ms, last frame at %2 ms")
+                            .arg(durationMs).arg(lastTimestampMs)));
+}
+
+void TestNativeVideoEncoder::testOddFrameSize_IsRoundedUp()
+{
+    const QString path = m_tempDir.filePath(QStringLiteral("odd.mp4"));
+    if (!m_encoder->start(path, QSize(101, 75), 30)) {
+        QSKIP(qPrintable(QStringLiteral("Native encoder cannot start in this environment: %1")
+                             .arg(m_encoder->lastError())));
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        m_encoder->writeFrame(createFrame(QSize(101, 75), i), i * 33);
+    }
+    QCOMPARE(m_encoder->framesWritten(), 5);
+
+    QSignalSpy finishedSpy(m_encoder.get(), &IVideoEncoder::finished);
+    m_encoder->finish();
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 10000);
+    QVERIFY(finishedSpy.first().at(0).toBool());
+    QVERIFY(QFile::exists(path));
+}
+
+void TestNativeVideoEncoder::testAbort_RemovesOutput()
+{
+    const QString path = m_tempDir.filePath(QStringLiteral("aborted.mp4"));
+    if (!m_encoder->start(path, QSize(64, 64), 30)) {
+        QSKIP(qPrintable(QStringLiteral("Native encoder cannot start in this environment: %1")
+                             .arg(m_encoder->lastError())));
+    }
+
+    m_encoder->writeFrame(createFrame(QSize(64, 64), 0), 0);
+    m_encoder->abort();
+
+    QVERIFY(!m_encoder->isRunning());
+    QVERIFY(!QFile::exists(path));
+}
+
+QTEST_MAIN(TestNativeVideoEncoder)
+#include "tst_NativeVideoEncoder.moc"
@@ -0,0 +1,244 @@
+#include <QtTest/QtTest>
+#include <QImage>
+#include <QRandomGenerator>
+
+#include "encoding/YuvConverter.h"
+
+#include <cmath>
+#include <vector>
+
+/**
+ * @brief Unit tests for BGRA to I420 conversion.
+ *
+ * Covers:
+ * - Limited-range levels for black, white and primaries
+ * - Vector paths against a scalar reference at every width alignment
+ * - Odd sizes, padded strides and chroma subsampling
+ */
+class TestYuvConverter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testBlackAndWhite_LimitedRange();
+    void testPrimaries_MatchBt709();
+    void testRandomImages_MatchReference_data();
+    void testRandomImages_MatchReference();
+    void testPaddedStrides_LeavePaddingUntouched();
+    void testChroma_AveragesBlocks();
+
+private:
+    struct Planes {
+        std::vector<uchar> y;
+        std::vector<uchar> u;
+        std::vector<uchar> v;
+        int yStride = 0;
+        int chromaStride = 0;
+        int chromaHeight = 0;
+    };
+
+    static Planes convert(const QImage& image, int padding = 0, uchar fill = 0);
+    static QImage createNoiseImage(const QSize& size, quint32 seed);
+    static void referenceAverage(const QImage& image, int cx, int cy, int& r, int& g, int& b);
+};
+
+TestYuvConverter::Planes TestYuvConverter::convert(const QImage& image, int padding, uchar fill)
+{
+    Planes planes;
+    planes.yStride = image.width() + padding;
+    planes.chromaStride = (image.width() + 1) / 2 + padding;
+    planes.chromaHeight = (image.height() + 1) / 2;
+    planes.y.assign(static_cast<size_t>(planes.yStride) * image.height(), fill);
+    planes.u.assign(static_cast<size_t>(planes.chromaStride) * planes.chromaHeight, fill);
+    planes.v.assign(static_cast<size_t>(planes.chromaStride) * planes.chromaHeight, fill);
+
+    YuvConverter::I420Planes out;
+    out.y = planes.y.data();
+    out.yStride = planes.yStride;
+    out.u = planes.u.data();
+    out.uStride = planes.chromaStride;
+    out.v = planes.v.data();
+    out.vStride = planes.chromaStride;
+    YuvConverter::bgraToI420(image, out);
+    return planes;
+}
+
+QImage TestYuvConverter::createNoiseImage(const QSize& size, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    QImage image(size, QImage::Format_ARGB32);
+    for (int y = 0; y < size.height(); ++y) {
+        auto* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < size.width(); ++x) {
+            line[x] = rng.generate();
+        }
+    }
+    return image;
+}
+
+void TestYuvConverter::referenceAverage(const QImage& image, int cx, int cy,
+                                        int& r, int& g, int& b)
+{
+    const int x0 = cx * 2;
+    const int y0 = cy * 2;
+    const int x1 = qMin(x0 + 1, image.width() - 1);
+    const int y1 = qMin(y0 + 1, image.height() - 1);
+    const QRgb pixels[4] = {image.pixel(x0, y0), image.pixel(x1, y0),
+                            image.pixel(x0, y1), image.pixel(x1, y1)};
+    r = g = b = 0;
+    for (QRgb pixel : pixels) {
+        r += qRed(pixel);
+        g += qGreen(pixel);
+        b += qBlue(pixel);
+    }
+    r = (r + 2) >> 2;
+    g = (g + 2) >> 2;
+    b = (b + 2) >> 2;
+}
+
+void TestYuvConverter::testBlackAndWhite_LimitedRange()
+{
+    QImage black(4, 4, QImage::Format_RGB32);
+    black.fill(Qt::black);
+    const Planes blackPlanes = convert(black);
+    QCOMPARE(int(blackPlanes.y[0]), 16);
+    QCOMPARE(int(blackPlanes.u[0]), 128);
+    QCOMPARE(int(blackPlanes.v[0]), 128);
+
+    QImage white(4, 4, QImage::Format_RGB32);
+    white.fill(Qt::white);
+    const Planes whitePlanes = convert(white);
+    QCOMPARE(int(whitePlanes.y[0]), 235);
+    QCOMPARE(int(whitePlanes.u[0]), 128);
+    QCOMPARE(int(whitePlanes.v[0]), 128);
+}
+
+void TestYuvConverter::testPrimaries_MatchBt709()
+{
+    const QList<QColor> colors = {Qt::red, Qt::green, Qt::blue, Qt::cyan, Qt::magenta,
+                                  Qt::yellow, QColor(128, 128, 128), QColor(200, 30, 90)};
+    for (const QColor& color : colors) {
+        QImage image(2, 2, QImage::Format_RGB32);
+        image.fill(color);
+        const Planes planes = convert(image);
+
+        const double r = color.redF();
+        const double g = color.greenF();
+        const double b = color.blueF();
+        const double luma = 0.2126 * r + 0.7152 * g + 0.0722 * b;
+        const int expectedY = int(std::lround(16 + 219 * luma));
+        const int expectedU = int(std::lround(128 + 224 * (b - luma) / 1.8556));
+        const int expectedV = int(std::lround(128 + 224 * (r - luma) / 1.5748));
+
+        QVERIFY2(qAbs(int(planes.y[0]) - expectedY) <= 1, qPrintable(color.name()));
+        QVERIFY2(qAbs(int(planes.u[0]) - expectedU) <= 1, qPrintable(color.name()));
+        QVERIFY2(qAbs(int(planes.v[0]) - expectedV) <= 1, qPrintable(color.name()));
+    }
+}
+
+void TestYuvConverter::testRandomImages_MatchReference_data()
+{
+    QTest::addColumn<QSize>("size");
+
+    // Widths around the 8- and 16-pixel vector blocks, odd heights
+    for (int width : {1, 2, 7, 8, 9, 15, 16, 17, 31, 33, 101}) {
+        for (int height : {1, 2, 5}) {
+            QTest::addRow("%dx%d", width, height) << QSize(width, height);
+        }
+    }
+    QTest::addRow("1920x1080") << QSize(1920, 1080);
+}
+
+void TestYuvConverter::testRandomImages_MatchReference()
+{
+    QFETCH(QSize, size);
+    const QImage image = createNoiseImage(size, quint32(size.width() * 31 + size.height()));
+    const Planes planes = convert(image);
+
+    // Vector and scalar paths must agree exactly with the fixed-point formula
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            const QRgb pixel = image.pixel(x, y);
+            const int expected =
+                ((47 * qRed(pixel) + 157 * qGreen(pixel) + 16 * qBlue(pixel) + 128) >> 8) + 16;
+            const int actual = planes.y[static_cast<size_t>(y) * planes.yStride + x];
+            if (actual != expected) {
+                QFAIL(qPrintable(QStringLiteral("Y mismatch at (%1,%2): %3 != %4")
+                                     .arg(x).arg(y).arg(actual).arg(expected)));
+            }
+        }
+    }
+
+    for (int cy = 0; cy < planes.chromaHeight; ++cy) {
+        for (int cx = 0; cx < (size.width() + 1) / 2; ++cx) {
+            int r, g, b;
+            referenceAverage(image, cx, cy, r, g, b);
+            const int expectedU = (112 * b - 26 * r - 86 * g + 32896) >> 8;
+            const int expectedV = (112 * r - 102 * g - 10 * b + 32896) >> 8;
+            const size_t index = static_cast<size_t>(cy) * planes.chromaStride + cx;
+            if (planes.u[index] != expectedU || planes.v[index] != expectedV) {
+                QFAIL(qPrintable(QStringLiteral("UV mismatch at (%1,%2): %3/%4 != %5/%6")
+                                     .arg(cx).arg(cy)
+                                     .arg(planes.u[index]).arg(planes.v[index])
+                                     .arg(expectedU).arg(expectedV)));
+            }
+        }
+    }
+}
+
+void TestYuvConverter::testPaddedStrides_LeavePaddingUntouched()
+{
+    const QImage image = createNoiseImage(QSize(37, 11), 7);
+    constexpr int kPadding = 13;
+    constexpr uchar kFill = 0xa5;
+    const Planes padded = convert(image, kPadding, kFill);
+    const Planes tight = convert(image);
+
+    for (int y = 0; y < image.height(); ++y) {
+        const uchar* paddedRow = padded.y.data() + static_cast<size_t>(y) * padded.yStride;
+        const uchar* tightRow = tight.y.data() + static_cast<size_t>(y) * tight.yStride;
+        QVERIFY(std::equal(tightRow, tightRow + image.width(), paddedRow));
+        for (int x = image.width(); x < padded.yStride; ++x) {
+            QCOMPARE(paddedRow[x], kFill);
+        }
+    }
+
+    const int chromaWidth = (image.width() + 1) / 2;
+    for (int cy = 0; cy < padded.chromaHeight; ++cy) {
+        const size_t paddedOffset = static_cast<size_t>(cy) * padded.chromaStride;
+        const size_t tightOffset = static_cast<size_t>(cy) * tight.chromaStride;
+        QVERIFY(std::equal(tight.u.begin() + tightOffset,
+                           tight.u.begin() + tightOffset + chromaWidth,
+                           padded.u.begin() + paddedOffset));
+        QVERIFY(std::equal(tight.v.begin() + tightOffset,
+                           tight.v.begin() + tightOffset + chromaWidth,
+                           padded.v.begin() + paddedOffset));
+        for (int cx = chromaWidth; cx < padded.chromaStride; ++cx) {
+            QCOMPARE(padded.u[paddedOffset + cx], kFill);
+            QCOMPARE(padded.v[paddedOffset + cx], kFill);
+        }
+    }
+}
+
+void TestYuvConverter::testChroma_AveragesBlocks()
+{
+    // Alternating black and white columns average to mid gray: no color cast
+    QImage stripes(32, 4, QImage::Format_RGB32);
+    for (int y = 0; y < stripes.height(); ++y) {
+        for (int x = 0; x < stripes.width(); ++x) {
+            stripes.setPixel(x, y, (x % 2) ? qRgb(255, 255, 255) : qRgb(0, 0, 0));
+        }
+    }
+    const Planes planes = convert(stripes);
+    for (uchar value : planes.u) {
+        QCOMPARE(int(value), 128);
+    }
+    for (uchar value : planes.v) {
+        QCOMPARE(int(value), 128);
+    }
+    QCOMPARE(int(planes.y[0]), 16);
+    QCOMPARE(int(planes.y[1]), 235);
+}
+
+QTEST_MAIN(TestYuvConverter)
+#include "tst_YuvConverter.moc"
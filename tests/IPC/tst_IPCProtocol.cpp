@@ -1,6 +1,6 @@
 #include <QtTest>
 
-#include <QDataStream>
+#include <QBuffer>
 #include <QLocalServer>
 #include <QLocalSocket>
 
@@ -9,6 +9,7 @@
 #include <memory>
 
 #include "cli/IPCProtocol.h"
+#include "cli/IPCServerSession.h"
 
 using namespace SnapTray::CLI;
 
@@ -17,13 +18,16 @@ namespace {
 constexpr int kSocketTimeoutMs = 1000;
 constexpr int kFutureTimeoutMs = 5000;
 
-QByteArray buildLengthPrefixedPacket(const QByteArray& payload)
+// IPCProtocol's connection numbers requests from 1.
+constexpr quint32 kFirstRequestId = 1;
+
+QByteArray buildResponseFrame(const IPCResponse& response)
 {
-    QByteArray packet;
-    QDataStream stream(&packet, QIODevice::WriteOnly);
-    stream << static_cast<quint32>(payload.size());
-    packet.append(payload);
-    return packet;
+    IPCFrame frame;
+    frame.type = IPCFrame::Type::Response;
+    frame.requestId = kFirstRequestId;
+    frame.payload = response.toJson();
+    return frame.encode();
 }
 
 std::future<IPCResponse> sendCommandAsync()
@@ -74,14 +78,20 @@ bool waitForClientCommand(QLocalSocket* client)
     if (!client) {
         return false;
     }
-    while (client->bytesAvailable() < static_cast<qint64>(sizeof(quint32))) {
-        if (!client->waitForReadyRead(kSocketTimeoutMs)) {
+    // Read and discard the client's command frame.
+    IPCFrameReader reader;
+    for (;;) {
+        reader.append(client->readAll());
+        IPCFrame frame;
+        const IPCFrameReader::Status status = reader.next(&frame);
+        if (status == IPCFrameReader::Status::Ready) {
+            return frame.type == IPCFrame::Type::Command && frame.requestId == kFirstRequestId;
+        }
+        if (status == IPCFrameReader::Status::Invalid ||
+            !client->waitForReadyRead(kSocketTimeoutMs)) {
             return false;
         }
     }
-    // Read and discard the client's length-prefixed command.
-    client->readAll();
-    return true;
 }
 
 void disconnectClient(QLocalSocket* client)
@@ -120,10 +130,13 @@ class tst_IPCProtocol : public QObject
 
 private slots:
     void cleanup();
-    void testResponseHeaderSplit_1Plus3Bytes();
+    void testResponseHeaderSplit_1PlusRest();
     void testResponseBodySplit_MultiChunks();
     void testResponseHeaderIncomplete_Disconnect();
     void testResponseBodyIncomplete_Disconnect();
+    void testFrameReader_SplitAndInvalidInput();
+    void testPipelinedRequests_OutOfOrderReads();
+    void testStreamedData_AbortedByServer();
 
 private:
     bool tryPrepareServer(QLocalServer& server, QString& skipReason);
@@ -148,7 +161,7 @@ bool tst_IPCProtocol::tryPrepareServer(QLocalServer& server, QString& skipReason
     return true;
 }
 
-void tst_IPCProtocol::testResponseHeaderSplit_1Plus3Bytes()
+void tst_IPCProtocol::testResponseHeaderSplit_1PlusRest()
 {
     QLocalServer server;
     QString skipReason;
@@ -165,8 +178,8 @@ void tst_IPCProtocol::testResponseHeaderSplit_1Plus3Bytes()
     QVERIFY(client != nullptr);
     QVERIFY(waitForClientCommand(client.get()));
 
-    const QByteArray packet = buildLengthPrefixedPacket(expected.toJson());
-    const int headerSize = static_cast<int>(sizeof(quint32));
+    const QByteArray packet = buildResponseFrame(expected);
+    const int headerSize = IPCFrame::kHeaderSize;
     QVERIFY(packet.size() > headerSize);
 
     QVERIFY(writeChunk(client.get(), packet.left(1)));
@@ -200,8 +213,8 @@ void tst_IPCProtocol::testResponseBodySplit_MultiChunks()
     QVERIFY(client != nullptr);
     QVERIFY(waitForClientCommand(client.get()));
 
-    const QByteArray packet = buildLengthPrefixedPacket(expected.toJson());
-    const int headerSize = static_cast<int>(sizeof(quint32));
+    const QByteArray packet = buildResponseFrame(expected);
+    const int headerSize = IPCFrame::kHeaderSize;
     const QByteArray header = packet.left(headerSize);
     const QByteArray body = packet.mid(headerSize);
     QVERIFY(body.size() > 6);
@@ -238,7 +251,7 @@ void tst_IPCProtocol::testResponseHeaderIncomplete_Disconnect()
     QVERIFY(client != nullptr);
     QVERIFY(waitForClientCommand(client.get()));
 
-    const QByteArray packet = buildLengthPrefixedPacket(expected.toJson());
+    const QByteArray packet = buildResponseFrame(expected);
     QVERIFY(packet.size() >= 2);
 
     QVERIFY(writeChunk(client.get(), packet.left(2)));
@@ -267,8 +280,8 @@ void tst_IPCProtocol::testResponseBodyIncomplete_Disconnect()
     QVERIFY(client != nullptr);
     QVERIFY(waitForClientCommand(client.get()));
 
-    const QByteArray packet = buildLengthPrefixedPacket(expected.toJson());
-    const int headerSize = static_cast<int>(sizeof(quint32));
+    const QByteArray packet = buildResponseFrame(expected);
+    const int headerSize = IPCFrame::kHeaderSize;
     const QByteArray header = packet.left(headerSize);
     const QByteArray body = packet.mid(headerSize);
     QVERIFY(!body.isEmpty());
@@ -283,5 +296,186 @@ void tst_IPCProtocol::testResponseBodyIncomplete_Disconnect()
     QCOMPARE(actual.error, QString("Timeout waiting for response"));
 }
 
+void tst_IPCProtocol::testFrameReader_SplitAndInvalidInput()
+{
+    IPCFrame first;
+    first.type = IPCFrame::Type::Command;
+    first.requestId = 7;
+    first.payload = "{\"command\":\"gui\"}";
+    IPCFrame second;
+    second.type = IPCFrame::Type::Data;
+    second.requestId = 8;
+    second.payload = QByteArray(1000, 'x');
+    const QByteArray stream = first.encode() + second.encode();
+
+    // Byte-at-a-time delivery yields both frames intact.
+    IPCFrameReader reader;
+    QList<IPCFrame> frames;
+    for (char byte : stream) {
+        reader.append(QByteArray(1, byte));
+        IPCFrame frame;
+        const IPCFrameReader::Status status = reader.next(&frame);
+        QVERIFY(status != IPCFrameReader::Status::Invalid);
+        if (status == IPCFrameReader::Status::Ready) {
+            frames.append(frame);
+        }
+    }
+    QCOMPARE(frames.size(), 2);
+    QCOMPARE(frames[0].type, IPCFrame::Type::Command);
+    QCOMPARE(frames[0].requestId, quint32(7));
+    QCOMPARE(frames[0].payload, first.payload);
+    QCOMPARE(frames[1].type, IPCFrame::Type::Data);
+    QCOMPARE(frames[1].payload, second.payload);
+
+    IPCFrame frame;
+    IPCFrameReader legacy;
+    legacy.append(QByteArray("\x00\x00\x00\x10{\"command\":\"x\"}", 20));
+    QCOMPARE(legacy.next(&frame), IPCFrameReader::Status::Invalid);
+
+    QByteArray wrongVersion = first.encode();
+    wrongVersion[4] = char(IPCFrame::kVersion + 1);
+    IPCFrameReader versionReader;
+    versionReader.append(wrongVersion);
+    QCOMPARE(versionReader.next(&frame), IPCFrameReader::Status::Invalid);
+
+    IPCFrameReader oversizeReader;
+    oversizeReader.append(
+        IPCFrame::encodeHeader(IPCFrame::Type::Data, 0, 1, IPCFrame::kMaxPayloadSize + 1));
+    QCOMPARE(oversizeReader.next(&frame), IPCFrameReader::Status::Invalid);
+
+    QVERIFY(IPCFrame::hasMagicPrefix("ST"));
+    QVERIFY(!IPCFrame::hasMagicPrefix("activate"));
+}
+
+void tst_IPCProtocol::testPipelinedRequests_OutOfOrderReads()
+{
+    QLocalServer server;
+    QString skipReason;
+    if (!tryPrepareServer(server, skipReason)) {
+        QSKIP(qPrintable(skipReason));
+    }
+
+    // Spans several Data frames.
+    QByteArray blob(3 * IPCFrame::kDataChunkSize + 17, Qt::Uninitialized);
+    for (int i = 0; i < blob.size(); ++i) {
+        blob[i] = char(i * 31);
+    }
+
+    struct ClientOutcome
+    {
+        QString error;
+        QStringList messages;
+        QByteArray data;
+    };
+
+    auto future = std::async(std::launch::async, [blob]() {
+        ClientOutcome outcome;
+        IPCConnection connection;
+        if (!connection.connectToServer(IPCProtocol::getServerName(), kSocketTimeoutMs)) {
+            outcome.error = connection.errorString();
+            return outcome;
+        }
+
+        const QStringList commands{"first", "blob", "third"};
+        QList<quint32> ids;
+        for (const QString& command : commands) {
+            IPCMessage message;
+            message.command = command;
+            ids.append(connection.post(message));
+        }
+        if (!connection.flush(kSocketTimeoutMs)) {
+            outcome.error = connection.errorString();
+            return outcome;
+        }
+
+        // Last request first: earlier responses must be held, not dropped.
+        for (int i = ids.size() - 1; i >= 0; --i) {
+            IPCResponse response;
+            if (!connection.waitForResponse(ids[i], &response, kFutureTimeoutMs)) {
+                outcome.error = connection.errorString();
+                return outcome;
+            }
+            outcome.messages.append(response.message);
+            if (response.hasData) {
+                QBuffer buffer(&outcome.data);
+                buffer.open(QIODevice::WriteOnly);
+                if (!connection.readData(ids[i], &buffer, kFutureTimeoutMs)) {
+                    outcome.error = connection.errorString();
+                    return outcome;
+                }
+            }
+        }
+        return outcome;
+    });
+
+    QLocalSocket* client = waitForClient(server);
+    QVERIFY(client != nullptr);
+    QObject owner;
+    auto* session = new IPCServerSession(client, QByteArray(), &owner);
+    QStringList received;
+    connect(session, &IPCServerSession::commandReceived, &owner,
+        [&](quint32 requestId, const QByteArray& commandData) {
+            const IPCMessage message = IPCMessage::fromJson(commandData);
+            received.append(message.command);
+            IPCResponse response;
+            response.success = true;
+            response.message = message.command;
+            if (message.command == "blob") {
+                session->sendResponse(requestId, response, [&blob](QIODevice* device) {
+                    return device->write(blob) == blob.size();
+                });
+            }
+            else {
+                session->sendResponse(requestId, response);
+            }
+        });
+    session->start();
+
+    QTRY_VERIFY_WITH_TIMEOUT(
+        future.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready, kFutureTimeoutMs);
+    const ClientOutcome outcome = future.get();
+    QVERIFY2(outcome.error.isEmpty(), qPrintable(outcome.error));
+    QCOMPARE(received, QStringList({"first", "blob", "third"}));
+    QCOMPARE(outcome.messages, QStringList({"third", "blob", "first"}));
+    QCOMPARE(outcome.data, blob);
+}
+
+void tst_IPCProtocol::testStreamedData_AbortedByServer()
+{
+    QLocalServer server;
+    QString skipReason;
+    if (!tryPrepareServer(server, skipReason)) {
+        QSKIP(qPrintable(skipReason));
+    }
+
+    auto future = std::async(std::launch::async, []() {
+        IPCProtocol protocol;
+        IPCMessage message;
+        message.command = "run";
+        return protocol.sendCommand(message, true);
+    });
+
+    QLocalSocket* client = waitForClient(server);
+    QVERIFY(client != nullptr);
+    QObject owner;
+    auto* session = new IPCServerSession(client, QByteArray(), &owner);
+    connect(session, &IPCServerSession::commandReceived, &owner,
+        [session](quint32 requestId, const QByteArray&) {
+            IPCResponse response;
+            response.success = true;
+            session->sendResponse(requestId, response, [](QIODevice* device) {
+                device->write(QByteArray(100, 'a'));
+                return false;
+            });
+        });
+    session->start();
+
+    QTRY_VERIFY_WITH_TIMEOUT(
+        future.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready, kFutureTimeoutMs);
+    const IPCResponse actual = future.get();
+    QVERIFY(!actual.success);
+    QCOMPARE(actual.error, QString("SnapTray failed while sending data"));
+}
+
 QTEST_MAIN(tst_IPCProtocol)
 #include "tst_IPCProtocol.moc"
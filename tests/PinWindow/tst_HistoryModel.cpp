@@ -52,6 +52,7 @@ void appendBytes(const QString& filePath, qint64 byteCount)
     QFile file(filePath);
     QVERIFY(file.open(QIODevice::Append));
     QVERIFY(file.write(QByteArray(static_cast<int>(byteCount), '@')) == byteCount);
+    SnapTray::HistoryStore::invalidateIndex();
 }
 
 void setReplayAvailable(const SnapTray::HistoryEntry& entry, bool replayAvailable)
@@ -68,6 +69,7 @@ void setReplayAvailable(const SnapTray::HistoryEntry& entry, bool replayAvailabl
     QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
     file.write(QJsonDocument(updated).toJson(QJsonDocument::Indented));
     file.close();
+    SnapTray::HistoryStore::invalidateIndex();
 }
 
 } // namespace
@@ -80,6 +82,7 @@ private slots:
     void testRefreshAndRoles();
     void testSearchFiltersAndCounts();
     void testSortingModes();
+    void testFetchMorePagesLargeHistory();
 };
 
 void tst_HistoryModel::testRefreshAndRoles()
@@ -202,5 +205,68 @@ void tst_HistoryModel::testSortingModes()
     qunsetenv("SNAPTRAY_HISTORY_DIR");
 }
 
+void tst_HistoryModel::testFetchMorePagesLargeHistory()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    qputenv("SNAPTRAY_HISTORY_DIR", tempDir.path().toLocal8Bit());
+
+    constexpr int kEntryCount = 130;
+    const QDateTime base = QDateTime::currentDateTime().addDays(-1);
+    for (int i = 0; i < kEntryCount; ++i) {
+        SnapTray::CaptureSessionWriteRequest request;
+        request.canvasImage = makeImage(QSize(8, 8), i);
+        request.resultImage = makeImage(QSize(4, 4), i);
+        request.selectionRect = QRect(0, 0, 4, 4);
+        request.annotationsJson = QByteArrayLiteral("{\"items\":[]}");
+        request.createdAt = base.addSecs(i);
+        request.maxEntries = 0;
+        QVERIFY(SnapTray::HistoryStore::writeCaptureSession(request).has_value());
+    }
+
+    SnapTray::HistoryModel model;
+    QCOMPARE(model.totalCount(), kEntryCount);
+    QCOMPARE(model.countForFilter(SnapTray::HistoryModel::AllScreenshots), kEntryCount);
+    QVERIFY(model.rowCount() < kEntryCount);
+    QVERIFY(model.canFetchMore(QModelIndex()));
+
+    const int firstPage = model.rowCount();
+    const QString lastLoadedId = model.idAt(firstPage - 1);
+    QVERIFY(!lastLoadedId.isEmpty());
+
+    // Lookups reach entries that are not loaded yet; finding one by id
+    // loads the rows up to it.
+    const QString lastId = model.idAt(kEntryCount - 1);
+    QVERIFY(!lastId.isEmpty());
+    QCOMPARE(model.entryAt(kEntryCount - 1).id, lastId);
+    QCOMPARE(model.rowCount(), firstPage);
+    QCOMPARE(model.indexOfId(lastId), kEntryCount - 1);
+    QCOMPARE(model.rowCount(), kEntryCount);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+
+    model.setSortOrder(SnapTray::HistoryModel::OldestFirst);
+    model.setSortOrder(SnapTray::HistoryModel::NewestFirst);
+    QCOMPARE(model.rowCount(), firstPage);
+
+    QSignalSpy insertSpy(&model, &QAbstractItemModel::rowsInserted);
+    QVERIFY(insertSpy.isValid());
+    while (model.canFetchMore(QModelIndex())) {
+        model.fetchMore(QModelIndex());
+    }
+    QVERIFY(insertSpy.count() >= 1);
+    QCOMPARE(model.rowCount(), kEntryCount);
+    QCOMPARE(model.indexOfId(lastLoadedId), firstPage - 1);
+
+    // Refreshing keeps the rows the view has already pulled in.
+    model.refresh();
+    QCOMPARE(model.rowCount(), kEntryCount);
+
+    // Changing the sort order starts again from the first page.
+    model.setSortOrder(SnapTray::HistoryModel::OldestFirst);
+    QCOMPARE(model.rowCount(), firstPage);
+
+    qunsetenv("SNAPTRAY_HISTORY_DIR");
+}
+
 QTEST_MAIN(tst_HistoryModel)
 #include "tst_HistoryModel.moc"
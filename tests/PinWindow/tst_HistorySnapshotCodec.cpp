@@ -0,0 +1,157 @@
+#include <QtTest/QtTest>
+
+#include "history/HistorySnapshotCodec.h"
+
+#include <QColorSpace>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+
+namespace {
+
+// Flat areas, gradients and noise so every QOI op gets exercised.
+QImage makeImage(const QSize& size, QImage::Format format)
+{
+    QImage image(size, format);
+    quint32 seed = 7;
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            const int zone = (x / 24 + y / 12) % 4;
+            QColor color;
+            if (zone == 0) {
+                color = QColor(30, 30, 30);
+            } else if (zone == 1) {
+                color = QColor(x & 0xff, y & 0xff, (x + y) & 0xff);
+            } else if (zone == 2) {
+                color = QColor((seed >> 24) & 0xff, (seed >> 16) & 0xff, (seed >> 8) & 0xff);
+            } else {
+                color = QColor(200, 100 + (x % 3), 50, image.hasAlphaChannel() ? (y * 7) & 0xff : 255);
+            }
+            image.setPixelColor(x, y, color);
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+class tst_HistorySnapshotCodec : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRoundTrip_data();
+    void testRoundTrip();
+    void testKeepsDevicePixelRatioAndColorSpace();
+    void testWriteAndReadFile();
+    void testReadsPngFiles();
+    void testRejectsCorruptData();
+};
+
+void tst_HistorySnapshotCodec::testRoundTrip_data()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<int>("format");
+
+    QTest::newRow("rgb32") << QSize(333, 211) << int(QImage::Format_RGB32);
+    QTest::newRow("argb32") << QSize(128, 97) << int(QImage::Format_ARGB32);
+    QTest::newRow("premultiplied") << QSize(640, 400) << int(QImage::Format_ARGB32_Premultiplied);
+    QTest::newRow("single-row") << QSize(1000, 1) << int(QImage::Format_RGB32);
+    QTest::newRow("single-pixel") << QSize(1, 1) << int(QImage::Format_ARGB32);
+}
+
+void tst_HistorySnapshotCodec::testRoundTrip()
+{
+    QFETCH(QSize, size);
+    QFETCH(int, format);
+
+    const QImage image = makeImage(size, static_cast<QImage::Format>(format));
+    const QByteArray encoded = SnapTray::HistorySnapshotCodec::encodeQoi(image);
+    QVERIFY(!encoded.isEmpty());
+
+    QString error;
+    const QImage decoded = SnapTray::HistorySnapshotCodec::decodeQoi(
+        reinterpret_cast<const uchar*>(encoded.constData()), encoded.size(), &error);
+    QVERIFY2(!decoded.isNull(), qPrintable(error));
+    QCOMPARE(decoded.format(), image.format());
+    QCOMPARE(decoded, image);
+}
+
+void tst_HistorySnapshotCodec::testKeepsDevicePixelRatioAndColorSpace()
+{
+    QImage image = makeImage(QSize(64, 48), QImage::Format_RGB32);
+    image.setDevicePixelRatio(1.5);
+    image.setColorSpace(QColorSpace(QColorSpace::DisplayP3));
+
+    const QByteArray encoded = SnapTray::HistorySnapshotCodec::encodeQoi(image);
+    const QImage decoded = SnapTray::HistorySnapshotCodec::decodeQoi(
+        reinterpret_cast<const uchar*>(encoded.constData()), encoded.size());
+    QCOMPARE(decoded.devicePixelRatio(), 1.5);
+    QCOMPARE(decoded.colorSpace(), image.colorSpace());
+}
+
+void tst_HistorySnapshotCodec::testWriteAndReadFile()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Formats without a stored layout come back in the nearest lossless one.
+    const QImage image = makeImage(QSize(300, 200), QImage::Format_RGB888);
+    const QString path = tempDir.filePath(QStringLiteral("canvas.snapshot"));
+    QString error;
+    QVERIFY2(SnapTray::HistorySnapshotCodec::write(
+                 image, path, SnapTray::HistorySnapshotCodec::Format::Qoi, &error),
+             qPrintable(error));
+
+    const QImage loaded = SnapTray::HistorySnapshotCodec::read(path, &error);
+    QVERIFY2(!loaded.isNull(), qPrintable(error));
+    QCOMPARE(loaded.format(), QImage::Format_RGB32);
+    QCOMPARE(loaded, image.convertToFormat(QImage::Format_RGB32));
+}
+
+void tst_HistorySnapshotCodec::testReadsPngFiles()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QImage image = makeImage(QSize(80, 60), QImage::Format_ARGB32);
+    const QString path = tempDir.filePath(QStringLiteral("canvas.png"));
+    QVERIFY(image.save(path, "PNG"));
+
+    const QImage loaded = SnapTray::HistorySnapshotCodec::read(path);
+    QCOMPARE(loaded.convertToFormat(QImage::Format_ARGB32), image);
+}
+
+void tst_HistorySnapshotCodec::testRejectsCorruptData()
+{
+    const QImage image = makeImage(QSize(200, 120), QImage::Format_RGB32);
+    const QByteArray encoded = SnapTray::HistorySnapshotCodec::encodeQoi(image);
+    const auto* data = reinterpret_cast<const uchar*>(encoded.constData());
+
+    QString error;
+    QVERIFY(SnapTray::HistorySnapshotCodec::decodeQoi(data, encoded.size() - 1, &error).isNull());
+    QVERIFY(!error.isEmpty());
+    QVERIFY(SnapTray::HistorySnapshotCodec::decodeQoi(data, 20).isNull());
+
+    QByteArray badHeader = encoded;
+    badHeader[8] = 0;
+    badHeader[9] = 0;
+    badHeader[10] = 0;
+    badHeader[11] = 0;
+    QVERIFY(SnapTray::HistorySnapshotCodec::decodeQoi(
+                reinterpret_cast<const uchar*>(badHeader.constData()), badHeader.size())
+                .isNull());
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString path = tempDir.filePath(QStringLiteral("garbage.snapshot"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QByteArrayLiteral("not an image"));
+    file.close();
+    QVERIFY(SnapTray::HistorySnapshotCodec::read(path).isNull());
+}
+
+QTEST_MAIN(tst_HistorySnapshotCodec)
+#include "tst_HistorySnapshotCodec.moc"
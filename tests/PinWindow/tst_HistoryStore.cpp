@@ -35,6 +35,32 @@ QByteArray sampleAnnotations()
     return SnapTray::serializeAnnotationLayer(layer);
 }
 
+std::optional<SnapTray::HistoryEntry> writeSmallEntry(int seed)
+{
+    SnapTray::CaptureSessionWriteRequest request;
+    request.canvasImage = makeImage(QSize(16, 16), QColor(seed, 20, 30));
+    request.resultImage = makeImage(QSize(8, 8), QColor(40, seed, 60));
+    request.selectionRect = QRect(0, 0, 8, 8);
+    request.annotationsJson = QByteArrayLiteral("{\"items\":[]}");
+    request.captureRegions.append({QRect(1, 2, 3, 4), QColor(10, 20, 30, 40), 1, true});
+    request.devicePixelRatio = 1.5;
+    request.createdAt = QDateTime(QDate(2026, 1, 1), QTime(12, 0, seed % 60, 0));
+    request.maxEntries = 0;
+    return SnapTray::HistoryStore::writeCaptureSession(request);
+}
+
+QString indexPath()
+{
+    return QDir(SnapTray::HistoryStore::historyRootPath()).filePath(QStringLiteral("index.bin"));
+}
+
+// Directory stamps have the filesystem's timestamp granularity; step past it
+// so an external change is distinguishable from the last index update.
+void waitForNewDirectoryStamp()
+{
+    QTest::qWait(50);
+}
+
 } // namespace
 
 class tst_HistoryStore : public QObject
@@ -45,6 +71,12 @@ private slots:
     void testWriteAndLoadCapture();
     void testIgnoresNonCaptureManifest();
     void testRetentionTrimsOldestEntries();
+    void testIndexMatchesManifests();
+    void testIndexRebuiltWhenDamaged();
+    void testIndexRebuiltAfterExternalRemoval();
+    void testInvalidateIndexPicksUpManifestEdits();
+    void testThumbnailWrittenForLargeResults();
+    void testCanvasCodecChosenByRequest();
 };
 
 void tst_HistoryStore::testWriteAndLoadCapture()
@@ -143,5 +175,207 @@ void tst_HistoryStore::testRetentionTrimsOldestEntries()
     qunsetenv("SNAPTRAY_HISTORY_DIR");
 }
 
+void tst_HistoryStore::testIndexMatchesManifests()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    qputenv("SNAPTRAY_HISTORY_DIR", tempDir.path().toLocal8Bit());
+
+    // The first listing builds the index; later writes and deletes append.
+    const auto firstEntry = writeSmallEntry(0);
+    QVERIFY(firstEntry.has_value());
+    QCOMPARE(SnapTray::HistoryStore::loadEntries().size(), 1);
+    QVERIFY(QFileInfo::exists(indexPath()));
+    for (int i = 1; i < 4; ++i) {
+        QVERIFY(writeSmallEntry(i).has_value());
+    }
+    QVERIFY(SnapTray::HistoryStore::deleteEntry(*firstEntry));
+
+    const QList<SnapTray::HistoryEntry> indexed = SnapTray::HistoryStore::loadEntries();
+    SnapTray::HistoryStore::invalidateIndex();
+    QVERIFY(!QFileInfo::exists(indexPath()));
+    const QList<SnapTray::HistoryEntry> scanned = SnapTray::HistoryStore::loadEntries();
+
+    QCOMPARE(indexed.size(), 3);
+    QCOMPARE(scanned.size(), indexed.size());
+    for (int i = 0; i < indexed.size(); ++i) {
+        const SnapTray::HistoryEntry& lhs = indexed.at(i);
+        const SnapTray::HistoryEntry& rhs = scanned.at(i);
+        QCOMPARE(lhs.id, rhs.id);
+        QCOMPARE(lhs.createdAt, rhs.createdAt);
+        QCOMPARE(lhs.entryDirectory, rhs.entryDirectory);
+        QCOMPARE(lhs.previewPath, rhs.previewPath);
+        QCOMPARE(lhs.resultPath, rhs.resultPath);
+        QCOMPARE(lhs.canvasPath, rhs.canvasPath);
+        QCOMPARE(lhs.annotationsPath, rhs.annotationsPath);
+        QCOMPARE(lhs.replayAvailable, rhs.replayAvailable);
+        QCOMPARE(lhs.resultSize, rhs.resultSize);
+        QCOMPARE(lhs.fileSizeBytes, rhs.fileSizeBytes);
+        QCOMPARE(lhs.devicePixelRatio, rhs.devicePixelRatio);
+        QCOMPARE(lhs.selectionRect, rhs.selectionRect);
+        QCOMPARE(lhs.canvasLogicalSize, rhs.canvasLogicalSize);
+        QCOMPARE(lhs.cornerRadius, rhs.cornerRadius);
+        QCOMPARE(lhs.captureRegions.size(), 1);
+        QCOMPARE(lhs.captureRegions.first().rect, rhs.captureRegions.first().rect);
+        QCOMPARE(lhs.captureRegions.first().color, rhs.captureRegions.first().color);
+        QCOMPARE(lhs.captureRegions.first().index, rhs.captureRegions.first().index);
+        QCOMPARE(lhs.captureRegions.first().isActive, rhs.captureRegions.first().isActive);
+    }
+
+    qunsetenv("SNAPTRAY_HISTORY_DIR");
+}
+
+void tst_HistoryStore::testIndexRebuiltWhenDamaged()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    qputenv("SNAPTRAY_HISTORY_DIR", tempDir.path().toLocal8Bit());
+
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(writeSmallEntry(i).has_value());
+    }
+    QCOMPARE(SnapTray::HistoryStore::loadEntries().size(), 3);
+
+    QFile index(indexPath());
+    QVERIFY(index.open(QIODevice::ReadWrite));
+    const qint64 fullSize = index.size();
+    QVERIFY(index.resize(fullSize - 5));
+    index.close();
+    QCOMPARE(SnapTray::HistoryStore::loadEntries().size(), 3);
+
+    // Flip a payload byte; the record checksum must reject it.
+    QVERIFY(index.open(QIODevice::ReadWrite));
+    QCOMPARE(index.size(), fullSize);
+    QVERIFY(index.seek(fullSize - 3));
+    QVERIFY(index.write("\xff", 1) == 1);
+    index.close();
+    QCOMPARE(SnapTray::HistoryStore::loadEntries().size(), 3);
+
+    QVERIFY(index.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    index.write("not an index");
+    index.close();
+    QCOMPARE(SnapTray::HistoryStore::loadEntries().size(), 3);
+
+    qunsetenv("SNAPTRAY_HISTORY_DIR");
+}
+
+void tst_HistoryStore::testIndexRebuiltAfterExternalRemoval()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    qputenv("SNAPTRAY_HISTORY_DIR", tempDir.path().toLocal8Bit());
+
+    const auto first = writeSmallEntry(1);
+    const auto second = writeSmallEntry(2);
+    QVERIFY(first.has_value());
+    QVERIFY(second.has_value());
+    QCOMPARE(SnapTray::HistoryStore::loadEntries().size(), 2);
+
+    waitForNewDirectoryStamp();
+    QVERIFY(QDir(first->entryDirectory).removeRecursively());
+
+    const QList<SnapTray::HistoryEntry> entries = SnapTray::HistoryStore::loadEntries();
+    QCOMPARE(entries.size(), 1);
+    QCOMPARE(entries.first().id, second->id);
+
+    qunsetenv("SNAPTRAY_HISTORY_DIR");
+}
+
+void tst_HistoryStore::testInvalidateIndexPicksUpManifestEdits()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    qputenv("SNAPTRAY_HISTORY_DIR", tempDir.path().toLocal8Bit());
+
+    const auto entry = writeSmallEntry(1);
+    QVERIFY(entry.has_value());
+    QVERIFY(SnapTray::HistoryStore::loadEntries().first().replayAvailable);
+
+    QFile manifestFile(QDir(entry->entryDirectory).filePath(QStringLiteral("manifest.json")));
+    QVERIFY(manifestFile.open(QIODevice::ReadOnly));
+    QJsonObject manifest = QJsonDocument::fromJson(manifestFile.readAll()).object();
+    manifestFile.close();
+    manifest.insert(QStringLiteral("replayAvailable"), false);
+    QVERIFY(manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    manifestFile.write(QJsonDocument(manifest).toJson(QJsonDocument::Indented));
+    manifestFile.close();
+
+    // Editing a file inside an entry doesn't touch the entries directory, so
+    // the index still answers until it is invalidated.
+    QVERIFY(SnapTray::HistoryStore::loadEntries().first().replayAvailable);
+    SnapTray::HistoryStore::invalidateIndex();
+    QVERIFY(!SnapTray::HistoryStore::loadEntries().first().replayAvailable);
+
+    qunsetenv("SNAPTRAY_HISTORY_DIR");
+}
+
+void tst_HistoryStore::testThumbnailWrittenForLargeResults()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    qputenv("SNAPTRAY_HISTORY_DIR", tempDir.path().toLocal8Bit());
+
+    SnapTray::CaptureSessionWriteRequest request;
+    request.canvasImage = makeImage(QSize(64, 64), QColor(10, 20, 30));
+    request.resultImage = makeImage(QSize(2000, 500), QColor(40, 50, 60));
+    request.selectionRect = QRect(0, 0, 2000, 500);
+    request.annotationsJson = QByteArrayLiteral("{\"items\":[]}");
+    const auto large = SnapTray::HistoryStore::writeCaptureSession(request);
+    QVERIFY(large.has_value());
+
+    const QString thumbnailPath = SnapTray::HistoryStore::thumbnailSourcePath(large->id);
+    QVERIFY(!thumbnailPath.isEmpty());
+    QVERIFY(thumbnailPath != large->resultPath);
+    const QImage thumbnail(thumbnailPath);
+    QCOMPARE(thumbnail.size(), QSize(SnapTray::HistoryStore::kThumbnailMaxEdge,
+                                     SnapTray::HistoryStore::kThumbnailMaxEdge / 4));
+
+    request.resultImage = makeImage(QSize(120, 90), QColor(40, 50, 60));
+    request.selectionRect = QRect(0, 0, 120, 90);
+    const auto small = SnapTray::HistoryStore::writeCaptureSession(request);
+    QVERIFY(small.has_value());
+    QCOMPARE(SnapTray::HistoryStore::thumbnailSourcePath(small->id), small->resultPath);
+
+    QVERIFY(SnapTray::HistoryStore::thumbnailSourcePath(QStringLiteral("../outside")).isEmpty());
+    QVERIFY(SnapTray::HistoryStore::thumbnailSourcePath(QStringLiteral("missing")).isEmpty());
+
+    qunsetenv("SNAPTRAY_HISTORY_DIR");
+}
+
+void tst_HistoryStore::testCanvasCodecChosenByRequest()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    qputenv("SNAPTRAY_HISTORY_DIR", tempDir.path().toLocal8Bit());
+
+    SnapTray::CaptureSessionWriteRequest request;
+    request.canvasImage = makeImage(QSize(96, 64), QColor(10, 20, 30));
+    request.resultImage = makeImage(QSize(32, 32), QColor(40, 50, 60));
+    request.selectionRect = QRect(0, 0, 32, 32);
+    request.annotationsJson = QByteArrayLiteral("{\"items\":[]}");
+
+    const auto snapshot = SnapTray::HistoryStore::writeCaptureSession(request);
+    QVERIFY(snapshot.has_value());
+    QCOMPARE(QFileInfo(snapshot->canvasPath).suffix(), QStringLiteral("snapshot"));
+    QCOMPARE(SnapTray::HistorySnapshotCodec::read(snapshot->canvasPath), request.canvasImage);
+
+    // PNG canvases, as written before the snapshot format, still load.
+    request.canvasFormat = SnapTray::HistorySnapshotCodec::Format::Png;
+    const auto png = SnapTray::HistoryStore::writeCaptureSession(request);
+    QVERIFY(png.has_value());
+    QCOMPARE(QFileInfo(png->canvasPath).suffix(), QStringLiteral("png"));
+    QCOMPARE(QImage(png->canvasPath).convertToFormat(request.canvasImage.format()),
+             request.canvasImage);
+    QCOMPARE(SnapTray::HistorySnapshotCodec::read(png->canvasPath)
+                 .convertToFormat(request.canvasImage.format()),
+             request.canvasImage);
+
+    const auto reloaded = SnapTray::HistoryStore::loadEntry(snapshot->id);
+    QVERIFY(reloaded.has_value());
+    QCOMPARE(reloaded->canvasPath, snapshot->canvasPath);
+
+    qunsetenv("SNAPTRAY_HISTORY_DIR");
+}
+
 QTEST_MAIN(tst_HistoryStore)
 #include "tst_HistoryStore.moc"
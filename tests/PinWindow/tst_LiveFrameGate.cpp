@@ -0,0 +1,139 @@
+#include <QtTest/QtTest>
+
+#include <QImage>
+
+#include "pinwindow/LiveFrameGate.h"
+
+namespace {
+
+QImage makeFrame(QRgb color, const QSize& size = QSize(64, 48))
+{
+    QImage frame(size, QImage::Format_RGB32);
+    frame.fill(color);
+    return frame;
+}
+
+} // namespace
+
+class tst_LiveFrameGate : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testFirstFrameIsPainted();
+    void testIdenticalPixelsAreSkipped();
+    void testSameImageIsSkippedWithoutHashing();
+    void testDirtyRegionDecides();
+    void testBacksOffWhileIdleAndRecovers();
+    void testSlowBaseIntervalIsNotShortened();
+    void testResetClearsStats();
+};
+
+void tst_LiveFrameGate::testFirstFrameIsPainted()
+{
+    LiveFrameGate gate;
+    QVERIFY(!gate.submitFrame(QImage(), std::nullopt));
+    QCOMPARE(gate.stats().captured, quint64(0));
+
+    QVERIFY(gate.submitFrame(makeFrame(Qt::red), std::nullopt));
+    QCOMPARE(gate.stats().captured, quint64(1));
+    QCOMPARE(gate.stats().painted, quint64(1));
+    QCOMPARE(gate.stats().skipped, quint64(0));
+}
+
+void tst_LiveFrameGate::testIdenticalPixelsAreSkipped()
+{
+    LiveFrameGate gate;
+    QVERIFY(gate.submitFrame(makeFrame(Qt::red), std::nullopt));
+    QVERIFY(!gate.submitFrame(makeFrame(Qt::red), std::nullopt));
+
+    QImage changed = makeFrame(Qt::red);
+    changed.setPixel(63, 47, qRgb(0, 0, 255));
+    QVERIFY(gate.submitFrame(changed, std::nullopt));
+    QVERIFY(gate.submitFrame(makeFrame(Qt::red, QSize(48, 64)), std::nullopt));
+
+    QCOMPARE(gate.stats().captured, quint64(4));
+    QCOMPARE(gate.stats().painted, quint64(3));
+    QCOMPARE(gate.stats().skipped, quint64(1));
+}
+
+void tst_LiveFrameGate::testSameImageIsSkippedWithoutHashing()
+{
+    LiveFrameGate gate;
+    QImage frame = makeFrame(Qt::green);
+    QVERIFY(gate.submitFrame(frame, std::nullopt));
+    QVERIFY(!gate.submitFrame(frame, std::nullopt));
+
+    // Writing through bits() changes the cache key, so in-place updates are seen.
+    frame.bits()[0] = 0x7f;
+    QVERIFY(gate.submitFrame(frame, std::nullopt));
+}
+
+void tst_LiveFrameGate::testDirtyRegionDecides()
+{
+    LiveFrameGate gate;
+    QVERIFY(gate.submitFrame(makeFrame(Qt::red), QRegion()));
+    QVERIFY(!gate.submitFrame(makeFrame(Qt::blue), QRegion()));
+    QVERIFY(gate.submitFrame(makeFrame(Qt::blue), QRegion(0, 0, 4, 4)));
+}
+
+void tst_LiveFrameGate::testBacksOffWhileIdleAndRecovers()
+{
+    LiveFrameGate gate;
+    gate.setBaseInterval(33);
+    const QImage frame = makeFrame(Qt::red);
+    QVERIFY(gate.submitFrame(frame, std::nullopt));
+
+    for (int i = 1; i < LiveFrameGate::kIdleFramesBeforeBackoff; ++i) {
+        QVERIFY(!gate.submitFrame(frame, std::nullopt));
+        QCOMPARE(gate.intervalMs(), 33);
+    }
+
+    int previousInterval = gate.intervalMs();
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(!gate.submitFrame(frame, std::nullopt));
+        QVERIFY(gate.intervalMs() >= previousInterval);
+        previousInterval = gate.intervalMs();
+    }
+    QCOMPARE(gate.intervalMs(), LiveFrameGate::kMaxIdleIntervalMs);
+
+    QVERIFY(gate.submitFrame(makeFrame(Qt::blue), std::nullopt));
+    QCOMPARE(gate.intervalMs(), 33);
+
+    // A new base interval also drops the back-off.
+    for (int i = 0; i < 20; ++i) {
+        gate.submitFrame(frame, QRegion());
+    }
+    QVERIFY(gate.intervalMs() > 100);
+    gate.setBaseInterval(100);
+    QCOMPARE(gate.intervalMs(), 100);
+}
+
+void tst_LiveFrameGate::testSlowBaseIntervalIsNotShortened()
+{
+    LiveFrameGate gate;
+    gate.setBaseInterval(1000);
+    const QImage frame = makeFrame(Qt::red);
+    for (int i = 0; i < 20; ++i) {
+        gate.submitFrame(frame, std::nullopt);
+        QCOMPARE(gate.intervalMs(), 1000);
+    }
+}
+
+void tst_LiveFrameGate::testResetClearsStats()
+{
+    LiveFrameGate gate;
+    gate.setBaseInterval(50);
+    const QImage frame = makeFrame(Qt::red);
+    for (int i = 0; i < 20; ++i) {
+        gate.submitFrame(frame, std::nullopt);
+    }
+
+    gate.reset();
+    QCOMPARE(gate.stats().captured, quint64(0));
+    QCOMPARE(gate.intervalMs(), 50);
+    QVERIFY(gate.submitFrame(frame, std::nullopt));
+}
+
+QTEST_MAIN(tst_LiveFrameGate)
+#include "tst_LiveFrameGate.moc"
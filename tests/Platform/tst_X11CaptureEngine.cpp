@@ -0,0 +1,253 @@
+#include <QtTest/QtTest>
+
+#include <QGuiApplication>
+#include <QScreen>
+#include <QtGui/qguiapplication_platform.h>
+
+#include "capture/X11CaptureEngine.h"
+
+#include <X11/Xlib.h>
+
+namespace {
+
+constexpr unsigned long kFirstColor = 0x3366cc;
+constexpr unsigned long kSecondColor = 0xcc6633;
+
+struct TestWindow
+{
+    Display* display = nullptr;
+    ::Window window = 0;
+
+    ~TestWindow()
+    {
+        if (display && window != 0) {
+            XDestroyWindow(display, window);
+            XFlush(display);
+        }
+    }
+
+    void fill(unsigned long color)
+    {
+        XSetWindowBackground(display, window, color);
+        XClearWindow(display, window);
+        XSync(display, False);
+    }
+
+    void fillRect(unsigned long color, const QRect& rect)
+    {
+        GC gc = XCreateGC(display, window, 0, nullptr);
+        XSetForeground(display, gc, color);
+        XFillRectangle(display, window, gc, rect.x(), rect.y(),
+                       static_cast<unsigned int>(rect.width()),
+                       static_cast<unsigned int>(rect.height()));
+        XFreeGC(display, gc);
+        XSync(display, False);
+    }
+};
+
+QRgb centerPixel(const QImage& image)
+{
+    return image.pixel(image.width() / 2, image.height() / 2) & 0xffffff;
+}
+
+} // namespace
+
+class tst_X11CaptureEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testCapturesWindowContents();
+    void testReusesTargetBuffer();
+    void testReportsDamageOnlyForChanges();
+    void testAlternatingTargetsCopyMissedDamage();
+    void testRejectsTinyRegion();
+
+private:
+    bool createWindow(TestWindow* window, QRect* bounds);
+    QScreen* m_screen = nullptr;
+};
+
+void tst_X11CaptureEngine::init()
+{
+    if (QGuiApplication::platformName() != QStringLiteral("xcb")) {
+        QSKIP("X11 capture needs the xcb platform.");
+    }
+    if (!X11CaptureEngine::isAvailable()) {
+        QSKIP("MIT-SHM is unavailable on this display.");
+    }
+    m_screen = QGuiApplication::primaryScreen();
+    if (!m_screen || !qFuzzyCompare(m_screen->devicePixelRatio(), 1.0)) {
+        QSKIP("Test expects an unscaled primary screen.");
+    }
+}
+
+bool tst_X11CaptureEngine::createWindow(TestWindow* window, QRect* bounds)
+{
+    auto* x11Application = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+    if (!x11Application || !x11Application->display()) {
+        return false;
+    }
+
+    *bounds = QRect(m_screen->geometry().center() - QPoint(80, 60), QSize(160, 120));
+    Display* display = x11Application->display();
+    window->display = display;
+    window->window = XCreateSimpleWindow(display,
+                                         DefaultRootWindow(display),
+                                         bounds->x(),
+                                         bounds->y(),
+                                         static_cast<unsigned int>(bounds->width()),
+                                         static_cast<unsigned int>(bounds->height()),
+                                         0,
+                                         0,
+                                         kFirstColor);
+    if (window->window == 0) {
+        return false;
+    }
+
+    // Keep the window manager from moving or decorating it.
+    XSetWindowAttributes attributes;
+    attributes.override_redirect = True;
+    XChangeWindowAttributes(display, window->window, CWOverrideRedirect, &attributes);
+    XMapRaised(display, window->window);
+    XSync(display, False);
+    return true;
+}
+
+void tst_X11CaptureEngine::testCapturesWindowContents()
+{
+    TestWindow window;
+    QRect bounds;
+    QVERIFY(createWindow(&window, &bounds));
+
+    X11CaptureEngine engine;
+    QVERIFY(engine.setRegion(bounds.adjusted(20, 20, -20, -20), m_screen));
+    QVERIFY(engine.start());
+    QVERIFY(engine.isRunning());
+
+    QImage frame;
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (frame = engine.captureFrame(), !frame.isNull() && centerPixel(frame) == kFirstColor),
+        3000);
+    QCOMPARE(frame.size(), QSize(120, 80));
+    QCOMPARE(frame.format(), QImage::Format_RGB32);
+
+    window.fill(kSecondColor);
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (frame = engine.captureFrame(), centerPixel(frame) == kSecondColor), 3000);
+
+    engine.stop();
+    QVERIFY(!engine.isRunning());
+    QVERIFY(engine.captureFrame().isNull());
+}
+
+void tst_X11CaptureEngine::testReusesTargetBuffer()
+{
+    TestWindow window;
+    QRect bounds;
+    QVERIFY(createWindow(&window, &bounds));
+
+    X11CaptureEngine engine;
+    QVERIFY(engine.setRegion(bounds, m_screen));
+    QVERIFY(engine.start());
+
+    QImage target;
+    QVERIFY(engine.captureFrameInto(target));
+    const uchar* buffer = target.constBits();
+
+    for (int i = 0; i < 5; ++i) {
+        window.fill(i % 2 ? kFirstColor : kSecondColor);
+        QVERIFY(engine.captureFrameInto(target));
+        QCOMPARE(target.constBits(), buffer);
+    }
+}
+
+void tst_X11CaptureEngine::testReportsDamageOnlyForChanges()
+{
+    TestWindow window;
+    QRect bounds;
+    QVERIFY(createWindow(&window, &bounds));
+
+    X11CaptureEngine engine;
+    QVERIFY(engine.setRegion(bounds, m_screen));
+    QVERIFY(engine.start());
+
+    QImage target;
+    QVERIFY(engine.captureFrameInto(target));
+    if (!engine.lastDirtyRegion().has_value()) {
+        QSKIP("XDamage is unavailable; frames carry no dirty regions.");
+    }
+
+    // Settle: the first frames may still see damage from mapping the window.
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (engine.captureFrameInto(target), engine.lastDirtyRegion()->isEmpty()), 3000);
+
+    window.fill(kSecondColor);
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (engine.captureFrameInto(target), !engine.lastDirtyRegion()->isEmpty()), 3000);
+    QCOMPARE(centerPixel(target), QRgb(kSecondColor));
+    QVERIFY(QRect(QPoint(0, 0), target.size()).contains(engine.lastDirtyRegion()->boundingRect()));
+
+    // A caller that replaces its buffer gets a full frame again.
+    QImage freshTarget;
+    QVERIFY(engine.captureFrameInto(freshTarget));
+    QCOMPARE(*engine.lastDirtyRegion(), QRegion(QRect(QPoint(0, 0), freshTarget.size())));
+    QCOMPARE(centerPixel(freshTarget), QRgb(kSecondColor));
+}
+
+void tst_X11CaptureEngine::testAlternatingTargetsCopyMissedDamage()
+{
+    TestWindow window;
+    QRect bounds;
+    QVERIFY(createWindow(&window, &bounds));
+
+    X11CaptureEngine engine;
+    QVERIFY(engine.setRegion(bounds, m_screen));
+    QVERIFY(engine.start());
+
+    // Recording rotates through pooled buffers; none of them is the one
+    // written last.
+    QImage first;
+    QImage second;
+    QVERIFY(engine.captureFrameInto(first));
+    if (!engine.lastDirtyRegion().has_value()) {
+        QSKIP("XDamage is unavailable; frames carry no dirty regions.");
+    }
+    const QRegion fullFrame(QRect(QPoint(0, 0), first.size()));
+    QVERIFY(engine.captureFrameInto(second));
+    QCOMPARE(*engine.lastDirtyRegion(), fullFrame);
+
+    // Settle: a clean second buffer means no damage since either was written.
+    QTRY_VERIFY_WITH_TIMEOUT((engine.captureFrameInto(first), engine.captureFrameInto(second),
+                              engine.lastDirtyRegion()->isEmpty()),
+                             3000);
+
+    window.fillRect(kSecondColor, QRect(60, 40, 40, 40));
+    QTRY_VERIFY_WITH_TIMEOUT(
+        (engine.captureFrameInto(first), !engine.lastDirtyRegion()->isEmpty()), 3000);
+    const QRegion firstDirty = *engine.lastDirtyRegion();
+    QVERIFY(firstDirty != fullFrame);
+    QCOMPARE(centerPixel(first), QRgb(kSecondColor));
+
+    // The second buffer missed the same change and gets only that, not a
+    // full copy.
+    QVERIFY(engine.captureFrameInto(second));
+    const QRegion secondDirty = *engine.lastDirtyRegion();
+    QVERIFY((firstDirty - secondDirty).isEmpty());
+    QVERIFY(secondDirty != fullFrame);
+    QCOMPARE(centerPixel(second), QRgb(kSecondColor));
+    QCOMPARE(second, first);
+}
+
+void tst_X11CaptureEngine::testRejectsTinyRegion()
+{
+    X11CaptureEngine engine;
+    QVERIFY(engine.setRegion(QRect(0, 0, 5, 5), m_screen));
+    QSignalSpy errorSpy(&engine, &ICaptureEngine::error);
+    QVERIFY(!engine.start());
+    QCOMPARE(errorSpy.count(), 1);
+}
+
+QTEST_MAIN(tst_X11CaptureEngine)
+#include "tst_X11CaptureEngine.moc"
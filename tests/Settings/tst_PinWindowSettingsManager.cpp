@@ -312,11 +312,11 @@ void tst_PinWindowSettingsManager::testLoadMaxCacheFiles_ClampMin()
 void tst_PinWindowSettingsManager::testLoadMaxCacheFiles_ClampMax()
 {
     auto settings = SnapTray::getSettings();
-    settings.setValue("history/maxEntries", 500);  // Above maximum
+    settings.setValue("history/maxEntries", 5000);  // Above maximum
     settings.sync();
 
     int maxFiles = PinWindowSettingsManager::instance().loadMaxCacheFiles();
-    QCOMPARE(maxFiles, 200);  // Clamped to maximum
+    QCOMPARE(maxFiles, 2000);  // Clamped to maximum
 }
 
 void tst_PinWindowSettingsManager::testMaxCacheFiles_ValidRange()
@@ -328,8 +328,8 @@ void tst_PinWindowSettingsManager::testMaxCacheFiles_ValidRange()
     QCOMPARE(manager.loadMaxCacheFiles(), 5);
 
     // Test maximum valid value
-    manager.saveMaxCacheFiles(200);
-    QCOMPARE(manager.loadMaxCacheFiles(), 200);
+    manager.saveMaxCacheFiles(2000);
+    QCOMPARE(manager.loadMaxCacheFiles(), 2000);
 
     // Test middle value
     manager.saveMaxCacheFiles(75);
@@ -0,0 +1,208 @@
+#include <QtTest>
+
+#include <QBuffer>
+#include <QColorSpace>
+#include <QImageReader>
+#include <QTemporaryDir>
+
+#include <cstring>
+
+#include "utils/ImageSaveUtils.h"
+#include "utils/ParallelPngWriter.h"
+
+namespace {
+
+// Screenshot-like content: flat areas for long matches plus noisy tiles so
+// every filter type gets picked somewhere.
+QImage makeImage(const QSize& size, QImage::Format format)
+{
+    QImage image(size, format);
+    quint32 seed = 12345;
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            seed = seed * 1103515245u + 12345u;
+            const bool noisy = ((x / 16 + y / 8) % 3) == 0;
+            const int r = noisy ? (seed >> 16) & 0xff : (x * 3) & 0xff;
+            const int g = noisy ? (seed >> 8) & 0xff : (y * 5) & 0xff;
+            const int b = noisy ? seed & 0xff : ((x + y) * 2) & 0xff;
+            const int a = image.hasAlphaChannel() ? ((x + 2 * y) % 256) : 255;
+            image.setPixelColor(x, y, QColor(r, g, b, a));
+        }
+    }
+    return image;
+}
+
+QImage decode(const QByteArray& data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer, "png");
+    return reader.read();
+}
+
+bool samePixels(const QImage& lhs, const QImage& rhs)
+{
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    const QImage a = lhs.convertToFormat(QImage::Format_RGBA8888);
+    const QImage b = rhs.convertToFormat(QImage::Format_RGBA8888);
+    for (int y = 0; y < a.height(); ++y) {
+        if (std::memcmp(a.constScanLine(y), b.constScanLine(y), static_cast<size_t>(a.width()) * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+class tst_ParallelPngWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testRoundTrip_data();
+    void testRoundTrip();
+    void testCompressionLevelsTradeSizeForSpeed();
+    void testPreservesColorSpaceAndText();
+    void testSaveImageAtomicallyUsesParallelPath();
+    void testRejectsUnsupportedFormats();
+};
+
+void tst_ParallelPngWriter::init()
+{
+    if (!ParallelPngWriter::isAvailable()) {
+        QSKIP("Built without zlib");
+    }
+}
+
+void tst_ParallelPngWriter::testRoundTrip_data()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("level");
+
+    QTest::newRow("rgb32-single-row") << QSize(37, 1) << int(QImage::Format_RGB32) << 6;
+    QTest::newRow("argb32-odd") << QSize(333, 257) << int(QImage::Format_ARGB32) << 6;
+    QTest::newRow("premultiplied-opaque-alpha") << QSize(640, 480)
+                                                << int(QImage::Format_ARGB32_Premultiplied) << 1;
+    QTest::newRow("rgb888-many-bands") << QSize(1200, 900) << int(QImage::Format_RGB888) << 9;
+    QTest::newRow("rgba8888-stored") << QSize(200, 150) << int(QImage::Format_RGBA8888) << 0;
+}
+
+void tst_ParallelPngWriter::testRoundTrip()
+{
+    QFETCH(QSize, size);
+    QFETCH(int, format);
+    QFETCH(int, level);
+
+    QImage image = makeImage(size, static_cast<QImage::Format>(format));
+    if (image.format() == QImage::Format_ARGB32_Premultiplied) {
+        // Premultiplying loses precision; compare against what is encodable.
+        image = makeImage(size, QImage::Format_RGB32)
+                    .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    QByteArray encoded;
+    QBuffer buffer(&encoded);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QString error;
+    QVERIFY2(ParallelPngWriter::write(image, &buffer, level, &error), qPrintable(error));
+
+    const QImage decoded = decode(encoded);
+    QVERIFY(!decoded.isNull());
+    QCOMPARE(decoded.hasAlphaChannel(), image.hasAlphaChannel());
+    QVERIFY(samePixels(decoded, image));
+}
+
+void tst_ParallelPngWriter::testCompressionLevelsTradeSizeForSpeed()
+{
+    const QImage image = makeImage(QSize(1024, 768), QImage::Format_RGB32);
+
+    QByteArray fastest;
+    QBuffer fastestBuffer(&fastest);
+    QVERIFY(fastestBuffer.open(QIODevice::WriteOnly));
+    QVERIFY(ParallelPngWriter::write(
+        image, &fastestBuffer,
+        ImageSaveUtils::pngCompressionLevel(ImageSaveUtils::PngCompression::Fastest)));
+
+    QByteArray smallest;
+    QBuffer smallestBuffer(&smallest);
+    QVERIFY(smallestBuffer.open(QIODevice::WriteOnly));
+    QVERIFY(ParallelPngWriter::write(
+        image, &smallestBuffer,
+        ImageSaveUtils::pngCompressionLevel(ImageSaveUtils::PngCompression::Smallest)));
+
+    QVERIFY(smallest.size() <= fastest.size());
+    QVERIFY(samePixels(decode(fastest), image));
+    QVERIFY(samePixels(decode(smallest), image));
+}
+
+void tst_ParallelPngWriter::testPreservesColorSpaceAndText()
+{
+    QImage image = makeImage(QSize(64, 64), QImage::Format_ARGB32);
+    QColorSpace colorSpace(QColorSpace::DisplayP3);
+    if (!colorSpace.isValid()) {
+        colorSpace = QColorSpace(QColorSpace::SRgb);
+    }
+    image.setColorSpace(colorSpace);
+    image.setDotsPerMeterX(5669);
+    image.setDotsPerMeterY(5669);
+    image.setText(QStringLiteral("Software"), QStringLiteral("SnapTray"));
+    image.setText(QStringLiteral("Title"), QStringLiteral("Capture — été"));
+
+    QByteArray encoded;
+    QBuffer buffer(&encoded);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(ParallelPngWriter::write(image, &buffer, 6));
+
+    const QImage decoded = decode(encoded);
+    QVERIFY(decoded.colorSpace().isValid());
+    const QByteArray icc = colorSpace.iccProfile();
+    if (!icc.isEmpty()) {
+        QCOMPARE(decoded.colorSpace().iccProfile(), icc);
+    }
+    QCOMPARE(decoded.dotsPerMeterX(), 5669);
+    QCOMPARE(decoded.dotsPerMeterY(), 5669);
+    QCOMPARE(decoded.text(QStringLiteral("Software")), QStringLiteral("SnapTray"));
+    QCOMPARE(decoded.text(QStringLiteral("Title")), QStringLiteral("Capture — été"));
+}
+
+void tst_ParallelPngWriter::testSaveImageAtomicallyUsesParallelPath()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Large enough for ImageSaveUtils to hand it to the parallel writer.
+    const QImage image = makeImage(QSize(1400, 900), QImage::Format_ARGB32);
+    const QString filePath = tempDir.filePath(QStringLiteral("large.png"));
+    ImageSaveUtils::Error error;
+    QVERIFY2(ImageSaveUtils::saveImageAtomically(image, filePath, QByteArray(), &error,
+                                                 ImageSaveUtils::PngCompression::Fastest),
+             qPrintable(error.message));
+
+    const QImage loaded(filePath);
+    QVERIFY(samePixels(loaded, image));
+}
+
+void tst_ParallelPngWriter::testRejectsUnsupportedFormats()
+{
+    QImage indexed(16, 16, QImage::Format_Indexed8);
+    QVERIFY(!ParallelPngWriter::canWrite(indexed));
+    QImage deep(16, 16, QImage::Format_RGBA64);
+    QVERIFY(!ParallelPngWriter::canWrite(deep));
+    QVERIFY(!ParallelPngWriter::canWrite(QImage()));
+
+    QByteArray encoded;
+    QBuffer buffer(&encoded);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QString error;
+    QVERIFY(!ParallelPngWriter::write(deep, &buffer, 6, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_MAIN(tst_ParallelPngWriter)
+#include "tst_ParallelPngWriter.moc"
@@ -0,0 +1,205 @@
+#include <QtTest>
+#include <QImage>
+#include <QRandomGenerator>
+
+#include "utils/PixelateKernel.h"
+
+/**
+ * @brief Unit tests for the shared mosaic pixelation kernel.
+ *
+ * The kernel output is compared pixel-for-pixel against a straightforward
+ * per-block reference, covering:
+ * - Grid-aligned and unaligned target rects
+ * - Rects with negative origins or partly outside the source
+ * - RGB32, ARGB32 and premultiplied sources
+ */
+class tst_PixelateKernel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testMatchesReference_RandomRects();
+    void testMatchesReference_PremultipliedSource();
+    void testMatchesReference_Rgb32Source();
+    void testBlocksAlignedToSourceGrid();
+    void testPartiallyOutsideSource_AveragesCoveredPixelsOnly();
+    void testNoOverlap_ReturnsNullImage();
+    void testResultFormatAndSize();
+
+private:
+    static QImage createNoiseImage(int width, int height, QImage::Format format, quint32 seed);
+    static QImage referencePixelate(const QImage& source, const QRect& targetRect, int blockSize);
+    static int floorToBlock(int value, int blockSize);
+};
+
+int tst_PixelateKernel::floorToBlock(int value, int blockSize)
+{
+    int remainder = value % blockSize;
+    if (remainder < 0) {
+        remainder += blockSize;
+    }
+    return value - remainder;
+}
+
+QImage tst_PixelateKernel::createNoiseImage(int width, int height, QImage::Format format,
+                                            quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        auto* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            line[x] = rng.generate();
+        }
+    }
+    return image.convertToFormat(format);
+}
+
+QImage tst_PixelateKernel::referencePixelate(const QImage& source, const QRect& targetRect,
+                                             int blockSize)
+{
+    const bool premultiplied = source.format() == QImage::Format_ARGB32_Premultiplied;
+    QImage result(targetRect.size(), QImage::Format_ARGB32);
+    result.fill(Qt::transparent);
+
+    const int startX = floorToBlock(targetRect.left(), blockSize);
+    const int startY = floorToBlock(targetRect.top(), blockSize);
+    for (int by = startY; by <= targetRect.bottom(); by += blockSize) {
+        for (int bx = startX; bx <= targetRect.right(); bx += blockSize) {
+            const QRect block(bx, by, blockSize, blockSize);
+            const QRect covered = block.intersected(source.rect());
+            const QRect target = block.intersected(targetRect);
+            if (covered.isEmpty() || target.isEmpty()) {
+                continue;
+            }
+
+            qint64 r = 0, g = 0, b = 0, a = 0;
+            for (int y = covered.top(); y <= covered.bottom(); ++y) {
+                const auto* line = reinterpret_cast<const QRgb*>(source.constScanLine(y));
+                for (int x = covered.left(); x <= covered.right(); ++x) {
+                    r += qRed(line[x]);
+                    g += qGreen(line[x]);
+                    b += qBlue(line[x]);
+                    a += qAlpha(line[x]);
+                }
+            }
+            const qint64 count = static_cast<qint64>(covered.width()) * covered.height();
+            QRgb color = qRgba(static_cast<int>(r / count), static_cast<int>(g / count),
+                               static_cast<int>(b / count), static_cast<int>(a / count));
+            if (premultiplied) {
+                color = qUnpremultiply(color);
+            }
+
+            for (int y = target.top(); y <= target.bottom(); ++y) {
+                auto* line = reinterpret_cast<QRgb*>(result.scanLine(y - targetRect.top()));
+                for (int x = target.left(); x <= target.right(); ++x) {
+                    line[x - targetRect.left()] = color;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+void tst_PixelateKernel::testMatchesReference_RandomRects()
+{
+    const QImage source = createNoiseImage(203, 157, QImage::Format_ARGB32, 0x1234);
+    QRandomGenerator rng(0x5eed);
+
+    for (int i = 0; i < 300; ++i) {
+        const int blockSize = 1 + rng.bounded(40);
+        const QRect targetRect(rng.bounded(-50, 250), rng.bounded(-50, 200),
+                               1 + rng.bounded(120), 1 + rng.bounded(120));
+
+        const QImage expected = referencePixelate(source, targetRect, blockSize);
+        const QImage actual = PixelateKernel::pixelate(source, targetRect, blockSize);
+        if (actual.isNull()) {
+            // Only allowed when no block touches the source at all
+            QImage transparent(expected.size(), expected.format());
+            transparent.fill(Qt::transparent);
+            QCOMPARE(expected, transparent);
+            continue;
+        }
+        QVERIFY2(actual == expected,
+                 qPrintable(QStringLiteral("block %1, rect %2,%3 %4x%5")
+                                .arg(blockSize)
+                                .arg(targetRect.x())
+                                .arg(targetRect.y())
+                                .arg(targetRect.width())
+                                .arg(targetRect.height())));
+    }
+}
+
+void tst_PixelateKernel::testMatchesReference_PremultipliedSource()
+{
+    const QImage source =
+        createNoiseImage(160, 120, QImage::Format_ARGB32_Premultiplied, 0xbeef);
+
+    for (int blockSize : {1, 3, 8, 17, 64}) {
+        const QRect targetRect(-5, 7, 150, 130);
+        const QImage expected = referencePixelate(source, targetRect, blockSize);
+        const QImage actual = PixelateKernel::pixelate(source, targetRect, blockSize);
+        QCOMPARE(actual, expected);
+    }
+}
+
+void tst_PixelateKernel::testMatchesReference_Rgb32Source()
+{
+    const QImage source = createNoiseImage(97, 61, QImage::Format_RGB32, 0xcafe);
+    const QRect targetRect(10, 3, 80, 50);
+
+    const QImage actual = PixelateKernel::pixelate(source, targetRect, 12);
+    QCOMPARE(actual, referencePixelate(source, targetRect, 12));
+    QCOMPARE(qAlpha(actual.pixel(0, 0)), 255);
+}
+
+void tst_PixelateKernel::testBlocksAlignedToSourceGrid()
+{
+    const QImage source = createNoiseImage(128, 128, QImage::Format_ARGB32, 0x42);
+    const QImage full = PixelateKernel::pixelate(source, source.rect(), 16);
+
+    // A sub-rect that starts mid-block must reproduce the same blocks.
+    const QRect subRect(21, 37, 50, 40);
+    const QImage partial = PixelateKernel::pixelate(source, subRect, 16);
+    QCOMPARE(partial, full.copy(subRect));
+}
+
+void tst_PixelateKernel::testPartiallyOutsideSource_AveragesCoveredPixelsOnly()
+{
+    QImage source(10, 10, QImage::Format_ARGB32);
+    source.fill(qRgba(40, 80, 120, 255));
+
+    // The block at (0,0) is 16x16 but only the 10x10 source pixels count.
+    const QImage result = PixelateKernel::pixelate(source, QRect(-8, -8, 24, 24), 16);
+    QCOMPARE(result.size(), QSize(24, 24));
+    QCOMPARE(result.pixel(8, 8), qRgba(40, 80, 120, 255));
+    QCOMPARE(result.pixel(23, 23), qRgba(40, 80, 120, 255));
+
+    // The block at (-16,-16) has no source coverage and stays transparent.
+    QCOMPARE(result.pixel(0, 0), qRgba(0, 0, 0, 0));
+}
+
+void tst_PixelateKernel::testNoOverlap_ReturnsNullImage()
+{
+    const QImage source = createNoiseImage(32, 32, QImage::Format_ARGB32, 7);
+
+    QVERIFY(PixelateKernel::pixelate(source, QRect(100, 100, 20, 20), 8).isNull());
+    QVERIFY(PixelateKernel::pixelate(source, QRect(-40, 0, 20, 20), 8).isNull());
+    QVERIFY(PixelateKernel::pixelate(QImage(), QRect(0, 0, 20, 20), 8).isNull());
+    QVERIFY(PixelateKernel::pixelate(source, QRect(), 8).isNull());
+}
+
+void tst_PixelateKernel::testResultFormatAndSize()
+{
+    const QImage source = createNoiseImage(64, 48, QImage::Format_RGB888, 3);
+    const QRect targetRect(5, 5, 30, 20);
+
+    const QImage result = PixelateKernel::pixelate(source, targetRect, 8);
+    QCOMPARE(result.format(), QImage::Format_ARGB32);
+    QCOMPARE(result.size(), targetRect.size());
+    QCOMPARE(result, referencePixelate(source.convertToFormat(QImage::Format_ARGB32),
+                                       targetRect, 8));
+}
+
+QTEST_MAIN(tst_PixelateKernel)
+#include "tst_PixelateKernel.moc"
@@ -0,0 +1,84 @@
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QRandomGenerator>
+
+#include "utils/PixelateKernel.h"
+
+#include <algorithm>
+#include <vector>
+
+class TestPixelateKernelBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchmarkPixelate4K_data();
+    void benchmarkPixelate4K();
+
+private:
+    static QImage createScreenshotLikeImage(const QSize& size);
+};
+
+QImage TestPixelateKernelBenchmark::createScreenshotLikeImage(const QSize& size)
+{
+    // Noise over a gradient, so every block has a distinct average.
+    QRandomGenerator rng(0x4b);
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < size.height(); ++y) {
+        auto* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < size.width(); ++x) {
+            const int noise = static_cast<int>(rng.bounded(32));
+            line[x] = qRgb((x * 255 / size.width() + noise) & 0xff,
+                           (y * 255 / size.height() + noise) & 0xff,
+                           noise * 8);
+        }
+    }
+    return image;
+}
+
+void TestPixelateKernelBenchmark::benchmarkPixelate4K_data()
+{
+    QTest::addColumn<int>("blockSize");
+    QTest::newRow("block 8") << 8;
+    QTest::newRow("block 16") << 16;
+    QTest::newRow("block 32") << 32;
+    QTest::newRow("block 64") << 64;
+}
+
+void TestPixelateKernelBenchmark::benchmarkPixelate4K()
+{
+    QFETCH(int, blockSize);
+    constexpr int kIterations = 10;
+
+    static const QImage source = createScreenshotLikeImage(QSize(3840, 2160));
+
+    // Full-screen mosaic, offset by a few pixels so edge blocks are partial.
+    const QRect targetRect = source.rect().adjusted(3, 5, -7, -2);
+    QImage result = PixelateKernel::pixelate(source, targetRect, blockSize);
+    QCOMPARE(result.size(), targetRect.size());
+
+    std::vector<qint64> timingsNs;
+    timingsNs.reserve(kIterations);
+    QElapsedTimer timer;
+    for (int i = 0; i < kIterations; ++i) {
+        timer.start();
+        result = PixelateKernel::pixelate(source, targetRect, blockSize);
+        timingsNs.push_back(timer.nsecsElapsed());
+    }
+
+    std::sort(timingsNs.begin(), timingsNs.end());
+    const double medianMs = static_cast<double>(timingsNs[timingsNs.size() / 2]) / 1.0e6;
+    const double megapixels =
+        static_cast<double>(targetRect.width()) * targetRect.height() / 1.0e6;
+    qInfo().nospace()
+        << "PixelateKernel " << targetRect.width() << "x" << targetRect.height()
+        << " block " << blockSize << ": median " << medianMs << " ms, min "
+        << static_cast<double>(timingsNs.front()) / 1.0e6 << " ms ("
+        << megapixels / (medianMs / 1000.0) << " MP/s)";
+
+    QVERIFY(!result.isNull());
+}
+
+QTEST_MAIN(TestPixelateKernelBenchmark)
+#include "tst_PixelateKernelBenchmark.moc"
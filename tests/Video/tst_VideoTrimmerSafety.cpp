@@ -2,10 +2,17 @@
 
 #include <QDir>
 #include <QFile>
+#include <QThread>
 
 #include "IVideoEncoder.h"
+#include "video/DecodedFrameQueue.h"
+#include "video/IVideoPlayer.h"
 #include "video/VideoTrimmer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 class BackpressureVideoEncoder final : public IVideoEncoder
 {
 public:
@@ -18,15 +25,16 @@ public:
     QString encoderName() const override { return QStringLiteral("Backpressure test encoder"); }
     bool start(const QString &, const QSize &, int) override { m_running = true; return true; }
 
-    void writeFrame(const QImage &, qint64) override
+    void writeFrame(const QImage &, qint64 timestampMs) override
     {
         ++m_attempts;
         if (m_attempts > m_rejectedAttempts) {
             ++m_framesWritten;
+            m_timestamps.append(timestampMs);
         }
     }
 
-    void finish() override { m_running = false; }
+    void finish() override { m_running = false; m_finished = true; }
     void abort() override { m_running = false; }
     bool isRunning() const override { return m_running; }
     QString lastError() const override { return {}; }
@@ -34,12 +42,87 @@ public:
     QString outputPath() const override { return {}; }
 
     int attempts() const { return m_attempts; }
+    bool isFinished() const { return m_finished; }
+    QList<qint64> timestamps() const { return m_timestamps; }
 
 private:
     int m_rejectedAttempts = 0;
     int m_attempts = 0;
     qint64 m_framesWritten = 0;
     bool m_running = true;
+    bool m_finished = false;
+    QList<qint64> m_timestamps;
+};
+
+// Decodes a synthetic 10 fps stream from a keyframe at 0 ms on a worker
+// thread, the way the platform players run sequential decode.
+class SequentialTestPlayer final : public IVideoPlayer
+{
+public:
+    explicit SequentialTestPlayer(QObject *parent = nullptr) : IVideoPlayer(parent) {}
+    ~SequentialTestPlayer() override { stopSequentialDecode(); }
+
+    bool load(const QString &) override { return true; }
+    void play() override {}
+    void pause() override {}
+    void stop() override {}
+    void seek(qint64) override { ++m_seeks; }
+    State state() const override { return State::Paused; }
+    qint64 duration() const override { return 10000; }
+    qint64 position() const override { return 0; }
+    QSize videoSize() const override { return QSize(8, 8); }
+    bool hasVideo() const override { return true; }
+    bool hasAudio() const override { return false; }
+    double frameRate() const override { return 10.0; }
+    int frameIntervalMs() const override { return 100; }
+    void setVolume(float) override {}
+    float volume() const override { return 1.0f; }
+    void setMuted(bool) override {}
+    bool isMuted() const override { return false; }
+    void setLooping(bool) override {}
+    bool isLooping() const override { return false; }
+    void setPlaybackRate(float) override {}
+    float playbackRate() const override { return 1.0f; }
+
+    bool supportsSequentialDecode() const override { return true; }
+    bool startSequentialDecode(qint64 startMs, qint64 endMs,
+                               SequentialFrameCallback callback) override
+    {
+        m_thread.reset(QThread::create([this, startMs, endMs, callback]() {
+            for (qint64 timestampMs = 0; timestampMs < endMs && !m_stopped; timestampMs += 100) {
+                if (timestampMs + 100 <= startMs) {
+                    continue;
+                }
+                QImage frame(8, 8, QImage::Format_RGB32);
+                frame.fill(Qt::green);
+                ++m_framesDecoded;
+                if (!callback(frame, timestampMs)) {
+                    return;
+                }
+            }
+            QMetaObject::invokeMethod(this, [this]() { emit sequentialDecodeFinished(); },
+                                      Qt::QueuedConnection);
+        }));
+        m_thread->start();
+        return true;
+    }
+
+    void stopSequentialDecode() override
+    {
+        m_stopped = true;
+        if (m_thread) {
+            m_thread->wait();
+        }
+    }
+
+    int seeks() const { return m_seeks; }
+    int framesDecoded() const { return m_framesDecoded; }
+
+private:
+    std::unique_ptr<QThread> m_thread;
+    std::atomic<bool> m_stopped{false};
+    std::atomic<int> m_framesDecoded{0};
+    int m_seeks = 0;
 };
 
 class TestVideoTrimmerSafety : public QObject
@@ -48,6 +131,8 @@ class TestVideoTrimmerSafety : public QObject
 
 private slots:
     void nativeEncoderBackpressureRetriesSameFrame();
+    void decodedFrameQueueBlocksProducerWhenFull();
+    void sequentialDecodeEncodesRangeWithoutSeeking();
     void avFoundationSeekUsesLockedAffinityHandoff();
     void mediaFoundationPausedSeekKeepsFramePending();
 };
@@ -83,6 +168,86 @@ void TestVideoTrimmerSafety::nativeEncoderBackpressureRetriesSameFrame()
     trimmer.m_videoEncoder = nullptr;
 }
 
+void TestVideoTrimmerSafety::decodedFrameQueueBlocksProducerWhenFull()
+{
+    DecodedFrameQueue queue(2);
+    QImage frame(4, 4, QImage::Format_RGB32);
+    QVERIFY(queue.push(frame, 0));
+    QVERIFY(queue.push(frame, 10));
+
+    std::atomic<bool> thirdPushed{false};
+    std::unique_ptr<QThread> producer(QThread::create([&]() {
+        thirdPushed = queue.push(frame, 20);
+    }));
+    producer->start();
+    QVERIFY(!producer->wait(100));
+    QVERIFY(!thirdPushed);
+
+    DecodedFrameQueue::Frame popped;
+    QVERIFY(queue.tryPop(popped));
+    QCOMPARE(popped.timestampMs, qint64(0));
+    QVERIFY(producer->wait(1000));
+    QVERIFY(thirdPushed);
+    QCOMPARE(queue.size(), 2);
+
+    queue.close();
+    QVERIFY(!queue.isDrained());
+    QVERIFY(queue.tryPop(popped));
+    QVERIFY(queue.tryPop(popped));
+    QCOMPARE(popped.timestampMs, qint64(20));
+    QVERIFY(queue.isDrained());
+
+    // Aborting releases a producer blocked on a full queue.
+    DecodedFrameQueue abortedQueue(1);
+    QVERIFY(abortedQueue.push(frame, 0));
+    std::atomic<bool> blockedPushResult{true};
+    producer.reset(QThread::create([&]() {
+        blockedPushResult = abortedQueue.push(frame, 10);
+    }));
+    producer->start();
+    QVERIFY(!producer->wait(50));
+    abortedQueue.abort();
+    QVERIFY(producer->wait(1000));
+    QVERIFY(!blockedPushResult);
+    QCOMPARE(abortedQueue.size(), 0);
+}
+
+void TestVideoTrimmerSafety::sequentialDecodeEncodesRangeWithoutSeeking()
+{
+    BackpressureVideoEncoder encoder(0);
+    SequentialTestPlayer player;
+    VideoTrimmer trimmer;
+    QSignalSpy progressSpy(&trimmer, &VideoTrimmer::progress);
+    trimmer.m_running = true;
+    trimmer.m_player = &player;
+    trimmer.m_videoEncoder = &encoder;
+    trimmer.m_trimStart = 250;
+    trimmer.m_trimEnd = 2250;
+    trimmer.m_totalFrames = 20;
+    trimmer.m_elapsed.start();
+
+    QVERIFY(trimmer.startSequentialDecode());
+    QTRY_VERIFY_WITH_TIMEOUT(encoder.isFinished(), 5000);
+
+    // Frames 200..2200 ms cover the range; the first one starts before it.
+    QCOMPARE(player.seeks(), 0);
+    QCOMPARE(encoder.framesWritten(), qint64(21));
+    const QList<qint64> timestamps = encoder.timestamps();
+    QCOMPARE(timestamps.first(), qint64(0));
+    QCOMPARE(timestamps.at(1), qint64(50));
+    QCOMPARE(timestamps.last(), qint64(1950));
+    QVERIFY(std::is_sorted(timestamps.cbegin(), timestamps.cend()));
+    QCOMPARE(progressSpy.count(), 21);
+    QVERIFY(progressSpy.last().at(0).toInt() <= 99);
+    QVERIFY(progressSpy.last().at(1).toDouble() > 0.0);
+
+    // Keep teardown independent from the normal asynchronous completion path.
+    trimmer.stopSequentialDecode();
+    trimmer.m_running = false;
+    trimmer.m_player = nullptr;
+    trimmer.m_videoEncoder = nullptr;
+}
+
 void TestVideoTrimmerSafety::avFoundationSeekUsesLockedAffinityHandoff()
 {
     QFile source(QDir(QStringLiteral(VIDEO_SOURCE_ROOT))